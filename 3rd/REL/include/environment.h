@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -23,7 +25,9 @@ namespace rel {
 //  {
 //    "datasets": [
 //      { "name": "noise",    "format": "hdf5", "path": "/data/noise.xdataset" },
-//      { "name": "amplifier","format": "hdf5", "path": "/data/amp.xdataset" }
+//      { "name": "corners",  "format": "xds",  "path": "/data/corners.xds" },
+//      { "name": "amplifier","format": "hdf5", "path": "/data/amp.xdataset",
+//        "lazy": true }
 //    ],
 //    "default_dataset": "noise",
 //    "python_plugins": ["plugins/snr.py", "plugins/eye.py"]
@@ -31,6 +35,13 @@ namespace rel {
 //
 //  "default_dataset" is optional; if omitted, the first dataset in "datasets"
 //  becomes the default.
+//  "lazy" is optional and defaults to false.  When true, numeric data of an
+//  hdf5 dataset is read when an expression first uses it, and only the rows
+//  a selection touches (see xdataset::DatasetIOOptions::lazy), so archives
+//  larger than memory can be opened; rows read in full stay resident only
+//  while some value still holds them.
+//  "xds" datasets are memory-mapped: loading reads only the header, and the
+//  numeric columns are shared through the page cache between processes.
 //  "python_plugins" is optional; each entry is a .py plugin path resolved
 //  relative to the config file's directory (requires BUILD_PYTHON=ON).
 
@@ -38,6 +49,7 @@ struct REL_API DatasetConfig {
     std::string name;
     std::string format;
     std::string path;
+    bool        lazy = false;
 };
 
 struct REL_API EnvironmentConfig {
@@ -53,6 +65,39 @@ private:
     static EnvironmentConfig Parse(const rapidjson::Document& doc);
 };
 
+// =========================================================================
+//  ParallelOptions -- intra-operation parallelism of element-wise kernels
+// =========================================================================
+//
+//  Large element-wise operations (arithmetic, sin, db, phase, ...) split
+//  their rows across one process-wide worker pool.  Results are identical
+//  to a serial run for any thread count.
+
+struct ParallelOptions {
+    /// Threads per operation, the evaluating thread included.  1 keeps
+    /// every operation serial; 0 uses std::thread::hardware_concurrency().
+    std::size_t threads = 1;
+
+    /// Operations over fewer elements stay serial.
+    std::size_t min_elements = std::size_t(1) << 20;
+};
+
+/// Keeps every operation evaluated on the calling thread serial for the
+/// scope's lifetime, whatever the Environment's ParallelOptions say.  Hosts
+/// that evaluate on their own worker threads open one there, so each of
+/// their workers does not fan out onto REL's pool as well.
+class REL_API SerialEvalScope {
+public:
+    explicit SerialEvalScope(bool enabled = true);
+    ~SerialEvalScope();
+
+    SerialEvalScope(const SerialEvalScope&) = delete;
+    SerialEvalScope& operator=(const SerialEvalScope&) = delete;
+
+private:
+    bool saved_;
+};
+
 // =========================================================================
 //  Environment -- flat variable table + global shared context
 // =========================================================================
@@ -65,12 +110,27 @@ private:
 //    - LoadFromConfig() loads datasets/plugins globally, not per-env.
 //    - Define() rejects names that collide with builtin constants.
 //
+//  The variable table is guarded by a per-instance mutex, so one Environment
+//  may be read and written from several threads at once (e.g. independent
+//  equations evaluated in parallel).  Use CopyVariableOrConstant() rather
+//  than LookupVariableOrConstant() when another thread may Define/Remove.
+//  The dataset registry has its own lock, and the builtin constants are
+//  populated once and read-only afterwards, so both may be read from any
+//  thread.
+//
 
 class REL_API Environment
 {
 public:
     Environment() = default;
 
+    /// Copy/move transfer the variable table and parallel options (taken
+    /// under the source's lock); each instance keeps its own mutex.
+    Environment(const Environment& other);
+    Environment(Environment&& other);
+    Environment& operator=(const Environment& other);
+    Environment& operator=(Environment&& other);
+
     // ---- variables (instance -- user-defined only) ----
 
     /// Bind or rebind a name.  Overwrites existing bindings silently.
@@ -92,10 +152,29 @@ public:
     /// Names of all user-defined variables (unordered).
     std::vector<std::string> VariableNames() const;
 
+    /// True when `name` is a user-defined variable.  Hashed lookup; unlike
+    /// VariableNames() it does not materialise the name list.
+    bool Contains(const std::string& name) const;
+
+    /// Copy a user-defined variable into `out` under the variable lock.
+    /// Returns false (leaving `out` untouched) when not found.
+    bool Find(const std::string& name, rel::Value& out) const;
+
+    /// Number of user-defined variables.
+    std::size_t size() const;
+
+    // ---- parallel execution (instance) ----
+
+    /// Parallelism used by rel::Eval against this Environment.  Serial by
+    /// default.
+    void SetParallelOptions(const ParallelOptions& options);
+    ParallelOptions parallel_options() const;
+
     // ---- static: builtin constants ----------------------------------------
 
     /// Populate the global builtin-constant registry (PI, e, c0, ...).
-    /// Call once during process startup.
+    /// Only the first call has an effect, so later calls never race with
+    /// readers on other threads.
     static void InitBuiltinConstants();
 
     /// Look up a builtin constant by name, or nullptr when not found.
@@ -105,6 +184,13 @@ public:
     static std::vector<std::string> ConstantNames();
 
     // ---- static: function registry ----------------------------------------
+    //
+    //  The registry is an immutable snapshot replaced wholesale by every
+    //  Register/Unregister (copy-on-write under a writer lock).  Each thread
+    //  keeps the snapshot it last used and re-fetches it only when the
+    //  version has moved, so lookups take no lock in the steady state.
+    //  Every name seen is given a slot that is never reused; call sites can
+    //  resolve the name to its slot once and index the snapshot afterwards.
 
     /// Register REL's builtin function libraries ("builtin" + "math").
     /// Call once during process startup.
@@ -115,6 +201,7 @@ public:
     static void RegisterFunction(Function fn);
 
     /// Register every function in a library.
+    /// Publishes one snapshot for the whole library.
     static void RegisterLibrary(const FunctionLibrary& lib);
 
     /// Remove a registered function by name.
@@ -122,16 +209,28 @@ public:
     static bool UnregisterFunction(const std::string& name);
 
     /// Check whether a function of that name is registered.
-    /// Thread-safe existence check; use CopyFunction() to obtain a callable
-    /// copy (a raw pointer/reference into the registry would escape the
-    /// registry lock and could dangle on a concurrent re-registration).
     static bool HasFunction(const std::string& name);
 
-    /// Thread-safe copy of a registered function, or false when not found.
-    /// Copies the Function while holding the registry lock, so the returned
-    /// copy can be invoked without racing a concurrent re-registration.
+    /// Copy of a registered function, or false when not found.  Prefer
+    /// ResolveFunction(), which shares the registered instance instead.
     static bool CopyFunction(const std::string& name, Function& out);
 
+    /// The registered function, or nullptr.  The handle keeps the Function
+    /// alive across a concurrent re-registration or unregistration.
+    static std::shared_ptr<const Function> ResolveFunction(const std::string& name);
+
+    /// Stable slot of a function name, allocated on first use (whether or
+    /// not the function is registered yet) and never reused.
+    static std::size_t FunctionSlot(const std::string& name);
+
+    /// The function currently registered in `slot`, or nullptr.  No lock
+    /// and no string hashing unless the registry changed since this
+    /// thread's last lookup.
+    static std::shared_ptr<const Function> ResolveFunction(std::size_t slot);
+
+    /// Incremented by every registry change.
+    static std::uint64_t FunctionRegistryVersion();
+
     /// Names of all registered functions (unordered).
     static std::vector<std::string> FunctionNames();
 
@@ -196,9 +295,26 @@ public:
     // ---- direct lookups (AST-free) ----------------------------------------
 
     /// Look up a name in user variables, then builtin constants.
-    /// Returns nullptr when not found in either.
+    /// Returns nullptr when not found in either.  The returned pointer is
+    /// only stable while no other thread modifies the variable table.
     const rel::Value* LookupVariableOrConstant(const std::string& name) const;
 
+    /// Thread-safe form of LookupVariableOrConstant(): copies the value while
+    /// holding the variable lock.  Returns false when not found in either.
+    bool CopyVariableOrConstant(const std::string& name, rel::Value& out) const;
+
+    /// Stable slot of an identifier, allocated on first use and never
+    /// reused.  The numbering is shared by every Environment, so a compiled
+    /// Program resolves each identifier to its slot once.
+    static std::size_t VariableSlot(const std::string& name);
+
+    /// Slot form of CopyVariableOrConstant(); `name` is the slot's name.
+    /// The first lookup hashes the name and remembers where the value
+    /// lives; later ones reuse that while the table's revision is unchanged
+    /// (removing a variable bumps it).
+    bool CopyVariableOrConstant(std::size_t slot, const std::string& name,
+                                rel::Value& out) const;
+
     /// Find a registered Dataset by name, or nullptr if not found.
     static xdataset::Dataset* FindDataset(const std::string& name);
 
@@ -227,14 +343,34 @@ public:
     static void CleanupPythonState();
 
 private:
+    /// Where a slot's value was found; valid while `revision` == revision_.
+    struct SlotEntry
+    {
+        const rel::Value* value = nullptr;
+        std::uint64_t     revision = 0;
+    };
+
     std::unordered_map<std::string, rel::Value> variables_;
+    ParallelOptions parallel_;
+    mutable std::vector<SlotEntry> slot_cache_;  // indexed by VariableSlot
+    std::uint64_t revision_ = 1;  // bumped whenever a variable is erased
+    mutable std::mutex variables_mutex_;  // guards all of the above
 
     // ---- global (static) state --------------------------------------------
     static std::unordered_map<std::string, rel::Value>
         builtin_constants_;
-    static std::unordered_map<std::string, Function>
-        functions_;
-    static std::mutex functions_mutex_;  // guards functions_
+    static std::unordered_map<std::string, std::size_t> variable_slots_;
+    static std::mutex variable_slots_mutex_;  // guards variable_slots_
+    struct FunctionTable;
+    /// This thread's snapshot of the registry, refreshed when stale.
+    static const FunctionTable& function_table();
+    /// Replace the registry by `edit` applied to a copy (writer lock held).
+    static void update_functions(const std::function<void(FunctionTable&)>& edit);
+
+    static std::shared_ptr<const FunctionTable> functions_;
+    static std::atomic<std::uint64_t> functions_version_;
+    static std::mutex functions_mutex_;  // serialises writers; guards functions_
+    static std::mutex datasets_mutex_;  // guards datasets_, default_dataset_name_
     static std::unordered_map<std::string, std::unique_ptr<xdataset::Dataset>>
         datasets_;
     static std::string default_dataset_name_;
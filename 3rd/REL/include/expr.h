@@ -10,6 +10,7 @@
 namespace rel
 {
     class ExprVisitor;
+    class Value;
 
     class Expr;
     class NumberExpr;
@@ -28,6 +29,8 @@ namespace rel
     class MatrixExpr;
     class RangeExpr;
     class NullRangeExpr;
+    class ConstantExpr;
+    struct ResolvedReference;
 
     typedef std::unique_ptr<Expr> ExprPtr;
 
@@ -83,6 +86,7 @@ namespace rel
         virtual void visit_matrix(const MatrixExpr& expr) = 0;
         virtual void visit_range(const RangeExpr& expr) = 0;
         virtual void visit_null_range(const NullRangeExpr& expr) = 0;
+        virtual void visit_constant(const ConstantExpr& expr) = 0;
     };
 
     class REL_API Expr
@@ -152,6 +156,11 @@ namespace rel
 
         std::vector<RefSegment> segments;
 
+        /// Dataset lookup last made for this node; the evaluator reuses it
+        /// while the Dataset is unchanged.  Accessed with std::atomic_load /
+        /// std::atomic_store, as one tree may be evaluated concurrently.
+        mutable std::shared_ptr<const ResolvedReference> resolved;
+
         void accept(ExprVisitor& visitor) const override;
     };
 
@@ -309,4 +318,21 @@ namespace rel
 
         void accept(ExprVisitor& visitor) const override;
     };
+
+    // Never produced by the parser: rel::Optimize() replaces literals and
+    // constant sub-expressions with their pre-built Value.  `text` is the
+    // source form of the replaced sub-tree, kept for printing.
+    class REL_API ConstantExpr : public Expr
+    {
+    public:
+        ConstantExpr(int line_value,
+                     int column_value,
+                     std::shared_ptr<const Value> value_value,
+                     std::string text_value);
+
+        std::shared_ptr<const Value> value;
+        std::string text;
+
+        void accept(ExprVisitor& visitor) const override;
+    };
 } // namespace rel
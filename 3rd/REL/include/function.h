@@ -31,6 +31,12 @@ namespace rel
     //  supplied as a static constant, but must be produced at resolve time
     //  from the already-resolved parameters.  Computed defaults are
     //  registered via ComputedParam().
+    //
+    //  A function may instead be implemented positionally (see
+    //  Function::Positional): the implementation receives the resolved
+    //  arguments as an array in declaration order, and call sites that pass
+    //  plain leading arguments reach it through Invoke(const Value*, size_t)
+    //  without building an ArgMap.
 
     /// Named-argument map: param names to resolved Values, in declaration order.
     using ArgMap = tsl::ordered_map<std::string, Value>;
@@ -38,6 +44,10 @@ namespace rel
     /// Native implementation of a registered REL function.
     typedef std::function<Value(const ArgMap&)> NativeFunction;
 
+    /// Positional implementation: `count` resolved arguments in declaration
+    /// order (always the full arity).
+    typedef std::function<Value(const Value* args, std::size_t count)> PositionalFunction;
+
     /// One parameter of a function; may carry a default value.
     struct FunctionParam
     {
@@ -103,9 +113,22 @@ namespace rel
             , impl_(std::move(impl_value))
         {}
 
+        /// A function implemented positionally.  It is still callable
+        /// through Invoke(const ArgMap&); the resolved map is flattened in
+        /// declaration order.
+        static Function Positional(std::string name_value,
+                                   std::vector<FunctionParam> params_value,
+                                   PositionalFunction positional_value)
+        {
+            Function fn(std::move(name_value), std::move(params_value), NativeFunction());
+            fn.positional_ = std::move(positional_value);
+            return fn;
+        }
+
         const std::string&              name()   const { return name_; }
         const std::vector<FunctionParam>& params() const { return params_; }
         const NativeFunction&           impl()   const { return impl_; }
+        const PositionalFunction&       positional() const { return positional_; }
 
         /// Number of declared parameters.
         std::size_t arity() const { return params_.size(); }
@@ -132,10 +155,21 @@ namespace rel
         /// required parameter is missing.
         REL_API Value Invoke(const ArgMap& user_args) const;
 
+        /// Invoke with the first `count` parameters given positionally; the
+        /// remaining ones take their defaults.  A positional implementation
+        /// whose missing slots all have static defaults is called directly
+        /// on `args` (or a defaulted copy); everything else goes through
+        /// Invoke(const ArgMap&).  Throws when `count` exceeds the arity.
+        REL_API Value Invoke(const Value* args, std::size_t count) const;
+
     private:
+        /// Call an implementation, prefixing its error with the function name.
+        Value call_positional(const Value* args, std::size_t count) const;
+
         std::string                name_;
         std::vector<FunctionParam> params_;
         NativeFunction             impl_;
+        PositionalFunction         positional_;
     };
 
     // =====================================================================
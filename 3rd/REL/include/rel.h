@@ -5,11 +5,13 @@
 #include "function.h"   // FunctionParam / NativeFunction
 #include "value.h"      // rel::Value
 
+#include <memory>
 #include <string>
 
 namespace rel {
 
 class Environment;
+class Program;
 
 /// Parse a single REL expression from a source string into a syntax tree.
 /// Returns the parsed AST (ExprPtr); throws std::runtime_error with the
@@ -18,6 +20,15 @@ class Environment;
 /// without re-parsing, or inspected/transformed by an ExprVisitor.
 REL_API ExprPtr Parse(const std::string& source);
 
+/// Rewrite a parsed syntax tree for repeated evaluation.  Literals become
+/// pre-built Values, and sub-expressions made only of literals and builtin
+/// constants (`2*PI*1GHz`, `c0/(4*PI)`) are folded into one constant
+/// through the ordinary operators.  Function calls are never folded, and a
+/// sub-tree whose folding throws is kept so the error is still raised by
+/// Eval.  Call after Environment::InitBuiltinConstants(); the optimised
+/// tree evaluates to the same Value as the original.
+REL_API ExprPtr Optimize(ExprPtr expr);
+
 /// Parse and evaluate a single REL expression from a source string.
 /// When `env` is nullptr (the default), a temporary Environment is used.
 /// Otherwise the given Environment is used (with its variables, datasets,
@@ -29,6 +40,20 @@ REL_API Value Eval(const std::string& source, Environment* env = nullptr);
 /// Throws std::runtime_error on evaluation failure.
 REL_API Value Eval(const Expr& expr, Environment& env);
 
+/// Lower a syntax tree (typically an Optimize()d one) to bytecode for a
+/// register VM, so repeated evaluation skips the tree walk.  Identifiers
+/// and called names are resolved to variable and function-registry slots
+/// once; what a slot holds is read on every run, so variables defined and
+/// functions registered or replaced after Compile() are seen.
+/// The Program takes ownership of the tree and is immutable: one Program
+/// may be evaluated concurrently against different Environments.
+REL_API std::shared_ptr<const Program> Compile(ExprPtr expr);
+
+/// Run a compiled Program against an Environment.  Produces the same Value
+/// -- and the same errors -- as Eval(const Expr&, Environment&) on the
+/// tree the Program was compiled from.
+REL_API Value Eval(const Program& program, Environment& env);
+
 /// Execute a single line of REL source, which may be either a plain
 /// expression or a `name = expr` binding:
 ///   - plain expression: parsed and evaluated; the result is discarded;
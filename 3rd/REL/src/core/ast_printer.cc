@@ -261,4 +261,6 @@ namespace rel
     }
 
     void AstPrinter::visit_null_range(const NullRangeExpr&) { out_ = "::"; }
+
+    void AstPrinter::visit_constant(const ConstantExpr& expr) { out_ = expr.text; }
 } // namespace rel
@@ -28,6 +28,7 @@ namespace rel
         void visit_matrix(const MatrixExpr& expr) override;
         void visit_range(const RangeExpr& expr) override;
         void visit_null_range(const NullRangeExpr& expr) override;
+        void visit_constant(const ConstantExpr& expr) override;
 
     private:
         std::string out_;
@@ -0,0 +1,672 @@
+#include "bytecode.h"
+
+#include "evaluator.h"
+#include "evaluator_helpers.h"
+#include "operation/operator.h"
+#include "rel.h"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace rel {
+
+using operation::FusedExpr;
+
+Program::Program(ExprPtr root) : root_(std::move(root)) {}
+
+// =========================================================================
+//  Compiler -- AST -> instructions
+// =========================================================================
+//
+//  compile(e, dst) leaves the value of `e` in r[dst]; registers above dst
+//  are free scratch space for the sub-tree, so operands of a node are laid
+//  out in consecutive registers starting at dst.
+
+class Compiler
+{
+public:
+    explicit Compiler(Program& program) : program_(program) {}
+
+    void Run()
+    {
+        compile(program_.root(), 0, false);
+        program_.result_ = 0;
+    }
+
+private:
+    void compile(const Expr& e, std::int32_t dst, bool inside_matrix);
+    void compile_fused(const Expr& e, std::int32_t dst, bool inside_matrix);
+    std::int32_t build_fused(const Expr& e, FusedChain& chain, std::int32_t& next_reg,
+                             bool inside_matrix);
+    void compile_logical(const LogicalExpr& e, std::int32_t dst, bool inside_matrix);
+    void compile_conditional(const ConditionalExpr& e, std::int32_t dst, bool inside_matrix);
+    void compile_if(const IfExpr& e, std::int32_t dst, bool inside_matrix);
+    void compile_call(const CallExpr& e, std::int32_t dst, bool inside_matrix);
+    void compile_index(const IndexExpr& e, std::int32_t dst, bool inside_matrix);
+    void compile_items(const Expr& e,
+                       const std::vector<ExprPtr>& items,
+                       OpCode op,
+                       std::int32_t dst,
+                       bool inside_matrix);
+
+    /// Hand `e` to the tree-walking evaluator at run time.
+    void emit_eval(const Expr& e, std::int32_t dst, bool inside_matrix);
+
+    std::int32_t emit(OpCode op,
+                      std::int32_t a = 0,
+                      std::int32_t b = 0,
+                      std::int32_t c = 0,
+                      std::int32_t d = 0)
+    {
+        Instruction in;
+        in.op = op;
+        in.a  = a;
+        in.b  = b;
+        in.c  = c;
+        in.d  = d;
+        program_.code_.push_back(in);
+        return static_cast<std::int32_t>(program_.code_.size()) - 1;
+    }
+
+    std::int32_t here() const { return static_cast<std::int32_t>(program_.code_.size()); }
+    Instruction& at(std::int32_t pc) { return program_.code_[static_cast<std::size_t>(pc)]; }
+
+    void use_register(std::int32_t r)
+    {
+        if (r + 1 > program_.registers_)
+            program_.registers_ = r + 1;
+    }
+
+    std::int32_t add_node(const Expr& e, bool inside_matrix)
+    {
+        program_.nodes_.push_back(NodeRef{&e, inside_matrix});
+        return static_cast<std::int32_t>(program_.nodes_.size()) - 1;
+    }
+
+    std::int32_t add_name(const std::string& name)
+    {
+        for (std::size_t i = 0; i < program_.names_.size(); ++i)
+        {
+            if (program_.names_[i] == name)
+                return static_cast<std::int32_t>(i);
+        }
+        program_.names_.push_back(name);
+        program_.slots_.push_back(Environment::VariableSlot(name));
+        return static_cast<std::int32_t>(program_.names_.size()) - 1;
+    }
+
+    static bool is_range(const ExprPtr& e)
+    {
+        return dynamic_cast<const RangeExpr*>(e.get()) ||
+               dynamic_cast<const NullRangeExpr*>(e.get());
+    }
+
+    Program& program_;
+};
+
+void Compiler::emit_eval(const Expr& e, std::int32_t dst, bool inside_matrix)
+{
+    use_register(dst);
+    emit(OpCode::kEval, dst, add_node(e, inside_matrix));
+}
+
+void Compiler::compile(const Expr& e, std::int32_t dst, bool inside_matrix)
+{
+    use_register(dst);
+
+    if (auto* c = dynamic_cast<const ConstantExpr*>(&e))
+    {
+        program_.consts_.push_back(*c->value);
+        emit(OpCode::kLoadConst, dst, static_cast<std::int32_t>(program_.consts_.size()) - 1);
+        return;
+    }
+
+    if (dynamic_cast<const NumberExpr*>(&e) || dynamic_cast<const BooleanExpr*>(&e) ||
+        dynamic_cast<const StringExpr*>(&e))
+    {
+        // Literals are materialised once; one that cannot be (an unknown
+        // unit suffix, ...) keeps failing at run time.
+        try
+        {
+            Environment env;
+            Evaluator evaluator(env);
+            program_.consts_.push_back(evaluator.Evaluate(e));
+        }
+        catch (const std::exception&)
+        {
+            emit_eval(e, dst, inside_matrix);
+            return;
+        }
+        emit(OpCode::kLoadConst, dst, static_cast<std::int32_t>(program_.consts_.size()) - 1);
+        return;
+    }
+
+    if (auto* r = dynamic_cast<const ReferenceExpr*>(&e))
+    {
+        if (r->segments.size() != 1)
+        {
+            emit_eval(e, dst, inside_matrix);
+            return;
+        }
+        emit(OpCode::kLoadVar, dst, add_name(r->segments[0].name), add_node(e, inside_matrix));
+        return;
+    }
+
+    if (auto* g = dynamic_cast<const GroupingExpr*>(&e))
+    {
+        compile(*g->inner, dst, inside_matrix);
+        return;
+    }
+
+    if (auto* u = dynamic_cast<const UnaryExpr*>(&e))
+    {
+        if (CountFusedOps(e, 2) >= 2)
+        {
+            compile_fused(e, dst, inside_matrix);
+            return;
+        }
+        compile(*u->operand, dst, inside_matrix);
+        emit(OpCode::kUnary, dst, dst, static_cast<std::int32_t>(u->op));
+        return;
+    }
+
+    if (auto* b = dynamic_cast<const BinaryExpr*>(&e))
+    {
+        if (CountFusedOps(e, 2) >= 2)
+        {
+            compile_fused(e, dst, inside_matrix);
+            return;
+        }
+        compile(*b->left, dst, inside_matrix);
+        compile(*b->right, dst + 1, inside_matrix);
+        emit(OpCode::kBinary, dst, dst, dst + 1, static_cast<std::int32_t>(b->op));
+        return;
+    }
+
+    if (auto* l = dynamic_cast<const LogicalExpr*>(&e))
+    {
+        compile_logical(*l, dst, inside_matrix);
+        return;
+    }
+    if (auto* c = dynamic_cast<const ConditionalExpr*>(&e))
+    {
+        compile_conditional(*c, dst, inside_matrix);
+        return;
+    }
+    if (auto* i = dynamic_cast<const IfExpr*>(&e))
+    {
+        compile_if(*i, dst, inside_matrix);
+        return;
+    }
+    if (auto* call = dynamic_cast<const CallExpr*>(&e))
+    {
+        compile_call(*call, dst, inside_matrix);
+        return;
+    }
+    if (auto* idx = dynamic_cast<const IndexExpr*>(&e))
+    {
+        compile_index(*idx, dst, inside_matrix);
+        return;
+    }
+    if (auto* s = dynamic_cast<const SweepExpr*>(&e))
+    {
+        compile_items(e, s->items, OpCode::kSweep, dst, inside_matrix);
+        return;
+    }
+    if (auto* m = dynamic_cast<const MatrixExpr*>(&e))
+    {
+        compile_items(e, m->items, OpCode::kMatrix, dst, inside_matrix);
+        return;
+    }
+
+    emit_eval(e, dst, inside_matrix);
+}
+
+// ---- fused chains: same shape as Evaluator::build_fused -----------------
+
+void Compiler::compile_fused(const Expr& e, std::int32_t dst, bool inside_matrix)
+{
+    FusedChain chain;
+    std::int32_t next_reg = dst;
+    build_fused(e, chain, next_reg, inside_matrix);
+    program_.fused_.push_back(std::move(chain));
+    emit(OpCode::kFused, dst, static_cast<std::int32_t>(program_.fused_.size()) - 1);
+}
+
+std::int32_t Compiler::build_fused(const Expr& e,
+                                   FusedChain& chain,
+                                   std::int32_t& next_reg,
+                                   bool inside_matrix)
+{
+    const Expr& s = StripGrouping(e);
+    FusedChain::Node node;
+    node.op  = FusedOpOf(s);
+    node.lhs = -1;
+    node.rhs = -1;
+    node.reg = -1;
+
+    if (node.op == FusedExpr::Op::kLeaf)
+    {
+        node.reg = next_reg++;
+        compile(s, node.reg, inside_matrix);
+    }
+    else if (node.op == FusedExpr::Op::kNegate)
+    {
+        node.lhs =
+            build_fused(*static_cast<const UnaryExpr&>(s).operand, chain, next_reg, inside_matrix);
+    }
+    else
+    {
+        const BinaryExpr& b = static_cast<const BinaryExpr&>(s);
+        node.lhs = build_fused(*b.left, chain, next_reg, inside_matrix);
+        node.rhs = build_fused(*b.right, chain, next_reg, inside_matrix);
+    }
+    chain.nodes.push_back(node);
+    return static_cast<std::int32_t>(chain.nodes.size()) - 1;
+}
+
+// ---- lazy operators -----------------------------------------------------
+
+void Compiler::compile_logical(const LogicalExpr& e, std::int32_t dst, bool inside_matrix)
+{
+    const std::int32_t is_and = (e.op == TokenType::OP_LAND || e.op == TokenType::KW_AND) ? 1 : 0;
+    compile(*e.left, dst, inside_matrix);
+    std::int32_t skip = emit(OpCode::kShortCircuit, dst, dst, is_and);
+    compile(*e.right, dst + 1, inside_matrix);
+    emit(OpCode::kLogical, dst, dst, dst + 1, is_and);
+    at(skip).d = here();
+}
+
+void Compiler::compile_conditional(const ConditionalExpr& e, std::int32_t dst, bool inside_matrix)
+{
+    compile(*e.condition, dst, inside_matrix);
+    std::int32_t branch = emit(OpCode::kBranch, 0, dst);
+    compile(*e.then_branch, dst, inside_matrix);
+    std::int32_t then_done = emit(OpCode::kJump);
+    at(branch).c = here();
+    compile(*e.else_branch, dst, inside_matrix);
+    std::int32_t else_done = emit(OpCode::kJump);
+    at(branch).d = here();
+    emit(OpCode::kElementwiseConditional, dst, dst, add_node(e, inside_matrix));
+    at(then_done).a = here();
+    at(else_done).a = here();
+}
+
+void Compiler::compile_if(const IfExpr& e, std::int32_t dst, bool inside_matrix)
+{
+    if (!e.else_value)
+    {
+        emit_eval(e, dst, inside_matrix);
+        return;
+    }
+
+    std::vector<std::int32_t> branches;
+    std::vector<std::int32_t> to_end;
+    for (const IfBranch& br : e.branches)
+    {
+        compile(*br.condition, dst, inside_matrix);
+        branches.push_back(emit(OpCode::kBranch, 0, dst));
+        compile(*br.value, dst, inside_matrix);
+        to_end.push_back(emit(OpCode::kJump));
+        at(branches.back()).c = here();
+    }
+    compile(*e.else_value, dst, inside_matrix);
+    to_end.push_back(emit(OpCode::kJump));
+
+    // From the first array condition on, the evaluator's element-wise path
+    // takes over with the condition already in r[dst].
+    const std::int32_t node = add_node(e, inside_matrix);
+    for (std::size_t i = 0; i < branches.size(); ++i)
+    {
+        at(branches[i]).d = here();
+        emit(OpCode::kElementwiseIf, dst, dst, node, static_cast<std::int32_t>(i));
+        to_end.push_back(emit(OpCode::kJump));
+    }
+    for (std::int32_t pc : to_end)
+        at(pc).a = here();
+}
+
+// ---- calls, indexing, generators ----------------------------------------
+
+void Compiler::compile_call(const CallExpr& e, std::int32_t dst, bool inside_matrix)
+{
+    auto* ref = dynamic_cast<const ReferenceExpr*>(e.callee.get());
+    if (!ref || ref->segments.size() != 1)
+    {
+        emit_eval(e, dst, inside_matrix);
+        return;
+    }
+
+    CallSite site;
+    site.name    = ref->segments[0].name;
+    site.slot    = Environment::FunctionSlot(site.name);
+    site.node    = add_node(e, inside_matrix);
+    site.skipped = HasSkippedSlot(e);
+    program_.calls_.push_back(site);
+    const std::int32_t index = static_cast<std::int32_t>(program_.calls_.size()) - 1;
+
+    std::int32_t resolve = emit(OpCode::kCall, dst, index);
+    std::vector<std::int32_t> args;
+    for (std::size_t i = 0; i < e.args.size(); ++i)
+    {
+        if (!e.args[i])
+        {
+            args.push_back(-1);
+            continue;
+        }
+        const std::int32_t reg = dst + 1 + static_cast<std::int32_t>(i);
+        compile(*e.args[i], reg, inside_matrix);
+        args.push_back(reg);
+    }
+    program_.calls_[static_cast<std::size_t>(index)].args = std::move(args);
+    emit(OpCode::kInvoke, dst, index);
+    at(resolve).c = here();
+}
+
+void Compiler::compile_index(const IndexExpr& e, std::int32_t dst, bool inside_matrix)
+{
+    for (const ExprPtr& idx : e.indices)
+    {
+        if (is_range(idx))
+        {
+            emit_eval(e, dst, inside_matrix);
+            return;
+        }
+    }
+
+    compile(*e.object, dst, inside_matrix);
+    emit(OpCode::kExpectArray, dst);
+    for (std::size_t i = 0; i < e.indices.size(); ++i)
+        compile(*e.indices[i], dst + 1 + static_cast<std::int32_t>(i), inside_matrix);
+    emit(OpCode::kIndex,
+         dst,
+         dst,
+         dst + 1,
+         static_cast<std::int32_t>(e.indices.size()));
+}
+
+void Compiler::compile_items(const Expr& e,
+                             const std::vector<ExprPtr>& items,
+                             OpCode op,
+                             std::int32_t dst,
+                             bool inside_matrix)
+{
+    for (const ExprPtr& item : items)
+    {
+        if (is_range(item))
+        {
+            emit_eval(e, dst, inside_matrix);
+            return;
+        }
+    }
+
+    // Items of a matrix literal are evaluated "inside" it; a sweep keeps
+    // the surrounding state, exactly as in the evaluator.
+    const bool inner = (op == OpCode::kMatrix) || inside_matrix;
+    for (std::size_t i = 0; i < items.size(); ++i)
+        compile(*items[i], dst + static_cast<std::int32_t>(i), inner);
+    use_register(dst + static_cast<std::int32_t>(items.size()));
+    emit(op, dst, dst, static_cast<std::int32_t>(items.size()), inside_matrix ? 0 : 1);
+}
+
+// =========================================================================
+//  Vm -- register machine
+// =========================================================================
+
+Vm::Vm(const Program& program, Environment& env)
+    : program_(program)
+    , env_(env)
+    , regs_(static_cast<std::size_t>(program.registers_))
+    , functions_(program.calls_.size())
+{}
+
+rel::Value Vm::eval_node(std::int32_t node)
+{
+    const NodeRef& ref = program_.nodes_[static_cast<std::size_t>(node)];
+    Evaluator evaluator(env_);
+    evaluator.inside_matrix_ = ref.inside_matrix;
+    return evaluator.Evaluate(*ref.expr);
+}
+
+rel::Value Vm::run_fused(const FusedChain& chain)
+{
+    bool has_array = false;
+    for (const FusedChain::Node& n : chain.nodes)
+    {
+        if (n.op == FusedExpr::Op::kLeaf && regs_[static_cast<std::size_t>(n.reg)].is_data_array())
+        {
+            has_array = true;
+            break;
+        }
+    }
+
+    if (!has_array)
+    {
+        // What OperateFused does without a DataArray operand, minus building
+        // the tree: the ordinary operators in post-order.
+        std::vector<rel::Value> values(chain.nodes.size());
+        for (std::size_t i = 0; i < chain.nodes.size(); ++i)
+        {
+            const FusedChain::Node& n = chain.nodes[i];
+            const rel::Value* l = n.lhs >= 0 ? &values[static_cast<std::size_t>(n.lhs)] : nullptr;
+            const rel::Value* r = n.rhs >= 0 ? &values[static_cast<std::size_t>(n.rhs)] : nullptr;
+            switch (n.op)
+            {
+                case FusedExpr::Op::kLeaf:
+                    values[i] = std::move(regs_[static_cast<std::size_t>(n.reg)]);
+                    break;
+                case FusedExpr::Op::kAdd: values[i] = operation::OperationAdd(*l, *r); break;
+                case FusedExpr::Op::kSub: values[i] = operation::OperationSub(*l, *r); break;
+                case FusedExpr::Op::kMul: values[i] = operation::OperationMul(*l, *r); break;
+                case FusedExpr::Op::kDiv: values[i] = operation::OperationDiv(*l, *r); break;
+                case FusedExpr::Op::kNegate: values[i] = operation::OperationNegate(*l); break;
+            }
+        }
+        return std::move(values.back());
+    }
+
+    std::vector<std::unique_ptr<FusedExpr>> built(chain.nodes.size());
+    for (std::size_t i = 0; i < chain.nodes.size(); ++i)
+    {
+        const FusedChain::Node& n = chain.nodes[i];
+        if (n.op == FusedExpr::Op::kLeaf)
+            built[i] = FusedExpr::Leaf(std::move(regs_[static_cast<std::size_t>(n.reg)]));
+        else if (n.op == FusedExpr::Op::kNegate)
+            built[i] = FusedExpr::Unary(n.op, std::move(built[static_cast<std::size_t>(n.lhs)]));
+        else
+            built[i] = FusedExpr::Binary(n.op,
+                                         std::move(built[static_cast<std::size_t>(n.lhs)]),
+                                         std::move(built[static_cast<std::size_t>(n.rhs)]));
+    }
+    return operation::OperateFused(*built.back());
+}
+
+rel::Value Vm::Run()
+{
+    const std::vector<Instruction>& code = program_.code_;
+    auto reg = [this](std::int32_t r) -> rel::Value& {
+        return regs_[static_cast<std::size_t>(r)];
+    };
+
+    std::size_t pc = 0;
+    while (pc < code.size())
+    {
+        const Instruction& in = code[pc++];
+        switch (in.op)
+        {
+            case OpCode::kLoadConst:
+                reg(in.a) = program_.consts_[static_cast<std::size_t>(in.b)];
+                break;
+
+            case OpCode::kLoadVar:
+            {
+                const std::size_t v = static_cast<std::size_t>(in.b);
+                if (!env_.CopyVariableOrConstant(program_.slots_[v], program_.names_[v], reg(in.a)))
+                    reg(in.a) = eval_node(in.c);  // dataset lookup / error message
+                break;
+            }
+
+            case OpCode::kEval:
+                reg(in.a) = eval_node(in.b);
+                break;
+
+            case OpCode::kUnary:
+                reg(in.a) = Evaluator::apply_unary(static_cast<TokenType>(in.c), reg(in.b));
+                break;
+
+            case OpCode::kBinary:
+                reg(in.a) =
+                    Evaluator::apply_binary(static_cast<TokenType>(in.d), reg(in.b), reg(in.c));
+                break;
+
+            case OpCode::kFused:
+                reg(in.a) = run_fused(program_.fused_[static_cast<std::size_t>(in.b)]);
+                break;
+
+            case OpCode::kShortCircuit:
+            {
+                bool truth = false;
+                if (ScalarTruth(reg(in.b), truth) && truth != (in.c != 0))
+                {
+                    reg(in.a) = rel::Value::Boolean(truth);
+                    pc = static_cast<std::size_t>(in.d);
+                }
+                break;
+            }
+
+            case OpCode::kLogical:
+                reg(in.a) = in.d ? (reg(in.b) && reg(in.c)) : (reg(in.b) || reg(in.c));
+                break;
+
+            case OpCode::kBranch:
+            {
+                bool truth = false;
+                if (!ScalarTruth(reg(in.b), truth))
+                    pc = static_cast<std::size_t>(in.d);
+                else if (!truth)
+                    pc = static_cast<std::size_t>(in.c);
+                break;
+            }
+
+            case OpCode::kJump:
+                pc = static_cast<std::size_t>(in.a);
+                break;
+
+            case OpCode::kElementwiseConditional:
+            {
+                const NodeRef& ref = program_.nodes_[static_cast<std::size_t>(in.c)];
+                Evaluator evaluator(env_);
+                evaluator.inside_matrix_ = ref.inside_matrix;
+                rel::Value cond = std::move(reg(in.b));
+                reg(in.a) = evaluator.eval_conditional_elementwise(
+                    static_cast<const ConditionalExpr&>(*ref.expr), cond);
+                break;
+            }
+
+            case OpCode::kElementwiseIf:
+            {
+                const NodeRef& ref = program_.nodes_[static_cast<std::size_t>(in.c)];
+                Evaluator evaluator(env_);
+                evaluator.inside_matrix_ = ref.inside_matrix;
+                rel::Value cond = std::move(reg(in.b));
+                reg(in.a) = evaluator.eval_if_elementwise(static_cast<const IfExpr&>(*ref.expr),
+                                                     static_cast<std::size_t>(in.d),
+                                                     std::move(cond));
+                break;
+            }
+
+            case OpCode::kCall:
+            {
+                const CallSite& site = program_.calls_[static_cast<std::size_t>(in.b)];
+                std::shared_ptr<const Function>& fn = functions_[static_cast<std::size_t>(in.b)];
+                fn = Environment::ResolveFunction(site.slot);
+                if (!fn)
+                {
+                    // Not a function (any more): matrix indexing a(i, j) or
+                    // the evaluator's error.
+                    reg(in.a) = eval_node(site.node);
+                    pc = static_cast<std::size_t>(in.c);
+                    break;
+                }
+                if (site.args.size() > fn->arity())
+                {
+                    std::ostringstream oss;
+                    oss << "function '" << fn->name() << "' expects at most " << fn->arity()
+                        << " argument(s), got " << site.args.size();
+                    throw std::runtime_error(oss.str());
+                }
+                break;
+            }
+
+            case OpCode::kInvoke:
+            {
+                const CallSite& site = program_.calls_[static_cast<std::size_t>(in.b)];
+                const Function& fn = *functions_[static_cast<std::size_t>(in.b)];
+                if (!site.skipped)
+                {
+                    const rel::Value* first = site.args.empty() ? nullptr : &reg(site.args[0]);
+                    reg(in.a) = fn.Invoke(first, site.args.size());
+                    break;
+                }
+                Function::ArgMap args;
+                for (std::size_t i = 0; i < site.args.size(); ++i)
+                {
+                    if (site.args[i] >= 0)
+                        args[fn.params()[i].name] = std::move(reg(site.args[i]));
+                }
+                reg(in.a) = fn.Invoke(args);
+                break;
+            }
+
+            case OpCode::kExpectArray:
+                if (!reg(in.a).is_data_array())
+                    throw std::runtime_error("[] indexing requires a DataArray");
+                break;
+
+            case OpCode::kIndex:
+            {
+                std::vector<xdataset::MultiIndexSelector> selectors;
+                selectors.reserve(static_cast<std::size_t>(in.d));
+                for (std::int32_t i = 0; i < in.d; ++i)
+                    selectors.push_back(IndexSelector(reg(in.c + i), /*one_based=*/false));
+                reg(in.a) = SelectSweep(reg(in.b), selectors);
+                break;
+            }
+
+            case OpCode::kSweep:
+            case OpCode::kMatrix:
+            {
+                std::vector<rel::Value> items;
+                items.reserve(static_cast<std::size_t>(in.c));
+                for (std::int32_t i = 0; i < in.c; ++i)
+                    items.push_back(std::move(reg(in.b + i)));
+
+                if (items.empty())
+                    reg(in.a) = rel::Value();
+                else if (in.op == OpCode::kSweep)
+                    reg(in.a) = operation::OperationSweep(items);
+                else if (items.size() == 1 && in.d)
+                    reg(in.a) = std::move(items[0]);
+                else
+                    reg(in.a) = operation::OperationMatrix(items);
+                break;
+            }
+        }
+    }
+    return std::move(reg(program_.result_));
+}
+
+// =========================================================================
+//  Public entry point
+// =========================================================================
+
+std::shared_ptr<const Program> Compile(ExprPtr expr)
+{
+    std::shared_ptr<Program> program = std::make_shared<Program>(std::move(expr));
+    Compiler(*program).Run();
+    return program;
+}
+
+} // namespace rel
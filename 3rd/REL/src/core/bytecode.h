@@ -0,0 +1,150 @@
+// =============================================================================
+//  REL -- Bytecode program and register VM (private header)
+// =============================================================================
+//
+//  rel::Compile() lowers a syntax tree into a flat instruction list over a
+//  register file; rel::Eval(const Program&, Environment&) runs it.  The
+//  result -- including every error message -- is the one the tree-walking
+//  Evaluator produces for the same tree:
+//
+//    - literals and ConstantExpr become LOAD_CONST;
+//    - single identifiers become LOAD_VAR of their Environment::VariableSlot,
+//      so a run indexes the Environment's slot cache instead of hashing;
+//    - + - * / chains the evaluator would fuse become one FUSED instruction;
+//    - calls by name become CALL / INVOKE: the registry slot is looked up
+//      at compile time, the function in it is resolved on every run;
+//    - ?:, if, &&, || keep their lazy scalar behaviour through jumps;
+//    - [..] indexing and generators without ranges become INDEX / SWEEP /
+//      MATRIX.
+//
+//  Anything else (dataset paths, matrix indexing a(i), ranges, element-wise
+//  ?: and if on array conditions) is handed back to the Evaluator sub-tree by
+//  sub-tree through EVAL, so the two back ends cannot diverge there.
+
+#ifndef REL_BYTECODE_H
+#define REL_BYTECODE_H
+
+#include "environment.h"
+#include "expr.h"
+#include "operation/fused_operation.h"
+#include "value.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rel {
+
+enum class OpCode : std::uint8_t {
+    kLoadConst,        // r[a] = consts[b]
+    kLoadVar,          // r[a] = variable / builtin constant slots[b]; else EVAL nodes[c]
+    kEval,             // r[a] = Evaluator(nodes[b])
+    kUnary,            // r[a] = op(c) r[b]
+    kBinary,           // r[a] = r[b] op(d) r[c]
+    kFused,            // r[a] = fused[b] over its leaf registers
+    kShortCircuit,     // scalar r[b] decides &&(c=1) / ||(c=0): r[a] = bool, pc = d
+    kLogical,          // r[a] = r[b] && r[c] (d=1) or r[b] || r[c] (d=0)
+    kBranch,           // scalar r[b]: true -> next, false -> pc = c; array -> pc = d
+    kJump,             // pc = a
+    kElementwiseConditional, // r[a] = element-wise ?: nodes[c], array condition r[b]
+    kElementwiseIf,    // r[a] = element-wise if nodes[c] from branch d, condition r[b]
+    kCall,             // resolve calls[b].slot; not registered -> r[a] = EVAL node, pc = c
+    kInvoke,           // r[a] = invoke calls[b]
+    kExpectArray,      // throw unless r[a] is a DataArray ([] indexing)
+    kIndex,            // r[a] = r[b][r[c] .. r[c+d-1]]
+    kSweep,            // r[a] = [r[b] .. r[b+c-1]]
+    kMatrix,           // r[a] = {r[b] .. r[b+c-1]}, single item unwrapped when d
+};
+
+struct Instruction {
+    OpCode       op;
+    std::int32_t a;
+    std::int32_t b;
+    std::int32_t c;
+    std::int32_t d;
+};
+
+/// One fused chain: nodes in post-order, the root last.  Leaves name the
+/// register holding the already-evaluated operand.
+struct FusedChain {
+    struct Node {
+        operation::FusedExpr::Op op;
+        std::int32_t lhs;   // node index (also the operand of kNegate)
+        std::int32_t rhs;   // node index
+        std::int32_t reg;   // kLeaf only
+    };
+    std::vector<Node> nodes;
+};
+
+/// A sub-tree evaluated by the Evaluator.  `inside_matrix` carries the
+/// evaluator's nested-brace state ({{1},{2}} keeps inner braces as vectors).
+struct NodeRef {
+    const Expr* expr;
+    bool        inside_matrix;
+};
+
+/// One call site whose callee is a single identifier, bound at compile
+/// time to its registry slot.  A negative register marks a slot skipped at
+/// the call site (`f(1,,3)`), which takes the declared default; without
+/// one the arguments sit in consecutive registers and are passed
+/// positionally.
+struct CallSite {
+    std::string               name;
+    std::size_t               slot;   // Environment::FunctionSlot(name)
+    std::int32_t              node;   // nodes_ index of the CallExpr
+    std::vector<std::int32_t> args;
+    bool                      skipped;
+};
+
+class Program
+{
+public:
+    explicit Program(ExprPtr root);
+
+    const Expr& root() const { return *root_; }
+
+private:
+    friend class Compiler;
+    friend class Vm;
+
+    ExprPtr                   root_;   // owns every node referenced below
+    std::vector<Instruction>  code_;
+    std::vector<rel::Value>   consts_;
+    std::vector<std::string>  names_;
+    std::vector<std::size_t>  slots_;  // Environment::VariableSlot(names_[i])
+    std::vector<NodeRef>      nodes_;
+    std::vector<FusedChain>   fused_;
+    std::vector<CallSite>     calls_;
+    std::int32_t              registers_ = 0;
+    std::int32_t              result_ = 0;
+};
+
+/// Executes a Program against an Environment.  One Vm per evaluation.
+class Vm
+{
+public:
+    Vm(const Program& program, Environment& env);
+
+    rel::Value Run();
+
+private:
+    rel::Value eval_node(std::int32_t node);
+    rel::Value run_fused(const FusedChain& chain);
+
+    const Program&          program_;
+    Environment&            env_;
+    std::vector<rel::Value> regs_;
+    std::vector<std::shared_ptr<const Function>> functions_;  // per call site, set by kCall
+};
+
+/// Back end used by Eval(const std::string&, Environment*): the
+/// tree-walking evaluator (default) or Compile() + the bytecode VM.  A
+/// process-wide switch for the test suites (rel_vm_test), not public API.
+enum class EvalBackend { kTreeWalker, kBytecode };
+REL_API void SetEvalBackend(EvalBackend backend);
+REL_API EvalBackend GetEvalBackend();
+
+}  // namespace rel
+
+#endif  // REL_BYTECODE_H
@@ -1,11 +1,17 @@
 #include "evaluator.h"
 
+#include "evaluator_helpers.h"
+#include "data_array_view.h"
 #include "multi_index_selector.h"
+#include "operation/fused_operation.h"
 #include "operation/operator.h"
 #include "unit.h"
 
+#include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -146,18 +152,124 @@ rel::Value Evaluator::apply_binary(TokenType op, const rel::Value& lhs, const re
 }
 
 // =========================================================================
-//  apply_logical -- delegate to rel::Value operators
+//  Condition helpers -- lazy evaluation of &&, ||, ?: and if
+// =========================================================================
+
+bool ScalarTruth(const rel::Value& v, bool& truth)
+{
+    if (!v.is_measurement() || !v.is_scalar())
+        return false;
+
+    const xdataset::Measurement& m = v.as_measurement();
+    switch (m.data_type())
+    {
+        case xdataset::DataType::kBoolean:
+            truth = m.as_scalar<bool>();
+            return true;
+        case xdataset::DataType::kInteger:
+            truth = m.as_scalar<int>() != 0;
+            return true;
+        case xdataset::DataType::kReal:
+            truth = m.as_scalar<double>() != 0.0;
+            return true;
+        case xdataset::DataType::kComplex:
+            truth = m.as_scalar<std::complex<double>>() != std::complex<double>(0.0, 0.0);
+            return true;
+        case xdataset::DataType::kString:
+            truth = !m.as_scalar<std::string>().empty();
+            return true;
+        default:
+            return false;
+    }
+}
+
+// =========================================================================
+//  apply_logical -- short-circuit on scalars, else rel::Value operators
 // =========================================================================
 
 rel::Value Evaluator::apply_logical(TokenType op, const LogicalExpr& expr)
 {
+    bool is_and = (op == TokenType::OP_LAND || op == TokenType::KW_AND);
     rel::Value lhs = Evaluate(*expr.left);
+
+    // A scalar left operand that already decides the outcome skips the right
+    // operand entirely (0 && x, 1 || x).  Array operands stay element-wise.
+    bool truth = false;
+    if (ScalarTruth(lhs, truth) && truth != is_and)
+        return rel::Value::Boolean(truth);
+
     rel::Value rhs = Evaluate(*expr.right);
+    return is_and ? (lhs && rhs) : (lhs || rhs);
+}
 
-    if (op == TokenType::OP_LAND || op == TokenType::KW_AND)
-        return lhs && rhs;
-    else
-        return lhs || rhs;
+// =========================================================================
+//  Fused element-wise chains
+// =========================================================================
+
+using rel::operation::FusedExpr;
+
+const Expr& StripGrouping(const Expr& expr)
+{
+    const Expr* e = &expr;
+    while (auto* g = dynamic_cast<const GroupingExpr*>(e))
+        e = g->inner.get();
+    return *e;
+}
+
+FusedExpr::Op FusedOpOf(const Expr& expr)
+{
+    if (auto* b = dynamic_cast<const BinaryExpr*>(&expr))
+    {
+        switch (b->op)
+        {
+            case TokenType::OP_ADD: return FusedExpr::Op::kAdd;
+            case TokenType::OP_SUB: return FusedExpr::Op::kSub;
+            case TokenType::OP_MUL: return FusedExpr::Op::kMul;
+            case TokenType::OP_DIV: return FusedExpr::Op::kDiv;
+            default: return FusedExpr::Op::kLeaf;
+        }
+    }
+    if (auto* u = dynamic_cast<const UnaryExpr*>(&expr))
+    {
+        if (u->op == TokenType::OP_SUB)
+            return FusedExpr::Op::kNegate;
+    }
+    return FusedExpr::Op::kLeaf;
+}
+
+int CountFusedOps(const Expr& expr, int limit)
+{
+    const Expr& e = StripGrouping(expr);
+    FusedExpr::Op op = FusedOpOf(e);
+    if (op == FusedExpr::Op::kLeaf)
+        return 0;
+    int count = 1;
+    if (op == FusedExpr::Op::kNegate)
+    {
+        count += CountFusedOps(*static_cast<const UnaryExpr&>(e).operand, limit - count);
+        return count;
+    }
+    const BinaryExpr& b = static_cast<const BinaryExpr&>(e);
+    if (count < limit)
+        count += CountFusedOps(*b.left, limit - count);
+    if (count < limit)
+        count += CountFusedOps(*b.right, limit - count);
+    return count;
+}
+
+std::unique_ptr<FusedExpr> Evaluator::build_fused(const Expr& expr)
+{
+    const Expr& e = StripGrouping(expr);
+    FusedExpr::Op op = FusedOpOf(e);
+    if (op == FusedExpr::Op::kLeaf)
+        return FusedExpr::Leaf(Evaluate(e));
+    if (op == FusedExpr::Op::kNegate)
+        return FusedExpr::Unary(op, build_fused(*static_cast<const UnaryExpr&>(e).operand));
+
+    const BinaryExpr& b = static_cast<const BinaryExpr&>(e);
+    std::unique_ptr<FusedExpr> lhs = build_fused(*b.left);
+    std::unique_ptr<FusedExpr> rhs = build_fused(*b.right);
+    return FusedExpr::Binary(op, std::move(lhs), std::move(rhs));
 }
 
 // =========================================================================
@@ -166,6 +278,12 @@ rel::Value Evaluator::apply_logical(TokenType op, const LogicalExpr& expr)
 
 void Evaluator::visit_unary(const UnaryExpr& expr)
 {
+    if (CountFusedOps(expr, 2) >= 2)
+    {
+        result_ = rel::operation::OperateFused(*build_fused(expr));
+        return;
+    }
+
     rel::Value operand = Evaluate(*expr.operand);
     result_ = apply_unary(expr.op, operand);
 }
@@ -176,6 +294,14 @@ void Evaluator::visit_unary(const UnaryExpr& expr)
 
 void Evaluator::visit_binary(const BinaryExpr& expr)
 {
+    // A chain of element-wise operators is evaluated in one fused pass so no
+    // intermediate DataSeries is materialised per operator.
+    if (CountFusedOps(expr, 2) >= 2)
+    {
+        result_ = rel::operation::OperateFused(*build_fused(expr));
+        return;
+    }
+
     rel::Value lhs = Evaluate(*expr.left);
     rel::Value rhs = Evaluate(*expr.right);
     result_ = apply_binary(expr.op, lhs, rhs);
@@ -207,7 +333,7 @@ void Evaluator::visit_reference(const ReferenceExpr& expr)
 {
     try
     {
-        result_ = ResolveReference(expr.segments);
+        result_ = ResolveReference(expr);
     }
     catch (const std::exception& e)
     {
@@ -217,13 +343,52 @@ void Evaluator::visit_reference(const ReferenceExpr& expr)
     }
 }
 
+// =========================================================================
+//  ResolvedReference -- per-node cache of the Dataset part of a lookup
+// =========================================================================
+//
+//  Valid while the same Dataset is at the same revision().  Variables and
+//  constants are still looked up first on every evaluation, so defining one
+//  keeps shadowing a cached DataArray.
+
+struct ResolvedReference
+{
+    const xdataset::Dataset* dataset;
+    std::uint64_t revision;
+    std::string block_path;
+    std::string data_array_name;
+};
+
+static bool load_cached_reference(const ReferenceExpr& expr,
+                                  xdataset::Dataset& ds,
+                                  rel::Value& out)
+{
+    std::shared_ptr<const ResolvedReference> entry = std::atomic_load(&expr.resolved);
+    if (!entry || entry->dataset != &ds || entry->revision != ds.revision())
+        return false;
+    out = rel::Value(ds.GetDataArray(entry->block_path, entry->data_array_name));
+    return true;
+}
+
+static rel::Value load_and_cache_reference(const ReferenceExpr& expr,
+                                           xdataset::Dataset& ds,
+                                           std::string block_path,
+                                           std::string data_array_name)
+{
+    rel::Value value(ds.GetDataArray(block_path, data_array_name));
+    std::shared_ptr<const ResolvedReference> entry(new ResolvedReference{
+        &ds, ds.revision(), std::move(block_path), std::move(data_array_name)});
+    std::atomic_store(&expr.resolved, entry);
+    return value;
+}
+
 // =========================================================================
 //  ResolveReference -- AST-aware reference resolution (formerly in Environment)
 // =========================================================================
 
-rel::Value Evaluator::ResolveReference(
-    const std::vector<RefSegment>& segments) const
+rel::Value Evaluator::ResolveReference(const ReferenceExpr& expr) const
 {
+    const std::vector<RefSegment>& segments = expr.segments;
     if (segments.empty())
         return rel::Value();
 
@@ -248,12 +413,13 @@ rel::Value Evaluator::ResolveReference(
     {
         const std::string& name = segments[0].name;
 
-        const rel::Value* c = env_.LookupVariableOrConstant(name);
-        if (c) return *c;
+        rel::Value c;
+        if (env_.CopyVariableOrConstant(name, c)) return c;
 
         xdataset::Dataset* ds = Environment::DefaultDataset();
+        if (ds && load_cached_reference(expr, *ds, c)) return c;
         if (ds && ds->HasUniqueDataArray(name))
-            return rel::Value(ds->GetDataArray(name));
+            return load_and_cache_reference(expr, *ds, ds->FindUniqueDataArray(name), name);
 
         throw std::runtime_error("undefined identifier '" + name + "'");
     }
@@ -267,7 +433,11 @@ rel::Value Evaluator::ResolveReference(
         if (!ds)
             throw std::runtime_error("unknown Dataset '" + segments[0].name + "'");
 
-        return rel::Value(ds->GetDataArray(join(segments, 1, segments.size(), ".")));
+        rel::Value cached;
+        if (load_cached_reference(expr, *ds, cached)) return cached;
+
+        std::string name = join(segments, 1, segments.size(), ".");
+        return load_and_cache_reference(expr, *ds, ds->FindUniqueDataArray(name), name);
     }
 
     // =================================================================
@@ -299,6 +469,9 @@ rel::Value Evaluator::ResolveReference(
             "reference needs at least block.variable after path");
     }
 
+    rel::Value cached;
+    if (load_cached_reference(expr, *ds, cached)) return cached;
+
     // ---- strategy A: split at k -> block=segs[start..k-1], var=segs[k..] ---
     // k = n-1: single-segment var (SP.Vout)        -- original behaviour
     // k = n-2: two-segment  var (SP.SRC1.i)        -- fallback for dotted dependents
@@ -311,7 +484,7 @@ rel::Value Evaluator::ResolveReference(
         std::string var_name = join(segments, k, n, ".");
         try
         {
-            return rel::Value(ds->GetDataArray(block_path, var_name));
+            return load_and_cache_reference(expr, *ds, block_path, var_name);
         }
         catch (const std::invalid_argument&) { /* try next split */ }
     }
@@ -322,7 +495,7 @@ rel::Value Evaluator::ResolveReference(
     {
         std::string joined = join(segments, start, n, ".");
         if (ds->HasUniqueDataArray(joined))
-            return rel::Value(ds->GetDataArray(joined));
+            return load_and_cache_reference(expr, *ds, ds->FindUniqueDataArray(joined), joined);
     }
 
     throw std::runtime_error(
@@ -335,10 +508,27 @@ rel::Value Evaluator::ResolveReference(
 
 void Evaluator::visit_conditional(const ConditionalExpr& expr)
 {
-    rel::Value cond   = Evaluate(*expr.condition);
+    rel::Value cond = Evaluate(*expr.condition);
+
+    // Scalar condition: evaluate only the selected branch.
+    bool truth = false;
+    if (ScalarTruth(cond, truth))
+    {
+        result_ = Evaluate(truth ? *expr.then_branch : *expr.else_branch);
+        return;
+    }
+
+    result_ = eval_conditional_elementwise(expr, cond);
+}
+
+rel::Value Evaluator::eval_conditional_elementwise(const ConditionalExpr& expr, const rel::Value& cond)
+{
+    // Array condition: both branches take part in the element-wise selection
+    // even where the mask never picks one, so the result dtype, unit and the
+    // branch width check do not depend on the condition's values.
     rel::Value then_v = Evaluate(*expr.then_branch);
     rel::Value else_v = Evaluate(*expr.else_branch);
-    result_ = rel::operation::OperationConditional(cond, then_v, else_v);
+    return rel::operation::OperationConditional(cond, then_v, else_v);
 }
 
 // =========================================================================
@@ -347,17 +537,53 @@ void Evaluator::visit_conditional(const ConditionalExpr& expr)
 
 void Evaluator::visit_if(const IfExpr& expr)
 {
+    // Leading scalar conditions are decided one at a time: the first true one
+    // evaluates only its own value, false ones are dropped unevaluated.
+    std::size_t first_array = 0;
+    rel::Value cond;
+    for (; first_array < expr.branches.size(); ++first_array)
+    {
+        const IfBranch& br = expr.branches[first_array];
+        cond = Evaluate(*br.condition);
+        bool truth = false;
+        if (!ScalarTruth(cond, truth))
+            break;
+        if (truth)
+        {
+            result_ = Evaluate(*br.value);
+            return;
+        }
+    }
+    if (first_array == expr.branches.size())
+    {
+        result_ = Evaluate(*expr.else_value);
+        return;
+    }
+
+    result_ = eval_if_elementwise(expr, first_array, std::move(cond));
+}
+
+rel::Value Evaluator::eval_if_elementwise(const IfExpr& expr, std::size_t first_array, rel::Value cond)
+{
+    // Once a condition is an array, every branch feeds OperationIf, which
+    // derives the result dtype and unit from all values. The caller already
+    // evaluated the conditions up to `first_array`: the earlier ones were
+    // scalar false and are passed as such rather than evaluated again.
     std::vector<rel::Value> operands;
     operands.reserve(expr.branches.size() * 2 + 1);
 
-    for (const auto& br : expr.branches)
+    for (std::size_t i = 0; i < expr.branches.size(); ++i)
     {
-        operands.push_back(Evaluate(*br.condition));
+        const IfBranch& br = expr.branches[i];
+        if (i < first_array)
+            operands.push_back(rel::Value::Boolean(false));
+        else
+            operands.push_back(i == first_array ? std::move(cond) : Evaluate(*br.condition));
         operands.push_back(Evaluate(*br.value));
     }
     operands.push_back(Evaluate(*expr.else_value));
 
-    result_ = rel::operation::OperationIf(operands);
+    return rel::operation::OperationIf(operands);
 }
 
 // =========================================================================
@@ -373,9 +599,8 @@ void Evaluator::visit_if(const IfExpr& expr)
 
 // ---- shared: evaluate a sub-expression into a scalar double ----
 
-static double eval_scalar_num(rel::Evaluator& eval, const rel::Expr& arg)
+static double scalar_num(const rel::Value& v)
 {
-    rel::Value v = eval.Evaluate(arg);
     if (!v.is_measurement() || !v.is_scalar())
         throw std::runtime_error("range/index operand must be a scalar number");
     const auto& m = v.as_measurement();
@@ -386,6 +611,11 @@ static double eval_scalar_num(rel::Evaluator& eval, const rel::Expr& arg)
     throw std::runtime_error("range/index operand must be numeric");
 }
 
+static double eval_scalar_num(rel::Evaluator& eval, const rel::Expr& arg)
+{
+    return scalar_num(eval.Evaluate(arg));
+}
+
 // ---- index selectors: AST -> MultiIndexSelector (used by visit_call / visit_index) ----
 //    matrix index a(i, j): 1-based -> 0-based
 //    sweep  index a[i, j]: 0-based (no conversion)
@@ -412,6 +642,21 @@ make_selector(rel::Evaluator& eval, const rel::ExprPtr& arg, bool one_based)
         if (start < 0)
             throw std::runtime_error("index out of range (negative)");
 
+        // Integral start and step: keep the range as bounds instead of an
+        // index list.  In() sorts, so a descending range selects the same
+        // ascending set.
+        if (start == std::floor(start) && step == std::floor(step))
+        {
+            const double stride = std::fabs(step);
+            const double span = step > 0 ? stop - start : start - stop;
+            const xdataset::Index count = static_cast<xdataset::Index>((span + 1e-12) / stride) + 1;
+            const xdataset::Index first = static_cast<xdataset::Index>(start);
+            const xdataset::Index delta = static_cast<xdataset::Index>(stride);
+            const xdataset::Index low = step > 0 ? first : first - (count - 1) * delta;
+            if (low >= 0)
+                return xdataset::MultiIndexSelector::Range(low, low + (count - 1) * delta + 1, delta);
+        }
+
         std::vector<xdataset::Index> indices;
         if (step > 0)
             for (double v = start; v <= stop + 1e-12; v += step)
@@ -423,7 +668,12 @@ make_selector(rel::Evaluator& eval, const rel::ExprPtr& arg, bool one_based)
         return xdataset::MultiIndexSelector::In(indices);
     }
 
-    double idx = eval_scalar_num(eval, *arg);
+    return IndexSelector(eval.Evaluate(*arg), one_based);
+}
+
+xdataset::MultiIndexSelector IndexSelector(const rel::Value& index, bool one_based)
+{
+    double idx = scalar_num(index);
     if (one_based) idx -= 1;
     if (idx < 0)
         throw std::runtime_error("index out of range (negative)");
@@ -593,13 +843,13 @@ bool Evaluator::try_function_call(const CallExpr& expr)
     if (!ref || ref->segments.size() != 1)
         return false;
 
-    // Copy under the registry lock (thread-safe); the implementation may
-    // register more functions while running without invalidating the copy.
-    Function fn;
-    if (!Environment::CopyFunction(ref->segments[0].name, fn))
+    // The handle shares the registered instance; the implementation may
+    // re-register functions while running without invalidating it.
+    std::shared_ptr<const Function> fn = Environment::ResolveFunction(ref->segments[0].name);
+    if (!fn)
         return false;
 
-    result_ = invoke_function(fn, expr);
+    result_ = invoke_function(*fn, expr);
     return true;
 }
 
@@ -640,7 +890,18 @@ rel::Value Evaluator::eval_matrix_index(const CallExpr& expr)
 //  Slot resolution lives here (not in Function): explicit arguments
 //  are evaluated, omitted slots are filled with the declared defaults via
 //  Function::HasDefault / DefaultValue, and the fully-resolved list
-//  is handed to Function::Invoke.
+//  is handed to Function::Invoke.  A call without skipped slots passes its
+//  arguments positionally and never builds an ArgMap.
+
+bool HasSkippedSlot(const CallExpr& expr)
+{
+    for (const auto& arg : expr.args)
+    {
+        if (!arg)
+            return true;
+    }
+    return false;
+}
 
 rel::Value Evaluator::invoke_function(const Function& fn,
                                            const CallExpr& expr)
@@ -654,6 +915,15 @@ rel::Value Evaluator::invoke_function(const Function& fn,
         throw std::runtime_error(oss.str());
     }
 
+    if (!HasSkippedSlot(expr))
+    {
+        std::vector<rel::Value> args;
+        args.reserve(provided);
+        for (const auto& arg : expr.args)
+            args.push_back(Evaluate(*arg));
+        return fn.Invoke(args.data(), args.size());
+    }
+
     Function::ArgMap user_args;
     for (std::size_t i = 0; i < fn.arity(); ++i)
     {
@@ -680,19 +950,35 @@ void Evaluator::visit_index(const IndexExpr& expr)
     for (const auto& idx : expr.indices)
         selectors.push_back(make_selector(*this, idx, /*one_based=*/false));
 
-    xdataset::DataArray da = obj.as_data_array().select(selectors);
+    result_ = SelectSweep(obj, selectors);
+}
+
+rel::Value SelectSweep(const rel::Value& obj,
+                       const std::vector<xdataset::MultiIndexSelector>& selectors)
+{
+    const xdataset::DataArray& source = obj.as_data_array();
+
+    // Regular dimensions: a single cell is read through a view without
+    // building the intermediate DataArray; larger slices are materialized.
+    if (xdataset::DataArrayView::CanView(source, selectors))
+    {
+        xdataset::DataArrayView view(source, selectors);
+        const bool independent = source.data_kind() == xdataset::DataArrayKind::kIndependent;
+        if (view.size() == 1 && view.rank() == (independent ? 1u : 0u))
+            return rel::Value(view.measurement_at(0));
+        return rel::Value(view.materialize());
+    }
+
+    xdataset::DataArray da = source.select(selectors);
 
     // Unwrap single-row, single-cell Independent DataArray -> Measurement.
     if (da.data_kind() == xdataset::DataArrayKind::kIndependent &&
         da.datas().size() == 1 &&
         da.data().size() == 1)
     {
-        result_ = rel::Value(da.data().measurement_at(0));
-    }
-    else
-    {
-        result_ = rel::Value(std::move(da));
+        return rel::Value(da.data().measurement_at(0));
     }
+    return rel::Value(std::move(da));
 }
 
 // =========================================================================
@@ -703,4 +989,13 @@ void Evaluator::visit_index(const IndexExpr& expr)
 void Evaluator::visit_range(const RangeExpr&)           {}
 void Evaluator::visit_null_range(const NullRangeExpr&)  {}
 
+// =========================================================================
+//  visit_constant -- value pre-built by rel::Optimize()
+// =========================================================================
+
+void Evaluator::visit_constant(const ConstantExpr& expr)
+{
+    result_ = *expr.value;
+}
+
 } // namespace rel
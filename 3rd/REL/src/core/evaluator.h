@@ -5,10 +5,14 @@
 #include "environment.h"
 #include "value.h"
 
+#include <memory>
 #include <string>
 
 namespace rel {
 
+namespace operation { struct FusedExpr; }
+class Vm;
+
 // =========================================================================
 //  Evaluator -- ExprVisitor that walks the AST and produces an rel::Value
 // =========================================================================
@@ -44,20 +48,37 @@ public:
     void visit_matrix(const MatrixExpr& expr) override;
     void visit_range(const RangeExpr& expr) override;
     void visit_null_range(const NullRangeExpr& expr) override;
+    void visit_constant(const ConstantExpr& expr) override;
 
 private:
+    /// The bytecode VM hands sub-trees it does not lower back to the
+    /// evaluator (see bytecode.h).
+    friend class Vm;
+
     /// Parse base_lexeme according to radix into a double.
     static double parse_base(const std::string& lexeme, int radix);
 
     /// Apply a unary operator.
-    rel::Value apply_unary(TokenType op, const rel::Value& operand);
+    static rel::Value apply_unary(TokenType op, const rel::Value& operand);
 
     /// Apply a binary operator (delegates to rel::Value operators).
-    rel::Value apply_binary(TokenType op, const rel::Value& lhs, const rel::Value& rhs);
+    static rel::Value apply_binary(TokenType op, const rel::Value& lhs, const rel::Value& rhs);
 
     /// Apply a short-circuit logical operator.
     rel::Value apply_logical(TokenType op, const LogicalExpr& expr);
 
+    /// ?: with a non-scalar condition: element-wise selection.
+    rel::Value eval_conditional_elementwise(const ConditionalExpr& expr, const rel::Value& cond);
+
+    /// if/elseif/else once branch `first_array` has a non-scalar condition
+    /// (already evaluated into `cond`); earlier conditions were scalar false.
+    rel::Value eval_if_elementwise(const IfExpr& expr, std::size_t first_array, rel::Value cond);
+
+    /// Lower a chain of element-wise operators (+ - * / and unary minus)
+    /// rooted at `expr` into a FusedExpr; every other sub-expression is
+    /// evaluated (left to right) and becomes a leaf.
+    std::unique_ptr<operation::FusedExpr> build_fused(const Expr& expr);
+
     /// Resolve a registered-function call site: evaluate the explicit
     /// arguments, fill omitted parameter slots with the declared defaults
     /// (via Function::HasDefault/DefaultValue), then invoke the
@@ -76,9 +97,9 @@ private:
     rel::Value eval_matrix_index(const CallExpr& expr);
 
     /// Resolve a reference (single identifier, dotted path, DDot) into a
-    /// Value using Environment lookups and Dataset traversal.
-    rel::Value ResolveReference(
-        const std::vector<RefSegment>& segments) const;
+    /// Value using Environment lookups and Dataset traversal.  The Dataset
+    /// part is cached on the node (ReferenceExpr::resolved).
+    rel::Value ResolveReference(const ReferenceExpr& expr) const;
 
     Environment& env_;
     rel::Value result_;
@@ -0,0 +1,59 @@
+// =============================================================================
+//  REL -- Internal evaluation helpers (shared by evaluator.cc & bytecode.cc)
+// =============================================================================
+//
+//  This is a private header -- NOT part of the public API.  Both back ends
+//  (the tree-walking Evaluator and the bytecode VM) go through these so
+//  that truthiness, fusion and indexing rules cannot drift apart.
+
+#ifndef REL_EVALUATOR_HELPERS_H
+#define REL_EVALUATOR_HELPERS_H
+
+#include "expr.h"
+#include "multi_index_selector.h"
+#include "operation/fused_operation.h"
+#include "value.h"
+
+#include <vector>
+
+namespace rel {
+
+// ---- conditions ---------------------------------------------------------
+
+/// Truth value of a scalar Measurement (non-zero number / non-empty
+/// string).  Returns false when `v` is not a scalar Measurement; callers
+/// then fall back to element-wise evaluation.
+bool ScalarTruth(const rel::Value& v, bool& truth);
+
+// ---- fused element-wise chains ------------------------------------------
+
+/// Look through parentheses.
+const Expr& StripGrouping(const Expr& expr);
+
+/// Fused operator for `expr`, or kLeaf when it is not an element-wise
+/// arithmetic node.
+operation::FusedExpr::Op FusedOpOf(const Expr& expr);
+
+/// Number of fusable operator nodes reachable from `expr`, counting no
+/// further than `limit`.  A node reaching two is evaluated fused.
+int CountFusedOps(const Expr& expr, int limit);
+
+// ---- calls --------------------------------------------------------------
+
+/// True when a call site leaves a slot empty (`f(1, , 3)`).
+bool HasSkippedSlot(const CallExpr& expr);
+
+// ---- indexing -----------------------------------------------------------
+
+/// Selector for a single (non-range) index value; `one_based` for matrix
+/// indexing a(i), zero-based for sweep indexing a[i].
+xdataset::MultiIndexSelector IndexSelector(const rel::Value& index, bool one_based);
+
+/// Sweep indexing a[...] of a DataArray value; a single remaining cell of
+/// an Independent array is unwrapped to a Measurement.
+rel::Value SelectSweep(const rel::Value& obj,
+                       const std::vector<xdataset::MultiIndexSelector>& selectors);
+
+}  // namespace rel
+
+#endif  // REL_EVALUATOR_HELPERS_H
@@ -176,4 +176,14 @@ namespace rel
     NullRangeExpr::NullRangeExpr(int line_value, int column_value) : Expr(line_value, column_value) {}
 
     void NullRangeExpr::accept(ExprVisitor& visitor) const { visitor.visit_null_range(*this); }
+
+    ConstantExpr::ConstantExpr(int line_value,
+                               int column_value,
+                               std::shared_ptr<const Value> value_value,
+                               std::string text_value)
+        : Expr(line_value, column_value), value(std::move(value_value)), text(std::move(text_value))
+    {
+    }
+
+    void ConstantExpr::accept(ExprVisitor& visitor) const { visitor.visit_constant(*this); }
 } // namespace rel
@@ -0,0 +1,180 @@
+#include "rel.h"
+
+#include "ast_printer.h"
+#include "environment.h"
+#include "evaluator.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rel {
+namespace {
+
+// =========================================================================
+//  ConstantFolder -- bottom-up rewrite of constant sub-trees
+// =========================================================================
+//
+//  A sub-tree is constant when it is a literal, a single-segment reference
+//  to a builtin constant, or a unary / binary / logical / conditional /
+//  grouping node over constant operands.  Constant sub-trees are evaluated
+//  once by the ordinary Evaluator (so the Operation* kernels, unit handling
+//  and error messages are exactly those of evaluation) and replaced by a
+//  ConstantExpr.  Calls, indexing, sweeps, matrices and ranges are never
+//  folded themselves -- their node kind is inspected by the evaluator --
+//  but their operands are.
+
+class ConstantFolder
+{
+public:
+    /// Fold `slot` in place; true when it is now a ConstantExpr.
+    bool fold(ExprPtr& slot);
+
+private:
+    /// Fold every item; true when all of them are now constant.
+    bool fold_all(std::vector<ExprPtr>& items);
+
+    /// Replace `slot` (whose operands are already constant) with its value.
+    /// Leaves the node untouched and returns false when evaluation throws,
+    /// so the error is raised at evaluation time as before.
+    bool replace(ExprPtr& slot);
+
+    Environment env_;  // empty: constant sub-trees reference no variables
+};
+
+bool ConstantFolder::fold(ExprPtr& slot)
+{
+    Expr* e = slot.get();
+    if (!e)
+        return false;
+    if (dynamic_cast<ConstantExpr*>(e))
+        return true;
+
+    if (dynamic_cast<NumberExpr*>(e) || dynamic_cast<BooleanExpr*>(e) ||
+        dynamic_cast<StringExpr*>(e))
+        return replace(slot);
+
+    if (auto* r = dynamic_cast<ReferenceExpr*>(e))
+    {
+        // Builtin constants cannot be shadowed (Environment::Define rejects
+        // the collision), so the reference always resolves to the constant.
+        if (r->segments.size() == 1 && Environment::FindConstant(r->segments[0].name))
+            return replace(slot);
+        return false;
+    }
+
+    if (auto* u = dynamic_cast<UnaryExpr*>(e))
+        return fold(u->operand) && replace(slot);
+
+    if (auto* b = dynamic_cast<BinaryExpr*>(e))
+    {
+        bool left  = fold(b->left);
+        bool right = fold(b->right);
+        return left && right && replace(slot);
+    }
+
+    if (auto* l = dynamic_cast<LogicalExpr*>(e))
+    {
+        bool left  = fold(l->left);
+        bool right = fold(l->right);
+        return left && right && replace(slot);
+    }
+
+    if (auto* c = dynamic_cast<ConditionalExpr*>(e))
+    {
+        bool cond = fold(c->condition);
+        bool then = fold(c->then_branch);
+        bool els  = fold(c->else_branch);
+        return cond && then && els && replace(slot);
+    }
+
+    if (auto* i = dynamic_cast<IfExpr*>(e))
+    {
+        bool all = true;
+        for (auto& branch : i->branches)
+        {
+            all = fold(branch.condition) && all;
+            all = fold(branch.value) && all;
+        }
+        all = fold(i->else_value) && all;
+        return all && replace(slot);
+    }
+
+    if (auto* g = dynamic_cast<GroupingExpr*>(e))
+        return fold(g->inner) && replace(slot);
+
+    if (auto* call = dynamic_cast<CallExpr*>(e))
+    {
+        // The callee decides between function call and matrix indexing by
+        // its node kind, so only the arguments are folded.
+        fold_all(call->args);
+        return false;
+    }
+
+    if (auto* idx = dynamic_cast<IndexExpr*>(e))
+    {
+        fold(idx->object);
+        fold_all(idx->indices);
+        return false;
+    }
+
+    if (auto* s = dynamic_cast<SweepExpr*>(e))
+    {
+        fold_all(s->items);
+        return false;
+    }
+
+    if (auto* m = dynamic_cast<MatrixExpr*>(e))
+    {
+        fold_all(m->items);
+        return false;
+    }
+
+    if (auto* range = dynamic_cast<RangeExpr*>(e))
+    {
+        fold(range->start);
+        fold(range->step);
+        fold(range->stop);
+        return false;
+    }
+
+    return false;
+}
+
+bool ConstantFolder::fold_all(std::vector<ExprPtr>& items)
+{
+    bool all = true;
+    for (auto& item : items)
+        all = fold(item) && all;
+    return all;
+}
+
+bool ConstantFolder::replace(ExprPtr& slot)
+{
+    std::shared_ptr<const Value> value;
+    try
+    {
+        Evaluator evaluator(env_);
+        value = std::make_shared<const Value>(evaluator.Evaluate(*slot));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    AstPrinter printer;
+    std::string text = printer.Print(*slot);
+    slot.reset(new ConstantExpr(slot->line, slot->column, std::move(value), std::move(text)));
+    return true;
+}
+
+}  // namespace
+
+ExprPtr Optimize(ExprPtr expr)
+{
+    ConstantFolder folder;
+    folder.fold(expr);
+    return expr;
+}
+
+} // namespace rel
@@ -1,11 +1,14 @@
 #include "rel.h"
 
+#include "bytecode.h"
 #include "environment.h"
 #include "error.h"
 #include "evaluator.h"
+#include "operation/parallel.h"
 #include "parser.h"
 #include "scanner.h"
 
+#include <atomic>
 #include <cctype>
 #include <string>
 #include <utility>
@@ -36,6 +39,8 @@ RelError make_eval_error(const Expr& expr, const std::exception& e)
     return RelError(err);
 }
 
+std::atomic<int> g_backend(static_cast<int>(EvalBackend::kTreeWalker));
+
 bool is_ident_start(char c)
 {
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
@@ -112,6 +117,9 @@ Value Eval(const std::string& source, Environment* env)
     Environment temp_env;
     if (!env) env = &temp_env;
 
+    if (GetEvalBackend() == EvalBackend::kBytecode)
+        return Eval(*Compile(Parse(source)), *env);
+
     ExprPtr expr = Parse(source);
     try
     {
@@ -129,6 +137,8 @@ Value Eval(const std::string& source, Environment* env)
 
 Value Eval(const Expr& expr, Environment& env)
 {
+    const ParallelOptions parallel = env.parallel_options();
+    operation::ParallelScope scope(parallel.threads, parallel.min_elements);
     try
     {
         Evaluator evaluator(env);
@@ -144,6 +154,35 @@ Value Eval(const Expr& expr, Environment& env)
     }
 }
 
+Value Eval(const Program& program, Environment& env)
+{
+    const ParallelOptions parallel = env.parallel_options();
+    operation::ParallelScope scope(parallel.threads, parallel.min_elements);
+    try
+    {
+        Vm vm(program, env);
+        return vm.Run();
+    }
+    catch (const RelError&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw make_eval_error(program.root(), e);
+    }
+}
+
+void SetEvalBackend(EvalBackend backend)
+{
+    g_backend.store(static_cast<int>(backend));
+}
+
+EvalBackend GetEvalBackend()
+{
+    return static_cast<EvalBackend>(g_backend.load());
+}
+
 void Exec(const std::string& source, Environment& env)
 {
     std::size_t eq = find_binding_eq(source);
@@ -30,20 +30,22 @@ namespace math
 
     // ---- Function factory helpers ----------------------------------------------------
 
+    // Positional: sin(x) / add(x, y) call straight through without an ArgMap.
+
     Function make_unary_fn(const char* name, Value (*fn)(const Value&))
     {
-        return Function(name,
-                        std::vector<FunctionParam>{Param("x")},
-                        [name, fn](const Function::ArgMap& args) -> Value
-                        { return fn(args.at("x")); });
+        return Function::Positional(name,
+                                    std::vector<FunctionParam>{Param("x")},
+                                    [fn](const Value* args, std::size_t) -> Value
+                                    { return fn(args[0]); });
     }
 
     Function make_binary_fn(const char* name, Value (*fn)(const Value&, const Value&))
     {
-        return Function(name,
-                        std::vector<FunctionParam>{Param("x"), Param("y")},
-                        [name, fn](const Function::ArgMap& args) -> Value
-                        { return fn(args.at("x"), args.at("y")); });
+        return Function::Positional(name,
+                                    std::vector<FunctionParam>{Param("x"), Param("y")},
+                                    [fn](const Value* args, std::size_t) -> Value
+                                    { return fn(args[0], args[1]); });
     }
 
     // ---- Reduce helpers --------------------------------------------------------------
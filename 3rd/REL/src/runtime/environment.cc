@@ -6,6 +6,7 @@
 #include "builtin_library/math_library.h"
 
 #include <stdexcept>
+#include <utility>
 
 namespace rel {
 
@@ -15,9 +16,39 @@ namespace rel {
 
 std::unordered_map<std::string, rel::Value>
     Environment::builtin_constants_;
-std::unordered_map<std::string, Function>
-    Environment::functions_;
+std::unordered_map<std::string, std::size_t> Environment::variable_slots_;
+std::mutex Environment::variable_slots_mutex_;
+/// One immutable version of the function registry.
+struct Environment::FunctionTable
+{
+    std::uint64_t version = 0;
+    std::unordered_map<std::string, std::size_t> slots;    // every name seen
+    std::vector<std::shared_ptr<const Function>> by_slot;  // null: not registered
+
+    const std::shared_ptr<const Function>* find(const std::string& name) const
+    {
+        auto it = slots.find(name);
+        if (it == slots.end() || !by_slot[it->second])
+            return nullptr;
+        return &by_slot[it->second];
+    }
+
+    std::size_t slot(const std::string& name)
+    {
+        auto it = slots.find(name);
+        if (it != slots.end())
+            return it->second;
+        slots.emplace(name, by_slot.size());
+        by_slot.emplace_back();
+        return by_slot.size() - 1;
+    }
+};
+
+std::shared_ptr<const Environment::FunctionTable>
+    Environment::functions_ = std::make_shared<const Environment::FunctionTable>();
+std::atomic<std::uint64_t> Environment::functions_version_(0);
 std::mutex Environment::functions_mutex_;
+std::mutex Environment::datasets_mutex_;
 std::unordered_map<std::string, std::unique_ptr<xdataset::Dataset>>
     Environment::datasets_;
 std::string Environment::default_dataset_name_;
@@ -26,16 +57,72 @@ std::string Environment::default_dataset_name_;
 //  Variables (instance)
 // =========================================================================
 
+Environment::Environment(const Environment& other)
+{
+    std::lock_guard<std::mutex> lock(other.variables_mutex_);
+    variables_ = other.variables_;
+    parallel_ = other.parallel_;
+}
+
+Environment::Environment(Environment&& other)
+{
+    std::lock_guard<std::mutex> lock(other.variables_mutex_);
+    variables_ = std::move(other.variables_);
+    parallel_ = other.parallel_;
+    ++other.revision_;
+}
+
+Environment& Environment::operator=(const Environment& other)
+{
+    if (this != &other)
+    {
+        std::unordered_map<std::string, rel::Value> copy;
+        ParallelOptions parallel;
+        {
+            std::lock_guard<std::mutex> lock(other.variables_mutex_);
+            copy = other.variables_;
+            parallel = other.parallel_;
+        }
+        std::lock_guard<std::mutex> lock(variables_mutex_);
+        variables_ = std::move(copy);
+        parallel_ = parallel;
+        ++revision_;
+    }
+    return *this;
+}
+
+Environment& Environment::operator=(Environment&& other)
+{
+    if (this != &other)
+    {
+        std::unordered_map<std::string, rel::Value> moved;
+        ParallelOptions parallel;
+        {
+            std::lock_guard<std::mutex> lock(other.variables_mutex_);
+            moved = std::move(other.variables_);
+            parallel = other.parallel_;
+            ++other.revision_;
+        }
+        std::lock_guard<std::mutex> lock(variables_mutex_);
+        variables_ = std::move(moved);
+        parallel_ = parallel;
+        ++revision_;
+    }
+    return *this;
+}
+
 void Environment::Define(const std::string& name, rel::Value value)
 {
     if (builtin_constants_.find(name) != builtin_constants_.end())
         throw std::runtime_error(
             "cannot redefine builtin constant '" + name + "'");
+    std::lock_guard<std::mutex> lock(variables_mutex_);
     variables_[name] = std::move(value);
 }
 
 rel::Value Environment::Get(const std::string& name) const
 {
+    std::lock_guard<std::mutex> lock(variables_mutex_);
     auto it = variables_.find(name);
     if (it != variables_.end())
         return it->second;
@@ -44,16 +131,23 @@ rel::Value Environment::Get(const std::string& name) const
 
 bool Environment::Remove(const std::string& name)
 {
-    return variables_.erase(name) > 0;
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    if (variables_.erase(name) == 0)
+        return false;
+    ++revision_;
+    return true;
 }
 
 void Environment::Clear()
 {
+    std::lock_guard<std::mutex> lock(variables_mutex_);
     variables_.clear();
+    ++revision_;
 }
 
 std::vector<std::string> Environment::VariableNames() const
 {
+    std::lock_guard<std::mutex> lock(variables_mutex_);
     std::vector<std::string> names;
     names.reserve(variables_.size());
     for (const auto& kv : variables_)
@@ -61,26 +155,68 @@ std::vector<std::string> Environment::VariableNames() const
     return names;
 }
 
+bool Environment::Contains(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    return variables_.find(name) != variables_.end();
+}
+
+bool Environment::Find(const std::string& name, rel::Value& out) const
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    auto it = variables_.find(name);
+    if (it == variables_.end())
+        return false;
+    out = it->second;
+    return true;
+}
+
+std::size_t Environment::size() const
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    return variables_.size();
+}
+
+// =========================================================================
+//  Parallel execution options (instance)
+// =========================================================================
+
+void Environment::SetParallelOptions(const ParallelOptions& options)
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    parallel_ = options;
+}
+
+ParallelOptions Environment::parallel_options() const
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    return parallel_;
+}
+
 // =========================================================================
 //  Static: builtin constants
 // =========================================================================
 
 void Environment::InitBuiltinConstants()
 {
-    builtin_constants_["PI"]        = rel::Value::Real(3.1415926535898);
-    builtin_constants_["pi"]        = rel::Value::Real(3.1415926535898);
-    builtin_constants_["e"]         = rel::Value::Real(2.718281822);
-    builtin_constants_["ln10"]      = rel::Value::Real(2.302585093);
-    builtin_constants_["boltzmann"] = rel::Value::Real(1.380658e-23);
-    builtin_constants_["qelectron"] = rel::Value::Real(1.60217733e-19);
-    builtin_constants_["planck"]    = rel::Value::Real(6.6260755e-34);
-    builtin_constants_["c0"]        = rel::Value::Real(2.99792e+08);
-    builtin_constants_["e0"]        = rel::Value::Real(8.85419e-12);
-    builtin_constants_["u0"]        = rel::Value::Real(12.5664e-07);
-    builtin_constants_["tinyReal"]  = rel::Value::Real(2.2e-308);
-    builtin_constants_["hugeReal"]  = rel::Value::Real(3.4e+38);
-    builtin_constants_["i"]  = rel::Value::Complex(std::complex<double>(0,1));
-    builtin_constants_["j"]  = rel::Value::Complex(std::complex<double>(0,1));
+    static std::once_flag once;
+    std::call_once(once, []()
+    {
+        builtin_constants_["PI"]        = rel::Value::Real(3.1415926535898);
+        builtin_constants_["pi"]        = rel::Value::Real(3.1415926535898);
+        builtin_constants_["e"]         = rel::Value::Real(2.718281822);
+        builtin_constants_["ln10"]      = rel::Value::Real(2.302585093);
+        builtin_constants_["boltzmann"] = rel::Value::Real(1.380658e-23);
+        builtin_constants_["qelectron"] = rel::Value::Real(1.60217733e-19);
+        builtin_constants_["planck"]    = rel::Value::Real(6.6260755e-34);
+        builtin_constants_["c0"]        = rel::Value::Real(2.99792e+08);
+        builtin_constants_["e0"]        = rel::Value::Real(8.85419e-12);
+        builtin_constants_["u0"]        = rel::Value::Real(12.5664e-07);
+        builtin_constants_["tinyReal"]  = rel::Value::Real(2.2e-308);
+        builtin_constants_["hugeReal"]  = rel::Value::Real(3.4e+38);
+        builtin_constants_["i"]  = rel::Value::Complex(std::complex<double>(0,1));
+        builtin_constants_["j"]  = rel::Value::Complex(std::complex<double>(0,1));
+    });
 }
 
 const rel::Value* Environment::FindConstant(const std::string& name)
@@ -110,86 +246,142 @@ void Environment::InitBuiltinFunctions()
     RegisterLibrary(math::MakeLibrary());
 }
 
-void Environment::RegisterFunction(Function fn)
+const Environment::FunctionTable& Environment::function_table()
+{
+    // The snapshot this thread last used.  While no writer has published,
+    // the version matches and the lookup is a single atomic load.  Callers
+    // copy the shared_ptr of the function they resolve before invoking it,
+    // so a refresh triggered from inside an implementation cannot free
+    // anything still in use.
+    thread_local std::shared_ptr<const FunctionTable> snapshot;
+    if (!snapshot ||
+        snapshot->version != functions_version_.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(functions_mutex_);
+        snapshot = functions_;
+    }
+    return *snapshot;
+}
+
+void Environment::update_functions(const std::function<void(FunctionTable&)>& edit)
 {
     std::lock_guard<std::mutex> lock(functions_mutex_);
-    functions_[fn.name()] = std::move(fn);
+    std::shared_ptr<FunctionTable> next = std::make_shared<FunctionTable>(*functions_);
+    edit(*next);
+    next->version = functions_->version + 1;
+    functions_ = next;
+    functions_version_.store(next->version, std::memory_order_release);
+}
+
+void Environment::RegisterFunction(Function fn)
+{
+    std::shared_ptr<const Function> shared = std::make_shared<const Function>(std::move(fn));
+    update_functions([&shared](FunctionTable& table) {
+        table.by_slot[table.slot(shared->name())] = shared;
+    });
 }
 
 void Environment::RegisterLibrary(const FunctionLibrary& lib)
 {
-    for (const auto& fn : lib.functions())
-        RegisterFunction(fn);
+    update_functions([&lib](FunctionTable& table) {
+        for (const auto& fn : lib.functions())
+            table.by_slot[table.slot(fn.name())] = std::make_shared<const Function>(fn);
+    });
 }
 
 bool Environment::UnregisterFunction(const std::string& name)
 {
-    std::lock_guard<std::mutex> lock(functions_mutex_);
-    return functions_.erase(name) > 0;
+    if (!function_table().find(name))
+        return false;
+
+    bool removed = false;
+    update_functions([&name, &removed](FunctionTable& table) {
+        auto it = table.slots.find(name);
+        if (it != table.slots.end() && table.by_slot[it->second])
+        {
+            table.by_slot[it->second].reset();
+            removed = true;
+        }
+    });
+    return removed;
 }
 
 bool Environment::HasFunction(const std::string& name)
 {
-    std::lock_guard<std::mutex> lock(functions_mutex_);
-    return functions_.find(name) != functions_.end();
+    return function_table().find(name) != nullptr;
 }
 
 bool Environment::CopyFunction(const std::string& name, Function& out)
 {
-    std::lock_guard<std::mutex> lock(functions_mutex_);
-    auto it = functions_.find(name);
-    if (it == functions_.end())
+    std::shared_ptr<const Function> fn = ResolveFunction(name);
+    if (!fn)
         return false;
-    out = it->second;  // copy under lock
+    out = *fn;
     return true;
 }
 
+std::shared_ptr<const Function> Environment::ResolveFunction(const std::string& name)
+{
+    const std::shared_ptr<const Function>* fn = function_table().find(name);
+    return fn ? *fn : nullptr;
+}
+
+std::size_t Environment::FunctionSlot(const std::string& name)
+{
+    {
+        const FunctionTable& table = function_table();
+        auto it = table.slots.find(name);
+        if (it != table.slots.end())
+            return it->second;
+    }
+
+    std::size_t slot = 0;
+    update_functions([&name, &slot](FunctionTable& table) { slot = table.slot(name); });
+    return slot;
+}
+
+std::shared_ptr<const Function> Environment::ResolveFunction(std::size_t slot)
+{
+    const FunctionTable& table = function_table();
+    return slot < table.by_slot.size() ? table.by_slot[slot] : nullptr;
+}
+
+std::uint64_t Environment::FunctionRegistryVersion()
+{
+    return functions_version_.load(std::memory_order_acquire);
+}
+
 std::vector<std::string> Environment::FunctionNames()
 {
-    std::lock_guard<std::mutex> lock(functions_mutex_);
+    const FunctionTable& table = function_table();
     std::vector<std::string> names;
-    names.reserve(functions_.size());
-    for (const auto& kv : functions_)
-        names.push_back(kv.first);
+    names.reserve(table.slots.size());
+    for (const auto& kv : table.slots)
+    {
+        if (table.by_slot[kv.second])
+            names.push_back(kv.first);
+    }
     return names;
 }
 
 rel::Value Environment::CallFunction(const std::string& name,
                                      const Function::ArgMap& args)
 {
-    Function fn;
-    if (!CopyFunction(name, fn))
+    // The handle keeps the Function alive even if the implementation
+    // re-registers it while running.
+    std::shared_ptr<const Function> fn = ResolveFunction(name);
+    if (!fn)
         throw std::runtime_error("function '" + name + "' is not registered");
-
-    // The copy is taken under the registry lock (CopyFunction), so the
-    // implementation may register more functions while running without
-    // invalidating anything we hold.  Invoke runs without the lock.
-    return fn.Invoke(args);
+    return fn->Invoke(args);
 }
 
 rel::Value Environment::CallFunction(const std::string& name,
                                      const std::vector<rel::Value>& args)
 {
-    Function fn;
-    if (!CopyFunction(name, fn))
+    std::shared_ptr<const Function> fn = ResolveFunction(name);
+    if (!fn)
         throw std::runtime_error("function '" + name + "' is not registered");
-
-    // Bind positional arguments to the function's declared parameter names.
-    const std::vector<FunctionParam>& params = fn.params();
-    if (args.size() > params.size())
-    {
-        throw std::runtime_error("function '" + name + "' expects at most " +
-                                 std::to_string(params.size()) +
-                                 " argument(s), got " +
-                                 std::to_string(args.size()));
-    }
-
-    Function::ArgMap named;
-    for (std::size_t i = 0; i < args.size(); ++i)
-        named[params[i].name] = args[i];
-
-    // The copy was taken under the registry lock (CopyFunction).
-    return fn.Invoke(named);
+    return fn->Invoke(args.data(), args.size());
 }
 
 // =========================================================================
@@ -199,11 +391,13 @@ rel::Value Environment::CallFunction(const std::string& name,
 void Environment::AddDataset(std::unique_ptr<xdataset::Dataset> ds)
 {
     std::string name = ds->name();
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     datasets_[std::move(name)] = std::move(ds);
 }
 
 std::unique_ptr<xdataset::Dataset> Environment::RemoveDataset(const std::string& name)
 {
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     auto it = datasets_.find(name);
     if (it == datasets_.end())
         return nullptr;
@@ -218,11 +412,13 @@ std::unique_ptr<xdataset::Dataset> Environment::RemoveDataset(const std::string&
 
 void Environment::SetDefaultDataset(const std::string& name)
 {
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     default_dataset_name_ = name;
 }
 
 xdataset::Dataset* Environment::DefaultDataset()
 {
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     if (default_dataset_name_.empty())
         return nullptr;
     auto it = datasets_.find(default_dataset_name_);
@@ -234,6 +430,7 @@ xdataset::Dataset* Environment::DefaultDataset()
 std::vector<std::string> Environment::DatasetNames()
 {
     std::vector<std::string> names;
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     names.reserve(datasets_.size());
     for (const auto& kv : datasets_)
         names.push_back(kv.first);
@@ -254,8 +451,66 @@ const rel::Value* Environment::LookupVariableOrConstant(
     return FindConstant(name);
 }
 
+bool Environment::CopyVariableOrConstant(const std::string& name,
+                                         rel::Value& out) const
+{
+    {
+        std::lock_guard<std::mutex> lock(variables_mutex_);
+        auto it = variables_.find(name);
+        if (it != variables_.end())
+        {
+            out = it->second;
+            return true;
+        }
+    }
+
+    const rel::Value* c = FindConstant(name);
+    if (!c)
+        return false;
+    out = *c;
+    return true;
+}
+
+std::size_t Environment::VariableSlot(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(variable_slots_mutex_);
+    return variable_slots_.emplace(name, variable_slots_.size()).first->second;
+}
+
+bool Environment::CopyVariableOrConstant(std::size_t slot, const std::string& name,
+                                         rel::Value& out) const
+{
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    if (slot < slot_cache_.size() && slot_cache_[slot].revision == revision_)
+    {
+        out = *slot_cache_[slot].value;
+        return true;
+    }
+
+    // Map nodes keep their address until erased, and builtin constants are
+    // never erased nor shadowed (Define rejects their names), so a found
+    // value can be remembered until the next erase.  Misses are not cached:
+    // the name may be defined later.
+    const rel::Value* found = nullptr;
+    auto it = variables_.find(name);
+    if (it != variables_.end())
+        found = &it->second;
+    else
+        found = FindConstant(name);
+    if (!found)
+        return false;
+
+    if (slot >= slot_cache_.size())
+        slot_cache_.resize(slot + 1);
+    slot_cache_[slot].value = found;
+    slot_cache_[slot].revision = revision_;
+    out = *found;
+    return true;
+}
+
 xdataset::Dataset* Environment::FindDataset(const std::string& name)
 {
+    std::lock_guard<std::mutex> lock(datasets_mutex_);
     auto it = datasets_.find(name);
     if (it != datasets_.end())
         return it->second.get();
@@ -290,7 +545,15 @@ void Environment::LoadFromConfig(const std::string& config_path)
 
         if (ds.format == "hdf5")
         {
-            loaded = xdataset::DatasetIO::Load(ds.format, full_path);
+            xdataset::DatasetIOOptions options;
+            options.lazy = ds.lazy;
+            loaded = xdataset::DatasetIO::Load(ds.format, full_path, options);
+            loaded.set_name(ds.name);
+        }
+        else if (ds.format == "xds")
+        {
+            // Memory-mapped: numeric columns stay in the shared page cache.
+            loaded = xdataset::DatasetIO::Load("xds", full_path);
             loaded.set_name(ds.name);
         }
         else if (ds.format == "touchstone")
@@ -304,6 +567,7 @@ void Environment::LoadFromConfig(const std::string& config_path)
                 "unsupported dataset format '" + ds.format + "'");
         }
 
+        std::lock_guard<std::mutex> lock(datasets_mutex_);
         datasets_[ds.name] = std::unique_ptr<xdataset::Dataset>(
             new xdataset::Dataset(std::move(loaded)));
     }
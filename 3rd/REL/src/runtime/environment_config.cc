@@ -12,6 +12,8 @@ DatasetConfig EnvironmentConfig::ParseDataset(const rapidjson::Value& v)
     ds.name   = v["name"].GetString();
     ds.format = v["format"].GetString();
     ds.path   = v["path"].GetString();
+    if (v.HasMember("lazy") && v["lazy"].IsBool())
+        ds.lazy = v["lazy"].GetBool();
     return ds;
 }
 
@@ -7,13 +7,14 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace rel
 {
 
     Value Function::Invoke(const ArgMap& user_args) const
     {
-        if (!impl_)
+        if (!impl_ && !positional_)
             throw std::runtime_error("function '" + name_ + "' has no implementation");
 
         ArgMap resolved;
@@ -42,6 +43,15 @@ namespace rel
             }
         }
 
+        if (!impl_)
+        {
+            std::vector<Value> flat;
+            flat.reserve(resolved.size());
+            for (const auto& kv : resolved)
+                flat.push_back(kv.second);
+            return call_positional(flat.data(), flat.size());
+        }
+
         try
         {
             return impl_(resolved);
@@ -54,4 +64,53 @@ namespace rel
         }
     }
 
+    Value Function::Invoke(const Value* args, std::size_t count) const
+    {
+        if (count > params_.size())
+        {
+            std::ostringstream oss;
+            oss << "function '" << name_ << "' expects at most " << params_.size()
+                << " argument(s), got " << count;
+            throw std::runtime_error(oss.str());
+        }
+
+        if (positional_)
+        {
+            if (count == params_.size())
+                return call_positional(args, count);
+
+            bool static_defaults = true;
+            for (std::size_t i = count; i < params_.size(); ++i)
+                static_defaults = static_defaults && params_[i].has_default &&
+                                  !params_[i].has_computed_default;
+            if (static_defaults)
+            {
+                std::vector<Value> full(args, args + count);
+                full.reserve(params_.size());
+                for (std::size_t i = count; i < params_.size(); ++i)
+                    full.push_back(params_[i].default_value);
+                return call_positional(full.data(), full.size());
+            }
+        }
+
+        ArgMap named;
+        for (std::size_t i = 0; i < count; ++i)
+            named[params_[i].name] = args[i];
+        return Invoke(named);
+    }
+
+    Value Function::call_positional(const Value* args, std::size_t count) const
+    {
+        try
+        {
+            return positional_(args, count);
+        }
+        catch (const std::exception& e)
+        {
+            std::ostringstream oss;
+            oss << "error invoking function '" << name_ << "':\n" << e.what();
+            throw std::runtime_error(oss.str());
+        }
+    }
+
 }  // namespace rel
@@ -0,0 +1,472 @@
+// =============================================================================
+//  REL -- Fused element-wise evaluation of operator trees
+// =============================================================================
+
+#include "operation/fused_operation.h"
+#include "operation/operation_helpers.h"
+#include "operation/operator.h"
+#include "operation/parallel.h"
+#include "data_array.h"
+#include "data_series.h"
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace rel {
+namespace operation {
+
+using namespace xdataset;
+
+namespace {
+
+typedef std::complex<double> Complex;
+typedef FusedExpr::Op        FusedOp;
+
+/// Rows processed per pass.  Small enough that every intermediate buffer of
+/// a typical tree stays in L1/L2 while the next node reads it.  Large plans
+/// split their rows across the ParallelRanges pool first; each range then
+/// walks its own rows in passes of this size.
+const Index kChunkRows = 1024;
+
+// =========================================================================
+//  Element functors (same arithmetic as op_add / op_sub / ... in operator.cc)
+// =========================================================================
+
+struct AddFn    { template <typename T> T operator()(T a, T b) const { return a + b; } };
+struct SubFn    { template <typename T> T operator()(T a, T b) const { return a - b; } };
+struct MulFn    { template <typename T> T operator()(T a, T b) const { return a * b; } };
+struct DivFn    { template <typename T> T operator()(T a, T b) const { return a / b; } };
+struct NegateFn { template <typename T> T operator()(T a) const { return -a; } };
+
+// =========================================================================
+//  Unfused reference path
+// =========================================================================
+
+Value EvaluateUnfused(const FusedExpr& e) {
+    switch (e.op) {
+        case FusedOp::kLeaf:   return e.leaf;
+        case FusedOp::kAdd:    return OperationAdd(EvaluateUnfused(*e.lhs), EvaluateUnfused(*e.rhs));
+        case FusedOp::kSub:    return OperationSub(EvaluateUnfused(*e.lhs), EvaluateUnfused(*e.rhs));
+        case FusedOp::kMul:    return OperationMul(EvaluateUnfused(*e.lhs), EvaluateUnfused(*e.rhs));
+        case FusedOp::kDiv:    return OperationDiv(EvaluateUnfused(*e.lhs), EvaluateUnfused(*e.rhs));
+        case FusedOp::kNegate: return OperationNegate(EvaluateUnfused(*e.lhs));
+    }
+    throw std::logic_error("OperateFused: unknown operator");
+}
+
+bool HasArrayLeaf(const FusedExpr& e) {
+    if (e.op == FusedOp::kLeaf) return e.leaf.is_data_array();
+    if (HasArrayLeaf(*e.lhs)) return true;
+    return e.rhs && HasArrayLeaf(*e.rhs);
+}
+
+bool IsNumeric(DataType dt) {
+    return dt == DataType::kInteger || dt == DataType::kReal || dt == DataType::kComplex;
+}
+
+// =========================================================================
+//  Typed scratch storage
+// =========================================================================
+
+struct Scratch {
+    std::vector<int>     i;
+    std::vector<double>  d;
+    std::vector<Complex> c;
+};
+
+template <typename T> std::vector<T>& Get(Scratch& s);
+template <> std::vector<int>&     Get<int>(Scratch& s)     { return s.i; }
+template <> std::vector<double>&  Get<double>(Scratch& s)  { return s.d; }
+template <> std::vector<Complex>& Get<Complex>(Scratch& s) { return s.c; }
+
+/// Element promotion along Integer -> Real -> Complex.  Node dtypes come from
+/// DeriveDtypePromote*, so a node never narrows its operands.
+template <typename From, typename To>
+struct Promotion {
+    static void Run(const From* src, Index n, To* dst) {
+        for (Index i = 0; i < n; ++i) dst[i] = To(src[i]);
+    }
+};
+template <typename From>
+struct NoPromotion {
+    static void Run(const From*, Index, void*) {
+        throw std::logic_error("OperateFused: narrowing conversion");
+    }
+};
+template <> struct Promotion<double, int>      : NoPromotion<double>  {};
+template <> struct Promotion<Complex, int>     : NoPromotion<Complex> {};
+template <> struct Promotion<Complex, double>  : NoPromotion<Complex> {};
+
+// =========================================================================
+//  FusedPlan
+// =========================================================================
+//
+//  The tree flattened into post-order steps.  Leaves are either a DataArray
+//  column read in place or a single constant; inner steps carry the dtype
+//  and unit the Operate pipeline would derive for that node.
+
+struct Step {
+    FusedOp  op = FusedOp::kLeaf;
+    DataType dtype = DataType::kInteger;
+    Unit     unit;
+    int      lhs = -1;
+    int      rhs = -1;
+
+    // leaves
+    Value                       value;      // canonicalized operand
+    std::unique_ptr<DataSeries> owner;      // only when flat_data had to convert
+    const void*                 data = nullptr;
+    bool                        constant = false;
+    int                         ci = 0;
+    double                      cd = 0.0;
+    Complex                     cc;
+};
+
+/// Buffers of one row range: each inner step's result for the current
+/// pass (indexed like the steps), plus promotion space for its operands.
+/// Ranges running concurrently each have their own.
+struct Workspace {
+    std::vector<Scratch> results;
+    Scratch              lhs_tmp;
+    Scratch              rhs_tmp;
+};
+
+template <typename T> T ConstantAs(const Step& s);
+template <> int     ConstantAs<int>(const Step& s)     { return s.ci; }
+template <> double  ConstantAs<double>(const Step& s)  { return s.cd; }
+template <> Complex ConstantAs<Complex>(const Step& s) { return s.cc; }
+
+class FusedPlan {
+public:
+    /// False when the tree cannot be evaluated exactly by the fused loop.
+    bool Build(const FusedExpr& root) {
+        return AddStep(root) >= 0 && meta_ != nullptr;
+    }
+
+    Value Run();
+
+private:
+    int AddStep(const FusedExpr& e);
+    bool AddArrayLeaf(Step& s, const Value& v);
+    bool AddConstantLeaf(Step& s, const Value& v);
+
+    template <typename T>
+    const T* Fetch(const Step& child, const Scratch& child_result, Index begin, Index n,
+                   std::vector<T>& tmp, bool& constant, T& value) const;
+    template <typename T>
+    void RunStep(const Step& s, Workspace& ws, Index begin, Index n, T* out) const;
+    void RunStep(std::size_t k, Workspace& ws, Index begin, Index n, void* out) const;
+    void RunRange(Index begin, Index end, char* out_base, std::size_t out_elem) const;
+
+    std::vector<Step>  steps_;
+    Index              rows_ = -1;
+    const DataArray*   meta_ = nullptr;   // leftmost DataArray operand
+};
+
+int FusedPlan::AddStep(const FusedExpr& e) {
+    Step s;
+    s.op = e.op;
+
+    if (e.op != FusedOp::kLeaf && HasArrayLeaf(e)) {
+        int l = AddStep(*e.lhs);
+        if (l < 0) return -1;
+        int r = e.rhs ? AddStep(*e.rhs) : -1;
+        if (e.rhs && r < 0) return -1;
+
+        std::vector<DataType> dtypes;
+        std::vector<Unit>     units;
+        dtypes.push_back(steps_[l].dtype);
+        units.push_back(steps_[l].unit);
+        if (r >= 0) {
+            dtypes.push_back(steps_[r].dtype);
+            units.push_back(steps_[r].unit);
+        }
+
+        try {
+            switch (e.op) {
+                case FusedOp::kAdd:
+                case FusedOp::kSub:
+                case FusedOp::kNegate:
+                    s.dtype = DeriveDtypePromote(dtypes);
+                    s.unit  = DeriveUnitPromoteDimension(units);
+                    break;
+                case FusedOp::kMul:
+                    s.dtype = DeriveDtypePromote(dtypes);
+                    s.unit  = DeriveUnitMul(units);
+                    break;
+                case FusedOp::kDiv:
+                    s.dtype = DeriveDtypePromoteReal(dtypes);
+                    s.unit  = DeriveUnitDiv(units);
+                    break;
+                default:
+                    return -1;
+            }
+        } catch (const std::exception&) {
+            return -1;   // let the unfused path raise the proper error
+        }
+        // The unfused path would re-canonicalize this intermediate before
+        // the parent reads it; only fuse when that is a no-op.
+        if (!s.unit.is_canonical()) return -1;
+
+        s.lhs = l;
+        s.rhs = r;
+        steps_.push_back(std::move(s));
+        return static_cast<int>(steps_.size()) - 1;
+    }
+
+    // Leaf, or a sub-tree of Measurements only: evaluate it now and use the
+    // result as a single operand.
+    Value v;
+    try {
+        v = EvaluateUnfused(e);
+    } catch (const std::exception&) {
+        return -1;
+    }
+    s.op = FusedOp::kLeaf;
+    bool ok = v.is_data_array() ? AddArrayLeaf(s, v) : AddConstantLeaf(s, v);
+    if (!ok) return -1;
+    steps_.push_back(std::move(s));
+    return static_cast<int>(steps_.size()) - 1;
+}
+
+bool FusedPlan::AddArrayLeaf(Step& s, const Value& v) {
+    if (v.data_shape().kind() != DataKind::kScalar) return false;
+    if (!IsNumeric(v.data_type())) return false;
+
+    s.value = v.canonicalized();
+    Index rows = s.value.rows();
+    if (rows_ >= 0 && rows != rows_) return false;   // row broadcast between arrays
+    rows_ = rows;
+
+    s.dtype = s.value.data_type();
+    s.unit  = s.value.unit();
+    switch (s.dtype) {
+        case DataType::kInteger: {
+            auto flat = s.value.flat_data<int>();
+            s.owner = std::move(flat.owner);
+            s.data  = flat.ptr;
+            break;
+        }
+        case DataType::kReal: {
+            auto flat = s.value.flat_data<double>();
+            s.owner = std::move(flat.owner);
+            s.data  = flat.ptr;
+            break;
+        }
+        default: {
+            auto flat = s.value.flat_data<Complex>();
+            s.owner = std::move(flat.owner);
+            s.data  = flat.ptr;
+            break;
+        }
+    }
+    if (meta_ == nullptr) meta_ = &s.value.as_data_array();
+    return true;
+}
+
+bool FusedPlan::AddConstantLeaf(Step& s, const Value& v) {
+    if (!v.is_measurement() || v.data_shape().kind() != DataKind::kScalar) return false;
+    if (!IsNumeric(v.data_type())) return false;
+
+    s.value    = v.canonicalized();
+    s.constant = true;
+    s.dtype    = s.value.data_type();
+    s.unit     = s.value.unit();
+
+    const Measurement& m = s.value.as_measurement();
+    switch (s.dtype) {
+        case DataType::kInteger:
+            s.ci = m.as_scalar<int>();
+            s.cd = static_cast<double>(s.ci);
+            s.cc = Complex(s.cd, 0.0);
+            break;
+        case DataType::kReal:
+            s.cd = m.as_scalar<double>();
+            s.cc = Complex(s.cd, 0.0);
+            break;
+        default:
+            s.cc = m.as_scalar<Complex>();
+            break;
+    }
+    return true;
+}
+
+/// Typed view of `child` for rows [begin, begin + n), converting into `tmp`
+/// when the child's dtype is narrower than T.
+template <typename T>
+const T* FusedPlan::Fetch(const Step& child, const Scratch& child_result, Index begin, Index n,
+                          std::vector<T>& tmp, bool& constant, T& value) const {
+    constant = child.constant;
+    if (child.constant) {
+        value = ConstantAs<T>(child);
+        return nullptr;
+    }
+
+    const void* src = nullptr;
+    Index offset = 0;
+    if (child.op == FusedOp::kLeaf) {
+        src    = child.data;
+        offset = begin;
+    } else {
+        switch (child.dtype) {
+            case DataType::kInteger: src = child_result.i.data(); break;
+            case DataType::kReal:    src = child_result.d.data(); break;
+            default:                 src = child_result.c.data(); break;
+        }
+    }
+
+    if (child.dtype == DataTypeOf<T>::tag)
+        return static_cast<const T*>(src) + offset;
+
+    tmp.resize(static_cast<std::size_t>(n));
+    switch (child.dtype) {
+        case DataType::kInteger:
+            Promotion<int, T>::Run(static_cast<const int*>(src) + offset, n, tmp.data());
+            break;
+        case DataType::kReal:
+            Promotion<double, T>::Run(static_cast<const double*>(src) + offset, n, tmp.data());
+            break;
+        default:
+            Promotion<Complex, T>::Run(static_cast<const Complex*>(src) + offset, n, tmp.data());
+            break;
+    }
+    return tmp.data();
+}
+
+template <typename T, typename Op>
+void ApplyBinary(const T* l, bool l_const, T l_value,
+                 const T* r, bool r_const, T r_value,
+                 T* out, Index n, Op elem_op) {
+    if (l_const)
+        ElementwiseKernelScalarLeft(l_value, r, out, n, elem_op);
+    else if (r_const)
+        ElementwiseKernelScalarRight(l, r_value, out, n, elem_op);
+    else
+        ElementwiseKernel(l, r, out, n, elem_op);
+}
+
+template <typename T>
+void FusedPlan::RunStep(const Step& s, Workspace& ws, Index begin, Index n, T* out) const {
+    bool l_const = false;
+    T    l_value = T();
+    const T* l = Fetch<T>(steps_[s.lhs], ws.results[s.lhs], begin, n, Get<T>(ws.lhs_tmp),
+                          l_const, l_value);
+
+    if (s.op == FusedOp::kNegate) {
+        // Constant operands were folded into leaves, so l is never constant here.
+        ElementwiseKernel(l, out, n, NegateFn());
+        return;
+    }
+
+    bool r_const = false;
+    T    r_value = T();
+    const T* r = Fetch<T>(steps_[s.rhs], ws.results[s.rhs], begin, n, Get<T>(ws.rhs_tmp),
+                          r_const, r_value);
+
+    switch (s.op) {
+        case FusedOp::kAdd: ApplyBinary(l, l_const, l_value, r, r_const, r_value, out, n, AddFn()); break;
+        case FusedOp::kSub: ApplyBinary(l, l_const, l_value, r, r_const, r_value, out, n, SubFn()); break;
+        case FusedOp::kMul: ApplyBinary(l, l_const, l_value, r, r_const, r_value, out, n, MulFn()); break;
+        case FusedOp::kDiv: ApplyBinary(l, l_const, l_value, r, r_const, r_value, out, n, DivFn()); break;
+        default: throw std::logic_error("OperateFused: unexpected operator");
+    }
+}
+
+void FusedPlan::RunStep(std::size_t k, Workspace& ws, Index begin, Index n, void* out) const {
+    const Step& s = steps_[k];
+    switch (s.dtype) {
+        case DataType::kInteger: RunStep<int>(s, ws, begin, n, static_cast<int*>(out)); break;
+        case DataType::kReal:    RunStep<double>(s, ws, begin, n, static_cast<double*>(out)); break;
+        default:                 RunStep<Complex>(s, ws, begin, n, static_cast<Complex*>(out)); break;
+    }
+}
+
+void FusedPlan::RunRange(Index begin, Index end, char* out_base, std::size_t out_elem) const {
+    Workspace ws;
+    ws.results.resize(steps_.size());
+    const std::size_t chunk = static_cast<std::size_t>(std::min(kChunkRows, end - begin));
+    for (std::size_t k = 0; k + 1 < steps_.size(); ++k) {
+        if (steps_[k].op == FusedOp::kLeaf) continue;
+        switch (steps_[k].dtype) {
+            case DataType::kInteger: ws.results[k].i.resize(chunk); break;
+            case DataType::kReal:    ws.results[k].d.resize(chunk); break;
+            default:                 ws.results[k].c.resize(chunk); break;
+        }
+    }
+
+    for (Index pass = begin; pass < end; pass += kChunkRows) {
+        Index n = std::min(kChunkRows, end - pass);
+        for (std::size_t k = 0; k < steps_.size(); ++k) {
+            const Step& s = steps_[k];
+            if (s.op == FusedOp::kLeaf) continue;
+
+            void* out = nullptr;
+            if (k + 1 == steps_.size()) {
+                out = out_base + static_cast<std::size_t>(pass) * out_elem;
+            } else {
+                switch (s.dtype) {
+                    case DataType::kInteger: out = ws.results[k].i.data(); break;
+                    case DataType::kReal:    out = ws.results[k].d.data(); break;
+                    default:                 out = ws.results[k].c.data(); break;
+                }
+            }
+            RunStep(k, ws, pass, n, out);
+        }
+    }
+}
+
+Value FusedPlan::Run() {
+    Step& root = steps_.back();
+
+    auto out_ds = std::unique_ptr<DataSeries>(new DataSeries(root.dtype, DataShape::Scalar()));
+    out_ds->set_unit(root.unit);
+    out_ds->resize(static_cast<std::size_t>(rows_));
+
+    char* out_base = nullptr;
+    std::size_t out_elem = 0;
+    switch (root.dtype) {
+        case DataType::kInteger:
+            out_base = reinterpret_cast<char*>(out_ds->mutable_contiguous_data<int>());
+            out_elem = sizeof(int);
+            break;
+        case DataType::kReal:
+            out_base = reinterpret_cast<char*>(out_ds->mutable_contiguous_data<double>());
+            out_elem = sizeof(double);
+            break;
+        default:
+            out_base = reinterpret_cast<char*>(out_ds->mutable_contiguous_data<Complex>());
+            out_elem = sizeof(Complex);
+            break;
+    }
+
+    // Every range writes its own rows of the output and reads the leaves in
+    // place, so ranges share nothing but the read-only steps.
+    ParallelRanges(rows_, 1, [&](Index begin, Index end) {
+        RunRange(begin, end, out_base, out_elem);
+    });
+
+    auto da = std::make_shared<DataArray>(meta_->clone());
+    da->set_data(std::move(*out_ds));
+    return Value(da);
+}
+
+}  // namespace
+
+// =========================================================================
+//  OperateFused
+// =========================================================================
+
+Value OperateFused(const FusedExpr& expr) {
+    if (expr.op != FusedOp::kLeaf && HasArrayLeaf(expr)) {
+        FusedPlan plan;
+        if (plan.Build(expr))
+            return plan.Run();
+    }
+    return EvaluateUnfused(expr);
+}
+
+}  // namespace operation
+}  // namespace rel
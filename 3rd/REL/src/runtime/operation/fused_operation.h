@@ -0,0 +1,70 @@
+#ifndef REL_OPERATION_FUSED_OPERATION_H
+#define REL_OPERATION_FUSED_OPERATION_H
+
+#include "rel_api.h"
+#include "value.h"
+
+#include <memory>
+#include <utility>
+
+namespace rel {
+namespace operation {
+
+// =========================================================================
+//  FusedExpr -- element-wise arithmetic tree over evaluated operands
+// =========================================================================
+//
+//  Built by the evaluator for operator chains such as `a*b + c*d - e`.
+//  Leaves hold operand Values that have already been evaluated (in source
+//  order); inner nodes are the element-wise operators below.
+
+struct FusedExpr {
+    enum class Op { kLeaf, kAdd, kSub, kMul, kDiv, kNegate };
+
+    Op                         op = Op::kLeaf;
+    Value                      leaf;   // kLeaf only
+    std::unique_ptr<FusedExpr> lhs;    // also the operand of kNegate
+    std::unique_ptr<FusedExpr> rhs;
+
+    static std::unique_ptr<FusedExpr> Leaf(Value v) {
+        std::unique_ptr<FusedExpr> e(new FusedExpr());
+        e->leaf = std::move(v);
+        return e;
+    }
+
+    static std::unique_ptr<FusedExpr> Binary(Op op,
+                                             std::unique_ptr<FusedExpr> lhs,
+                                             std::unique_ptr<FusedExpr> rhs) {
+        std::unique_ptr<FusedExpr> e(new FusedExpr());
+        e->op  = op;
+        e->lhs = std::move(lhs);
+        e->rhs = std::move(rhs);
+        return e;
+    }
+
+    static std::unique_ptr<FusedExpr> Unary(Op op, std::unique_ptr<FusedExpr> operand) {
+        std::unique_ptr<FusedExpr> e(new FusedExpr());
+        e->op  = op;
+        e->lhs = std::move(operand);
+        return e;
+    }
+};
+
+// =========================================================================
+//  OperateFused
+// =========================================================================
+//
+//  Evaluates the tree in one pass over the rows: intermediates live in
+//  small per-chunk scratch buffers and only the root writes a DataSeries.
+//  Sub-trees without a DataArray operand are evaluated up front through
+//  the ordinary Operation* calls.  Trees the fused loop cannot reproduce
+//  exactly (non-scalar cells, row broadcast between arrays, non-numeric
+//  data, unit mismatch, ...) are evaluated node by node the same way, so
+//  the result -- and any error -- always matches unfused evaluation.
+
+REL_API Value OperateFused(const FusedExpr& expr);
+
+}  // namespace operation
+}  // namespace rel
+
+#endif  // REL_OPERATION_FUSED_OPERATION_H
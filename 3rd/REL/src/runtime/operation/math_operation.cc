@@ -189,23 +189,26 @@ namespace rel
             }
 
             // --- dbm / W unit derives ---------------------------------------------
+            // Reference units are parsed once, not per operation.
             static inline Unit DeriveUnitDbmtow(const std::vector<Unit>& units)
             {
+                static const Unit watt = Unit::parse("W");
                 if (units[0].has_dimension())
                     throw std::invalid_argument("input must be dimensionless");
-                return Unit::parse("W");
+                return watt;
             }
             static inline Unit DeriveUnitWtodbm(const std::vector<Unit>& units)
             {
-                if (!units[0].has_dimension() || !units[0].same_dimension(Unit::parse("W")))
+                static const Unit watt = Unit::parse("W");
+                if (!units[0].has_dimension() || !units[0].same_dimension(watt))
                     throw std::invalid_argument("input unit must be W");
                 return Unit();
             }
             static inline Unit DeriveUnitDb(const std::vector<Unit>& units)
             {
+                static const Unit ohm = Unit::parse("Ohm");
                 if (units[0].has_dimension())
                     throw std::invalid_argument("r must be dimensionless");
-                Unit ohm = Unit::parse("Ohm");
                 for (size_t i = 1; i < units.size(); ++i)
                 {
                     if (units[i].has_dimension() && !units[i].same_dimension(ohm))
@@ -218,8 +221,8 @@ namespace rel
             }
             static inline Unit DeriveUnitDbm(const std::vector<Unit>& units)
             {
-                Unit volt = Unit::parse("V");
-                Unit ohm = Unit::parse("Ohm");
+                static const Unit volt = Unit::parse("V");
+                static const Unit ohm = Unit::parse("Ohm");
                 if (units[0].has_dimension() && !units[0].same_dimension(volt))
                     throw std::invalid_argument("v must be dimensionless or in V");
                 if (units[1].has_dimension() && !units[1].same_dimension(ohm))
@@ -601,19 +604,21 @@ namespace rel
             double* out = out_ds->mutable_contiguous_data<double>();
 
             Index os = sp.result_elements;
-            for (Index i = 0; i < info.rows; ++i)
-            {
-                Index v_off = (rp.broadcast[0] ? 0 : i) * v_stride;
-                Index z1_off = (rp.broadcast[1] ? 0 : i) * z1_stride;
-                Index z2_off = (rp.broadcast[2] ? 0 : i) * z2_stride;
-                Index o_off = i * os;
-                for (Index j = 0; j < os; ++j)
+            ParallelRanges(info.rows, os, [&](Index begin, Index end) {
+                for (Index i = begin; i < end; ++i)
                 {
-                    out[o_off + j] = op_db(std::abs(v_ptr[v_off + sp.MapFlatIndex(j, 0)]),
-                                           z1_ptr[z1_off + sp.MapFlatIndex(j, 1)],
-                                           z2_ptr[z2_off + sp.MapFlatIndex(j, 2)]);
+                    Index v_off = (rp.broadcast[0] ? 0 : i) * v_stride;
+                    Index z1_off = (rp.broadcast[1] ? 0 : i) * z1_stride;
+                    Index z2_off = (rp.broadcast[2] ? 0 : i) * z2_stride;
+                    Index o_off = i * os;
+                    for (Index j = 0; j < os; ++j)
+                    {
+                        out[o_off + j] = op_db(std::abs(v_ptr[v_off + sp.MapFlatIndex(j, 0)]),
+                                               z1_ptr[z1_off + sp.MapFlatIndex(j, 1)],
+                                               z2_ptr[z2_off + sp.MapFlatIndex(j, 2)]);
+                    }
                 }
-            }
+            });
             if (ops[0].is_measurement() && ops[1].is_measurement() && ops[2].is_measurement())
                 return Value(out_ds->measurement_at(0));
             const DataArray* src = &ops[0].as_data_array();
@@ -640,17 +645,19 @@ namespace rel
             double* out = out_ds->mutable_contiguous_data<double>();
 
             Index os = sp.result_elements;
-            for (Index i = 0; i < info.rows; ++i)
-            {
-                Index lo = (rp.broadcast[0] ? 0 : i) * ls;
-                Index ro = (rp.broadcast[1] ? 0 : i) * rs;
-                Index oo = i * os;
-                for (Index j = 0; j < os; ++j)
+            ParallelRanges(info.rows, os, [&](Index begin, Index end) {
+                for (Index i = begin; i < end; ++i)
                 {
-                    out[oo + j] = op_dbm(std::abs(l_ptr[lo + sp.MapFlatIndex(j, 0)]),
-                                         r_ptr[ro + sp.MapFlatIndex(j, 1)]);
+                    Index lo = (rp.broadcast[0] ? 0 : i) * ls;
+                    Index ro = (rp.broadcast[1] ? 0 : i) * rs;
+                    Index oo = i * os;
+                    for (Index j = 0; j < os; ++j)
+                    {
+                        out[oo + j] = op_dbm(std::abs(l_ptr[lo + sp.MapFlatIndex(j, 0)]),
+                                             r_ptr[ro + sp.MapFlatIndex(j, 1)]);
+                    }
                 }
-            }
+            });
             if (ops[0].is_measurement() && ops[1].is_measurement())
                 return Value(out_ds->measurement_at(0));
             const DataArray* src = &ops[0].as_data_array();
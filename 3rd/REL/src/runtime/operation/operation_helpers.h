@@ -5,10 +5,15 @@
 //  This is a private header -- NOT part of the public API.  It contains:
 //    - Shared templated execution loops (ExecBinaryLoop, ExecUnaryLoop, ...)
 //    - Shared Derive callbacks (DeriveShapeBroadcast, DeriveDtypePromote, ...)
+//
+//  The loops split large inputs across the shared pool (operation/parallel.h)
+//  when a ParallelScope is active; each chunk runs the serial code on its
+//  own range, so results do not depend on the thread count.
 
 #ifndef REL_OPERATION_HELPERS_H
 #define REL_OPERATION_HELPERS_H
 
+#include "operation/parallel.h"
 #include "operation/pipeline.h"
 #include "data_series.h"
 #include "data_array.h"
@@ -51,12 +56,145 @@ inline xdataset::DataType DeriveDtypeComplexOrReal(const std::vector<xdataset::D
 inline xdataset::Unit DeriveUnitForceDimless(const std::vector<xdataset::Unit>&) { return xdataset::Unit(); }
 inline xdataset::Unit DeriveUnitSquare(const std::vector<xdataset::Unit>& u) { return u[0].pow(2); }
 
+// =========================================================================
+//  Element functors
+// =========================================================================
+//
+//  Wrap a plain element function as a type.  The loops below are templated
+//  on the functor, so each operation gets its own instantiation and the
+//  element body is inlined instead of called through a pointer per element.
+//  Plain function pointers are still accepted by every loop.
+
+template <typename T, typename Out, Out (*Fn)(T, T)>
+struct BinaryElemFn {
+    Out operator()(T a, T b) const { return Fn(a, b); }
+};
+
+template <typename In, typename Out, Out (*Fn)(In)>
+struct UnaryElemFn {
+    Out operator()(In a) const { return Fn(a); }
+};
+
+// =========================================================================
+//  Contiguous kernels
+// =========================================================================
+//
+//  Tight loops over n consecutive elements with no index mapping, written
+//  so the compiler can vectorise them once elem_op is inlined.
+
+template <typename T, typename Out, typename Op>
+inline void ElementwiseKernel(const T* l, const T* r, Out* out,
+                              xdataset::Index n, Op elem_op)
+{
+    for (xdataset::Index i = 0; i < n; ++i)
+        out[i] = elem_op(l[i], r[i]);
+}
+
+template <typename T, typename Out, typename Op>
+inline void ElementwiseKernelScalarRight(const T* l, T r, Out* out,
+                                         xdataset::Index n, Op elem_op)
+{
+    for (xdataset::Index i = 0; i < n; ++i)
+        out[i] = elem_op(l[i], r);
+}
+
+template <typename T, typename Out, typename Op>
+inline void ElementwiseKernelScalarLeft(T l, const T* r, Out* out,
+                                        xdataset::Index n, Op elem_op)
+{
+    for (xdataset::Index i = 0; i < n; ++i)
+        out[i] = elem_op(l, r[i]);
+}
+
+template <typename In, typename Out, typename Op>
+inline void ElementwiseKernel(const In* in, Out* out, xdataset::Index n, Op op)
+{
+    for (xdataset::Index i = 0; i < n; ++i)
+        out[i] = op(in[i]);
+}
+
+/// True when operand k maps result cell j to its own cell j (same shape,
+/// no cell-level broadcast).
+inline bool IsIdentityShape(const ShapeBroadcastPlan& shape_plan, int k)
+{
+    const OperandBroadcastShapeInfo& op = shape_plan.ops[static_cast<size_t>(k)];
+    return op.elements == shape_plan.result_elements && !op.broadcast_row && !op.broadcast_col;
+}
+
 // =========================================================================
 //  ExecBinaryLoop -- core flat-buffer loop for binary ops
 // =========================================================================
 //
-//  Row-level and cell-level broadcast are driven by the two plans.
+//  Row-level and cell-level broadcast are driven by the two plans.  The
+//  common layouts are dispatched to the contiguous kernels above:
+//    - both operands have the result's layout      -> one flat loop
+//    - one operand is a single value for all rows  -> flat loop + constant
+//    - same cell shape, one operand row-broadcast  -> contiguous loop per row
+//  Everything else goes through MapFlatIndex per element.
+
+template <typename T, typename Out, typename Op>
+inline void ExecBinaryLoop(xdataset::Index rows,
+                            const RowBroadcastPlan& row_plan,
+                            const ShapeBroadcastPlan& shape_plan,
+                            const T* l_ptr, xdataset::Index l_stride,
+                            const T* r_ptr, xdataset::Index r_stride,
+                            Out* out,
+                            Op elem_op)
+{
+    const xdataset::Index out_stride = shape_plan.result_elements;
+    const bool l_row_bc = rows > 1 && row_plan.broadcast[0];
+    const bool r_row_bc = rows > 1 && row_plan.broadcast[1];
+    const bool l_same = IsIdentityShape(shape_plan, 0);
+    const bool r_same = IsIdentityShape(shape_plan, 1);
+    const bool l_single = shape_plan.ops[0].elements == 1 && (l_row_bc || rows == 1);
+    const bool r_single = shape_plan.ops[1].elements == 1 && (r_row_bc || rows == 1);
+    const bool l_flat = l_same && !l_row_bc && l_stride == out_stride;
+    const bool r_flat = r_same && !r_row_bc && r_stride == out_stride;
+    const xdataset::Index total = rows * out_stride;
+
+    if (l_flat && r_flat) {
+        ParallelRanges(total, 1, [&](xdataset::Index b, xdataset::Index e) {
+            ElementwiseKernel(l_ptr + b, r_ptr + b, out + b, e - b, elem_op);
+        });
+        return;
+    }
+    if (l_flat && r_single) {
+        ParallelRanges(total, 1, [&](xdataset::Index b, xdataset::Index e) {
+            ElementwiseKernelScalarRight(l_ptr + b, r_ptr[0], out + b, e - b, elem_op);
+        });
+        return;
+    }
+    if (l_single && r_flat) {
+        ParallelRanges(total, 1, [&](xdataset::Index b, xdataset::Index e) {
+            ElementwiseKernelScalarLeft(l_ptr[0], r_ptr + b, out + b, e - b, elem_op);
+        });
+        return;
+    }
 
+    ParallelRanges(rows, out_stride, [&](xdataset::Index begin, xdataset::Index end) {
+        for (xdataset::Index i = begin; i < end; ++i) {
+            xdataset::Index l_row_off = (row_plan.broadcast[0] ? 0 : i) * l_stride;
+            xdataset::Index r_row_off = (row_plan.broadcast[1] ? 0 : i) * r_stride;
+            xdataset::Index o_off     = i * out_stride;
+
+            if (l_same && r_same) {
+                ElementwiseKernel(l_ptr + l_row_off, r_ptr + r_row_off, out + o_off,
+                                  out_stride, elem_op);
+                continue;
+            }
+
+            for (xdataset::Index j = 0; j < shape_plan.result_elements; ++j) {
+                xdataset::Index lj = shape_plan.MapFlatIndex(j, 0);
+                xdataset::Index rj = shape_plan.MapFlatIndex(j, 1);
+                out[o_off + j] = elem_op(
+                    l_ptr[l_row_off + lj],
+                    r_ptr[r_row_off + rj]);
+            }
+        }
+    });
+}
+
+/// Overload kept for call sites that name only the element types.
 template <typename T, typename Out = T>
 inline void ExecBinaryLoop(xdataset::Index rows,
                             const RowBroadcastPlan& row_plan,
@@ -66,44 +204,40 @@ inline void ExecBinaryLoop(xdataset::Index rows,
                             Out* out,
                             Out (*elem_op)(T, T))
 {
-    xdataset::Index out_stride = shape_plan.result_elements;
-
-    for (xdataset::Index i = 0; i < rows; ++i) {
-        xdataset::Index l_row_off = (row_plan.broadcast[0] ? 0 : i) * l_stride;
-        xdataset::Index r_row_off = (row_plan.broadcast[1] ? 0 : i) * r_stride;
-        xdataset::Index o_off     = i * out_stride;
-
-        for (xdataset::Index j = 0; j < shape_plan.result_elements; ++j) {
-            xdataset::Index lj = shape_plan.MapFlatIndex(j, 0);
-            xdataset::Index rj = shape_plan.MapFlatIndex(j, 1);
-            out[o_off + j] = elem_op(
-                l_ptr[l_row_off + lj],
-                r_ptr[r_row_off + rj]);
-        }
-    }
+    ExecBinaryLoop<T, Out, Out (*)(T, T)>(rows, row_plan, shape_plan, l_ptr, l_stride,
+                                          r_ptr, r_stride, out, elem_op);
 }
 
 // =========================================================================
 //  ExecUnaryLoop -- core flat-buffer loop for single operand
 // =========================================================================
 
-template <typename T>
+template <typename In, typename Out, typename Op>
 inline void ExecUnaryLoop(xdataset::Index rows,
                            const ShapeBroadcastPlan& shape_plan,
-                           const T* ptr, xdataset::Index stride,
-                           T* out,
-                           UnaryOp<T> op)
+                           const In* ptr, xdataset::Index stride,
+                           Out* out,
+                           Op op)
 {
     xdataset::Index out_stride = shape_plan.result_elements;
 
-    for (xdataset::Index i = 0; i < rows; ++i) {
-        xdataset::Index i_off = i * stride;
-        xdataset::Index o_off = i * out_stride;
+    if (stride == out_stride) {
+        ParallelRanges(rows * out_stride, 1, [&](xdataset::Index b, xdataset::Index e) {
+            ElementwiseKernel(ptr + b, out + b, e - b, op);
+        });
+        return;
+    }
+
+    ParallelRanges(rows, out_stride, [&](xdataset::Index begin, xdataset::Index end) {
+        for (xdataset::Index i = begin; i < end; ++i) {
+            xdataset::Index i_off = i * stride;
+            xdataset::Index o_off = i * out_stride;
 
-        for (xdataset::Index j = 0; j < shape_plan.result_elements; ++j) {
-            out[o_off + j] = op(ptr[i_off + j]);
+            for (xdataset::Index j = 0; j < shape_plan.result_elements; ++j) {
+                out[o_off + j] = op(ptr[i_off + j]);
+            }
         }
-    }
+    });
 }
 
 // =========================================================================
@@ -123,10 +257,10 @@ inline const xdataset::DataArray* SelectOutputSource(bool l_meas, bool r_meas,
     return nullptr;
 }
 
-template <typename T>
+template <typename T, typename Op = ElemOp<T>>
 inline Value ExecBinaryArithT(const ExecContextInfo& info,
                                const std::vector<Value>& ops,
-                               ElemOp<T> elem_op)
+                               Op elem_op)
 {
     bool l_meas = ops[0].is_measurement();
     bool r_meas = ops[1].is_measurement();
@@ -157,8 +291,8 @@ inline Value ExecBinaryArithT(const ExecContextInfo& info,
     out_ds->resize(static_cast<std::size_t>(info.rows));
     T* out = out_ds->mutable_contiguous_data<T>();
 
-    ExecBinaryLoop(info.rows, row_plan, shape_plan,
-                   l_ptr, l_stride, r_ptr, r_stride, out, elem_op);
+    ExecBinaryLoop<T, T, Op>(info.rows, row_plan, shape_plan,
+                             l_ptr, l_stride, r_ptr, r_stride, out, elem_op);
 
     if (l_meas && r_meas) {
         return Value(out_ds->measurement_at(0));
@@ -173,10 +307,10 @@ inline Value ExecBinaryArithT(const ExecContextInfo& info,
 //  ExecUnaryT -- unary entry point (reuses flat_data, output helpers)
 // =========================================================================
 
-template <typename T>
+template <typename T, typename Op = UnaryOp<T>>
 inline Value ExecUnaryT(const ExecContextInfo& info,
                          const std::vector<Value>& ops,
-                         UnaryOp<T> op)
+                         Op op)
 {
     bool is_meas = ops[0].is_measurement();
 
@@ -193,7 +327,7 @@ inline Value ExecUnaryT(const ExecContextInfo& info,
     out_ds->resize(static_cast<std::size_t>(info.rows));
     T* out = out_ds->mutable_contiguous_data<T>();
 
-    ExecUnaryLoop(info.rows, shape_plan, ptr, stride, out, op);
+    ExecUnaryLoop<T, T, Op>(info.rows, shape_plan, ptr, stride, out, op);
 
     if (is_meas) {
         return Value(out_ds->measurement_at(0));
@@ -230,13 +364,7 @@ inline Value ExecUnaryCT(const ExecContextInfo& info,
     out_ds->resize(static_cast<std::size_t>(info.rows));
     Out* out = out_ds->mutable_contiguous_data<Out>();
 
-    xdataset::Index out_stride = shape_plan.result_elements;
-    for (xdataset::Index i = 0; i < info.rows; ++i) {
-        xdataset::Index i_off = i * stride;
-        xdataset::Index o_off = i * out_stride;
-        for (xdataset::Index j = 0; j < shape_plan.result_elements; ++j)
-            out[o_off + j] = op(ptr[i_off + j]);
-    }
+    ExecUnaryLoop<In, Out, Out (*)(In)>(info.rows, shape_plan, ptr, stride, out, op);
 
     if (is_meas) {
         return Value(out_ds->measurement_at(0));
@@ -535,6 +535,14 @@ namespace rel
                 return ~a;
             }
 
+            // Functor forms of the element ops above, so the hot loops inline them
+            template <typename T, T (*Fn)(T, T)>
+            using ArithFn = BinaryElemFn<T, T, Fn>;
+            template <typename T, int (*Fn)(T, T)>
+            using CmpFn = BinaryElemFn<T, int, Fn>;
+            template <typename T, T (*Fn)(T)>
+            using UnaryFn = UnaryElemFn<T, T, Fn>;
+
         } // anonymous namespace
 
         // =========================================================================
@@ -547,9 +555,11 @@ namespace rel
             {
                 case DataType::kComplex:
                     return ExecBinaryArithT<std::complex<double>>(
-                        info, ops, op_add<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryArithT<double>(info, ops, op_add<double>);
-                case DataType::kInteger: return ExecBinaryArithT<int>(info, ops, op_add<int>);
+                        info, ops, ArithFn<std::complex<double>, op_add<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryArithT<double>(info, ops, ArithFn<double, op_add<double>>());
+                case DataType::kInteger:
+                    return ExecBinaryArithT<int>(info, ops, ArithFn<int, op_add<int>>());
                 default: throw std::invalid_argument("unsupported dtype");
             }
         }
@@ -560,9 +570,11 @@ namespace rel
             {
                 case DataType::kComplex:
                     return ExecBinaryArithT<std::complex<double>>(
-                        info, ops, op_sub<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryArithT<double>(info, ops, op_sub<double>);
-                case DataType::kInteger: return ExecBinaryArithT<int>(info, ops, op_sub<int>);
+                        info, ops, ArithFn<std::complex<double>, op_sub<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryArithT<double>(info, ops, ArithFn<double, op_sub<double>>());
+                case DataType::kInteger:
+                    return ExecBinaryArithT<int>(info, ops, ArithFn<int, op_sub<int>>());
                 default: throw std::invalid_argument("unsupported dtype");
             }
         }
@@ -573,9 +585,11 @@ namespace rel
             {
                 case DataType::kComplex:
                     return ExecBinaryArithT<std::complex<double>>(
-                        info, ops, op_mul<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryArithT<double>(info, ops, op_mul<double>);
-                case DataType::kInteger: return ExecBinaryArithT<int>(info, ops, op_mul<int>);
+                        info, ops, ArithFn<std::complex<double>, op_mul<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryArithT<double>(info, ops, ArithFn<double, op_mul<double>>());
+                case DataType::kInteger:
+                    return ExecBinaryArithT<int>(info, ops, ArithFn<int, op_mul<int>>());
                 default: throw std::invalid_argument("unsupported dtype");
             }
         }
@@ -586,8 +600,9 @@ namespace rel
             {
                 case DataType::kComplex:
                     return ExecBinaryArithT<std::complex<double>>(
-                        info, ops, op_div<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryArithT<double>(info, ops, op_div<double>);
+                        info, ops, ArithFn<std::complex<double>, op_div<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryArithT<double>(info, ops, ArithFn<double, op_div<double>>());
                 default: throw std::invalid_argument("unsupported dtype");
             }
         }
@@ -660,10 +675,8 @@ namespace rel
         //  ExecBinaryCmpT -- compare at type T, output int 0/1
         // =========================================================================
 
-        template <typename T>
-        Value ExecBinaryCmpT(const ExecContextInfo& info,
-                             const std::vector<Value>& ops,
-                             int (*elem_op)(T, T))
+        template <typename T, typename Op>
+        Value ExecBinaryCmpT(const ExecContextInfo& info, const std::vector<Value>& ops, Op elem_op)
         {
             bool l_meas = ops[0].is_measurement();
             bool r_meas = ops[1].is_measurement();
@@ -696,7 +709,7 @@ namespace rel
 
             Index out_stride = shape_plan.result_elements;
 
-            ExecBinaryLoop<T, int>(
+            ExecBinaryLoop<T, int, Op>(
                 info.rows, row_plan, shape_plan, l_ptr, l_stride, r_ptr, r_stride, out, elem_op);
 
             if (l_meas && r_meas)
@@ -859,9 +872,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_eq);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_eq<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_eq<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_eq<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_eq<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_eq<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_eq<int>>());
             }
         }
 
@@ -876,9 +890,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_ne);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_ne<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_ne<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_ne<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_ne<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_ne<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_ne<int>>());
             }
         }
 
@@ -893,9 +908,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_lt);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_lt<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_lt<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_lt<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_lt<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_lt<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_lt<int>>());
             }
         }
 
@@ -910,9 +926,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_gt);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_gt<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_gt<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_gt<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_gt<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_gt<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_gt<int>>());
             }
         }
 
@@ -927,9 +944,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_le);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_le<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_le<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_le<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_le<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_le<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_le<int>>());
             }
         }
 
@@ -944,9 +962,10 @@ namespace rel
                     return ExecBinaryCmpString(info, ops, str_cmp_ge);
                 case DataType::kComplex:
                     return ExecBinaryCmpT<std::complex<double>>(
-                        info, ops, op_cmp_ge<std::complex<double>>);
-                case DataType::kReal: return ExecBinaryCmpT<double>(info, ops, op_cmp_ge<double>);
-                default: return ExecBinaryCmpT<int>(info, ops, op_cmp_ge<int>);
+                        info, ops, CmpFn<std::complex<double>, op_cmp_ge<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecBinaryCmpT<double>(info, ops, CmpFn<double, op_cmp_ge<double>>());
+                default: return ExecBinaryCmpT<int>(info, ops, CmpFn<int, op_cmp_ge<int>>());
             }
         }
 
@@ -1469,9 +1488,14 @@ namespace rel
             switch (info.dtype)
             {
                 case DataType::kComplex:
-                    return ExecUnaryT<std::complex<double>>(info, ops, op_negate);
-                case DataType::kReal: return ExecUnaryT<double>(info, ops, op_negate);
-                case DataType::kInteger: return ExecUnaryT<int>(info, ops, op_negate);
+                    return ExecUnaryT<std::complex<double>>(
+                        info,
+                        ops,
+                        UnaryFn<std::complex<double>, op_negate<std::complex<double>>>());
+                case DataType::kReal:
+                    return ExecUnaryT<double>(info, ops, UnaryFn<double, op_negate<double>>());
+                case DataType::kInteger:
+                    return ExecUnaryT<int>(info, ops, UnaryFn<int, op_negate<int>>());
                 default: throw std::invalid_argument("unsupported dtype");
             }
         }
@@ -1674,10 +1698,14 @@ namespace rel
                 {
                     case DataType::kComplex:
                         return ExecBinaryArithT<std::complex<double>>(
-                            info, ops, op_mul<std::complex<double>>);
+                            info,
+                            ops,
+                            ArithFn<std::complex<double>, op_mul<std::complex<double>>>());
                     case DataType::kReal:
-                        return ExecBinaryArithT<double>(info, ops, op_mul<double>);
-                    case DataType::kInteger: return ExecBinaryArithT<int>(info, ops, op_mul<int>);
+                        return ExecBinaryArithT<double>(
+                            info, ops, ArithFn<double, op_mul<double>>());
+                    case DataType::kInteger:
+                        return ExecBinaryArithT<int>(info, ops, ArithFn<int, op_mul<int>>());
                     default: throw std::invalid_argument("unsupported dtype");
                 }
             }
@@ -1735,10 +1763,14 @@ namespace rel
                 {
                     case DataType::kComplex:
                         return ExecBinaryArithT<std::complex<double>>(
-                            info, ops, op_div<std::complex<double>>);
+                            info,
+                            ops,
+                            ArithFn<std::complex<double>, op_div<std::complex<double>>>());
                     case DataType::kReal:
-                        return ExecBinaryArithT<double>(info, ops, op_div<double>);
-                    case DataType::kInteger: return ExecBinaryArithT<int>(info, ops, op_div<int>);
+                        return ExecBinaryArithT<double>(
+                            info, ops, ArithFn<double, op_div<double>>());
+                    case DataType::kInteger:
+                        return ExecBinaryArithT<int>(info, ops, ArithFn<int, op_div<int>>());
                     default: throw std::invalid_argument("unsupported dtype");
                 }
             }
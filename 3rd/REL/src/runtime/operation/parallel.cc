@@ -0,0 +1,207 @@
+// =============================================================================
+//  REL -- Shared worker pool and chunked ranges for element-wise kernels
+// =============================================================================
+
+#include "operation/parallel.h"
+
+#include "environment.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rel {
+namespace operation {
+
+using xdataset::Index;
+
+namespace {
+
+/// Innermost active scope of this thread (null: serial).
+thread_local const ParallelScope* t_scope = nullptr;
+
+/// True on pool workers and inside a SerialEvalScope; ranges run serially
+/// there.
+thread_local bool t_in_worker = false;
+
+std::size_t HardwareThreads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<std::size_t>(n);
+}
+
+// =========================================================================
+//  Pool -- one per process
+// =========================================================================
+//
+//  Grows to the largest worker count any scope has asked for (by default
+//  hardware_concurrency() - 1, the caller being the last thread) and never
+//  shrinks.  Never destroyed either: workers may still be parked in wait()
+//  during static destruction, so the pool is leaked on purpose rather than
+//  joined from an exit-time destructor.
+
+class Pool
+{
+public:
+    static Pool& Instance()
+    {
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+
+    /// Start workers until there are at least `workers` of them.
+    void Reserve(std::size_t workers)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (workers_ < workers)
+        {
+            std::thread([this] { WorkerLoop(); }).detach();
+            ++workers_;
+        }
+    }
+
+    /// Run task(0) .. task(n - 1); task(0) on the caller, the rest on the
+    /// workers.  Returns once all of them have finished.
+    void Run(std::size_t n, const std::function<void(std::size_t)>& task)
+    {
+        std::size_t remaining = n - 1;
+        std::mutex done_mutex;
+        std::condition_variable done;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::size_t k = 1; k < n; ++k)
+            {
+                queue_.push_back([&, k] {
+                    task(k);
+                    std::lock_guard<std::mutex> done_lock(done_mutex);
+                    if (--remaining == 0)
+                        done.notify_one();
+                });
+            }
+        }
+        wake_.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&remaining] { return remaining == 0; });
+    }
+
+private:
+    Pool() = default;
+
+    void WorkerLoop()
+    {
+        t_in_worker = true;
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return !queue_.empty(); });
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::size_t                        workers_ = 0;
+    std::mutex                         mutex_;   // guards workers_, queue_
+    std::condition_variable            wake_;
+    std::deque<std::function<void()>>  queue_;
+};
+
+}  // namespace
+
+// =========================================================================
+//  ParallelScope
+// =========================================================================
+
+ParallelScope::ParallelScope(std::size_t threads, std::size_t min_elements)
+    : saved_(t_scope)
+    , threads_(threads == 0 ? HardwareThreads() : threads)
+    , min_elements_(min_elements)
+{
+    t_scope = this;
+}
+
+ParallelScope::~ParallelScope()
+{
+    t_scope = saved_;
+}
+
+// =========================================================================
+//  Chunking
+// =========================================================================
+
+std::size_t PlanChunks(Index count, Index cost)
+{
+    const ParallelScope* scope = t_scope;
+    if (!scope || scope->threads_ <= 1 || t_in_worker || count < 2)
+        return 1;
+
+    const double elements = static_cast<double>(count) * static_cast<double>(std::max<Index>(cost, 1));
+    if (elements < static_cast<double>(scope->min_elements_))
+        return 1;
+
+    return std::min(scope->threads_, static_cast<std::size_t>(count));
+}
+
+void ParallelRanges(Index count,
+                    Index cost,
+                    const std::function<void(Index, Index)>& body)
+{
+    const std::size_t chunks = PlanChunks(count, cost);
+    if (chunks <= 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(chunks);
+    Pool::Instance().Reserve(chunks - 1);
+    Pool::Instance().Run(chunks, [&](std::size_t k) {
+        const Index begin = static_cast<Index>(count * static_cast<Index>(k) / static_cast<Index>(chunks));
+        const Index end   = static_cast<Index>(count * static_cast<Index>(k + 1) / static_cast<Index>(chunks));
+        try
+        {
+            body(begin, end);
+        }
+        catch (...)
+        {
+            errors[k] = std::current_exception();
+        }
+    });
+
+    for (const std::exception_ptr& e : errors)
+    {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
+}  // namespace operation
+
+// =========================================================================
+//  SerialEvalScope
+// =========================================================================
+
+SerialEvalScope::SerialEvalScope(bool enabled)
+    : saved_(operation::t_in_worker)
+{
+    if (enabled)
+        operation::t_in_worker = true;
+}
+
+SerialEvalScope::~SerialEvalScope()
+{
+    operation::t_in_worker = saved_;
+}
+
+}  // namespace rel
@@ -0,0 +1,63 @@
+// =============================================================================
+//  REL -- Intra-operation parallelism for element-wise kernels (private)
+// =============================================================================
+//
+//  Large element-wise operations split their row / element range into
+//  contiguous chunks that run on one process-wide worker pool.  Chunk
+//  boundaries depend only on the range and the thread count, and every
+//  element is computed by the same code as in the serial loop, so results
+//  are bit-for-bit those of a serial run.
+//
+//  Parallelism is off unless a ParallelScope is active on the calling
+//  thread; rel::Eval opens one from Environment::parallel_options().
+//  Calls made from inside a pool worker or a rel::SerialEvalScope always
+//  run serially.
+
+#ifndef REL_OPERATION_PARALLEL_H
+#define REL_OPERATION_PARALLEL_H
+
+#include "xdataset_predefine.h"  // xdataset::Index
+
+#include <cstddef>
+#include <functional>
+
+namespace rel {
+namespace operation {
+
+/// Enables parallel kernels on the current thread for its lifetime.
+/// `threads` counts the calling thread (1 = serial, 0 = hardware
+/// concurrency); an operation touching fewer than `min_elements`
+/// elements stays serial.  Scopes nest; the innermost one wins.
+class ParallelScope
+{
+public:
+    ParallelScope(std::size_t threads, std::size_t min_elements);
+    ~ParallelScope();
+
+    ParallelScope(const ParallelScope&) = delete;
+    ParallelScope& operator=(const ParallelScope&) = delete;
+
+private:
+    const ParallelScope* saved_;
+    std::size_t threads_;
+    std::size_t min_elements_;
+
+    friend std::size_t PlanChunks(xdataset::Index count, xdataset::Index cost);
+};
+
+/// Number of chunks an operation over `count` items of `cost` elements
+/// each is split into under the current scope (1 = run serially).
+std::size_t PlanChunks(xdataset::Index count, xdataset::Index cost);
+
+/// Run body(begin, end) over [0, count) -- serially, or as PlanChunks()
+/// contiguous ranges on the shared pool with the caller taking the first.
+/// An exception from any chunk is rethrown after all chunks finish; with
+/// several, the one from the lowest range wins.
+void ParallelRanges(xdataset::Index count,
+                    xdataset::Index cost,
+                    const std::function<void(xdataset::Index, xdataset::Index)>& body);
+
+}  // namespace operation
+}  // namespace rel
+
+#endif  // REL_OPERATION_PARALLEL_H
@@ -3,6 +3,7 @@
 // =============================================================================
 
 #include "operation/pipeline.h"
+#include "operation/operation_helpers.h"
 #include "data_series.h"
 #include "data_array.h"
 
@@ -124,6 +125,20 @@ Index ShapeBroadcastPlan::MapFlatIndex(Index result_flat, int k) const {
 //  Operate
 // =========================================================================
 
+namespace {
+
+// Unit derivations that map dimensionless operands to a dimensionless
+// result.  Scalar-heavy evaluation is mostly dimensionless-by-dimensionless
+// arithmetic, which then skips unit bookkeeping altogether.
+bool KeepsDimensionless(DeriveUnitFunc derive) {
+    return derive == DeriveUnitPromoteDimension || derive == DeriveUnitMod ||
+           derive == DeriveUnitDimlessRight || derive == DeriveUnitMul ||
+           derive == DeriveUnitDiv || derive == DeriveUnitDimless ||
+           derive == DeriveUnitForceDimless;
+}
+
+}  // namespace
+
 Value Operate(const std::vector<Value>& operands, const OpTraits& traits) {
     if (traits.arity != -1) {
         Index n = static_cast<Index>(operands.size());
@@ -143,20 +158,30 @@ Value Operate(const std::vector<Value>& operands, const OpTraits& traits) {
     std::vector<DataShape> operand_shapes;
     std::vector<Index>     row_counts;
     std::vector<DataType>  dtypes;
-    std::vector<Unit>      units;
+    operand_shapes.reserve(canonical_ops.size());
+    row_counts.reserve(canonical_ops.size());
+    dtypes.reserve(canonical_ops.size());
 
+    bool dimensionless = true;
     for (size_t i = 0; i < canonical_ops.size(); ++i) {
         operand_shapes.push_back(canonical_ops[i].data_shape());
         row_counts.push_back(canonical_ops[i].rows());
         dtypes.push_back(canonical_ops[i].data_type());
-        units.push_back(canonical_ops[i].unit());
+        dimensionless = dimensionless && !canonical_ops[i].unit().has_dimension();
     }
 
     try {
         DataShape shape = traits.derive_shape(operand_shapes);
         Index     rows  = traits.derive_rows(row_counts);
         DataType  dtype = traits.derive_dtype(dtypes);
-        Unit      unit  = traits.derive_unit(units);
+        Unit      unit;
+        if (!dimensionless || !KeepsDimensionless(traits.derive_unit)) {
+            std::vector<Unit> units;
+            units.reserve(canonical_ops.size());
+            for (size_t i = 0; i < canonical_ops.size(); ++i)
+                units.push_back(canonical_ops[i].unit());
+            unit = traits.derive_unit(units);
+        }
 
         ExecContextInfo info;
         info.rows  = rows;
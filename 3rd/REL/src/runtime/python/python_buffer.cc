@@ -0,0 +1,132 @@
+// =============================================================================
+//  python_buffer.cc -- zero-copy buffer adoption (see python_buffer.h)
+// =============================================================================
+
+#include "python_common.h"
+#include "python_buffer.h"
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rel {
+namespace python {
+
+using namespace xdataset;
+
+namespace {
+
+// References released without the GIL, dropped by flush_pending_releases().
+// Shared by all threads (a worker that never takes the GIL again must not
+// strand its references).
+std::mutex g_pending_mutex;
+std::vector<PyObject*> g_pending;
+
+void release_reference(PyObject* obj)
+{
+    // After finalization the object is gone with the interpreter; touching it
+    // would crash, so the reference is simply abandoned.
+    if (!Py_IsInitialized())
+        return;
+    if (PyGILState_Check())
+    {
+        Py_DECREF(obj);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_pending_mutex);
+    g_pending.push_back(obj);
+}
+
+// Owns one memoryview reference.  Held through the series' shared_ptr owner,
+// so copying / destroying the series never needs the GIL.
+struct BufferOwner
+{
+    explicit BufferOwner(PyObject* view) : view(view) {}
+    ~BufferOwner() { release_reference(view); }
+
+    BufferOwner(const BufferOwner&) = delete;
+    BufferOwner& operator=(const BufferOwner&) = delete;
+
+    PyObject* view;
+};
+
+}  // namespace
+
+bool adopt_buffer(PyObject* obj, DataSeries& out)
+{
+    if (PyBytes_Check(obj) || PyByteArray_Check(obj) || !PyObject_CheckBuffer(obj))
+        return false;
+
+    PyObject* memory_view = PyMemoryView_FromObject(obj);
+    if (!memory_view)
+    {
+        PyErr_Clear();
+        return false;
+    }
+    // Takes the reference; on an early return the view is released here
+    // (the GIL is held, so immediately).
+    std::shared_ptr<BufferOwner> owner = std::make_shared<BufferOwner>(memory_view);
+    Py_buffer* view = PyMemoryView_GET_BUFFER(memory_view);
+
+    std::string format = view->format ? view->format : "B";
+    if (!format.empty() && (format[0] == '@' || format[0] == '='))
+        format.erase(0, 1);
+
+    DataType dtype;
+    std::size_t alignment = 0;
+    if (format == "d" && view->itemsize == sizeof(double))
+    {
+        dtype = DataType::kReal;
+        alignment = alignof(double);
+    }
+    else if ((format == "i" || format == "l") && view->itemsize == sizeof(int))
+    {
+        dtype = DataType::kInteger;
+        alignment = alignof(int);
+    }
+    else if (format == "Zd" && view->itemsize == sizeof(std::complex<double>))
+    {
+        dtype = DataType::kComplex;
+        alignment = alignof(std::complex<double>);
+    }
+    else
+    {
+        return false;
+    }
+    if (view->ndim > 3 || !PyBuffer_IsContiguous(view, 'C') ||
+        reinterpret_cast<std::uintptr_t>(view->buf) % alignment != 0)
+        return false;
+
+    const std::size_t rows = view->ndim == 0 ? 1 : static_cast<std::size_t>(view->shape[0]);
+    if (rows == 0)
+        return false;
+
+    DataShape shape = DataShape::Scalar();
+    if (view->ndim == 2)
+        shape = DataShape::Vector(static_cast<Index>(view->shape[1]));
+    else if (view->ndim == 3)
+        shape = DataShape::Matrix(static_cast<Index>(view->shape[1]),
+                                  static_cast<Index>(view->shape[2]));
+
+    out = DataSeries::CreateBorrowed(dtype, shape, view->buf, rows, Unit(), std::move(owner));
+    return true;
+}
+
+void flush_pending_releases()
+{
+    std::vector<PyObject*> pending;
+    {
+        std::lock_guard<std::mutex> lock(g_pending_mutex);
+        pending.swap(g_pending);
+    }
+    // Outside the lock: a DECREF may run arbitrary finalizers that release
+    // further buffers.
+    for (PyObject* obj : pending)
+        Py_DECREF(obj);
+}
+
+}  // namespace python
+}  // namespace rel
@@ -0,0 +1,49 @@
+#pragma once
+
+// =============================================================================
+//  python_buffer.h -- zero-copy import of Python buffers into DataSeries.
+//
+//  Only compiled when BUILD_PYTHON=ON.  Unlike python_common.h this header
+//  does not pull in pybind11 or Python.h, so hosts that embed their own
+//  bindings (xequation's value converter) can share the same adopter as the
+//  plugin bridge.
+//
+//  An adopted series borrows the exporter's memory through a memoryview.
+//  The memoryview reference is released without requiring the GIL: when the
+//  last series copy dies on a thread that does not hold it, the reference is
+//  parked and dropped at the next flush_pending_releases() (run at every GIL
+//  entry point of the bridge).
+// =============================================================================
+
+#include "rel_api.h"
+
+#include "data_series.h"
+
+// CPython forward declaration (no Python.h in this header).
+struct _object;
+typedef _object PyObject;
+
+namespace rel {
+namespace python {
+
+/// Wrap the buffer exported by `obj` as a DataSeries without copying.
+///
+/// Accepts C-contiguous, suitably aligned buffers of double ("d"), C int
+/// ("i", or "l" where long is int-sized) and complex<double> ("Zd") with
+/// ndim 0..3; the first dimension is the row count and the remaining ones
+/// the cell shape (scalar / vector / matrix), so a 0-d buffer is one scalar
+/// row.  bytes / bytearray and empty buffers are not adopted.  While the
+/// series (or a copy) is alive the exporter cannot be resized; in-place
+/// writes on the Python side are visible through the series, and the first
+/// write on the C++ side copies the cells.
+///
+/// Returns false, with no Python error set, when `obj` is not adoptable;
+/// callers fall back to a copy or another conversion.  Requires the GIL.
+REL_API bool adopt_buffer(PyObject* obj, xdataset::DataSeries& out);
+
+/// Drop the memoryview references released on threads that did not hold the
+/// GIL.  Requires the GIL.
+REL_API void flush_pending_releases();
+
+}  // namespace python
+}  // namespace rel
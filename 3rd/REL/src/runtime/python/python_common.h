@@ -5,7 +5,7 @@
 //
 //  This header is only compiled when BUILD_PYTHON=ON (see CMakeLists.txt), so
 //  it may freely include pybind11.  It declares the pieces that are defined
-//  across the four python/*.cc translation units and consumed by each other:
+//  across the python/*.cc translation units and consumed by each other:
 //
 //    - register_xdataset_bindings()  (xdataset_bindings.cc)
 //    - register_rel_bindings()       (rel_bindings.cc)
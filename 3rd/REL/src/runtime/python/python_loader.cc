@@ -17,6 +17,7 @@
 // =============================================================================
 
 #include "python_common.h"
+#include "python_buffer.h"
 
 #include "environment.h"
 
@@ -87,6 +88,7 @@ bool LoadPythonFile(const std::string& path, std::string* error_out)
         return false;
 
     pybind11::gil_scoped_acquire gil;
+    flush_pending_releases();
     ConfigureStdout();
     try
     {
@@ -111,6 +113,7 @@ bool ExecPythonCode(const std::string& code, std::string* error_out)
         return false;
 
     pybind11::gil_scoped_acquire gil;
+    flush_pending_releases();
     ConfigureStdout();
     try
     {
@@ -151,6 +154,9 @@ void CleanupPythonState()
     g_callbacks.clear();
     g_name_to_key.clear();
 
+    // Buffers borrowed by series that died off the GIL (python_buffer.h).
+    flush_pending_releases();
+
     // NOTE: the interpreter itself is NOT finalized here.  Finalization is
     // owned by python_manager (python_manager::PyEnvManager::ShutdownPyEnv),
     // which the host calls AFTER this cleanup.
@@ -170,6 +176,7 @@ NativeFunction make_callback_shim(const std::string& key)
     // never touch Python objects and never need the GIL (PYTHON.md sec.4.1).
     return [key](const Function::ArgMap& args) -> Value {
         pybind11::gil_scoped_acquire gil;  // re-entrant: harmless if already held
+        flush_pending_releases();
 
         auto it = g_callbacks.find(key);
         if (it == g_callbacks.end())
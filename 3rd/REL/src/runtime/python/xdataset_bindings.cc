@@ -9,6 +9,7 @@
 // =============================================================================
 
 #include "python_common.h"
+#include "python_buffer.h"
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -227,16 +228,49 @@ pybind11::buffer_info make_measurement_buffer(const Measurement& m)
 
 // ---- ndarray / list -> DataSeries / Measurement ------------------------
 
+namespace {
+
+bool is_c_contiguous(const pybind11::buffer_info& info)
+{
+    ssize_t expected = info.itemsize;
+    for (ssize_t d = info.ndim - 1; d >= 0; --d)
+    {
+        if (info.shape[d] > 1 && info.strides[d] != expected)
+            return false;
+        expected *= info.shape[d];
+    }
+    return true;
+}
+
+}  // namespace
+
 /// Read a buffer (numpy array, memoryview, ...) into a DataSeries.  The
-/// buffer protocol is the "only entry point" from numpy.
+/// buffer protocol is the "only entry point" from numpy.  C-contiguous
+/// real / integer / complex buffers are borrowed in place (adopt_buffer);
+/// booleans and unaligned buffers are copied.
 DataSeries dataseries_from_buffer(pybind11::handle obj)
 {
     pybind11::buffer buf = pybind11::reinterpret_borrow<pybind11::buffer>(obj);
     pybind11::buffer_info info = buf.request();
 
+    if (!is_c_contiguous(info))
+    {
+        // Strided views (column slices, [::2], ...) are gathered into one
+        // C-contiguous block first; the readers below assume row-major cells.
+        pybind11::object packed = pybind11::reinterpret_steal<pybind11::object>(
+            PyMemoryView_GetContiguous(obj.ptr(), PyBUF_READ, 'C'));
+        if (!packed)
+            throw pybind11::error_already_set();
+        return dataseries_from_buffer(packed);
+    }
+
     const std::string fmt = info.format;
     const ssize_t ndim = info.ndim;
 
+    DataSeries borrowed;
+    if (ndim >= 1 && ndim <= 3 && adopt_buffer(obj.ptr(), borrowed))
+        return borrowed;
+
     auto dispatch = [&](DataKind kind) -> DataSeries
     {
         if (kind == DataKind::kScalar)
@@ -612,6 +646,7 @@ void register_xdataset_bindings(pybind11::module_& m)
         .def_property_readonly("unit", [](const DataSeries& d) { return d.unit(); })
         .def_property_readonly("data_type", [](const DataSeries& d) { return type_str(d.data_type()); })
         .def_property_readonly("data_kind", [](const DataSeries& d) { return kind_str(d.data_kind()); })
+        .def_property_readonly("is_borrowed", &DataSeries::is_borrowed)
         .def("measurement_at", &DataSeries::measurement_at)
         .def("__getitem__", [](const DataSeries& d, Index i) { return d.measurement_at(i); })
         .def("iloc", &DataSeries::iloc)
@@ -843,7 +878,9 @@ void register_xdataset_bindings(pybind11::module_& m)
     pybind11::class_<MultiIndexSelector>(m, "MultiIndexSelector")
         .def_static("Any", &MultiIndexSelector::Any)
         .def_static("Equal", &MultiIndexSelector::Equal)
-        .def_static("In", &MultiIndexSelector::In);
+        .def_static("In", &MultiIndexSelector::In)
+        .def_static("Range", &MultiIndexSelector::Range,
+                    pybind11::arg("start"), pybind11::arg("stop"), pybind11::arg("step") = 1);
 }
 
 }  // namespace python
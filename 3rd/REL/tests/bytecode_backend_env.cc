@@ -0,0 +1,20 @@
+// rel_vm_test: the evaluator suites re-run with Eval(const std::string&, ...)
+// routed through Compile() and the bytecode VM.
+
+#include "rel.h"
+#include "bytecode.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    class BytecodeBackend : public ::testing::Environment
+    {
+    public:
+        void SetUp() override { rel::SetEvalBackend(rel::EvalBackend::kBytecode); }
+        void TearDown() override { rel::SetEvalBackend(rel::EvalBackend::kTreeWalker); }
+    };
+
+    ::testing::Environment* const g_backend =
+        ::testing::AddGlobalTestEnvironment(new BytecodeBackend);
+} // namespace
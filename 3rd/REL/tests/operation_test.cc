@@ -6,9 +6,14 @@
 
 #include "operation/operator.h"
 #include "block_fixtures.h"
+#include "operation/fused_operation.h"
+#include "operation/math_operation.h"
+#include "operation/parallel.h"
+#include "environment.h"
 
 #include <complex>
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -158,6 +163,66 @@ TEST(OperationAddTest, ArrayArrayScalarSameRows)
     EXPECT_DOUBLE_EQ(arr.scalar_at<double>(2), 33.0);
 }
 
+TEST(OperationAddTest, ArrayArrayComplexSameRows)
+{
+    using C = std::complex<double>;
+    auto ds1 = xdataset::DataSeries::CreateScalarFromVector<C>({C(1, 1), C(2, -1), C(0, 3)});
+    auto ds2 = xdataset::DataSeries::CreateScalarFromVector<C>({C(1, 0), C(0, 1), C(-1, -1)});
+    Value result = OperationAdd(
+        Value(xdataset::DataArray::CreateIndependent(std::move(ds1))),
+        Value(xdataset::DataArray::CreateIndependent(std::move(ds2))));
+    ASSERT_TRUE(result.is_data_array());
+    const auto& arr = result.as_data_array().data();
+    EXPECT_EQ(arr.scalar_at<C>(0), C(2, 1));
+    EXPECT_EQ(arr.scalar_at<C>(1), C(2, 0));
+    EXPECT_EQ(arr.scalar_at<C>(2), C(-1, 2));
+}
+
+// Vector cells against a single vector: same cell shape, right side reused per row
+TEST(OperationAddTest, ArrayVectorMeasVectorRowBroadcast)
+{
+    Value v1(xdataset::DataArray::CreateIndependent(xdataset::block_fixtures::MakeVectorSeries(3, 2)));
+    VecXd offset(2); offset << 10.0, 20.0;
+    Value result = OperationAdd(v1, Value::Vector(offset));
+    ASSERT_TRUE(result.is_data_array());
+    const auto& arr = result.as_data_array().data();
+    ASSERT_EQ(arr.size(), 3);
+    for (Index i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(arr.vector_at<double>(i)(0), static_cast<double>(i * 2 + 1) + 10.0);
+        EXPECT_DOUBLE_EQ(arr.vector_at<double>(i)(1), static_cast<double>(i * 2 + 2) + 20.0);
+    }
+}
+
+// Vector cells against per-row scalars: cell-level broadcast on the right
+TEST(OperationAddTest, ArrayVectorArrayScalarCellBroadcast)
+{
+    Value v1(xdataset::DataArray::CreateIndependent(xdataset::block_fixtures::MakeVectorSeries(3, 2)));
+    auto ds2 = xdataset::DataSeries::CreateScalarFromVector<double>({100.0, 200.0, 300.0});
+    Value v2(xdataset::DataArray::CreateIndependent(std::move(ds2)));
+    Value result = OperationAdd(v1, v2);
+    ASSERT_TRUE(result.is_data_array());
+    const auto& arr = result.as_data_array().data();
+    ASSERT_EQ(arr.size(), 3);
+    for (Index i = 0; i < 3; ++i) {
+        double scale = 100.0 * static_cast<double>(i + 1);
+        EXPECT_DOUBLE_EQ(arr.vector_at<double>(i)(0), static_cast<double>(i * 2 + 1) + scale);
+        EXPECT_DOUBLE_EQ(arr.vector_at<double>(i)(1), static_cast<double>(i * 2 + 2) + scale);
+    }
+}
+
+// Scalar on the left reused for every cell of every row
+TEST(OperationAddTest, MeasScalarArrayVectorBroadcast)
+{
+    Value v2(xdataset::DataArray::CreateIndependent(xdataset::block_fixtures::MakeVectorSeries(2, 3)));
+    Value result = OperationSub(Value::Real(10.0), v2);
+    ASSERT_TRUE(result.is_data_array());
+    const auto& arr = result.as_data_array().data();
+    ASSERT_EQ(arr.size(), 2);
+    for (Index i = 0; i < 2; ++i)
+        for (Index j = 0; j < 3; ++j)
+            EXPECT_DOUBLE_EQ(arr.vector_at<double>(i)(j), 10.0 - static_cast<double>(i * 3 + j + 1));
+}
+
 // =========================================================================
 //  OperationMul
 // =========================================================================
@@ -1537,3 +1602,134 @@ TEST(OperationIfTest, DataArrayElseTaken)
     EXPECT_EQ(data.size(), 1u);
     EXPECT_EQ(data.scalar_at<int>(0), 99);
 }
+
+// =========================================================================
+//  Parallel chunked execution
+// =========================================================================
+
+namespace {
+
+/// 1000 x 2x3 complex rows with distinct values.
+Value MakeParallelInput(double seed)
+{
+    std::vector<std::complex<double>> values;
+    for (int i = 0; i < 1000; ++i)
+        for (int k = 0; k < 6; ++k)
+            values.push_back(std::complex<double>(seed + i + k, seed - 0.5 * i + k));
+    auto ds = xdataset::DataSeries::CreateMatrixFromVector(2, 3, values);
+    return Value(DataArray::CreateIndependent(std::move(ds)));
+}
+
+void ExpectSameCells(const Value& a, const Value& b)
+{
+    ASSERT_EQ(a.data_type(), b.data_type());
+    ASSERT_EQ(a.rows(), b.rows());
+    auto fa = a.flat_data<std::complex<double>>();
+    auto fb = b.flat_data<std::complex<double>>();
+    ASSERT_EQ(fa.stride, fb.stride);
+    for (Index i = 0; i < a.rows() * fa.stride; ++i)
+        ASSERT_EQ(fa.ptr[i], fb.ptr[i]) << "element " << i;
+}
+
+}  // namespace
+
+TEST(ParallelOperationTest, ChunkedResultsMatchSerial)
+{
+    Value a = MakeParallelInput(1.0);
+    Value b = MakeParallelInput(2.0);
+    Value s = Value::Complex(std::complex<double>(0.5, -0.25));
+
+    Value serial_add = OperationAdd(a, b);
+    Value serial_mul = OperationMul(a, s);
+    Value serial_sin = rel::operation::OperationSin(a);
+
+    for (std::size_t threads : {2u, 3u, 8u}) {
+        rel::operation::ParallelScope scope(threads, 1);
+        EXPECT_GT(rel::operation::PlanChunks(a.rows(), 6), 1u);
+        ExpectSameCells(OperationAdd(a, b), serial_add);
+        ExpectSameCells(OperationMul(a, s), serial_mul);
+        ExpectSameCells(rel::operation::OperationSin(a), serial_sin);
+    }
+}
+
+TEST(ParallelOperationTest, FusedChainMatchesSerial)
+{
+    using rel::operation::FusedExpr;
+    typedef FusedExpr::Op Op;
+
+    // more rows than one 1024-row pass per range, and not a multiple of it
+    std::vector<double> reals;
+    std::vector<int> ints;
+    for (int i = 0; i < 5003; ++i) {
+        reals.push_back(0.25 * i - 100.0);
+        ints.push_back(i % 17 - 8);
+    }
+    Value x(DataArray::CreateIndependent(xdataset::DataSeries::CreateScalarFromVector<double>(reals)));
+    Value n(DataArray::CreateIndependent(xdataset::DataSeries::CreateScalarFromVector<int>(ints)));
+
+    // x * n + x / 3 - (-n)
+    auto build = [&]() {
+        return FusedExpr::Binary(
+            Op::kSub,
+            FusedExpr::Binary(Op::kAdd,
+                              FusedExpr::Binary(Op::kMul, FusedExpr::Leaf(x), FusedExpr::Leaf(n)),
+                              FusedExpr::Binary(Op::kDiv, FusedExpr::Leaf(x),
+                                                FusedExpr::Leaf(Value::Integer(3)))),
+            FusedExpr::Unary(Op::kNegate, FusedExpr::Leaf(n)));
+    };
+
+    Value serial = rel::operation::OperateFused(*build());
+    ASSERT_EQ(serial.rows(), 5003);
+    for (std::size_t threads : {2u, 3u, 8u}) {
+        rel::operation::ParallelScope scope(threads, 1);
+        EXPECT_GT(rel::operation::PlanChunks(serial.rows(), 1), 1u);
+        Value parallel = rel::operation::OperateFused(*build());
+        ASSERT_EQ(parallel.data_type(), serial.data_type());
+        ASSERT_EQ(parallel.rows(), serial.rows());
+        auto fp = parallel.flat_data<double>();
+        auto fs = serial.flat_data<double>();
+        for (Index i = 0; i < serial.rows(); ++i)
+            ASSERT_EQ(fp.ptr[i], fs.ptr[i]) << "row " << i << ", " << threads << " threads";
+    }
+}
+
+TEST(ParallelOperationTest, SmallInputsAndNoScopeStaySerial)
+{
+    EXPECT_EQ(rel::operation::PlanChunks(1 << 24, 1), 1u);
+    {
+        rel::operation::ParallelScope scope(4, 1 << 20);
+        EXPECT_EQ(rel::operation::PlanChunks(1000, 6), 1u);
+        EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 4u);
+        {
+            rel::operation::ParallelScope serial(1, 0);
+            EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 1u);
+        }
+        EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 4u);
+    }
+    EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 1u);
+}
+
+TEST(ParallelOperationTest, SerialEvalScopeOverridesParallelScope)
+{
+    rel::operation::ParallelScope scope(4, 1);
+    {
+        rel::SerialEvalScope disabled(false);
+        EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 4u);
+    }
+    {
+        rel::SerialEvalScope serial;
+        rel::operation::ParallelScope inner(8, 1);
+        EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 1u);
+    }
+    EXPECT_EQ(rel::operation::PlanChunks(1 << 20, 1), 4u);
+}
+
+TEST(ParallelOperationTest, ChunkExceptionIsRethrown)
+{
+    rel::operation::ParallelScope scope(4, 1);
+    EXPECT_THROW(rel::operation::ParallelRanges(100, 1, [](Index begin, Index) {
+                     if (begin > 0)
+                         throw std::runtime_error("chunk failed");
+                 }),
+                 std::runtime_error);
+}
@@ -0,0 +1,164 @@
+// Compile() / Eval(Program) tests: the bytecode VM must agree with the
+// tree-walking evaluator value for value and error for error.
+
+#include "rel.h"
+#include "bytecode.h"
+#include "environment.h"
+
+#include "measurement.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    rel::Environment make_env()
+    {
+        rel::Environment::InitBuiltinConstants();
+        rel::Environment::InitBuiltinFunctions();
+        rel::Environment env;
+        env.Define("x", rel::Value::Real(3.0));
+        env.Define("n", rel::Value::Integer(4));
+        env.Define("v", rel::Eval("[1::4] * 1mV"));
+        env.Define("m", rel::Eval("{{1, 2}, {3, 4}}"));
+        return env;
+    }
+
+    /// Evaluate `source` with both back ends; value and type must agree.
+    void expect_same_value(const std::string& source)
+    {
+        rel::Environment env = make_env();
+        rel::Value expected = rel::Eval(*rel::Parse(source), env);
+        std::shared_ptr<const rel::Program> program = rel::Compile(rel::Parse(source));
+        rel::Value actual = rel::Eval(*program, env);
+        EXPECT_EQ(actual.to_string(), expected.to_string()) << source;
+        EXPECT_EQ(actual.data_type(), expected.data_type()) << source;
+    }
+
+    /// Both back ends must throw, with the same message.
+    void expect_same_error(const std::string& source)
+    {
+        rel::Environment env = make_env();
+        std::string expected;
+        std::string actual;
+        try { rel::Eval(*rel::Parse(source), env); }
+        catch (const std::exception& e) { expected = e.what(); }
+        try { rel::Eval(*rel::Compile(rel::Parse(source)), env); }
+        catch (const std::exception& e) { actual = e.what(); }
+        EXPECT_FALSE(expected.empty()) << source;
+        EXPECT_EQ(actual, expected) << source;
+    }
+} // namespace
+
+// =========================================================================
+//  Agreement with the tree walker
+// =========================================================================
+
+TEST(BytecodeTest, ScalarExpressionsMatchTreeWalker)
+{
+    expect_same_value("1 + 2 * 3");
+    expect_same_value("x * x - 2 * x + 1");
+    expect_same_value("-(x + 1) / (n - 1)");
+    expect_same_value("n % 3 + n ** 2");
+    expect_same_value("0x1F << 2");
+    expect_same_value("2i * x");
+    expect_same_value("sin(PI / 2) + sqrt(x)");
+    expect_same_value("1 < 2 && x > 4");
+    expect_same_value("0 && undefined_name");
+    expect_same_value("1 || undefined_name");
+    expect_same_value("x > 1 ? 1mV : 2mV");
+    expect_same_value("if (x > 4) then 1 elseif (x > 2) then 2 else 3");
+}
+
+TEST(BytecodeTest, ArrayExpressionsMatchTreeWalker)
+{
+    expect_same_value("v * 2 + v / 3 - v");
+    expect_same_value("v[1] + v[2]");
+    expect_same_value("[1::3] * (2 + 1)");
+    expect_same_value("[x, 2 * x, 3 * x]");
+    expect_same_value("{{1, 2}, {x, n}}");
+    expect_same_value("{x}");
+    expect_same_value("m(2, 1)");
+    expect_same_value("{10, 20, 30}(1 + 1)");
+    expect_same_value("v > 2mV ? v : 0mV");
+    expect_same_value("if (v > 3mV) then v elseif (v > 1mV) then 2 * v else 0mV");
+    expect_same_value("v > 2mV && v < 4mV");
+}
+
+TEST(BytecodeTest, ErrorsMatchTreeWalker)
+{
+    expect_same_error("undefined_name + 1");
+    expect_same_error("x[1]");
+    expect_same_error("nosuchfn(1)");
+    expect_same_error("sin(1, 2)");
+    expect_same_error("1 + \"a\"");
+}
+
+// =========================================================================
+//  Calls and rebinding
+// =========================================================================
+
+TEST(BytecodeTest, SkippedSlotsTakeDefaults)
+{
+    rel::Environment env = make_env();
+    rel::Environment::RegisterFunction(rel::Function(
+        "bc_sum",
+        std::vector<rel::FunctionParam>{
+            rel::Param("a"),
+            rel::Param("b", rel::Value::Integer(10)),
+            rel::Param("c", rel::Value::Integer(100)),
+        },
+        [](const rel::Function::ArgMap& args) -> rel::Value {
+            return rel::Value::Integer(args.at("a").as_measurement().as_scalar<int>() +
+                                       args.at("b").as_measurement().as_scalar<int>() +
+                                       args.at("c").as_measurement().as_scalar<int>());
+        }));
+
+    auto program = rel::Compile(rel::Parse("bc_sum(1, , n)"));
+    EXPECT_EQ(rel::Eval(*program, env).as_measurement().as_scalar<int>(), 15);
+    EXPECT_TRUE(rel::Environment::UnregisterFunction("bc_sum"));
+}
+
+TEST(BytecodeTest, ProgramSeesCurrentBindings)
+{
+    rel::Environment env = make_env();
+    auto program = rel::Compile(rel::Parse("x * 2 + 1"));
+    EXPECT_DOUBLE_EQ(rel::Eval(*program, env).as_measurement().as_scalar<double>(), 7.0);
+
+    env.Define("x", rel::Value::Real(10.0));
+    EXPECT_DOUBLE_EQ(rel::Eval(*program, env).as_measurement().as_scalar<double>(), 21.0);
+
+    rel::Environment other = make_env();
+    other.Define("x", rel::Value::Real(-1.0));
+    EXPECT_DOUBLE_EQ(rel::Eval(*program, other).as_measurement().as_scalar<double>(), -1.0);
+
+    // a removed variable is reported like the tree walker reports it, and
+    // seen again once redefined
+    EXPECT_TRUE(env.Remove("x"));
+    EXPECT_THROW(rel::Eval(*program, env), std::runtime_error);
+    env.Define("x", rel::Value::Real(0.5));
+    EXPECT_DOUBLE_EQ(rel::Eval(*program, env).as_measurement().as_scalar<double>(), 2.0);
+}
+
+TEST(BytecodeTest, OptimizedTreeCompiles)
+{
+    rel::Environment env = make_env();
+    auto program = rel::Compile(rel::Optimize(rel::Parse("2 * PI * x")));
+    rel::Value expected = rel::Eval("2 * PI * x", &env);
+    EXPECT_EQ(rel::Eval(*program, env).to_string(), expected.to_string());
+}
+
+TEST(BytecodeTest, BackendSwitchRoutesStringEval)
+{
+    rel::Environment env = make_env();
+    rel::EvalBackend saved = rel::GetEvalBackend();
+    rel::SetEvalBackend(rel::EvalBackend::kBytecode);
+    EXPECT_EQ(rel::GetEvalBackend(), rel::EvalBackend::kBytecode);
+    EXPECT_DOUBLE_EQ(rel::Eval("x + 1", &env).as_measurement().as_scalar<double>(), 4.0);
+    EXPECT_THROW(rel::Eval("undefined_name", &env), std::runtime_error);
+    rel::SetEvalBackend(saved);
+}
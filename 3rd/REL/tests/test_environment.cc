@@ -1,6 +1,7 @@
 // Environment tests powered by GoogleTest.
 
 #include "environment.h"
+#include "expr.h"
 #include "rel.h"
 
 #include "data_series.h"
@@ -65,6 +66,29 @@ TEST(EnvironmentTest, RedefineOverwrites)
     EXPECT_EQ(env.Get("x").as_measurement().as_scalar<int>(), 2);
 }
 
+TEST(EnvironmentTest, ContainsFindAndSize)
+{
+    rel::Environment env;
+    EXPECT_EQ(env.size(), 0u);
+    env.Define("x", rel::Value::Integer(7));
+    env.Define("y", rel::Value::Real(1.5));
+
+    EXPECT_TRUE(env.Contains("x"));
+    EXPECT_FALSE(env.Contains("z"));
+    EXPECT_FALSE(env.Contains("PI"));  // builtin constants are not variables
+    EXPECT_EQ(env.size(), 2u);
+
+    rel::Value out = rel::Value::Integer(-1);
+    EXPECT_FALSE(env.Find("z", out));
+    EXPECT_EQ(out.as_measurement().as_scalar<int>(), -1);
+    ASSERT_TRUE(env.Find("x", out));
+    EXPECT_EQ(out.as_measurement().as_scalar<int>(), 7);
+
+    EXPECT_TRUE(env.Remove("x"));
+    EXPECT_FALSE(env.Contains("x"));
+    EXPECT_EQ(env.size(), 1u);
+}
+
 // =========================================================================
 //  Built-in constants
 // =========================================================================
@@ -162,6 +186,43 @@ TEST(EnvironmentTest, LookupVariableOrConstantNotFound)
     EXPECT_EQ(env.LookupVariableOrConstant("no_such_var"), nullptr);
 }
 
+TEST(EnvironmentTest, SlotLookupFollowsDefineAndRemove)
+{
+    rel::Environment::InitBuiltinConstants();
+    const std::size_t x = rel::Environment::VariableSlot("slot_x");
+    const std::size_t y = rel::Environment::VariableSlot("slot_y");
+    EXPECT_NE(x, y);
+    EXPECT_EQ(rel::Environment::VariableSlot("slot_x"), x);
+
+    rel::Environment env;
+    rel::Value out;
+    EXPECT_FALSE(env.CopyVariableOrConstant(x, "slot_x", out));
+
+    env.Define("slot_x", rel::Value::Real(1.0));
+    ASSERT_TRUE(env.CopyVariableOrConstant(x, "slot_x", out));
+    EXPECT_DOUBLE_EQ(out.as_measurement().as_scalar<double>(), 1.0);
+
+    // rebinding keeps the slot's entry, erasing invalidates it
+    env.Define("slot_x", rel::Value::Real(2.0));
+    ASSERT_TRUE(env.CopyVariableOrConstant(x, "slot_x", out));
+    EXPECT_DOUBLE_EQ(out.as_measurement().as_scalar<double>(), 2.0);
+    env.Define("slot_y", rel::Value::Real(5.0));
+    EXPECT_TRUE(env.Remove("slot_x"));
+    EXPECT_FALSE(env.CopyVariableOrConstant(x, "slot_x", out));
+    ASSERT_TRUE(env.CopyVariableOrConstant(y, "slot_y", out));
+    EXPECT_DOUBLE_EQ(out.as_measurement().as_scalar<double>(), 5.0);
+
+    // a copy resolves against its own table
+    rel::Environment copy = env;
+    env.Clear();
+    EXPECT_FALSE(env.CopyVariableOrConstant(y, "slot_y", out));
+    ASSERT_TRUE(copy.CopyVariableOrConstant(y, "slot_y", out));
+    EXPECT_DOUBLE_EQ(out.as_measurement().as_scalar<double>(), 5.0);
+
+    ASSERT_TRUE(env.CopyVariableOrConstant(rel::Environment::VariableSlot("PI"), "PI", out));
+    EXPECT_TRUE(out.is_measurement());
+}
+
 // =========================================================================
 //  Dataset lookup
 // =========================================================================
@@ -181,3 +242,53 @@ TEST(EnvironmentTest, FindDatasetNotFound)
 {
     EXPECT_EQ(rel::Environment::FindDataset("nonexistent"), nullptr);
 }
+
+TEST(EnvironmentTest, CachedReferenceFollowsDatasetChanges)
+{
+    auto owned = std::make_unique<xdataset::Dataset>("cached");
+    owned->AddBlock("SP1/SP", make_block_info());
+    xdataset::Dataset* ds = owned.get();
+    rel::Environment::AddDataset(std::move(owned));
+    rel::Environment::SetDefaultDataset("cached");
+
+    rel::Environment env;
+    rel::ExprPtr expr = rel::Parse("Vout");
+    const auto* ref = dynamic_cast<const rel::ReferenceExpr*>(expr.get());
+    ASSERT_NE(ref, nullptr);
+    EXPECT_TRUE(rel::Eval(*expr, env).is_data_array());
+    EXPECT_NE(std::atomic_load(&ref->resolved), nullptr);
+
+    // A second Vout makes the name ambiguous; the cached path is not reused.
+    ds->AddBlock("SP2/SP", make_block_info());
+    EXPECT_THROW(rel::Eval(*expr, env), std::runtime_error);
+
+    ds->RemoveBlock("SP1/SP");
+    EXPECT_TRUE(rel::Eval(*expr, env).is_data_array());
+
+    // Variables still shadow a cached DataArray.
+    env.Define("Vout", rel::Value::Real(1.0));
+    EXPECT_TRUE(rel::Eval(*expr, env).is_measurement());
+
+    rel::Environment::RemoveDataset("cached");
+}
+
+TEST(EnvironmentTest, ParallelOptionsDriveEval)
+{
+    rel::Environment::InitBuiltinFunctions();
+    rel::Environment env;
+    EXPECT_EQ(env.parallel_options().threads, 1u);
+    env.Define("v", rel::Eval("[0::9999] * 1mV"));
+    rel::Value serial = rel::Eval("sin(v / 1V) * v + v", &env);
+
+    rel::ParallelOptions options;
+    options.threads = 4;
+    options.min_elements = 1;
+    env.SetParallelOptions(options);
+
+    rel::Environment copy(env);
+    EXPECT_EQ(copy.parallel_options().threads, 4u);
+    EXPECT_EQ(copy.parallel_options().min_elements, 1u);
+
+    rel::Value parallel = rel::Eval("sin(v / 1V) * v + v", &copy);
+    EXPECT_EQ(parallel.to_string(), serial.to_string());
+}
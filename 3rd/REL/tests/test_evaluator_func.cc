@@ -7,6 +7,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -211,3 +213,74 @@ TEST(FunctionTest, ReregisterOverwrites)
     rel::Value v = rel::Eval("g()", &env);
     EXPECT_EQ(v.as_measurement().as_scalar<int>(), 2);
 }
+
+// =========================================================================
+//  Positional implementations
+// =========================================================================
+
+TEST(FunctionTest, PositionalImplementationAndDefaults)
+{
+    rel::Environment env;
+    rel::Environment::RegisterFunction(rel::Function::Positional(
+        "psum",
+        std::vector<rel::FunctionParam>{
+            rel::Param("x", rel::Value::Integer(1)),
+            rel::Param("y", rel::Value::Integer(10)),
+        },
+        [](const rel::Value* args, std::size_t count) -> rel::Value {
+            EXPECT_EQ(count, 2u);
+            return rel::Value::Integer(args[0].as_measurement().as_scalar<int>() +
+                                       args[1].as_measurement().as_scalar<int>());
+        }));
+
+    EXPECT_EQ(rel::Eval("psum(1, 2)", &env).as_measurement().as_scalar<int>(), 3);
+    EXPECT_EQ(rel::Eval("psum(1)", &env).as_measurement().as_scalar<int>(), 11);
+    EXPECT_EQ(rel::Eval("psum(, 2)", &env).as_measurement().as_scalar<int>(), 3);
+    EXPECT_EQ(rel::Eval("psum()", &env).as_measurement().as_scalar<int>(), 11);
+    EXPECT_EQ(rel::Environment::CallFunction("psum", rel::Value::Integer(5))
+                  .as_measurement().as_scalar<int>(), 15);
+    EXPECT_THROW(rel::Eval("psum(1, 2, 3)", &env), std::runtime_error);
+}
+
+// =========================================================================
+//  Registry snapshots and slots
+// =========================================================================
+
+TEST(FunctionTest, ResolvedHandleOutlivesUnregister)
+{
+    rel::Environment::RegisterFunction(rel::Function(
+        "h", std::vector<rel::FunctionParam>{},
+        [](const rel::Function::ArgMap&) -> rel::Value {
+            return rel::Value::Integer(7);
+        }));
+
+    std::shared_ptr<const rel::Function> fn = rel::Environment::ResolveFunction("h");
+    ASSERT_TRUE(fn != nullptr);
+    EXPECT_TRUE(rel::Environment::UnregisterFunction("h"));
+    EXPECT_TRUE(rel::Environment::ResolveFunction("h") == nullptr);
+    EXPECT_EQ(fn->Invoke(nullptr, 0).as_measurement().as_scalar<int>(), 7);
+}
+
+TEST(FunctionTest, SlotIsStableAcrossRegistrations)
+{
+    const std::size_t slot = rel::Environment::FunctionSlot("slot_fn");
+    EXPECT_TRUE(rel::Environment::ResolveFunction(slot) == nullptr);
+
+    const std::uint64_t before = rel::Environment::FunctionRegistryVersion();
+    for (int i = 1; i <= 2; ++i)
+    {
+        rel::Environment::RegisterFunction(rel::Function(
+            "slot_fn", std::vector<rel::FunctionParam>{},
+            [i](const rel::Function::ArgMap&) -> rel::Value {
+                return rel::Value::Integer(i);
+            }));
+        EXPECT_EQ(rel::Environment::FunctionSlot("slot_fn"), slot);
+        EXPECT_EQ(rel::Environment::ResolveFunction(slot)->Invoke(nullptr, 0)
+                      .as_measurement().as_scalar<int>(), i);
+    }
+    EXPECT_GT(rel::Environment::FunctionRegistryVersion(), before);
+
+    EXPECT_TRUE(rel::Environment::UnregisterFunction("slot_fn"));
+    EXPECT_TRUE(rel::Environment::ResolveFunction(slot) == nullptr);
+    EXPECT_EQ(rel::Environment::FunctionSlot("slot_fn"), slot);
+}
@@ -2,6 +2,7 @@
 
 #include "evaluator.h"
 #include "rel.h"
+#include "environment.h"
 
 #include "expr.h"
 #include "data_array.h"
@@ -11,6 +12,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 using rel::Eval;
 
@@ -224,3 +226,43 @@ TEST(RegressionTest, MatrixWithSweepAndScalarConcat)
     std::string s = v.Format();
     EXPECT_FALSE(s.empty());
 }
+
+// =========================================================================
+//  IndexExpr -> a[start::step::stop] slices
+// =========================================================================
+
+namespace
+{
+    std::vector<int> sweep_ints(const rel::Value& v)
+    {
+        std::vector<int> out;
+        const xdataset::DataSeries& series = v.as_data_array().data();
+        for (std::size_t i = 0; i < series.size(); ++i)
+            out.push_back(series.scalar_at<int>(static_cast<xdataset::Index>(i)));
+        return out;
+    }
+} // namespace
+
+TEST(SweepIndexTest, StridedRangeSelectsEveryStep)
+{
+    rel::Environment env;
+    env.Define("v", Eval("[0::20]"));
+    EXPECT_EQ(sweep_ints(Eval("v[2::3::11]", &env)), (std::vector<int>{2, 5, 8, 11}));
+    EXPECT_EQ(sweep_ints(Eval("v[0::3]", &env)), (std::vector<int>{0, 1, 2, 3}));
+    // A descending range selects the same (ascending) set.
+    EXPECT_EQ(sweep_ints(Eval("v[11::-3::2]", &env)), (std::vector<int>{2, 5, 8, 11}));
+    // Fractional steps still truncate and de-duplicate.
+    EXPECT_EQ(sweep_ints(Eval("v[0::0.5::2]", &env)), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(SweepIndexTest, SingleCellAndOutOfRange)
+{
+    rel::Environment env;
+    env.Define("v", Eval("[0::20] * 1mV"));
+    rel::Value cell = Eval("v[5]", &env);
+    ASSERT_TRUE(cell.is_measurement());
+    EXPECT_EQ(cell.to_string(), Eval("5mV").to_string());
+
+    EXPECT_ANY_THROW(Eval("v[0::7::21]", &env));
+    EXPECT_ANY_THROW(Eval("v[21]", &env));
+}
@@ -1,13 +1,19 @@
 ﻿// Evaluator operator tests -> uses eval for concise test setup.
 
 #include "rel.h"
+#include "environment.h"
+#include "operation/operator.h"
 
 #include "data_array.h"
 #include "measurement.h"
+#include "unit.h"
 
 #include <gtest/gtest.h>
 
+#include <complex>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using rel::Eval;
 
@@ -495,3 +501,163 @@ TEST(OperatorTest, IfScalarCondVectorBranchElseScalar)
     EXPECT_EQ(vec[0], 10);
     EXPECT_EQ(vec[1], 20);
 }
+
+// --- lazy evaluation: branches a scalar condition does not select are skipped ---
+
+TEST(OperatorTest, ShortCircuitSkipsRightOperand)
+{
+    EXPECT_FALSE(Eval("0 && undefined_name").as_measurement().as_scalar<bool>());
+    EXPECT_TRUE(Eval("1 || undefined_name").as_measurement().as_scalar<bool>());
+    EXPECT_THROW(Eval("1 && undefined_name"), std::runtime_error);
+    // array operands stay element-wise, so the right side is still evaluated
+    EXPECT_THROW(Eval("{TRUE, FALSE} && undefined_name"), std::runtime_error);
+}
+
+TEST(OperatorTest, ConditionalScalarEvaluatesSelectedBranchOnly)
+{
+    EXPECT_EQ(Eval("TRUE ? 10 : undefined_name").as_measurement().as_scalar<int>(), 10);
+    EXPECT_EQ(Eval("(1 > 2) ? undefined_name : 20").as_measurement().as_scalar<int>(), 20);
+}
+
+TEST(OperatorTest, IfScalarEvaluatesSelectedBranchOnly)
+{
+    rel::Value v = Eval("if(FALSE) then undefined_a elseif(TRUE) then 2 else undefined_b");
+    EXPECT_EQ(v.as_measurement().as_scalar<int>(), 2);
+    v = Eval("if(FALSE) then undefined_a else 3");
+    EXPECT_EQ(v.as_measurement().as_scalar<int>(), 3);
+}
+
+TEST(OperatorTest, ConditionalElementwiseTypesFromBothBranches)
+{
+    // an array condition selects element-wise, so neither branch is skipped:
+    // the result type does not depend on which elements are true
+    rel::Value v = Eval("{TRUE, TRUE} ? {3, 4} : 5.5");
+    EXPECT_EQ(v.as_measurement().data_type(), xdataset::DataType::kReal);
+    auto vec = v.as_measurement().as_vector<double>();
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_DOUBLE_EQ(vec[0], 3.0);
+    EXPECT_DOUBLE_EQ(vec[1], 4.0);
+
+    EXPECT_THROW(Eval("{FALSE, FALSE} ? undefined_name : {1, 2}"), std::runtime_error);
+    EXPECT_THROW(Eval("{TRUE, TRUE} ? {1, 2} : {1, 2, 3}"), std::exception);
+}
+
+TEST(OperatorTest, IfElementwiseTypesFromAllBranches)
+{
+    rel::Value v = Eval(
+        "if({TRUE, FALSE}) then {1, 2} elseif({TRUE, FALSE}) then 0.5 "
+        "elseif({FALSE, TRUE}) then {10, 20} else 7");
+    EXPECT_EQ(v.as_measurement().data_type(), xdataset::DataType::kReal);
+    auto vec = v.as_measurement().as_vector<double>();
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_DOUBLE_EQ(vec[0], 1.0);
+    EXPECT_DOUBLE_EQ(vec[1], 20.0);
+
+    // a leading scalar FALSE branch still takes part once a condition is an array
+    v = Eval("if(FALSE) then 1.5 elseif({FALSE, TRUE}) then {1, 2} else {5, 6}");
+    EXPECT_EQ(v.as_measurement().data_type(), xdataset::DataType::kReal);
+    auto mixed = v.as_measurement().as_vector<double>();
+    ASSERT_EQ(mixed.size(), 2);
+    EXPECT_DOUBLE_EQ(mixed[0], 5.0);
+    EXPECT_DOUBLE_EQ(mixed[1], 2.0);
+
+    EXPECT_THROW(Eval("if({TRUE, TRUE}) then {1, 2} else undefined_b"), std::runtime_error);
+}
+
+// --- fused element-wise chains: same result as operator-by-operator ---
+
+namespace
+{
+    template <typename T>
+    rel::Value MakeArray(const std::vector<T>& values, const std::string& unit = "")
+    {
+        xdataset::Unit u = unit.empty() ? xdataset::Unit() : xdataset::Unit::parse(unit);
+        return rel::Value(xdataset::DataArray::CreateIndependent(
+            xdataset::DataSeries::CreateScalarFromVector<T>(values, u)));
+    }
+
+    template <typename T>
+    void ExpectSameArray(const rel::Value& actual, const rel::Value& expected)
+    {
+        ASSERT_TRUE(actual.is_data_array());
+        ASSERT_TRUE(expected.is_data_array());
+        const xdataset::DataSeries& a = actual.as_data_array().data();
+        const xdataset::DataSeries& e = expected.as_data_array().data();
+        EXPECT_EQ(a.data_type(), e.data_type());
+        EXPECT_TRUE(a.unit() == e.unit());
+        ASSERT_EQ(a.size(), e.size());
+        for (xdataset::Index i = 0; i < static_cast<xdataset::Index>(a.size()); ++i)
+            EXPECT_EQ(a.scalar_at<T>(i), e.scalar_at<T>(i)) << "row " << i;
+    }
+}
+
+TEST(OperatorTest, FusedChainMatchesUnfused)
+{
+    using rel::operation::OperationAdd;
+    using rel::operation::OperationDiv;
+    using rel::operation::OperationMul;
+    using rel::operation::OperationSub;
+    typedef std::complex<double> C;
+
+    // more rows than one fused chunk, with a partial last chunk
+    std::vector<double> a, b;
+    std::vector<C> c;
+    std::vector<int> d;
+    for (int i = 0; i < 2500; ++i)
+    {
+        a.push_back(0.5 * i);
+        b.push_back(3.0 - i);
+        c.push_back(C(i, -0.25 * i));
+        d.push_back(i % 7);
+    }
+
+    rel::Environment env;
+    env.Define("a", MakeArray(a));
+    env.Define("b", MakeArray(b));
+    env.Define("c", MakeArray(c));
+    env.Define("d", MakeArray(d));
+
+    rel::Value fused = Eval("a*b + c*d - a/2", &env);
+    rel::Value expected = OperationSub(
+        OperationAdd(OperationMul(MakeArray(a), MakeArray(b)),
+                     OperationMul(MakeArray(c), MakeArray(d))),
+        OperationDiv(MakeArray(a), rel::Value::Integer(2)));
+    ExpectSameArray<C>(fused, expected);
+
+    // integer-only chain stays integer; a scalar sub-tree is folded first
+    fused = Eval("-(d + d) * (2 + 1)", &env);
+    expected = OperationMul(
+        -OperationAdd(MakeArray(d), MakeArray(d)), rel::Value::Integer(3));
+    ExpectSameArray<int>(fused, expected);
+}
+
+TEST(OperatorTest, FusedChainCanonicalizesUnits)
+{
+    rel::Environment env;
+    env.Define("v", MakeArray(std::vector<double>{1.0, 2.0, 3.0}, "mV"));
+    env.Define("cur", MakeArray(std::vector<double>{4.0, 5.0, 6.0}, "A"));
+
+    rel::Value p = Eval("v * cur + v * cur", &env);
+    ASSERT_TRUE(p.is_data_array());
+    const xdataset::DataSeries& data = p.as_data_array().data();
+    EXPECT_TRUE(data.unit().same_dimension(xdataset::Unit::parse("W")));
+    EXPECT_DOUBLE_EQ(data.scalar_at<double>(0), 2 * 0.004);
+    EXPECT_DOUBLE_EQ(data.scalar_at<double>(2), 2 * 0.018);
+
+    // dimension mismatch raises the same error as unfused evaluation
+    EXPECT_THROW(Eval("v + cur - v", &env), std::runtime_error);
+}
+
+TEST(OperatorTest, FusedChainFallsBackOnRowBroadcast)
+{
+    rel::Environment env;
+    env.Define("a", MakeArray(std::vector<double>{1.0, 2.0, 3.0}));
+    env.Define("one", MakeArray(std::vector<double>{10.0}));
+
+    rel::Value v = Eval("a + one * 2", &env);
+    rel::Value expected = rel::operation::OperationAdd(
+        MakeArray(std::vector<double>{1.0, 2.0, 3.0}),
+        rel::operation::OperationMul(MakeArray(std::vector<double>{10.0}),
+                                     rel::Value::Integer(2)));
+    ExpectSameArray<double>(v, expected);
+}
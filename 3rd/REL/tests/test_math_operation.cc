@@ -723,4 +723,23 @@ namespace
         EXPECT_EQ(rel::Eval("sgn(abs(3))", &env).as_measurement().as_scalar<int>(), 1);
     }
 
+    // =========================================================================
+    //  Units of dimensionless operands
+    // =========================================================================
+
+    TEST(MathFunctionTest, DimensionlessOperandsKeepDerivedUnits)
+    {
+        rel::Environment env;
+        rel::Environment::InitBuiltinFunctions();
+
+        EXPECT_FALSE(rel::Eval("2 * 3 + 1 / 5", &env).unit().has_dimension());
+        EXPECT_EQ(rel::Eval("2 * 3GHz", &env).unit().to_string(), "Hz");
+
+        // dbmtow turns a dimensionless level into watts.
+        rel::Value w = rel::Eval("dbmtow(30)", &env);
+        EXPECT_EQ(w.unit().to_string(), "W");
+        EXPECT_NEAR(w.as_measurement().as_scalar<double>(), 1.0, 1e-12);
+        EXPECT_FALSE(rel::Eval("wtodbm(dbmtow(30))", &env).unit().has_dimension());
+    }
+
 } // namespace
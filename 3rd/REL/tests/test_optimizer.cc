@@ -0,0 +1,103 @@
+// Optimize() tests: literal pre-materialisation and constant folding.
+
+#include "rel.h"
+#include "ast_printer.h"
+#include "environment.h"
+#include "expr.h"
+
+#include "measurement.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+    rel::Environment make_env()
+    {
+        rel::Environment::InitBuiltinConstants();
+        rel::Environment::InitBuiltinFunctions();
+        rel::Environment env;
+        env.Define("x", rel::Value::Real(3.0));
+        return env;
+    }
+
+    /// Evaluate `source` unoptimised and optimised; both must agree.
+    void expect_same_value(const std::string& source)
+    {
+        rel::Environment env = make_env();
+        rel::ExprPtr plain = rel::Parse(source);
+        rel::ExprPtr optimised = rel::Optimize(rel::Parse(source));
+        rel::Value expected = rel::Eval(*plain, env);
+        rel::Value actual = rel::Eval(*optimised, env);
+        EXPECT_EQ(actual.to_string(), expected.to_string()) << source;
+        EXPECT_EQ(actual.data_type(), expected.data_type()) << source;
+    }
+} // namespace
+
+// =========================================================================
+//  Folding
+// =========================================================================
+
+TEST(OptimizerTest, LiteralBecomesConstant)
+{
+    rel::ExprPtr expr = rel::Optimize(rel::Parse("1.5GHz"));
+    auto* c = dynamic_cast<const rel::ConstantExpr*>(expr.get());
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(c->text, "1.5GHz");
+    EXPECT_EQ(c->value->as_measurement().unit().to_string(), "GHz");
+}
+
+TEST(OptimizerTest, ConstantSubtreeFoldsToOneNode)
+{
+    make_env();
+    rel::ExprPtr expr = rel::Optimize(rel::Parse("2*PI*1GHz"));
+    ASSERT_NE(dynamic_cast<const rel::ConstantExpr*>(expr.get()), nullptr);
+    expect_same_value("2*PI*1GHz");
+    expect_same_value("c0/(4*PI)");
+}
+
+TEST(OptimizerTest, VariableOperandIsNotFolded)
+{
+    make_env();
+    rel::ExprPtr expr = rel::Optimize(rel::Parse("x*(2*PI)"));
+    auto* b = dynamic_cast<const rel::BinaryExpr*>(expr.get());
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(dynamic_cast<const rel::ReferenceExpr*>(b->left.get()), nullptr);
+    EXPECT_NE(dynamic_cast<const rel::ConstantExpr*>(b->right.get()), nullptr);
+    expect_same_value("x*(2*PI)");
+}
+
+TEST(OptimizerTest, CallArgumentsFoldButCalleeDoesNot)
+{
+    make_env();
+    rel::ExprPtr expr = rel::Optimize(rel::Parse("sin(PI/2)"));
+    auto* call = dynamic_cast<const rel::CallExpr*>(expr.get());
+    ASSERT_NE(call, nullptr);
+    EXPECT_NE(dynamic_cast<const rel::ReferenceExpr*>(call->callee.get()), nullptr);
+    ASSERT_EQ(call->args.size(), 1u);
+    EXPECT_NE(dynamic_cast<const rel::ConstantExpr*>(call->args[0].get()), nullptr);
+    expect_same_value("sin(PI/2)");
+}
+
+TEST(OptimizerTest, ResultsMatchUnoptimised)
+{
+    expect_same_value("1 + 2 * 3");
+    expect_same_value("-(1cm + 20cm)");
+    expect_same_value("0x1F << 2");
+    expect_same_value("2i * 3");
+    expect_same_value("1 < 2 && 3 > 4");
+    expect_same_value("1 ? 2 : 3");
+    expect_same_value("x + 1 ? 1mV : 2mV");
+    expect_same_value("{{1, 2}, {3, 4}}(2, 1)");
+    expect_same_value("{10, 20, 30}(1 + 1)");
+    expect_same_value("[1::2 + 1] * (2 + 1)");
+}
+
+TEST(OptimizerTest, PrintedTreeKeepsSourceForm)
+{
+    make_env();
+    rel::ExprPtr expr = rel::Optimize(rel::Parse("x + 1GHz"));
+    rel::AstPrinter printer;
+    EXPECT_EQ(printer.Print(*expr), "(+ x 1GHz)");
+}
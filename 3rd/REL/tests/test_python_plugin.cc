@@ -175,6 +175,31 @@ TEST_F(PythonPluginTest, NumpyInterop)
         "assert np.allclose(back, arr)\n");
 }
 
+TEST_F(PythonPluginTest, FromArrayBorrowsContiguousBuffers)
+{
+    // array.array exports a C-contiguous buffer, so this runs without numpy.
+    RUN_PY(
+        "import array\n"
+        "import rel\n"
+        "buf = array.array('d', [1.0, 2.0, 3.0, 4.0])\n"
+        "ds = rel.DataSeries.from_array(buf)\n"
+        "assert ds.is_borrowed\n"
+        "buf[1] = 5.0\n"
+        "assert memoryview(ds)[1] == 5.0   # in-place writes show through\n"
+        "try:\n"
+        "    buf.append(6.0)\n"
+        "    raise AssertionError('exporter resized while borrowed')\n"
+        "except BufferError:\n"
+        "    pass\n"
+        "del ds\n"
+        "buf.append(6.0)                   # released with the series\n"
+        "strided = rel.DataSeries.from_array(memoryview(buf)[::2])\n"
+        "assert memoryview(strided).tolist() == [1.0, 3.0, 6.0]\n"
+        "buf.append(7.0)                   # strided views are gathered first\n"
+        "flags = rel.DataSeries.from_array(memoryview(bytes([1, 0, 1])).cast('?'))\n"
+        "assert not flags.is_borrowed and flags.data_type == 'integer'\n");
+}
+
 TEST_F(PythonPluginTest, MeasurementAndValueNumpy)
 {
     if (!g_numpy_available)
@@ -2,6 +2,7 @@
 #define BLOCK_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tsl/ordered_map.h>
 #include <vector>
@@ -52,6 +53,10 @@ namespace xdataset
         explicit Block(const BlockCreateInfo& info);
         explicit Block(BlockCreateInfo&& info);
 
+        // The caches are guarded by per-Block mutexes, which are not moved.
+        Block(Block&& other) noexcept;
+        Block& operator=(Block&& other) noexcept;
+
         /// Short (leaf) name, e.g. "SP" for path "simulation/SP1/SP".
         const std::string& name() const;
         void               set_name(std::string name);
@@ -64,6 +69,8 @@ namespace xdataset
 
         const DependentSpec& dependent_spec(const std::string& name) const;
 
+        /// Safe to call from several threads at once; the returned reference
+        /// stays valid for the lifetime of the Block.
         const DataArray& GetOrCreateDataArray(const std::string& name) const;
         const DataFrame& GetOrCreateDataFrame() const;
 
@@ -77,6 +84,8 @@ namespace xdataset
         tsl::ordered_map<std::string, DependentSpec>   dependent_spec_map_;
         mutable tsl::ordered_map<std::string, std::unique_ptr<DataArray>> data_array_cache_;
         mutable std::unique_ptr<DataFrame>                    data_frame_cache_;
+        mutable std::mutex data_array_cache_mutex_;
+        mutable std::mutex data_frame_cache_mutex_;
     };
 }
 
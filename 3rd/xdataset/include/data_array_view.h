@@ -0,0 +1,80 @@
+#ifndef DATA_ARRAY_VIEW_H
+#define DATA_ARRAY_VIEW_H
+
+#include <vector>
+
+#include "data_array.h"
+#include "measurement.h"
+#include "multi_index_selector.h"
+
+namespace xdataset
+{
+    /// Non-owning, read-only selection of a DataArray.
+    ///
+    /// Each selected dimension is kept as {start, step, count} over the
+    /// parent's rows instead of an expanded index list, so building a view
+    /// and reading single cells through it does not depend on the parent's
+    /// size.  Only regular dimensions selected by Any / Equal / Range can be
+    /// described this way -- see CanView(); everything else goes through
+    /// DataArray::select().
+    ///
+    /// The parent must outlive the view.  materialize() copies the selected
+    /// rows into a new DataArray identical to DataArray::select() with the
+    /// same selectors; series whose dimension is selected in full are shared
+    /// with the parent (copy-on-write) rather than copied.  Deferred series
+    /// (DataSeries::CreateDeferred()) have only the selected rows read, both
+    /// by measurement_at() and by materialize().
+    class XDATASET_API DataArrayView
+    {
+    public:
+        /// True when `selectors` (padded like DataArray::select(): missing
+        /// leading dimensions are Any) address only regular dimensions with
+        /// Any / Equal / Range selectors.
+        static bool CanView(const DataArray& parent, const std::vector<MultiIndexSelector>& selectors);
+
+        /// Throws std::invalid_argument when !CanView(), and the same
+        /// exceptions as DataArray::select() for bad ranks or out-of-range
+        /// indices.
+        DataArrayView(const DataArray& parent, const std::vector<MultiIndexSelector>& selectors);
+
+        const DataArray& parent() const
+        {
+            return *parent_;
+        }
+
+        /// Rank of the materialized result (dimensions not removed by Equal;
+        /// the self dimension of an Independent DataArray is always kept).
+        std::size_t rank() const;
+
+        /// Number of rows of the materialized self data.
+        Index size() const
+        {
+            return size_;
+        }
+
+        /// Row of parent().data() backing row `i` of the view.
+        Index parent_row(Index i) const;
+
+        /// Self value at row `i` of the view, read straight from the parent.
+        Measurement measurement_at(Index i) const;
+
+        /// Copy the selection into an owning DataArray.
+        DataArray materialize() const;
+
+    private:
+        struct Axis
+        {
+            Index start = 0;
+            Index step = 1;
+            Index count = 0;
+            Index width = 0;      // regular size of the parent dimension
+            bool retained = true;
+        };
+
+        const DataArray* parent_;
+        std::vector<Axis> axes_;  // one per parent dimension, outermost first
+        Index size_ = 0;
+    };
+} // namespace xdataset
+
+#endif // DATA_ARRAY_VIEW_H
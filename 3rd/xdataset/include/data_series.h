@@ -4,6 +4,7 @@
 #include <Eigen/Dense>
 #include <unsupported/Eigen/CXX11/Tensor>
 
+#include <atomic>
 #include <cstddef>
 #include <iterator>
 #include <memory>
@@ -22,6 +23,17 @@ namespace xdataset {
 
 class DataSeries;
 
+/// Source of the cells of a deferred DataSeries (see DataSeries::CreateDeferred()).
+/// load() may be called from several threads at once.
+class XDATASET_API SeriesLoader {
+public:
+    virtual ~SeriesLoader() {}
+
+    /// Rows start, start + step, ... (`count` of them) as an in-memory series
+    /// with the deferred series' data type, shape and unit.
+    virtual DataSeries load(Index start, Index step, std::size_t count) const = 0;
+};
+
 class XDATASET_API DataSeries {
 public:
     class RowView;
@@ -331,7 +343,44 @@ public:
     //
     static DataSeries CreateFromMeasurements(const std::vector<Measurement>& measurements);
 
-    std::size_t size() const { return storage_->size(); }
+    // -----------------------------------------------------------------------
+    //  Factory: CreateDeferred -> cells read on demand from a SeriesLoader
+    // -----------------------------------------------------------------------
+    //
+    //  Only the schema and row count are known up front.  The first read of
+    //  the cells loads every row and keeps them while this series -- or a
+    //  copy taken after that read -- is alive; copies that share the loader
+    //  reuse the loaded rows as long as any of them still holds them.
+    //  read_rows() / iloc() on a series that has not been loaded read just
+    //  the requested rows.  The first write turns the series into an
+    //  ordinary in-memory one.
+    //
+    static DataSeries CreateDeferred(DataType dtype, const DataShape& shape, std::size_t rows,
+                                     const Unit& u, std::shared_ptr<const SeriesLoader> loader);
+
+    // -----------------------------------------------------------------------
+    //  Factory: CreateBorrowed -> read-only view of numeric cells in place
+    // -----------------------------------------------------------------------
+    //
+    //  `cells` holds rows * element_count() values of the C++ type of a
+    //  numeric `dtype` (double / int / std::complex<double>), row-major and
+    //  suitably aligned, and must stay valid while `owner` is alive.  Copies
+    //  share the borrowed cells; the first write copies them into memory
+    //  owned by the series.
+    //
+    static DataSeries CreateBorrowed(DataType dtype, const DataShape& shape, const void* cells,
+                                     std::size_t rows, const Unit& u,
+                                     std::shared_ptr<const void> owner);
+
+    /// True when the cells are borrowed (CreateBorrowed()) rather than owned.
+    bool is_borrowed() const { return !deferred_ && storage_->is_borrowed(); }
+
+    /// True while the cells are still only in the SeriesLoader.
+    bool is_deferred() const {
+        return deferred_ && resident_.load(std::memory_order_acquire) == nullptr;
+    }
+
+    std::size_t size() const { return deferred_ ? deferred_rows() : storage_->size(); }
     bool empty() const { return size() == 0; }
 
     DataKind data_kind() const { return shape_.kind(); }
@@ -412,8 +461,8 @@ public:
 
     Index element_count() const { return shape_.element_count(); }
 
-    void resize(std::size_t n) { storage_->resize(n); }
-    void clear() { storage_->resize(0); }
+    void resize(std::size_t n) { mutable_storage()->resize(n); }
+    void clear() { mutable_storage()->resize(0); }
 
     DataSeries head(std::size_t n) const;
 
@@ -421,6 +470,9 @@ public:
 
     DataSeries iloc(std::size_t start, std::size_t end) const;
 
+    /// Rows start, start + step, ... (`count` of them) as a new series.
+    DataSeries read_rows(Index start, Index step, std::size_t count) const;
+
     iterator begin() { return iterator(this, 0); }
     iterator end() { return iterator(this, static_cast<Index>(size())); }
     const_iterator begin() const { return const_iterator(this, 0); }
@@ -633,28 +685,51 @@ private:
 
     static std::unique_ptr<SeriesStorage> make_storage(DataType dtype, const DataShape& shape);
 
+    // Copies of a series share one storage block (copy-on-write).  Every
+    // non-const path to the cells goes through here and first detaches a
+    // private copy when the block is shared or borrowed, so writes never
+    // leak into other series or into read-only memory.  Do not keep a mutable reference across a copy.
+    SeriesStorage* mutable_storage() {
+        if (deferred_) detach_deferred();
+        if (storage_.use_count() > 1 || storage_->is_borrowed())
+            storage_ = std::shared_ptr<SeriesStorage>(storage_->clone());
+        return storage_.get();
+    }
+
+    // Read-only path to the cells; loads a deferred series on first use.
+    const SeriesStorage* read_storage() const {
+        return deferred_ ? resident_storage() : storage_.get();
+    }
+
+    struct DeferredCells;
+
+    std::size_t deferred_rows() const;
+    const SeriesStorage* resident_storage() const;
+    void detach_deferred();
+    void copy_deferred_from(const DataSeries& other);
+
     template <typename T>
     ScalarSeriesStorage<T>* scalar_storage() {
         if (shape_.kind() != DataKind::kScalar || data_type_ != DataTypeOf<T>::tag) throw std::bad_cast();
-        return static_cast<ScalarSeriesStorage<T>*>(storage_.get());
+        return static_cast<ScalarSeriesStorage<T>*>(mutable_storage());
     }
 
     template <typename T>
     const ScalarSeriesStorage<T>* scalar_storage() const {
         if (shape_.kind() != DataKind::kScalar || data_type_ != DataTypeOf<T>::tag) throw std::bad_cast();
-        return static_cast<const ScalarSeriesStorage<T>*>(storage_.get());
+        return static_cast<const ScalarSeriesStorage<T>*>(read_storage());
     }
 
     template <typename T>
     VectorNumericSeriesStorage<T>* vector_storage_numeric() {
         if (shape_.kind() != DataKind::kVector || data_type_ != DataTypeOf<T>::tag || std::is_same<T, std::string>::value) throw std::bad_cast();
-        return static_cast<VectorNumericSeriesStorage<T>*>(storage_.get());
+        return static_cast<VectorNumericSeriesStorage<T>*>(mutable_storage());
     }
 
     template <typename T>
     const VectorNumericSeriesStorage<T>* vector_storage_numeric() const {
         if (shape_.kind() != DataKind::kVector || data_type_ != DataTypeOf<T>::tag || std::is_same<T, std::string>::value) throw std::bad_cast();
-        return static_cast<const VectorNumericSeriesStorage<T>*>(storage_.get());
+        return static_cast<const VectorNumericSeriesStorage<T>*>(read_storage());
     }
 
     VectorStringSeriesStorage* vector_storage_string();
@@ -664,13 +739,13 @@ private:
     template <typename T>
     MatrixNumericSeriesStorage<T>* matrix_storage_numeric() {
         if (shape_.kind() != DataKind::kMatrix || data_type_ != DataTypeOf<T>::tag || std::is_same<T, std::string>::value) throw std::bad_cast();
-        return static_cast<MatrixNumericSeriesStorage<T>*>(storage_.get());
+        return static_cast<MatrixNumericSeriesStorage<T>*>(mutable_storage());
     }
 
     template <typename T>
     const MatrixNumericSeriesStorage<T>* matrix_storage_numeric() const {
         if (shape_.kind() != DataKind::kMatrix || data_type_ != DataTypeOf<T>::tag || std::is_same<T, std::string>::value) throw std::bad_cast();
-        return static_cast<const MatrixNumericSeriesStorage<T>*>(storage_.get());
+        return static_cast<const MatrixNumericSeriesStorage<T>*>(read_storage());
     }
 
     MatrixStringSeriesStorage* matrix_storage_string();
@@ -693,8 +768,16 @@ private:
 
     DataType data_type_;
     DataShape shape_;
-    std::unique_ptr<SeriesStorage> storage_;
+    std::shared_ptr<SeriesStorage> storage_;
     Unit unit_;
+
+    // Set by CreateDeferred() until the first write; storage_ is an empty
+    // placeholder meanwhile.  pinned_ holds the loaded rows once this
+    // series has read them (guarded by the DeferredCells mutex) and
+    // resident_ publishes them to lock-free readers.
+    std::shared_ptr<DeferredCells> deferred_;
+    mutable std::shared_ptr<SeriesStorage> pinned_;
+    mutable std::atomic<const SeriesStorage*> resident_;
 };
 
 class DataSeries::RowView {
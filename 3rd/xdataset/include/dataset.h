@@ -1,9 +1,11 @@
 ﻿#ifndef DATASET_H
 #define DATASET_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tsl/ordered_map.h>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -151,9 +153,14 @@ inline TreeNode& TreeNode::operator=(TreeNode&& other) noexcept
         // Construction
         // --------------------------------------------------------------------
 
-        Dataset() = default;
+        Dataset();
         explicit Dataset(std::string name);
 
+        // Move-only (the tree owns its nodes).  Both sides get a new
+        // revision(), so lookups cached against either are invalidated.
+        Dataset(Dataset&& other) noexcept;
+        Dataset& operator=(Dataset&& other) noexcept;
+
         /// Human-readable name, e.g. "noise".
         const std::string& name() const { return name_; }
         void               set_name(std::string name) { name_ = std::move(name); }
@@ -197,6 +204,23 @@ inline TreeNode& TreeNode::operator=(TreeNode&& other) noexcept
         /// Blocks in the entire Dataset.
         bool HasUniqueDataArray(const std::string& data_array_name) const;
 
+        /// Paths of the Blocks holding a DataArray named `data_array_name`,
+        /// in the order the Blocks were added; empty when there is none.
+        /// Served from a name index kept up to date by AddBlock /
+        /// RemoveBlock / RemoveGroup, not by walking the tree.
+        const std::vector<std::string>& FindDataArrayPaths(
+            const std::string& data_array_name) const;
+
+        /// Path of the only Block holding `data_array_name`.  Throws
+        /// std::invalid_argument when it is missing or not unique.
+        std::string FindUniqueDataArray(const std::string& data_array_name) const;
+
+        /// Changes whenever Blocks are added or removed, and is never shared
+        /// by two Datasets (or by one Dataset before and after a move), so
+        /// {this, revision()} identifies one state of the tree for caching
+        /// resolved paths.
+        std::uint64_t revision() const { return revision_; }
+
         // --------------------------------------------------------------------
         // Access
         // --------------------------------------------------------------------
@@ -264,13 +288,21 @@ inline TreeNode& TreeNode::operator=(TreeNode&& other) noexcept
         /// Recursively count Blocks.
         std::size_t collect_block_count(const TreeNode& node) const;
 
-        /// Walk the tree looking for `data_array_name`.
-        /// Returns the block path of the unique match.
-        std::string find_unique_data_array(
-            const std::string& data_array_name) const;
+        /// Add / drop the DataArray names of the Block at `path` in the
+        /// name index.
+        void index_block(const std::string& path, const Block& block);
+        void unindex_block(const std::string& path, const Block& block);
+
+        /// Drop every Block at or below `node` (found at `path`) from the
+        /// name index.
+        void unindex_subtree(const TreeNode& node, const std::string& path);
 
         std::string name_;
         TreeNode    root_;
+
+        /// DataArray name -> paths of the Blocks holding it.
+        std::unordered_map<std::string, std::vector<std::string>> data_array_paths_;
+        std::uint64_t revision_;
     };
 }
 
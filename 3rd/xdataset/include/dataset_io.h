@@ -1,6 +1,7 @@
 #ifndef XDATASET_DATASET_IO_H
 #define XDATASET_DATASET_IO_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -11,6 +12,38 @@ namespace xdataset
 
 class Dataset;
 
+// =========================================================================
+// DatasetIOOptions -- format tuning for DatasetIO
+// =========================================================================
+//
+// Understood by the "hdf5" format, except `threads` which is used by
+// "touchstone"; formats ignore the options they do not use.
+// =========================================================================
+
+struct DatasetIOOptions
+{
+    // ---- writing ----
+
+    /// Rows per HDF5 chunk of numeric series; 0 picks about 1 MiB per chunk.
+    std::size_t chunk_rows = 0;
+
+    /// gzip level 1-9 for numeric series; 0 writes them uncompressed.
+    int deflate_level = 0;
+
+    /// Byte-shuffle numeric series before compressing them.
+    bool shuffle = false;
+
+    // ---- reading ----
+
+    /// Defer numeric series: only block structure and metadata are read
+    /// up front, cells are read when first used (DataSeries::CreateDeferred()).
+    bool lazy = false;
+
+    /// Worker threads when loading a directory of Touchstone files;
+    /// 0 uses std::thread::hardware_concurrency().
+    std::size_t threads = 0;
+};
+
 // =========================================================================
 // IDatasetWriter -- abstract output for Dataset persistence
 // =========================================================================
@@ -53,27 +86,50 @@ class XDATASET_API DatasetIO
 {
 public:
     /// Create a writer for the given format.
-    /// @param format  "hdf5" (extensible)
+    /// @param format  "hdf5" or "xds" (native memory-mapped format)
     /// @param path    output file path
     static std::unique_ptr<IDatasetWriter> CreateWriter(
         const std::string& format,
         const std::string& path);
 
+    static std::unique_ptr<IDatasetWriter> CreateWriter(
+        const std::string& format,
+        const std::string& path,
+        const DatasetIOOptions& options);
+
     /// Create a reader for the given format.
-    /// @param format  "hdf5" (extensible)
-    /// @param path    input file path
+    /// @param format  "hdf5", "xds", "touchstone" / "snp"
+    /// @param path    input file path (touchstone: a file or a directory
+    ///                of .sNp files)
+    /// @note touchstone: 3+ port files are read row-major, as the format
+    ///       specifies.  Files of 3+ ports saved by earlier versions of the
+    ///       writer are column-major and now read back transposed.
     static std::unique_ptr<IDatasetReader> CreateReader(
         const std::string& format,
         const std::string& path);
 
+    static std::unique_ptr<IDatasetReader> CreateReader(
+        const std::string& format,
+        const std::string& path,
+        const DatasetIOOptions& options);
+
     /// Convenience: save a Dataset using the writer for `format`.
     static void Save(const Dataset& dataset,
                      const std::string& format,
                      const std::string& path);
 
+    static void Save(const Dataset& dataset,
+                     const std::string& format,
+                     const std::string& path,
+                     const DatasetIOOptions& options);
+
     /// Convenience: load a Dataset using the reader for `format`.
     static Dataset Load(const std::string& format,
                         const std::string& path);
+
+    static Dataset Load(const std::string& format,
+                        const std::string& path,
+                        const DatasetIOOptions& options);
 };
 
 } // namespace xdataset
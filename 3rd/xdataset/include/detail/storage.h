@@ -34,6 +34,14 @@ struct NumericMatrixTypes {
 // ---------------------------------------------------------------------------
 //  Cell storage hierarchy (internal, not exposed to end users)
 // ---------------------------------------------------------------------------
+//
+//  A storage block is shared between copies of a DataSeries and is only
+//  duplicated (via clone()) when one of them is about to be written.
+//
+//  Numeric storage may instead borrow read-only cells that live elsewhere
+//  (e.g. in a memory-mapped file), kept alive by an owner handle.  A
+//  borrowed block is never written: clone() copies the cells into an
+//  owned block, and DataSeries clones before any write.
 
 class SeriesStorage {
 public:
@@ -41,31 +49,51 @@ public:
     virtual std::size_t size() const = 0;
     virtual void resize(std::size_t rows) = 0;
     virtual std::unique_ptr<SeriesStorage> clone() const = 0;
+
+    bool is_borrowed() const { return owner_ != nullptr; }
+
+protected:
+    std::shared_ptr<const void> owner_;   // keeps borrowed cells alive
 };
 
 template <typename T>
 class ScalarSeriesStorage : public SeriesStorage {
 public:
-    std::size_t size() const override { return values_.size(); }
+    ScalarSeriesStorage() : borrowed_(nullptr), borrowed_rows_(0) {}
+
+    ScalarSeriesStorage(const T* cells, std::size_t rows, std::shared_ptr<const void> owner)
+        : borrowed_(cells), borrowed_rows_(rows) {
+        owner_ = std::move(owner);
+    }
+
+    std::size_t size() const override { return borrowed_ ? borrowed_rows_ : values_.size(); }
 
     void resize(std::size_t rows) override {
         values_.resize(rows, T());
     }
 
     std::unique_ptr<SeriesStorage> clone() const override {
-        return std::unique_ptr<SeriesStorage>(new ScalarSeriesStorage<T>(*this));
+        std::unique_ptr<ScalarSeriesStorage<T>> copy(new ScalarSeriesStorage<T>());
+        if (borrowed_) copy->values_.assign(borrowed_, borrowed_ + borrowed_rows_);
+        else copy->values_ = values_;
+        return std::unique_ptr<SeriesStorage>(copy.release());
     }
 
     T& value(Index row) { return values_[static_cast<std::size_t>(row)]; }
-    const T& value(Index row) const { return values_[static_cast<std::size_t>(row)]; }
+    const T& value(Index row) const { return data()[row]; }
 
     void append(const T& v) { values_.push_back(v); }
 
     T* data() { return values_.empty() ? nullptr : &values_[0]; }
-    const T* data() const { return values_.empty() ? nullptr : &values_[0]; }
+    const T* data() const {
+        if (borrowed_) return borrowed_;
+        return values_.empty() ? nullptr : &values_[0];
+    }
 
 private:
     std::vector<T> values_;
+    const T* borrowed_;
+    std::size_t borrowed_rows_;
 };
 
 template <typename T>
@@ -75,7 +103,13 @@ public:
     typedef typename NumericVectorTypes<T>::MapType MapType;
     typedef typename NumericVectorTypes<T>::ConstMapType ConstMapType;
 
-    explicit VectorNumericSeriesStorage(Index width) : width_(width), rows_(0) {}
+    explicit VectorNumericSeriesStorage(Index width) : width_(width), rows_(0), borrowed_(nullptr) {}
+
+    VectorNumericSeriesStorage(Index width, const T* cells, std::size_t rows,
+                               std::shared_ptr<const void> owner)
+        : width_(width), rows_(rows), borrowed_(cells) {
+        owner_ = std::move(owner);
+    }
 
     std::size_t size() const override { return rows_; }
 
@@ -85,7 +119,11 @@ public:
     }
 
     std::unique_ptr<SeriesStorage> clone() const override {
-        return std::unique_ptr<SeriesStorage>(new VectorNumericSeriesStorage<T>(*this));
+        std::unique_ptr<VectorNumericSeriesStorage<T>> copy(new VectorNumericSeriesStorage<T>(width_));
+        copy->rows_ = rows_;
+        if (borrowed_) copy->values_.assign(borrowed_, borrowed_ + static_cast<std::size_t>(width_) * rows_);
+        else copy->values_ = values_;
+        return std::unique_ptr<SeriesStorage>(copy.release());
     }
 
     MapType value(Index row) {
@@ -109,7 +147,10 @@ public:
     }
 
     T* data() { return values_.empty() ? nullptr : &values_[0]; }
-    const T* data() const { return values_.empty() ? nullptr : &values_[0]; }
+    const T* data() const {
+        if (borrowed_) return borrowed_;
+        return values_.empty() ? nullptr : &values_[0];
+    }
 
 private:
     T* ptr_for_row(Index row) {
@@ -123,6 +164,7 @@ private:
     Index width_;
     std::size_t rows_;
     std::vector<T> values_;
+    const T* borrowed_;
 };
 
 class VectorStringSeriesStorage : public SeriesStorage {
@@ -166,7 +208,13 @@ public:
     typedef typename NumericMatrixTypes<T>::ConstMapType ConstMapType;
 
     MatrixNumericSeriesStorage(Index rows, Index cols)
-        : cell_rows_(rows), cell_cols_(cols), row_count_(0) {}
+        : cell_rows_(rows), cell_cols_(cols), row_count_(0), borrowed_(nullptr) {}
+
+    MatrixNumericSeriesStorage(Index rows, Index cols, const T* cells, std::size_t row_count,
+                               std::shared_ptr<const void> owner)
+        : cell_rows_(rows), cell_cols_(cols), row_count_(row_count), borrowed_(cells) {
+        owner_ = std::move(owner);
+    }
 
     std::size_t size() const override { return row_count_; }
 
@@ -176,7 +224,15 @@ public:
     }
 
     std::unique_ptr<SeriesStorage> clone() const override {
-        return std::unique_ptr<SeriesStorage>(new MatrixNumericSeriesStorage<T>(*this));
+        std::unique_ptr<MatrixNumericSeriesStorage<T>> copy(
+            new MatrixNumericSeriesStorage<T>(cell_rows_, cell_cols_));
+        copy->row_count_ = row_count_;
+        if (borrowed_)
+            copy->values_.assign(borrowed_,
+                                 borrowed_ + static_cast<std::size_t>(cell_rows_ * cell_cols_) * row_count_);
+        else
+            copy->values_ = values_;
+        return std::unique_ptr<SeriesStorage>(copy.release());
     }
 
     MapType value(Index row) {
@@ -205,7 +261,10 @@ public:
     }
 
     T* data() { return values_.empty() ? nullptr : &values_[0]; }
-    const T* data() const { return values_.empty() ? nullptr : &values_[0]; }
+    const T* data() const {
+        if (borrowed_) return borrowed_;
+        return values_.empty() ? nullptr : &values_[0];
+    }
 
 private:
     T* ptr_for_row(Index row) {
@@ -220,6 +279,7 @@ private:
     Index cell_cols_;
     std::size_t row_count_;
     std::vector<T> values_;
+    const T* borrowed_;
 };
 
 class MatrixStringSeriesStorage : public SeriesStorage {
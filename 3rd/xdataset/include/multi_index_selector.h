@@ -13,19 +13,30 @@ namespace xdataset
         {
             kAny,
             kEqual,
-            kIn
+            kIn,
+            kRange
         };
 
         static MultiIndexSelector Any();
         static MultiIndexSelector Equal(Index idx);
         static MultiIndexSelector In(const std::vector<Index>& indices);
+        /// Every step-th index in [start, stop).  Like In, a range always
+        /// enumerates ascending indices (step >= 1) and must not be empty,
+        /// but it stores only its bounds, never the expanded index list.
+        static MultiIndexSelector Range(Index start, Index stop, Index step = 1);
 
         Kind kind() const;
         bool is_any() const;
         bool is_equal() const;
         bool is_in() const;
+        bool is_range() const;
         Index equal_value() const;
         const std::vector<Index>& in_values() const;
+        Index range_start() const;
+        Index range_step() const;
+        /// Number of indices in the range; the last one is
+        /// range_start() + (range_count() - 1) * range_step().
+        Index range_count() const;
         std::vector<Index> resolve(Index width) const;
         bool matches(Index idx) const;
 
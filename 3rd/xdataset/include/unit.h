@@ -153,7 +153,9 @@ public:
     // ---- static factory ------------------------------------------------
 
     /// Parse a REL unit string.  Throws std::invalid_argument when the
-    /// string is not in the REL vocabulary.
+    /// string is not in the REL vocabulary.  Thread-safe; each distinct
+    /// spelling is resolved against the registry once and then served
+    /// from an intern table.
     static Unit parse(const std::string& s);
 
     // ---- arithmetic on dimensions (inputs must be canonical) ------------
@@ -172,6 +174,9 @@ private:
     // by canonicalize / multiply_dim / etc.
     explicit Unit(double mult, UnitData dim);
 
+    // Registry walk behind parse().
+    static Unit parse_uncached(const std::string& s);
+
     double   mult_ = 1.0;
     UnitData dim_;
 };
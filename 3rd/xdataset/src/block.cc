@@ -62,6 +62,28 @@ namespace xdataset
     {
     }
 
+    Block::Block(Block&& other) noexcept
+        : name_(std::move(other.name_)),
+          independent_spec_map_(std::move(other.independent_spec_map_)),
+          dependent_spec_map_(std::move(other.dependent_spec_map_)),
+          data_array_cache_(std::move(other.data_array_cache_)),
+          data_frame_cache_(std::move(other.data_frame_cache_))
+    {
+    }
+
+    Block& Block::operator=(Block&& other) noexcept
+    {
+        if (this != &other)
+        {
+            name_                 = std::move(other.name_);
+            independent_spec_map_ = std::move(other.independent_spec_map_);
+            dependent_spec_map_   = std::move(other.dependent_spec_map_);
+            data_array_cache_     = std::move(other.data_array_cache_);
+            data_frame_cache_     = std::move(other.data_frame_cache_);
+        }
+        return *this;
+    }
+
     const std::string& Block::name() const
     {
         return name_;
@@ -139,6 +161,9 @@ namespace xdataset
 
     const DataArray& Block::GetOrCreateDataArray(const std::string& name) const
     {
+        // Cached DataArrays are never evicted, so references handed out
+        // before another thread's insertion stay valid.
+        std::lock_guard<std::mutex> lock(data_array_cache_mutex_);
         auto cached_it = data_array_cache_.find(name);
         if (cached_it != data_array_cache_.end())
             return *cached_it->second;
@@ -181,6 +206,7 @@ namespace xdataset
 
     const DataFrame& Block::GetOrCreateDataFrame() const
     {
+        std::lock_guard<std::mutex> lock(data_frame_cache_mutex_);
         if (!data_frame_cache_)
             data_frame_cache_ = DataFrame::FromBlock(*this);
         return *data_frame_cache_;
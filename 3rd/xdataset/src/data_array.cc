@@ -1,4 +1,5 @@
 #include "data_array.h"
+#include "data_array_view.h"
 #include "data_series.h"
 #include "dimension_spec.h"
 #include "multi_dimension_spec.h"
@@ -314,6 +315,13 @@ namespace xdataset
             throw std::invalid_argument("selector count exceeds DataArray rank");
         }
 
+        // Regular dimensions with Any / Equal / Range selectors: strided copy
+        // without walking the dimension tree or expanding index lists.
+        if (DataArrayView::CanView(*this, selectors))
+        {
+            return DataArrayView(*this, selectors).materialize();
+        }
+
         // `selectors` may be shorter than rank: normalize it by prepending Any and
         // keeping the user-provided selectors at the end, so short selectors only
         // constrain the trailing dimensions by default.
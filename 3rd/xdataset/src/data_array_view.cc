@@ -0,0 +1,280 @@
+#include "data_array_view.h"
+
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <string>
+
+namespace xdataset
+{
+    namespace
+    {
+        /// Pad `selectors` to `rank` entries the way DataArray::select() does:
+        /// missing leading dimensions are Any.
+        std::vector<MultiIndexSelector> pad_selectors(
+            const std::vector<MultiIndexSelector>& selectors, std::size_t rank)
+        {
+            std::vector<MultiIndexSelector> padded;
+            padded.reserve(rank);
+            if (selectors.size() < rank)
+                padded.insert(padded.end(), rank - selectors.size(), MultiIndexSelector::Any());
+            padded.insert(padded.end(), selectors.begin(), selectors.end());
+            return padded;
+        }
+
+        template <typename T, typename RowAt>
+        void copy_rows(const DataSeries& src, DataSeries& out, Index count, RowAt row_at)
+        {
+            const Index width = src.element_count();
+            const T* from = src.contiguous_data<T>();
+            T* to = out.mutable_contiguous_data<T>();
+            for (Index k = 0; k < count; ++k)
+            {
+                const T* row = from + row_at(k) * width;
+                std::copy(row, row + width, to + k * width);
+            }
+        }
+
+        /// Rows row_at(0) .. row_at(count - 1) of `src`, as DataSeries::append_from()
+        /// would collect them; numeric cells are copied in bulk.
+        template <typename RowAt>
+        DataSeries gather(const DataSeries& src, Index count, RowAt row_at)
+        {
+            DataSeries out(src.data_type(), src.data_shape());
+            if (count == 0)
+                return out;
+
+            switch (src.data_type())
+            {
+            case DataType::kReal:
+                out.resize(static_cast<std::size_t>(count));
+                copy_rows<double>(src, out, count, row_at);
+                break;
+            case DataType::kInteger:
+                out.resize(static_cast<std::size_t>(count));
+                copy_rows<int>(src, out, count, row_at);
+                break;
+            case DataType::kComplex:
+                out.resize(static_cast<std::size_t>(count));
+                copy_rows<std::complex<double>>(src, out, count, row_at);
+                break;
+            default:
+                for (Index k = 0; k < count; ++k)
+                    out.append_from(src, row_at(k));
+                return out;
+            }
+
+            // append_from() only carries dimensioned units over; match it.
+            if (src.unit().has_dimension())
+                out.set_unit(src.unit());
+            return out;
+        }
+
+        /// Rows start, start + step, ... (count of them) of `src`.  A full,
+        /// unit-step selection shares src's storage instead of copying it;
+        /// a deferred `src` reads only the selected rows.
+        DataSeries gather_rows(const DataSeries& src, Index start, Index step, Index count)
+        {
+            if (start == 0 && step == 1 && count == static_cast<Index>(src.size()))
+            {
+                DataSeries shared(src);
+                if (!src.unit().has_dimension())
+                    shared.set_unit(Unit());
+                return shared;
+            }
+            if (src.is_deferred())
+            {
+                DataSeries out = src.read_rows(start, step, static_cast<std::size_t>(count));
+                if (!src.unit().has_dimension())
+                    out.set_unit(Unit());
+                return out;
+            }
+            return gather(src, count, [start, step](Index k) { return start + k * step; });
+        }
+    } // namespace
+
+    bool DataArrayView::CanView(const DataArray& parent, const std::vector<MultiIndexSelector>& selectors)
+    {
+        const MultiDimensionSpec& spec = parent.multi_dimension_spec();
+        const std::size_t rank = spec.rank();
+        if (rank == 0 || selectors.size() > rank)
+            return false;
+
+        const std::size_t offset = rank - selectors.size();
+        for (std::size_t d = 0; d < rank; ++d)
+        {
+            if (!spec.dim(static_cast<Index>(d)).is_regular())
+                return false;
+            if (d >= offset && selectors[d - offset].is_in())
+                return false;
+        }
+        return true;
+    }
+
+    DataArrayView::DataArrayView(const DataArray& parent, const std::vector<MultiIndexSelector>& selectors)
+        : parent_(&parent)
+    {
+        const MultiDimensionSpec& spec = parent.multi_dimension_spec();
+        const std::size_t rank = spec.rank();
+        if (rank == 0)
+            throw std::logic_error("select requires non-empty dimensions");
+        if (selectors.size() > rank)
+            throw std::invalid_argument("selector count exceeds DataArray rank");
+        if (!CanView(parent, selectors))
+            throw std::invalid_argument("DataArrayView requires regular dimensions and Any/Equal/Range selectors");
+
+        const std::vector<MultiIndexSelector> padded = pad_selectors(selectors, rank);
+        const bool independent = parent.data_kind() == DataArrayKind::kIndependent;
+
+        // A dimension below one with nothing selected is never visited by
+        // select(), so its selector is not checked against the width either.
+        bool reached = true;
+        axes_.resize(rank);
+        for (std::size_t d = 0; d < rank; ++d)
+        {
+            Axis& axis = axes_[d];
+            const MultiIndexSelector& selector = padded[d];
+            axis.width = static_cast<Index>(spec.dim(static_cast<Index>(d)).regular_size());
+            axis.retained = !selector.is_equal() || (independent && d == rank - 1);
+
+            if (selector.is_any())
+            {
+                axis.count = axis.width;
+            }
+            else if (selector.is_equal())
+            {
+                axis.start = selector.equal_value();
+                axis.count = 1;
+            }
+            else
+            {
+                axis.start = selector.range_start();
+                axis.step = selector.range_step();
+                axis.count = selector.range_count();
+            }
+
+            if (reached && !selector.is_any() && axis.start + (axis.count - 1) * axis.step >= axis.width)
+                selector.resolve(axis.width);  // throws the same out_of_range as select()
+
+            if (!reached)
+                axis.count = 0;
+            reached = reached && axis.count > 0;
+        }
+
+        if (independent)
+        {
+            size_ = axes_.back().count;
+        }
+        else
+        {
+            size_ = 1;
+            for (const Axis& axis : axes_)
+                size_ *= axis.count;
+        }
+    }
+
+    std::size_t DataArrayView::rank() const
+    {
+        std::size_t retained = 0;
+        for (const Axis& axis : axes_)
+        {
+            if (axis.retained)
+                ++retained;
+        }
+        return retained;
+    }
+
+    Index DataArrayView::parent_row(Index i) const
+    {
+        if (i < 0 || i >= size_)
+            throw std::out_of_range("view row index out of range");
+
+        if (parent_->data_kind() == DataArrayKind::kIndependent)
+            return axes_.back().start + i * axes_.back().step;
+
+        // Row-major over the selected cells, innermost dimension fastest.
+        Index flat = 0;
+        Index stride = 1;
+        for (std::size_t d = axes_.size(); d-- > 0;)
+        {
+            const Axis& axis = axes_[d];
+            flat += (axis.start + (i % axis.count) * axis.step) * stride;
+            i /= axis.count;
+            stride *= axis.width;
+        }
+        return flat;
+    }
+
+    Measurement DataArrayView::measurement_at(Index i) const
+    {
+        const DataSeries& data = parent_->data();
+        const Index row = parent_row(i);
+        if (data.is_deferred())
+            return data.read_rows(row, 1, 1).measurement_at(0);
+        return data.measurement_at(row);
+    }
+
+    DataArray DataArrayView::materialize() const
+    {
+        const bool dependent = parent_->data_kind() == DataArrayKind::kDependent;
+
+        DataArrayCreateInfo info;
+        info.kind = parent_->data_kind();
+        for (const Axis& axis : axes_)
+        {
+            if (axis.retained)
+                info.multi_dimension_spec.add_regular(static_cast<std::size_t>(axis.count));
+        }
+
+        // Same entry order as DataArray::select(): dimension data first,
+        // kSelf last.
+        const DataSeriesMap& datas = parent_->datas();
+        std::size_t idx = 0;
+        for (auto it = datas.begin(); it != datas.end(); ++it, ++idx)
+        {
+            const bool is_self = (idx == datas.size() - 1);
+            if (is_self && dependent)
+            {
+                const DataSeries& src = it->second;
+                if (size_ == static_cast<Index>(src.size()))
+                {
+                    info.datas.emplace(DataArray::kSelf, gather_rows(src, 0, 1, size_));
+                }
+                else if (src.is_deferred() && size_ > 0)
+                {
+                    // Read the span between the first and last selected
+                    // cell (rows are visited in increasing order), then
+                    // gather from it.
+                    const Index first = parent_row(0);
+                    const Index span = parent_row(size_ - 1) - first + 1;
+                    const DataSeries rows = src.read_rows(first, 1, static_cast<std::size_t>(span));
+                    info.datas.emplace(DataArray::kSelf,
+                                       gather(rows, size_, [this, first](Index r) { return parent_row(r) - first; }));
+                }
+                else
+                {
+                    info.datas.emplace(DataArray::kSelf,
+                                       gather(src, size_, [this](Index r) { return parent_row(r); }));
+                }
+                continue;
+            }
+
+            const Axis& axis = axes_[idx];
+            if (!axis.retained)
+                continue;
+            std::string key = is_self ? std::string(DataArray::kSelf) : it->first;
+            info.datas.emplace(std::move(key), gather_rows(it->second, axis.start, axis.step, axis.count));
+        }
+
+        // A Dependent selection with every dimension removed is demoted to a
+        // single-dimension Independent array, as in DataArray::select().
+        if (dependent && info.datas.size() == 1)
+        {
+            info.kind = DataArrayKind::kIndependent;
+            info.multi_dimension_spec =
+                MultiDimensionSpec().add_regular(static_cast<std::size_t>(info.datas[DataArray::kSelf].size()));
+        }
+
+        return DataArray(std::move(info));
+    }
+} // namespace xdataset
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <complex>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -17,24 +18,29 @@ DataSeries::DataSeries()
     : data_type_(DataType::kReal),
       shape_(),
       storage_(make_storage(DataType::kReal, DataShape())),
-      unit_() {}
+      unit_(),
+      resident_(nullptr) {}
 
 DataSeries::DataSeries(DataType dtype, const DataShape& shape)
     : data_type_(dtype == DataType::kBoolean ? DataType::kInteger : dtype)
     , shape_(shape)
     , storage_(make_storage(dtype == DataType::kBoolean ? DataType::kInteger : dtype, shape))
-    , unit_() {}
+    , unit_()
+    , resident_(nullptr) {}
 
 DataSeries::DataSeries(const DataSeries& other)
     : data_type_(other.data_type_), shape_(other.shape_),
-      storage_(other.storage_->clone()), unit_(other.unit_) {}
+      storage_(other.storage_), unit_(other.unit_), resident_(nullptr) {
+    copy_deferred_from(other);
+}
 
 DataSeries& DataSeries::operator=(const DataSeries& other) {
     if (this != &other) {
         data_type_ = other.data_type_;
         shape_ = other.shape_;
-        storage_ = other.storage_->clone();
+        storage_ = other.storage_;
         unit_ = other.unit_;
+        copy_deferred_from(other);
     }
     return *this;
 }
@@ -43,16 +49,146 @@ DataSeries::DataSeries(DataSeries&& other) noexcept
     : data_type_(other.data_type_),
       shape_(std::move(other.shape_)),
       storage_(std::move(other.storage_)),
-      unit_(std::move(other.unit_)) {}
+      unit_(std::move(other.unit_)),
+      deferred_(std::move(other.deferred_)),
+      pinned_(std::move(other.pinned_)),
+      resident_(other.resident_.exchange(nullptr)) {}
 
 DataSeries& DataSeries::operator=(DataSeries&& other) noexcept {
     data_type_ = other.data_type_;
     shape_ = std::move(other.shape_);
     storage_ = std::move(other.storage_);
     unit_ = std::move(other.unit_);
+    deferred_ = std::move(other.deferred_);
+    pinned_ = std::move(other.pinned_);
+    resident_.store(other.resident_.exchange(nullptr));
     return *this;
 }
 
+// =========================================================================
+// DataSeries -- deferred cells
+// =========================================================================
+
+namespace {
+
+template <typename T>
+std::shared_ptr<SeriesStorage> make_borrowed_storage(const T* cells, const DataShape& shape,
+                                                     std::size_t rows, std::shared_ptr<const void> owner) {
+    switch (shape.kind()) {
+    case DataKind::kVector:
+        return std::make_shared<VectorNumericSeriesStorage<T>>(shape[0], cells, rows, std::move(owner));
+    case DataKind::kMatrix:
+        return std::make_shared<MatrixNumericSeriesStorage<T>>(shape[0], shape[1], cells, rows,
+                                                               std::move(owner));
+    default:
+        return std::make_shared<ScalarSeriesStorage<T>>(cells, rows, std::move(owner));
+    }
+}
+
+}  // namespace
+
+struct DataSeries::DeferredCells {
+    std::shared_ptr<const SeriesLoader> loader;
+    std::size_t rows;
+    std::mutex mutex;                      // guards cache and every pinned_ sharing this
+    std::weak_ptr<SeriesStorage> cache;    // rows loaded by any series sharing this
+};
+
+DataSeries DataSeries::CreateDeferred(DataType dtype, const DataShape& shape, std::size_t rows,
+                                      const Unit& u, std::shared_ptr<const SeriesLoader> loader) {
+    if (!loader) throw std::invalid_argument("deferred series requires a loader");
+    DataSeries s(dtype, shape);
+    s.set_unit(u);
+    s.deferred_ = std::make_shared<DeferredCells>();
+    s.deferred_->loader = std::move(loader);
+    s.deferred_->rows = rows;
+    return s;
+}
+
+DataSeries DataSeries::CreateBorrowed(DataType dtype, const DataShape& shape, const void* cells,
+                                      std::size_t rows, const Unit& u,
+                                      std::shared_ptr<const void> owner) {
+    if (!owner) throw std::invalid_argument("borrowed series requires an owner");
+    if (rows > 0 && cells == nullptr)
+        throw std::invalid_argument("cells pointer must not be null when rows > 0");
+
+    DataSeries s(dtype, shape);
+    s.set_unit(u);
+    if (rows == 0) return s;
+
+    switch (dtype) {
+    case DataType::kReal:
+        s.storage_ = make_borrowed_storage(static_cast<const double*>(cells), shape, rows, std::move(owner));
+        break;
+    case DataType::kInteger:
+        s.storage_ = make_borrowed_storage(static_cast<const int*>(cells), shape, rows, std::move(owner));
+        break;
+    case DataType::kComplex:
+        s.storage_ = make_borrowed_storage(static_cast<const std::complex<double>*>(cells), shape, rows,
+                                           std::move(owner));
+        break;
+    default:
+        throw std::invalid_argument("borrowed series must be real, integer or complex");
+    }
+    return s;
+}
+
+std::size_t DataSeries::deferred_rows() const {
+    return deferred_->rows;
+}
+
+const SeriesStorage* DataSeries::resident_storage() const {
+    const SeriesStorage* resident = resident_.load(std::memory_order_acquire);
+    if (resident) return resident;
+
+    std::lock_guard<std::mutex> lock(deferred_->mutex);
+    if (!pinned_) {
+        pinned_ = deferred_->cache.lock();
+        if (!pinned_) {
+            DataSeries loaded = deferred_->loader->load(0, 1, deferred_->rows);
+            if (loaded.deferred_ || loaded.data_type_ != data_type_ || loaded.shape_ != shape_ ||
+                loaded.size() != deferred_->rows)
+                throw std::runtime_error("series loader returned rows of the wrong schema");
+            pinned_ = std::move(loaded.storage_);
+            deferred_->cache = pinned_;
+        }
+        resident_.store(pinned_.get(), std::memory_order_release);
+    }
+    return pinned_.get();
+}
+
+void DataSeries::detach_deferred() {
+    resident_storage();
+    {
+        // Decided under the lock: other holders only appear through
+        // cache.lock(), which takes it too, so a count of one is final here.
+        // Shared rows are cloned and stay in the cache for never-loaded
+        // copies; unshared ones leave the cache and are written in place.
+        std::lock_guard<std::mutex> lock(deferred_->mutex);
+        if (pinned_.use_count() == 1) {
+            deferred_->cache.reset();
+            storage_ = std::move(pinned_);
+        } else {
+            storage_ = std::shared_ptr<SeriesStorage>(pinned_->clone());
+            pinned_.reset();
+        }
+    }
+    deferred_.reset();
+    resident_.store(nullptr);
+}
+
+void DataSeries::copy_deferred_from(const DataSeries& other) {
+    deferred_ = other.deferred_;
+    if (!deferred_) {
+        pinned_.reset();
+        resident_.store(nullptr);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(deferred_->mutex);
+    pinned_ = other.pinned_;
+    resident_.store(pinned_.get(), std::memory_order_release);
+}
+
 // =========================================================================
 // DataSeries -- unit
 // =========================================================================
@@ -256,12 +392,32 @@ DataSeries DataSeries::tail(std::size_t n) const {
 
 DataSeries DataSeries::iloc(std::size_t start, std::size_t end) const {
     if (start > end || end > size()) throw std::out_of_range("iloc out of range");
+    if (is_deferred()) return read_rows(static_cast<Index>(start), 1, end - start);
     DataSeries out(data_type_, shape_);
     out.unit_ = unit_;
     for (std::size_t i = start; i < end; ++i) out.append_from(*this, static_cast<Index>(i));
     return out;
 }
 
+DataSeries DataSeries::read_rows(Index start, Index step, std::size_t count) const {
+    if (start < 0 || step < 1) throw std::invalid_argument("read_rows requires start >= 0 and step >= 1");
+    if (count > 0 && static_cast<std::size_t>(start) + (count - 1) * static_cast<std::size_t>(step) >= size())
+        throw std::out_of_range("read_rows out of range");
+
+    if (is_deferred()) {
+        DataSeries out = deferred_->loader->load(start, step, count);
+        if (out.data_type_ != data_type_ || out.shape_ != shape_ || out.size() != count)
+            throw std::runtime_error("series loader returned rows of the wrong schema");
+        return out;
+    }
+
+    DataSeries out(data_type_, shape_);
+    out.unit_ = unit_;
+    for (std::size_t k = 0; k < count; ++k)
+        out.append_from(*this, start + static_cast<Index>(k) * step);
+    return out;
+}
+
 // =========================================================================
 // DataSeries -- append helpers (non-template overloads)
 // =========================================================================
@@ -789,22 +945,22 @@ std::unique_ptr<SeriesStorage> DataSeries::make_storage(DataType dtype, const Da
 
 VectorStringSeriesStorage* DataSeries::vector_storage_string() {
     if (shape_.kind() != DataKind::kVector || data_type_ != DataType::kString) throw std::bad_cast();
-    return static_cast<VectorStringSeriesStorage*>(storage_.get());
+    return static_cast<VectorStringSeriesStorage*>(mutable_storage());
 }
 
 const VectorStringSeriesStorage* DataSeries::vector_storage_string() const {
     if (shape_.kind() != DataKind::kVector || data_type_ != DataType::kString) throw std::bad_cast();
-    return static_cast<const VectorStringSeriesStorage*>(storage_.get());
+    return static_cast<const VectorStringSeriesStorage*>(read_storage());
 }
 
 MatrixStringSeriesStorage* DataSeries::matrix_storage_string() {
     if (shape_.kind() != DataKind::kMatrix || data_type_ != DataType::kString) throw std::bad_cast();
-    return static_cast<MatrixStringSeriesStorage*>(storage_.get());
+    return static_cast<MatrixStringSeriesStorage*>(mutable_storage());
 }
 
 const MatrixStringSeriesStorage* DataSeries::matrix_storage_string() const {
     if (shape_.kind() != DataKind::kMatrix || data_type_ != DataType::kString) throw std::bad_cast();
-    return static_cast<const MatrixStringSeriesStorage*>(storage_.get());
+    return static_cast<const MatrixStringSeriesStorage*>(read_storage());
 }
 
 // =========================================================================
@@ -1,14 +1,72 @@
 #include "dataset.h"
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <stdexcept>
 
 namespace xdataset
 {
+    namespace
+    {
+        /// Process-wide, so no two Datasets ever share a revision.
+        std::uint64_t NextRevision()
+        {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
+        std::string JoinPath(const std::vector<std::string>& parts, std::size_t count)
+        {
+            std::string path;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (i > 0) path += '/';
+                path += parts[i];
+            }
+            return path;
+        }
+
+        const std::vector<std::string>& NoPaths()
+        {
+            static const std::vector<std::string> empty;
+            return empty;
+        }
+    } // namespace
+
+    Dataset::Dataset()
+        : revision_(NextRevision())
+    {}
+
     Dataset::Dataset(std::string name)
         : name_(std::move(name))
+        , revision_(NextRevision())
     {}
 
+    Dataset::Dataset(Dataset&& other) noexcept
+        : name_(std::move(other.name_))
+        , root_(std::move(other.root_))
+        , data_array_paths_(std::move(other.data_array_paths_))
+        , revision_(NextRevision())
+    {
+        other.data_array_paths_.clear();
+        other.revision_ = NextRevision();
+    }
+
+    Dataset& Dataset::operator=(Dataset&& other) noexcept
+    {
+        if (this != &other)
+        {
+            name_             = std::move(other.name_);
+            root_             = std::move(other.root_);
+            data_array_paths_ = std::move(other.data_array_paths_);
+            revision_         = NextRevision();
+            other.data_array_paths_.clear();
+            other.revision_ = NextRevision();
+        }
+        return *this;
+    }
+
     std::vector<std::string> Dataset::SplitPath(const std::string& path)
     {
         std::vector<std::string> parts;
@@ -95,6 +153,43 @@ namespace xdataset
         return count;
     }
 
+    // =========================================================================
+    //  Name index -- DataArray name -> Block paths
+    // =========================================================================
+
+    void Dataset::index_block(const std::string& path, const Block& block)
+    {
+        for (const auto& n : block.independents())
+            data_array_paths_[n].push_back(path);
+        for (const auto& n : block.dependents())
+            data_array_paths_[n].push_back(path);
+    }
+
+    void Dataset::unindex_block(const std::string& path, const Block& block)
+    {
+        auto drop = [&](const std::string& n)
+        {
+            auto it = data_array_paths_.find(n);
+            if (it == data_array_paths_.end()) return;
+            auto& paths = it->second;
+            paths.erase(std::remove(paths.begin(), paths.end(), path), paths.end());
+            if (paths.empty()) data_array_paths_.erase(it);
+        };
+        for (const auto& n : block.independents()) drop(n);
+        for (const auto& n : block.dependents()) drop(n);
+    }
+
+    void Dataset::unindex_subtree(const TreeNode& node, const std::string& path)
+    {
+        if (const LeafNode* leaf = node.leaf())
+        {
+            unindex_block(path, *leaf->block);
+            return;
+        }
+        for (const auto& kv : node.internal()->children)
+            unindex_subtree(*kv.second, path.empty() ? kv.first : path + "/" + kv.first);
+    }
+
     // =========================================================================
     //  AddBlock -- three overloads, shared implementation
     // =========================================================================
@@ -141,6 +236,10 @@ namespace xdataset
         if (slot && slot->leaf())
             throw std::invalid_argument("duplicate Block at path: " + path);
 
+        const std::string canonical = JoinPath(parts, parts.size());
+        if (slot)
+            unindex_subtree(*slot, canonical);  // an empty-or-not group is replaced
+
         std::string dotted = path;
         for (auto& ch : dotted) if (ch == '/') ch = '.';
         block.set_name(dotted);
@@ -148,6 +247,8 @@ namespace xdataset
         auto owned = std::unique_ptr<Block>(new Block(std::move(block)));
         Block& ref = *owned;
         slot = std::unique_ptr<TreeNode>(new TreeNode(LeafNode{std::move(owned)}));
+        index_block(canonical, ref);
+        revision_ = NextRevision();
         return ref;
     }
 
@@ -173,7 +274,9 @@ namespace xdataset
         auto it = parent->children.find(parts.back());
         if (it == parent->children.end()) return 0;
         if (!it->second->leaf()) return 0;
+        unindex_block(JoinPath(parts, parts.size()), *it->second->leaf()->block);
         parent->children.erase(it);
+        revision_ = NextRevision();
         return 1;
     }
 
@@ -188,12 +291,16 @@ namespace xdataset
         {
             std::size_t n = block_count();
             root_.internal()->children.clear();
+            data_array_paths_.clear();
+            revision_ = NextRevision();
             return n;
         }
 
         const TreeNode* target = navigate(path);
         if (!target) return 0;
         std::size_t count = collect_block_count(*target);
+        unindex_subtree(*target, JoinPath(parts, parts.size()));
+        revision_ = NextRevision();
 
         InternalNode* parent = root_.internal();
         for (std::size_t i = 0; i + 1 < parts.size(); ++i)
@@ -224,20 +331,23 @@ namespace xdataset
 
     bool Dataset::HasUniqueDataArray(const std::string& data_array_name) const
     {
-        std::size_t count = 0;
-        std::vector<std::string> paths = GetAllBlockPaths();
-        for (const auto& p : paths)
-        {
-            const TreeNode* node = navigate(p);
-            const LeafNode* leaf = node ? node->leaf() : nullptr;
-            if (!leaf) continue;
-            const Block& block = *leaf->block;
-            for (const auto& n : block.independents())
-                if (n == data_array_name && ++count > 1) return false;
-            for (const auto& n : block.dependents())
-                if (n == data_array_name && ++count > 1) return false;
-        }
-        return count == 1;
+        return FindDataArrayPaths(data_array_name).size() == 1;
+    }
+
+    const std::vector<std::string>& Dataset::FindDataArrayPaths(const std::string& data_array_name) const
+    {
+        auto it = data_array_paths_.find(data_array_name);
+        return it == data_array_paths_.end() ? NoPaths() : it->second;
+    }
+
+    std::string Dataset::FindUniqueDataArray(const std::string& data_array_name) const
+    {
+        const std::vector<std::string>& paths = FindDataArrayPaths(data_array_name);
+        if (paths.empty())
+            throw std::invalid_argument("DataArray '" + data_array_name + "' not found in any block");
+        if (paths.size() > 1)
+            throw std::invalid_argument("DataArray '" + data_array_name + "' is not unique (found in " + std::to_string(paths.size()) + " places); use the full block_path/data_array_name syntax");
+        return paths.front();
     }
 
     // =========================================================================
@@ -252,7 +362,7 @@ namespace xdataset
 
     const DataArray& Dataset::GetDataArray(const std::string& data_array_name)
     {
-        std::string path = find_unique_data_array(data_array_name);
+        std::string path = FindUniqueDataArray(data_array_name);
         return GetDataArray(path, data_array_name);
     }
 
@@ -321,31 +431,4 @@ namespace xdataset
     }
 
     std::size_t Dataset::block_count() const { return collect_block_count(root_); }
-
-    // =========================================================================
-    //  find_unique_data_array
-    // =========================================================================
-
-    std::string Dataset::find_unique_data_array(const std::string& data_array_name) const
-    {
-        std::string found_path;
-        std::size_t count = 0;
-        std::vector<std::string> paths = GetAllBlockPaths();
-        for (const auto& p : paths)
-        {
-            const TreeNode* node = navigate(p);
-            const LeafNode* leaf = node ? node->leaf() : nullptr;
-            if (!leaf) continue;
-            const Block& block = *leaf->block;
-            for (const auto& n : block.independents())
-                if (n == data_array_name) { found_path = p; ++count; }
-            for (const auto& n : block.dependents())
-                if (n == data_array_name) { found_path = p; ++count; }
-        }
-        if (count == 0)
-            throw std::invalid_argument("DataArray '" + data_array_name + "' not found in any block");
-        if (count > 1)
-            throw std::invalid_argument("DataArray '" + data_array_name + "' is not unique (found in " + std::to_string(count) + " places); use the full block_path/data_array_name syntax");
-        return found_path;
-    }
 }
@@ -0,0 +1,86 @@
+#include "file_mapping.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xdataset
+{
+
+FileMapping::FileMapping(const std::string& path)
+    : data_(nullptr), size_(0)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("cannot open file: " + path);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("cannot open file: " + path);
+    }
+    if (size.QuadPart == 0)
+    {
+        // CreateFileMapping rejects empty files.
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        throw std::runtime_error("cannot map file: " + path);
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == NULL)
+        throw std::runtime_error("cannot map file: " + path);
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open file: " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        throw std::runtime_error("cannot open file: " + path);
+    }
+    if (st.st_size == 0)
+    {
+        // mmap rejects zero-length mappings.
+        ::close(fd);
+        return;
+    }
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+        throw std::runtime_error("cannot map file: " + path);
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+}
+
+FileMapping::~FileMapping()
+{
+    if (!data_)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+} // namespace xdataset
@@ -0,0 +1,41 @@
+#ifndef XDATASET_FILE_MAPPING_H
+#define XDATASET_FILE_MAPPING_H
+
+// =========================================================================
+// FileMapping -- read-only mapping of a whole file (private to the library)
+// =========================================================================
+//
+// Shared by the readers that parse or borrow file contents in place
+// (src/xds_io.cc, src/touchstone_io.cc).  The file is unmapped when the
+// FileMapping is destroyed; hold it in a shared_ptr to keep borrowed
+// pointers alive.
+// =========================================================================
+
+#include <cstddef>
+#include <string>
+
+namespace xdataset
+{
+
+class FileMapping
+{
+public:
+    /// Map `path`; throws std::runtime_error if it cannot be opened or
+    /// mapped.  An empty file maps to data() == nullptr, size() == 0.
+    explicit FileMapping(const std::string& path);
+    ~FileMapping();
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+
+} // namespace xdataset
+
+#endif // XDATASET_FILE_MAPPING_H
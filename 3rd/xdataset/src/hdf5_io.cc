@@ -9,9 +9,12 @@
 #include "dataset.h"
 #include "dimension_spec.h"
 #include "touchstone_io.h"
+#include "xds_io.h"
 
+#include <algorithm>
 #include <complex>
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
 #include <vector>
 
@@ -33,6 +36,18 @@ void check_h5(herr_t status, const char* msg)
         throw std::runtime_error(std::string("HDF5 error: ") + msg);
 }
 
+// The HDF5 library is not built thread-safe, and deferred series may be
+// loaded from REL worker threads: every call into it holds this lock.
+std::mutex& hdf5_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Default chunk size of numeric series, in bytes.  Fits HDF5's default
+// 1 MiB per-dataset chunk cache.
+const std::size_t kDefaultChunkBytes = std::size_t(1) << 20;
+
 // -----------------------------------------------------------------------
 // Type mapping: xdataset DataType -- HDF5 type id.
 // Caller must close the returned type with H5Tclose unless it's a native type.
@@ -117,10 +132,40 @@ void write_dimension_attr(hid_t loc, const DimensionSpec& dim)
     }
 }
 
+// -----------------------------------------------------------------------
+// Creation properties of a numeric Dataset: chunked along rows, with the
+// shuffle / deflate filters from `options`.  Empty extents stay contiguous
+// (HDF5 chunks must not be empty).
+// -----------------------------------------------------------------------
+hid_t create_numeric_dcpl(const std::vector<hsize_t>& h5_dims, std::size_t row_bytes,
+                          const DatasetIOOptions& options)
+{
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    for (hsize_t d : h5_dims)
+    {
+        if (d == 0)
+            return dcpl;
+    }
+
+    std::vector<hsize_t> chunk(h5_dims);
+    std::size_t rows = options.chunk_rows;
+    if (rows == 0)
+        rows = std::max<std::size_t>(1, kDefaultChunkBytes / std::max<std::size_t>(row_bytes, 1));
+    chunk[0] = std::min(static_cast<hsize_t>(rows), h5_dims[0]);
+
+    check_h5(H5Pset_chunk(dcpl, static_cast<int>(chunk.size()), chunk.data()), "set chunk layout");
+    if (options.shuffle)
+        check_h5(H5Pset_shuffle(dcpl), "set shuffle filter");
+    if (options.deflate_level > 0)
+        check_h5(H5Pset_deflate(dcpl, static_cast<unsigned>(options.deflate_level)), "set deflate filter");
+    return dcpl;
+}
+
 // -----------------------------------------------------------------------
 // Write a DataSeries to an HDF5 Dataset under `group`.
 // -----------------------------------------------------------------------
-void write_data_series(hid_t group, const std::string& name, const DataSeries& series)
+void write_data_series(hid_t group, const std::string& name, const DataSeries& series,
+                       const DatasetIOOptions& options)
 {
     DataType dtype = series.data_type();
     DataKind  kind  = series.data_kind();
@@ -142,8 +187,24 @@ void write_data_series(hid_t group, const std::string& name, const DataSeries& s
     hid_t dtype_id = h5_type_from(dtype);
     bool  owns_dtype = (dtype == DataType::kComplex);
 
+    hid_t dcpl = H5P_DEFAULT;
+    if (dtype != DataType::kString)
+    {
+        const std::size_t cell_bytes = dtype == DataType::kComplex ? sizeof(std::complex<double>)
+                                     : dtype == DataType::kInteger ? sizeof(int)
+                                                                   : sizeof(double);
+        dcpl = create_numeric_dcpl(h5_dims, cell_bytes * static_cast<std::size_t>(cols), options);
+    }
+
     hid_t dset = H5Dcreate2(group, name.c_str(), dtype_id, fspace,
-                             H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+                             H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    if (dcpl != H5P_DEFAULT) H5Pclose(dcpl);
+    if (dset < 0)
+    {
+        if (owns_dtype) H5Tclose(dtype_id);
+        H5Sclose(fspace);
+        throw std::runtime_error("HDF5 error: create dataset " + name);
+    }
 
     // Write data
     if (dtype == DataType::kString)
@@ -223,7 +284,8 @@ void write_data_series(hid_t group, const std::string& name, const DataSeries& s
 // -----------------------------------------------------------------------
 // Write a Block (as nested HDF5 Groups matching the path, with datasets)
 // -----------------------------------------------------------------------
-void write_block(hid_t root_group, const std::string& block_path, const Block& block)
+void write_block(hid_t root_group, const std::string& block_path, const Block& block,
+                 const DatasetIOOptions& options)
 {
     // Create nested groups matching the path segments.
     hid_t current = root_group;
@@ -243,7 +305,7 @@ void write_block(hid_t root_group, const std::string& block_path, const Block& b
     for (const auto& name : block.independents())
     {
         const IndependentSpec& spec = block.independent_spec(name);
-        write_data_series(current, name, spec.data);
+        write_data_series(current, name, spec.data, options);
         hid_t dset = H5Dopen2(current, name.c_str(), H5P_DEFAULT);
         write_dimension_attr(dset, spec.dimension);
         H5Dclose(dset);
@@ -253,7 +315,7 @@ void write_block(hid_t root_group, const std::string& block_path, const Block& b
     for (const auto& name : block.dependents())
     {
         const DependentSpec& spec = block.dependent_spec(name);
-        write_data_series(current, name, spec.data);
+        write_data_series(current, name, spec.data, options);
     }
 
     H5Gclose(current);
@@ -268,9 +330,16 @@ void write_block(hid_t root_group, const std::string& block_path, const Block& b
 class Hdf5Writer::Impl
 {
 public:
-    explicit Impl(const std::string& path)
+    Impl(const std::string& path, const DatasetIOOptions& options)
+        : options_(options)
     {
+        if (options.deflate_level < 0 || options.deflate_level > 9)
+            throw std::invalid_argument("deflate_level must be in 0..9");
+
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
         disable_hdf5_errors();
+        if (options.deflate_level > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0)
+            throw std::runtime_error("HDF5 deflate filter is not available");
         file_ = H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
         if (file_ < 0)
             throw std::runtime_error("cannot create HDF5 file: " + path);
@@ -278,11 +347,14 @@ public:
 
     ~Impl()
     {
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
         if (file_ >= 0) H5Fclose(file_);
     }
 
     void write(const Dataset& dataset)
     {
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
+
         // Create root group with Dataset name
         hid_t root = H5Gcreate2(file_, dataset.name().c_str(),
                                  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
@@ -292,7 +364,7 @@ public:
         for (const auto& p : paths)
         {
             const Block& block = dataset.GetBlock(p);
-            write_block(root, p, block);
+            write_block(root, p, block, options_);
         }
 
         H5Gclose(root);
@@ -300,10 +372,11 @@ public:
 
 private:
     hid_t file_;
+    DatasetIOOptions options_;
 };
 
-Hdf5Writer::Hdf5Writer(const std::string& file_path)
-    : impl_(new Impl(file_path))
+Hdf5Writer::Hdf5Writer(const std::string& file_path, const DatasetIOOptions& options)
+    : impl_(new Impl(file_path, options))
 {}
 
 Hdf5Writer::~Hdf5Writer() = default;
@@ -320,7 +393,9 @@ void Hdf5Writer::Write(const Dataset& dataset)
 namespace
 {
 
-void load_groups(Dataset& ds, hid_t group, const std::string& prefix);
+struct ReadContext;
+
+void load_groups(Dataset& ds, hid_t group, const std::string& prefix, const ReadContext& ctx);
 
 std::string read_str_attr(hid_t loc, const char* name)
 {
@@ -397,97 +472,268 @@ DimensionSpec read_dimension_attr(hid_t loc)
 }
 
 // -----------------------------------------------------------------------
-// Read a DataSeries from an HDF5 Dataset.
+// Schema of a stored DataSeries, from its attributes and dataspace.
 // -----------------------------------------------------------------------
-DataSeries read_data_series(hid_t loc, const std::string& name)
+struct SeriesLayout
 {
-    hid_t dset = H5Dopen2(loc, name.c_str(), H5P_DEFAULT);
+    DataType             dtype = DataType::kReal;
+    DataShape            shape;
+    Unit                 unit;
+    std::vector<hsize_t> dims;   // HDF5 extent: [rows] / [rows, cols] / [rows, R, C]
+};
 
-    // Read attributes
+SeriesLayout read_series_layout(hid_t dset)
+{
     std::string dtype_str = read_str_attr(dset, "dtype");
     std::string kind_str  = read_str_attr(dset, "kind");
     std::string unit_str  = read_str_attr(dset, "unit");
 
-    // Get dataspace
+    SeriesLayout layout;
     hid_t fspace = H5Dget_space(dset);
     int ndims = H5Sget_simple_extent_ndims(fspace);
-    std::vector<hsize_t> h5_dims(static_cast<std::size_t>(ndims));
-    H5Sget_simple_extent_dims(fspace, h5_dims.data(), NULL);
+    layout.dims.resize(static_cast<std::size_t>(ndims));
+    H5Sget_simple_extent_dims(fspace, layout.dims.data(), NULL);
     H5Sclose(fspace);
 
-    // Determine rows and inner shape
-    std::size_t rows = static_cast<std::size_t>(h5_dims[0]);
-    Index cols = 0;
-    Index cell_rows = 0, cell_cols = 0;
+    if (dtype_str == "real")
+        layout.dtype = DataType::kReal;
+    else if (dtype_str == "int")
+        layout.dtype = DataType::kInteger;
+    else if (dtype_str == "complex")
+        layout.dtype = DataType::kComplex;
+    else
+        throw std::runtime_error("unsupported dtype: " + dtype_str);
 
-    if (kind_str == "vector" && ndims >= 2)
-        cols = static_cast<Index>(h5_dims[1]);
-    else if (kind_str == "matrix" && ndims >= 3)
+    if (kind_str == "scalar" && ndims == 1)
+        layout.shape = DataShape::Scalar();
+    else if (kind_str == "vector" && ndims == 2)
+        layout.shape = DataShape::Vector(static_cast<Index>(layout.dims[1]));
+    else if (kind_str == "matrix" && ndims == 3)
+        layout.shape = DataShape::Matrix(static_cast<Index>(layout.dims[1]), static_cast<Index>(layout.dims[2]));
+    else
+        throw std::runtime_error("unsupported kind: " + kind_str);
+
+    if (!unit_str.empty()) layout.unit = Unit::parse(unit_str);
+    return layout;
+}
+
+template <typename T>
+DataSeries series_from_buffer(const SeriesLayout& layout, const T* buf, std::size_t rows)
+{
+    const std::size_t total = rows * static_cast<std::size_t>(layout.shape.element_count());
+    switch (layout.shape.kind())
     {
-        cell_rows = static_cast<Index>(h5_dims[1]);
-        cell_cols = static_cast<Index>(h5_dims[2]);
+    case DataKind::kVector:
+        return DataSeries::CreateVectorFromMemory<T>(layout.shape[0], buf, total, layout.unit);
+    case DataKind::kMatrix:
+        return DataSeries::CreateMatrixFromMemory<T>(layout.shape[0], layout.shape[1], buf, total, layout.unit);
+    default:
+        return DataSeries::CreateScalarFromMemory<T>(buf, rows, layout.unit);
     }
+}
 
-    // Total flat elements
-    std::size_t total = rows * static_cast<std::size_t>(
-        cols > 0 ? cols : (cell_rows * cell_cols > 0 ? cell_rows * cell_cols : 1));
+template <typename T>
+herr_t read_hyperslab(hid_t dset, hid_t memtype, hid_t mspace, hid_t fspace,
+                      const SeriesLayout& layout, std::size_t rows, DataSeries& out)
+{
+    std::vector<T> buf(rows * static_cast<std::size_t>(layout.shape.element_count()));
+    herr_t status = H5Dread(dset, memtype, mspace, fspace, H5P_DEFAULT, buf.data());
+    if (status >= 0)
+        out = series_from_buffer<T>(layout, buf.data(), rows);
+    return status;
+}
 
-    DataSeries out;
-    Unit unit;
-    if (!unit_str.empty()) unit = Unit::parse(unit_str);
+// -----------------------------------------------------------------------
+// Read rows start, start + step, ... (`count` of them) of an HDF5 Dataset.
+// Only the chunks holding those rows are read (and decompressed).
+// -----------------------------------------------------------------------
+DataSeries read_series_rows(hid_t dset, const SeriesLayout& layout,
+                            hsize_t start, hsize_t step, hsize_t count)
+{
+    if (count == 0)
+    {
+        DataSeries empty(layout.dtype, layout.shape);
+        empty.set_unit(layout.unit);
+        return empty;
+    }
 
-    hid_t memtype = H5Dget_type(dset);
+    const std::size_t rank = layout.dims.size();
+    std::vector<hsize_t> offset(rank, 0);
+    std::vector<hsize_t> stride(rank, 1);
+    std::vector<hsize_t> extent(layout.dims);
+    offset[0] = start;
+    stride[0] = step;
+    extent[0] = count;
 
-    if (dtype_str == "real")
+    hid_t fspace = H5Dget_space(dset);
+    hid_t mspace = H5Screate_simple(static_cast<int>(rank), extent.data(), NULL);
+    herr_t status = H5Sselect_hyperslab(fspace, H5S_SELECT_SET, offset.data(), stride.data(),
+                                        extent.data(), NULL);
+
+    DataSeries out;
+    const std::size_t rows = static_cast<std::size_t>(count);
+    if (status >= 0)
     {
-        std::vector<double> buf(total);
-        H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buf[0]);
+        switch (layout.dtype)
+        {
+        case DataType::kReal:
+            status = read_hyperslab<double>(dset, H5T_NATIVE_DOUBLE, mspace, fspace, layout, rows, out);
+            break;
+        case DataType::kInteger:
+            status = read_hyperslab<int>(dset, H5T_NATIVE_INT, mspace, fspace, layout, rows, out);
+            break;
+        default:
+        {
+            hid_t memtype = h5_type_from(DataType::kComplex);
+            status = read_hyperslab<std::complex<double>>(dset, memtype, mspace, fspace, layout, rows, out);
+            H5Tclose(memtype);
+            break;
+        }
+        }
+    }
+
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+    check_h5(status, "read numeric dataset");
+    return out;
+}
+
+// -----------------------------------------------------------------------
+// Read a whole DataSeries from an HDF5 Dataset.
+// -----------------------------------------------------------------------
+DataSeries read_data_series(hid_t loc, const std::string& name)
+{
+    hid_t dset = H5Dopen2(loc, name.c_str(), H5P_DEFAULT);
+    if (dset < 0)
+        throw std::runtime_error("cannot open HDF5 dataset: " + name);
 
-        if (kind_str == "scalar")
-            out = DataSeries::CreateScalarFromMemory<double>(&buf[0], rows, unit);
-        else if (kind_str == "vector")
-            out = DataSeries::CreateVectorFromMemory<double>(cols, &buf[0], rows * cols, unit);
-        else if (kind_str == "matrix")
-            out = DataSeries::CreateMatrixFromMemory<double>(cell_rows, cell_cols, &buf[0], total, unit);
+    DataSeries out;
+    try
+    {
+        SeriesLayout layout = read_series_layout(dset);
+        out = read_series_rows(dset, layout, 0, 1, layout.dims[0]);
     }
-    else if (dtype_str == "int")
+    catch (...)
     {
-        std::vector<int> buf(total);
-        H5Dread(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buf[0]);
-
-        if (kind_str == "scalar")
-            out = DataSeries::CreateScalarFromMemory<int>(&buf[0], rows, unit);
-        else if (kind_str == "vector")
-            out = DataSeries::CreateVectorFromMemory<int>(cols, &buf[0], rows * cols, unit);
-        else if (kind_str == "matrix")
-            out = DataSeries::CreateMatrixFromMemory<int>(cell_rows, cell_cols, &buf[0], total, unit);
+        H5Dclose(dset);
+        throw;
     }
-    else if (dtype_str == "complex")
+    H5Dclose(dset);
+    return out;
+}
+
+// -----------------------------------------------------------------------
+// Lazy reading: HDF5 file kept open by the series deferred from it.
+// -----------------------------------------------------------------------
+class Hdf5File
+{
+public:
+    explicit Hdf5File(const std::string& path)
     {
-        std::vector<std::complex<double>> buf(total);
-        H5Dread(dset, memtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buf[0]);
+        disable_hdf5_errors();
+        id_ = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (id_ < 0)
+            throw std::runtime_error("cannot open HDF5 file: " + path);
+    }
 
-        if (kind_str == "scalar")
-            out = DataSeries::CreateScalarFromMemory<std::complex<double>>(&buf[0], rows, unit);
-        else if (kind_str == "vector")
-            out = DataSeries::CreateVectorFromMemory<std::complex<double>>(cols, &buf[0], rows * cols, unit);
-        else if (kind_str == "matrix")
-            out = DataSeries::CreateMatrixFromMemory<std::complex<double>>(cell_rows, cell_cols, &buf[0], total, unit);
+    ~Hdf5File()
+    {
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
+        H5Fclose(id_);
     }
-    else
+
+    Hdf5File(const Hdf5File&) = delete;
+    Hdf5File& operator=(const Hdf5File&) = delete;
+
+    hid_t id() const { return id_; }
+
+private:
+    hid_t id_;
+};
+
+class Hdf5SeriesLoader : public SeriesLoader
+{
+public:
+    Hdf5SeriesLoader(std::shared_ptr<const Hdf5File> file, std::string path, SeriesLayout layout)
+        : file_(std::move(file)), path_(std::move(path)), layout_(std::move(layout))
+    {}
+
+    DataSeries load(Index start, Index step, std::size_t count) const override
     {
-        throw std::runtime_error("unsupported dtype: " + dtype_str);
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
+        hid_t dset = H5Dopen2(file_->id(), path_.c_str(), H5P_DEFAULT);
+        if (dset < 0)
+            throw std::runtime_error("cannot open HDF5 dataset: " + path_);
+
+        DataSeries out;
+        try
+        {
+            out = read_series_rows(dset, layout_, static_cast<hsize_t>(start), static_cast<hsize_t>(step),
+                                   static_cast<hsize_t>(count));
+        }
+        catch (...)
+        {
+            H5Dclose(dset);
+            throw;
+        }
+        H5Dclose(dset);
+        return out;
     }
 
-    H5Tclose(memtype);
+private:
+    std::shared_ptr<const Hdf5File> file_;
+    std::string                     path_;   // absolute HDF5 path of the Dataset
+    SeriesLayout                    layout_;
+};
+
+struct ReadContext
+{
+    std::shared_ptr<const Hdf5File> file;
+    std::string                     root;   // "/" + root group name
+    bool                            lazy;
+};
+
+/// Read or defer the series `name` of the Block at `block_path`.
+DataSeries read_series(hid_t loc, const std::string& block_path, const std::string& name,
+                       const ReadContext& ctx)
+{
+    if (!ctx.lazy)
+        return read_data_series(loc, name);
+
+    hid_t dset = H5Dopen2(loc, name.c_str(), H5P_DEFAULT);
+    if (dset < 0)
+        throw std::runtime_error("cannot open HDF5 dataset: " + name);
+    SeriesLayout layout;
+    try
+    {
+        layout = read_series_layout(dset);
+    }
+    catch (...)
+    {
+        H5Dclose(dset);
+        throw;
+    }
     H5Dclose(dset);
-    return out;
+
+    // A scaled unit is canonicalized (every cell rescaled) as soon as the
+    // series enters a DataArray, so deferring it would not save a read.
+    if (layout.unit.multiplier() != 1.0)
+        return read_data_series(loc, name);
+
+    const std::size_t rows = static_cast<std::size_t>(layout.dims[0]);
+    const DataType dtype = layout.dtype;
+    const DataShape shape = layout.shape;
+    const Unit unit = layout.unit;
+    std::shared_ptr<const SeriesLoader> loader = std::make_shared<Hdf5SeriesLoader>(
+        ctx.file, ctx.root + "/" + block_path + "/" + name, std::move(layout));
+    return DataSeries::CreateDeferred(dtype, shape, rows, unit, std::move(loader));
 }
 
 // -----------------------------------------------------------------------
 // Read a Block from an HDF5 Group.
 // -----------------------------------------------------------------------
-Block read_block(hid_t group, const std::string& block_name)
+Block read_block(hid_t group, const std::string& block_name, const std::string& block_path,
+                 const ReadContext& ctx)
 {
     hid_t bg = H5Gopen2(group, block_name.c_str(), H5P_DEFAULT);
 
@@ -522,7 +768,7 @@ Block read_block(hid_t group, const std::string& block_name)
     // Read independents
     for (const auto& name : indep_names)
     {
-        DataSeries data = read_data_series(bg, name);
+        DataSeries data = read_series(bg, block_path, name, ctx);
         hid_t dset = H5Dopen2(bg, name.c_str(), H5P_DEFAULT);
         DimensionSpec dim = read_dimension_attr(dset);
         H5Dclose(dset);
@@ -534,7 +780,7 @@ Block read_block(hid_t group, const std::string& block_name)
     // Read dependents
     for (const auto& name : dep_names)
     {
-        DependentSpec ds = {name, read_data_series(bg, name)};
+        DependentSpec ds = {name, read_series(bg, block_path, name, ctx)};
         info.dependent_specs.push_back(ds);
     }
 
@@ -544,7 +790,7 @@ Block read_block(hid_t group, const std::string& block_name)
 }
 
 /// Walk an HDF5 group and recursively load Blocks into the Dataset.
-void load_groups(Dataset& ds, hid_t group, const std::string& prefix)
+void load_groups(Dataset& ds, hid_t group, const std::string& prefix, const ReadContext& ctx)
 {
     hsize_t num_objs = 0;
     H5Gget_num_objs(group, &num_objs);
@@ -578,11 +824,11 @@ void load_groups(Dataset& ds, hid_t group, const std::string& prefix)
             if (has_datasets)
             {
                 // This group is a Block.
-                ds.AddBlock(path, read_block(group, oname));
+                ds.AddBlock(path, read_block(group, oname, path, ctx));
             }
 
             // Recurse into subgroups.
-            load_groups(ds, child, path);
+            load_groups(ds, child, path, ctx);
 
             H5Gclose(child);
         }
@@ -598,44 +844,44 @@ void load_groups(Dataset& ds, hid_t group, const std::string& prefix)
 class Hdf5Reader::Impl
 {
 public:
-    explicit Impl(const std::string& path)
-    {
-        disable_hdf5_errors();
-        file_ = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-        if (file_ < 0)
-            throw std::runtime_error("cannot open HDF5 file: " + path);
-    }
-
-    ~Impl()
+    Impl(const std::string& path, const DatasetIOOptions& options)
+        : lazy_(options.lazy)
     {
-        if (file_ >= 0) H5Fclose(file_);
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
+        file_ = std::make_shared<Hdf5File>(path);
     }
 
     Dataset read()
     {
+        std::lock_guard<std::mutex> lock(hdf5_mutex());
+
         // Get the first (and only) root group = the Dataset name.
         hsize_t num_objs = 0;
-        H5Gget_num_objs(file_, &num_objs);
+        H5Gget_num_objs(file_->id(), &num_objs);
 
         if (num_objs != 1)
             throw std::runtime_error("HDF5 file must contain exactly one root group");
 
         char root_name[256];
-        H5Gget_objname_by_idx(file_, 0, root_name, sizeof(root_name));
+        H5Gget_objname_by_idx(file_->id(), 0, root_name, sizeof(root_name));
+
+        // Deferred series keep file_ open after the reader is gone.
+        ReadContext ctx = {file_, std::string("/") + root_name, lazy_};
 
         Dataset ds(root_name);
-        hid_t root = H5Gopen2(file_, root_name, H5P_DEFAULT);
-        load_groups(ds, root, "");
+        hid_t root = H5Gopen2(file_->id(), root_name, H5P_DEFAULT);
+        load_groups(ds, root, "", ctx);
         H5Gclose(root);
         return ds;
     }
 
 private:
-    hid_t file_;
+    std::shared_ptr<const Hdf5File> file_;
+    bool                            lazy_;
 };
 
-Hdf5Reader::Hdf5Reader(const std::string& file_path)
-    : impl_(new Impl(file_path))
+Hdf5Reader::Hdf5Reader(const std::string& file_path, const DatasetIOOptions& options)
+    : impl_(new Impl(file_path, options))
 {}
 
 Hdf5Reader::~Hdf5Reader() = default;
@@ -653,9 +899,20 @@ Dataset Hdf5Reader::Read()
 std::unique_ptr<IDatasetWriter> DatasetIO::CreateWriter(
     const std::string& format,
     const std::string& path)
+{
+    return CreateWriter(format, path, DatasetIOOptions());
+}
+
+/* static */
+std::unique_ptr<IDatasetWriter> DatasetIO::CreateWriter(
+    const std::string& format,
+    const std::string& path,
+    const DatasetIOOptions& options)
 {
     if (format == "hdf5")
-        return std::unique_ptr<IDatasetWriter>(new Hdf5Writer(path));
+        return std::unique_ptr<IDatasetWriter>(new Hdf5Writer(path, options));
+    if (format == "xds")
+        return std::unique_ptr<IDatasetWriter>(new XdsWriter(path));
     throw std::invalid_argument("unsupported format: " + format);
 }
 
@@ -663,11 +920,22 @@ std::unique_ptr<IDatasetWriter> DatasetIO::CreateWriter(
 std::unique_ptr<IDatasetReader> DatasetIO::CreateReader(
     const std::string& format,
     const std::string& path)
+{
+    return CreateReader(format, path, DatasetIOOptions());
+}
+
+/* static */
+std::unique_ptr<IDatasetReader> DatasetIO::CreateReader(
+    const std::string& format,
+    const std::string& path,
+    const DatasetIOOptions& options)
 {
     if (format == "hdf5")
-        return std::unique_ptr<IDatasetReader>(new Hdf5Reader(path));
+        return std::unique_ptr<IDatasetReader>(new Hdf5Reader(path, options));
+    if (format == "xds")
+        return std::unique_ptr<IDatasetReader>(new XdsReader(path));
     if (format == "touchstone" || format == "snp")
-        return std::unique_ptr<IDatasetReader>(new TouchstoneReader(path));
+        return std::unique_ptr<IDatasetReader>(new TouchstoneReader(path, options));
     throw std::invalid_argument("unsupported format: " + format);
 }
 
@@ -680,6 +948,16 @@ void DatasetIO::Save(const Dataset& dataset,
     writer->Write(dataset);
 }
 
+/* static */
+void DatasetIO::Save(const Dataset& dataset,
+                     const std::string& format,
+                     const std::string& path,
+                     const DatasetIOOptions& options)
+{
+    auto writer = CreateWriter(format, path, options);
+    writer->Write(dataset);
+}
+
 /* static */
 Dataset DatasetIO::Load(const std::string& format,
                         const std::string& path)
@@ -688,4 +966,13 @@ Dataset DatasetIO::Load(const std::string& format,
     return reader->Read();
 }
 
+/* static */
+Dataset DatasetIO::Load(const std::string& format,
+                        const std::string& path,
+                        const DatasetIOOptions& options)
+{
+    auto reader = CreateReader(format, path, options);
+    return reader->Read();
+}
+
 } // namespace xdataset
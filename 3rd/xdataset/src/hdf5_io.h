@@ -24,7 +24,8 @@ namespace xdataset
 class Hdf5Writer : public IDatasetWriter
 {
 public:
-    explicit Hdf5Writer(const std::string& file_path);
+    explicit Hdf5Writer(const std::string& file_path,
+                        const DatasetIOOptions& options = DatasetIOOptions());
     ~Hdf5Writer() override;
 
     void Write(const Dataset& dataset) override;
@@ -41,7 +42,8 @@ private:
 class Hdf5Reader : public IDatasetReader
 {
 public:
-    explicit Hdf5Reader(const std::string& file_path);
+    explicit Hdf5Reader(const std::string& file_path,
+                        const DatasetIOOptions& options = DatasetIOOptions());
     ~Hdf5Reader() override;
 
     Dataset Read() override;
@@ -17,6 +17,8 @@ namespace xdataset
                 return "Equal";
             case MultiIndexSelector::Kind::kIn:
                 return "In";
+            case MultiIndexSelector::Kind::kRange:
+                return "Range";
             }
 
             return "Unknown";
@@ -76,6 +78,30 @@ namespace xdataset
         return MultiIndexSelector(Kind::kIn, normalized);
     }
 
+    MultiIndexSelector MultiIndexSelector::Range(Index start, Index stop, Index step)
+    {
+        if (start < 0)
+        {
+            throw std::invalid_argument("range selector start must be >= 0");
+        }
+        if (step < 1)
+        {
+            throw std::invalid_argument("range selector step must be >= 1");
+        }
+        if (stop <= start)
+        {
+            throw std::invalid_argument("range selector must not be empty");
+        }
+
+        // Stored as {start, step, count}.
+        const Index count = (stop - start + step - 1) / step;
+        std::vector<Index> values;
+        values.push_back(start);
+        values.push_back(step);
+        values.push_back(count);
+        return MultiIndexSelector(Kind::kRange, values);
+    }
+
     MultiIndexSelector::Kind MultiIndexSelector::kind() const
     {
         return kind_;
@@ -96,6 +122,11 @@ namespace xdataset
         return kind_ == Kind::kIn;
     }
 
+    bool MultiIndexSelector::is_range() const
+    {
+        return kind_ == Kind::kRange;
+    }
+
     Index MultiIndexSelector::equal_value() const
     {
         if (!is_equal())
@@ -114,6 +145,33 @@ namespace xdataset
         return values_;
     }
 
+    Index MultiIndexSelector::range_start() const
+    {
+        if (!is_range())
+        {
+            throw std::logic_error("range_start() is only valid for range selectors");
+        }
+        return values_[0];
+    }
+
+    Index MultiIndexSelector::range_step() const
+    {
+        if (!is_range())
+        {
+            throw std::logic_error("range_step() is only valid for range selectors");
+        }
+        return values_[1];
+    }
+
+    Index MultiIndexSelector::range_count() const
+    {
+        if (!is_range())
+        {
+            throw std::logic_error("range_count() is only valid for range selectors");
+        }
+        return values_[2];
+    }
+
     std::vector<Index> MultiIndexSelector::resolve(Index width) const
     {
         if (width < 0)
@@ -147,6 +205,26 @@ namespace xdataset
             return selected;
         }
 
+        if (is_range())
+        {
+            const Index start = range_start();
+            const Index step = range_step();
+            const Index count = range_count();
+            const Index last = start + (count - 1) * step;
+            if (last >= width)
+            {
+                throw std::out_of_range(
+                    std::string("range selector index out of range: value=") +
+                    std::to_string(last) + ", width=" + std::to_string(width));
+            }
+            selected.reserve(static_cast<std::size_t>(count));
+            for (Index i = 0; i < count; ++i)
+            {
+                selected.push_back(start + i * step);
+            }
+            return selected;
+        }
+
         const std::vector<Index>& values = in_values();
         selected.reserve(values.size());
         for (Index value : values)
@@ -172,6 +250,11 @@ namespace xdataset
         {
             return idx == values_[0];
         }
+        if (kind_ == Kind::kRange)
+        {
+            const Index offset = idx - values_[0];
+            return offset >= 0 && offset % values_[1] == 0 && offset / values_[1] < values_[2];
+        }
         return std::binary_search(values_.begin(), values_.end(), idx);
     }
 
@@ -5,18 +5,40 @@
 #include "data_series.h"
 #include "dataset.h"
 #include "dimension_spec.h"
+#include "file_mapping.h"
 #include "unit.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <locale.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -103,7 +125,12 @@ void complex_to_db(std::complex<double> c, double& db, double& ang_deg)
 }
 
 // =========================================================================
-// Data-parsing helpers
+// Data-scanning helpers
+// =========================================================================
+//
+// The reader maps the file and walks it in place: values are converted
+// straight from the mapped bytes (from_chars-style, no per-line strings)
+// into the final series storage.
 // =========================================================================
 
 /// Strip leading/trailing whitespace
@@ -115,49 +142,266 @@ std::string trim(const std::string& s)
     return s.substr(start, end - start + 1);
 }
 
-/// Read all non-comment, non-empty lines from a file
-std::vector<std::string> read_data_lines(const std::string& file_path,
-                                          std::string& option_line)
+inline bool is_blank(char c)
 {
-    std::ifstream in(file_path.c_str());
-    if (!in.is_open())
-        throw std::runtime_error("Touchstone: cannot open file: " + file_path);
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
 
-    std::vector<std::string> lines;
-    std::string line;
-    bool found_option = false;
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
 
-    while (std::getline(in, line))
-    {
-        std::string trimmed = trim(line);
-        if (trimmed.empty()) continue;
-        if (trimmed[0] == '!') continue; // comment
+/// strtod() in the "C" locale whatever the process locale is (a Qt
+/// application sets it from the environment, where "0.5" may not parse).
+double strtod_c(const char* s, char** end)
+{
+#ifdef _WIN32
+    static const _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(s, end, c_locale);
+#else
+    static const locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+    return strtod_l(s, end, c_locale);
+#endif
+}
 
-        if (!found_option && trimmed[0] == '#')
+/// Parse the decimal literal occupying exactly [first, last).
+///
+/// Literals with at most 15-16 significant digits and a small exponent
+/// (the usual case) are converted exactly with one multiply or divide;
+/// longer ones go through strtod_c() from a stack copy.
+bool parse_number(const char* first, const char* last, double& out)
+{
+    static const double kPow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;     // significant digits held in mantissa
+    int exponent = 0;   // value = mantissa * 10^exponent
+    bool exact = true;  // false once a significant digit did not fit
+    bool any = false;
+
+    for (; p != last && is_digit(*p); ++p)
+    {
+        any = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (digits == 19)
         {
-            option_line = trimmed;
-            found_option = true;
+            exact = false;
             continue;
         }
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+        ++digits;
+    }
+    if (p != last && *p == '.')
+    {
+        for (++p; p != last && is_digit(*p); ++p)
+        {
+            any = true;
+            --exponent;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (digits == 19)
+            {
+                exact = false;
+                continue;
+            }
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            ++digits;
+        }
+    }
+    if (!any)
+        return false;
 
-        lines.push_back(trimmed);
+    if (p != last && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool negative_exp = false;
+        if (p != last && (*p == '+' || *p == '-'))
+            negative_exp = (*p++ == '-');
+        if (p == last || !is_digit(*p))
+            return false;
+        int e = 0;
+        for (; p != last && is_digit(*p); ++p)
+        {
+            if (e < 100000)
+                e = e * 10 + (*p - '0');
+        }
+        exponent += negative_exp ? -e : e;
     }
+    if (p != last)
+        return false;
 
-    if (!found_option)
-        throw std::runtime_error("Touchstone: no option line found in file");
+    // Both mantissa and 10^|exponent| are exact doubles here, so a single
+    // correctly rounded operation gives the correctly rounded result.
+    if (exact && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double v = static_cast<double>(mantissa);
+        v = exponent < 0 ? v / kPow10[-exponent] : v * kPow10[exponent];
+        out = negative ? -v : v;
+        return true;
+    }
 
-    return lines;
+    const std::size_t len = static_cast<std::size_t>(last - first);
+    char buf[64];
+    std::string long_literal;
+    const char* text = buf;
+    if (len < sizeof(buf))
+    {
+        std::memcpy(buf, first, len);
+        buf[len] = '\0';
+    }
+    else
+    {
+        long_literal.assign(first, last);
+        text = long_literal.c_str();
+    }
+    char* end = nullptr;
+    out = strtod_c(text, &end);
+    return end == text + len;
 }
 
-/// Parse all numeric values from a data line into a vector of doubles
-std::vector<double> parse_data_line(const std::string& line)
+/// Walks the network data that follows the option line.  Comments ("!"
+/// to end of line), repeated option lines and [keyword] lines are skipped
+/// like blanks.
+class TokenScanner
 {
-    std::vector<double> values;
-    std::istringstream ss(line);
-    double v;
-    while (ss >> v)
-        values.push_back(v);
-    return values;
+public:
+    TokenScanner(const char* first, const char* last)
+        : p_(first), last_(last), line_start_(true)
+    {}
+
+    /// Move to the next value; false at the end of the data.
+    bool skip()
+    {
+        while (p_ != last_)
+        {
+            const char c = *p_;
+            if (c == '\n')
+            {
+                line_start_ = true;
+                ++p_;
+            }
+            else if (is_blank(c))
+            {
+                ++p_;
+            }
+            else if (c == '!' || (line_start_ && (c == '#' || c == '[')))
+            {
+                const void* eol = std::memchr(p_, '\n', static_cast<std::size_t>(last_ - p_));
+                p_ = eol ? static_cast<const char*>(eol) : last_;
+            }
+            else
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Whether the current value is the first one on its line.
+    bool line_start() const { return line_start_; }
+
+    /// Step over the current value without converting it.
+    void next()
+    {
+        p_ = value_end();
+        line_start_ = false;
+    }
+
+    /// Convert the current value and step over it.
+    double number()
+    {
+        const char* end = value_end();
+        double v = 0.0;
+        if (!parse_number(p_, end, v))
+            throw std::runtime_error("Touchstone: invalid number: " + std::string(p_, end));
+        p_ = end;
+        line_start_ = false;
+        return v;
+    }
+
+private:
+    const char* value_end() const
+    {
+        const char* e = p_;
+        while (e != last_ && !is_blank(*e) && *e != '!')
+            ++e;
+        return e;
+    }
+
+    const char* p_;
+    const char* last_;
+    bool line_start_;
+};
+
+/// Find the option line, which must precede the network data.  Returns it
+/// trimmed and sets `data` to the end of that line.
+std::string find_option_line(const char* p, const char* last, const char*& data)
+{
+    while (p != last)
+    {
+        const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+        const char* eol = nl ? static_cast<const char*>(nl) : last;
+
+        const char* q = p;
+        while (q != eol && is_blank(*q))
+            ++q;
+        if (q != eol && *q == '#')
+        {
+            data = eol;
+            return trim(std::string(q, eol));
+        }
+        if (q != eol && *q != '!' && *q != '[')
+            break; // data before any option line
+
+        p = (eol == last) ? last : eol + 1;
+    }
+    throw std::runtime_error("Touchstone: no option line found in file");
+}
+
+/// Number of values on the first data line.
+int first_line_values(const char* first, const char* last)
+{
+    TokenScanner scan(first, last);
+    int n = 0;
+    while (scan.skip() && (n == 0 || !scan.line_start()))
+    {
+        scan.next();
+        ++n;
+    }
+    return n;
+}
+
+/// Port count from an ".sNp" extension (case-insensitive); 0 when the
+/// file name does not carry one.
+int ports_from_extension(const std::string& path)
+{
+    const std::string::size_type dot = path.find_last_of('.');
+    const std::string::size_type sep = path.find_last_of("/\\");
+    if (dot == std::string::npos || (sep != std::string::npos && dot < sep))
+        return 0;
+
+    const std::string ext = path.substr(dot + 1);
+    if (ext.size() < 3 || (ext[0] != 's' && ext[0] != 'S') ||
+        (ext[ext.size() - 1] != 'p' && ext[ext.size() - 1] != 'P'))
+        return 0;
+
+    int n = 0;
+    for (std::size_t i = 1; i + 1 < ext.size(); ++i)
+    {
+        if (!is_digit(ext[i]) || n > 999)
+            return 0;
+        n = n * 10 + (ext[i] - '0');
+    }
+    return n;
 }
 
 /// Map Touchstone frequency-unit string to Unit
@@ -189,6 +433,17 @@ int infer_num_ports(int num_values_per_line)
     return n;
 }
 
+/// Convert one value pair of the given format to complex.
+inline std::complex<double> pair_to_complex(char format, double v1, double v2)
+{
+    switch (format)
+    {
+    case 'R': return std::complex<double>(v1, v2);
+    case 'M': return ma_to_complex(v1, v2);
+    default:  return db_to_complex(v1, v2);
+    }
+}
+
 } // anonymous namespace
 
 // =========================================================================
@@ -204,84 +459,90 @@ public:
 
     DataArray read()
     {
-        std::string option_line;
-        std::vector<std::string> data_lines = read_data_lines(file_path_, option_line);
-        if (data_lines.empty())
-            throw std::runtime_error("Touchstone: no data lines in file");
+        std::unique_ptr<FileMapping> file;
+        try
+        {
+            file.reset(new FileMapping(file_path_));
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::runtime_error(std::string("Touchstone: ") + e.what());
+        }
+        const char* const last = file->data() + file->size();
 
-        TouchstoneOptions opts = parse_option_line(option_line);
+        const char* data = nullptr;
+        TouchstoneOptions opts = parse_option_line(find_option_line(file->data(), last, data));
+        if (opts.format != 'R' && opts.format != 'M' && opts.format != 'D')
+            throw std::runtime_error(
+                std::string("Touchstone: unknown format flag: ") + opts.format);
 
-        std::vector<std::vector<double>> all_rows;
-        for (const auto& dl : data_lines)
+        // An .sNp extension fixes the port count, so rows of 3+ port files
+        // may wrap over several lines; otherwise the first line decides.
+        opts.num_ports = ports_from_extension(file_path_);
+        if (opts.num_ports == 0)
         {
-            auto vals = parse_data_line(dl);
-            if (!vals.empty())
-                all_rows.push_back(std::move(vals));
+            const int values = first_line_values(data, last);
+            if (values == 0)
+                throw std::runtime_error("Touchstone: no numeric data found");
+            opts.num_ports = infer_num_ports(values);
         }
-
-        if (all_rows.empty())
+        const int N = opts.num_ports;
+        const std::size_t mat_elems = static_cast<std::size_t>(N) * static_cast<std::size_t>(N);
+        const std::size_t values_per_row = 1 + 2 * mat_elems;
+
+        // Count the values first so that both series are allocated once,
+        // at their final size, and filled in place.
+        std::size_t num_values = 0;
+        for (TokenScanner count(data, last); count.skip(); count.next())
+            ++num_values;
+        if (num_values == 0)
             throw std::runtime_error("Touchstone: no numeric data found");
-
-        int cols_per_row = static_cast<int>(all_rows[0].size());
-        opts.num_ports = infer_num_ports(cols_per_row);
-        int N = opts.num_ports;
-
-        std::size_t num_rows = all_rows.size();
-
-        // Extract frequency column
-        std::vector<double> freq_values(num_rows);
+        if (num_values % values_per_row != 0)
+            throw std::runtime_error("Touchstone: " + std::to_string(num_values) +
+                                     " values do not form rows of " +
+                                     std::to_string(values_per_row) + " (" +
+                                     std::to_string(N) + " ports)");
+        const std::size_t num_rows = num_values / values_per_row;
+
+        DataSeries freq_series = DataSeries::CreateScalar<double>(num_rows);
+        DataSeries s_series = DataSeries::CreateMatrix<std::complex<double>>(N, N, num_rows);
+        double* freq_values = freq_series.mutable_contiguous_data<double>();
+        std::complex<double>* s_flat = s_series.mutable_contiguous_data<std::complex<double>>();
+
+        // Touchstone pair order: 2-port files are column-major (S11 S21 S12 S22),
+        // every other port count is row-major (S11 S12 ... S1N S21 ...).
+        // Cells are stored row-major per frequency point.
+        const bool column_major = (N == 2);
+        TokenScanner scan(data, last);
         for (std::size_t i = 0; i < num_rows; ++i)
         {
-            if (static_cast<int>(all_rows[i].size()) != cols_per_row)
+            scan.skip();
+            if (!scan.line_start())
                 throw std::runtime_error("Touchstone: inconsistent column count on row " +
                                          std::to_string(i));
-            freq_values[i] = all_rows[i][0];
-        }
+            freq_values[i] = scan.number();
 
-        // Build S-matrix flat data (row-major per frequency point).
-        // Touchstone column order: S[1,1], S[2,1], ..., S[N,1], S[1,2], ..., S[N,N]
-        std::size_t mat_elems = static_cast<std::size_t>(N * N);
-        std::size_t total = num_rows * mat_elems;
-        std::vector<std::complex<double>> s_flat(total);
-
-        for (std::size_t i = 0; i < num_rows; ++i)
-        {
-            std::complex<double>* row_base = s_flat.data() + i * mat_elems;
-            for (int col = 1; col <= N; ++col)
+            std::complex<double>* row_base = s_flat + i * mat_elems;
+            for (std::size_t k = 0; k < mat_elems; ++k)
             {
-                for (int row = 1; row <= N; ++row)
-                {
-                    int base_idx = 1 + ((col - 1) * N + (row - 1)) * 2;
-                    double v1 = all_rows[i][base_idx];
-                    double v2 = all_rows[i][base_idx + 1];
-
-                    std::complex<double> val;
-                    switch (opts.format)
-                    {
-                    case 'R': val = std::complex<double>(v1, v2); break;
-                    case 'M': val = ma_to_complex(v1, v2);       break;
-                    case 'D': val = db_to_complex(v1, v2);       break;
-                    default:
-                        throw std::runtime_error(
-                            std::string("Touchstone: unknown format flag: ") + opts.format);
-                    }
-                    row_base[(row - 1) * N + (col - 1)] = val;
-                }
+                scan.skip();
+                const double v1 = scan.number();
+                scan.skip();
+                const double v2 = scan.number();
+                const std::size_t cell = column_major ? (k % 2) * 2 + k / 2 : k;
+                row_base[cell] = pair_to_complex(opts.format, v1, v2);
             }
         }
 
         // Build DataArray: freq independent + S-matrix dependent
         DataArrayCreateInfo info;
-        DataSeries freq_series = DataSeries::CreateScalarFromMemory<double>(
-            freq_values.data(), freq_values.size());
         freq_series.set_unit(freq_unit_from(opts.freq_unit));
         info.datas["freq"] = std::move(freq_series);
-        info.datas[DataArray::kSelf] = DataSeries::CreateMatrixFromMemory<std::complex<double>>(
-            N, N, s_flat.data(), total);
+        info.datas[DataArray::kSelf] = std::move(s_series);
         info.multi_dimension_spec.add_regular(num_rows);
         info.kind = DataArrayKind::kDependent;
 
-        return DataArray(info);
+        return DataArray(std::move(info));
     }
 
 private:
@@ -363,10 +624,15 @@ public:
 
         out << "# GHz S MA R 50\n";
         out << "! Touchstone file generated by xdataset\n";
+        // Same pair order as the reader: column-major for 2 ports only.
+        const bool column_major = (N == 2);
         out << "! freq";
-        for (int col = 1; col <= N; ++col)
-            for (int row = 1; row <= N; ++row)
-                out << "   S" << row << col;
+        for (int k = 0; k < N * N; ++k)
+        {
+            const int row = column_major ? k % N : k / N;
+            const int col = column_major ? k / N : k % N;
+            out << "   S" << row + 1 << col + 1;
+        }
         out << "\n";
 
         for (std::size_t i = 0; i < num_rows; ++i)
@@ -374,14 +640,13 @@ public:
             out << freq_data.scalar_at<double>(i);
 
             const auto& mat = s_data.matrix_at<std::complex<double>>(static_cast<Index>(i));
-            for (int col = 0; col < N; ++col)
+            for (int k = 0; k < N * N; ++k)
             {
-                for (int row = 0; row < N; ++row)
-                {
-                    double mag, ang;
-                    complex_to_ma(mat(row, col), mag, ang);
-                    out << "   " << mag << "   " << ang;
-                }
+                const int row = column_major ? k % N : k / N;
+                const int col = column_major ? k / N : k % N;
+                double mag, ang;
+                complex_to_ma(mat(row, col), mag, ang);
+                out << "   " << mag << "   " << ang;
             }
             out << "\n";
         }
@@ -408,63 +673,181 @@ void TouchstoneDataArrayWriter::Write(const DataArray& array)
 // TouchstoneReader (Dataset convenience) -- delegates to DataArray reader
 // =========================================================================
 
-class TouchstoneReader::Impl
+namespace
 {
-public:
-    explicit Impl(const std::string& path)
-        : file_path_(path)
-    {}
 
-    Dataset read()
+/// Last path component, trailing separators ignored.
+std::string base_name(std::string path)
+{
+    while (path.size() > 1 && (path[path.size() - 1] == '/' || path[path.size() - 1] == '\\'))
+        path.erase(path.size() - 1);
+    const auto pos = path.find_last_of("/\\");
+    return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+/// File name without its extension.
+std::string stem(const std::string& path)
+{
+    std::string name = base_name(path);
+    const auto pos = name.rfind('.');
+    if (pos != std::string::npos && pos > 0)
+        name.erase(pos);
+    return name;
+}
+
+bool is_directory(const std::string& path)
+{
+#ifdef _WIN32
+    const DWORD attrs = GetFileAttributesA(path.c_str());
+    return attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+/// The .sNp files directly inside `dir`, sorted by name.
+std::vector<std::string> list_touchstone_files(const std::string& dir)
+{
+    std::vector<std::string> names;
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA((dir + "\\*").c_str(), &entry);
+    if (find == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Touchstone: cannot list directory: " + dir);
+    do
     {
-        TouchstoneDataArrayReader da_reader(file_path_);
-        DataArray da = da_reader.Read();
+        if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0 &&
+            ports_from_extension(entry.cFileName) > 0)
+            names.push_back(entry.cFileName);
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    DIR* d = ::opendir(dir.c_str());
+    if (!d)
+        throw std::runtime_error("Touchstone: cannot list directory: " + dir);
+    while (const dirent* entry = ::readdir(d))
+    {
+        const std::string name = entry->d_name;
+        struct stat st;
+        if (ports_from_extension(name) > 0 &&
+            ::stat((dir + "/" + name).c_str(), &st) == 0 && S_ISREG(st.st_mode))
+            names.push_back(name);
+    }
+    ::closedir(d);
+#endif
+    std::sort(names.begin(), names.end());
+
+    std::vector<std::string> paths;
+    paths.reserve(names.size());
+    for (const auto& name : names)
+        paths.push_back(dir + "/" + name);
+    return paths;
+}
+
+/// "SP" block contents for a DataArray read from a Touchstone file.
+BlockCreateInfo sp_block_info(const DataArray& da)
+{
+    BlockCreateInfo info;
+    const auto& datas_map = da.datas();
 
-        // Build Dataset name from file name
-        std::string ds_name = file_path_;
+    // Extract independent (freq)
+    for (const auto& kv : datas_map)
+    {
+        if (kv.first != DataArray::kSelf)
         {
-            auto pos = ds_name.find_last_of("/\\");
-            if (pos != std::string::npos)
-                ds_name = ds_name.substr(pos + 1);
-            pos = ds_name.rfind('.');
-            if (pos != std::string::npos)
-                ds_name = ds_name.substr(0, pos);
+            IndependentSpec is = {kv.first, kv.second,
+                DimensionSpec::Regular(kv.second.size())};
+            info.independent_specs.push_back(std::move(is));
         }
+    }
 
-        Dataset ds(ds_name);
+    // Extract dependent (S-matrix)
+    auto self_it = datas_map.find(DataArray::kSelf);
+    if (self_it != datas_map.end())
+    {
+        DependentSpec dep = {"S", self_it->second};
+        info.dependent_specs.push_back(std::move(dep));
+    }
+    return info;
+}
 
-        BlockCreateInfo info;
-        const auto& datas_map = da.datas();
+} // anonymous namespace
 
-        // Extract independent (freq)
-        for (const auto& kv : datas_map)
-        {
-            if (kv.first != DataArray::kSelf)
+class TouchstoneReader::Impl
+{
+public:
+    Impl(const std::string& path, const DatasetIOOptions& options)
+        : file_path_(path), threads_(options.threads)
+    {}
+
+    Dataset read()
+    {
+        if (is_directory(file_path_))
+            return read_directory();
+
+        // Dataset named after the file, one "SP" block
+        TouchstoneDataArrayReader da_reader(file_path_);
+        Dataset ds(stem(file_path_));
+        ds.AddBlock("SP", sp_block_info(da_reader.Read()));
+        return ds;
+    }
+
+private:
+    /// Every .sNp file of the directory, parsed in parallel; file "a.s2p"
+    /// becomes block "a/SP".  The first failing file (in name order) is
+    /// reported.
+    Dataset read_directory()
+    {
+        const std::vector<std::string> files = list_touchstone_files(file_path_);
+        if (files.empty())
+            throw std::runtime_error("Touchstone: no .sNp files in directory: " + file_path_);
+
+        std::vector<BlockCreateInfo> blocks(files.size());
+        std::vector<std::exception_ptr> errors(files.size());
+        std::atomic<std::size_t> next(0);
+        auto work = [&]() {
+            for (std::size_t i = next++; i < files.size(); i = next++)
             {
-                IndependentSpec is = {kv.first, kv.second,
-                    DimensionSpec::Regular(kv.second.size())};
-                info.independent_specs.push_back(std::move(is));
+                try
+                {
+                    blocks[i] = sp_block_info(TouchstoneDataArrayReader(files[i]).Read());
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
             }
-        }
-
-        // Extract dependent (S-matrix)
-        auto self_it = datas_map.find(DataArray::kSelf);
-        if (self_it != datas_map.end())
+        };
+
+        std::size_t threads = threads_ ? threads_ : std::thread::hardware_concurrency();
+        threads = std::max<std::size_t>(1, std::min(threads, files.size()));
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < threads; ++t)
+            workers.emplace_back(work);
+        work();
+        for (auto& worker : workers)
+            worker.join();
+
+        for (const auto& error : errors)
         {
-            DependentSpec dep = {"S", self_it->second};
-            info.dependent_specs.push_back(std::move(dep));
+            if (error)
+                std::rethrow_exception(error);
         }
 
-        ds.AddBlock("SP", std::move(info));
+        Dataset ds(base_name(file_path_));
+        for (std::size_t i = 0; i < files.size(); ++i)
+            ds.AddBlock(stem(files[i]) + "/SP", std::move(blocks[i]));
         return ds;
     }
 
-private:
     std::string file_path_;
+    std::size_t threads_;
 };
 
-TouchstoneReader::TouchstoneReader(const std::string& file_path)
-    : impl_(new Impl(file_path))
+TouchstoneReader::TouchstoneReader(const std::string& file_path,
+                                   const DatasetIOOptions& options)
+    : impl_(new Impl(file_path, options))
 {}
 
 TouchstoneReader::~TouchstoneReader() = default;
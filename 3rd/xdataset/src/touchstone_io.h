@@ -39,6 +39,12 @@ private:
 // =========================================================================
 // TouchstoneDataArrayReader -- read a DataArray from a Touchstone (.sNp)
 // =========================================================================
+//
+// Pairs are column-major for 2-port files and row-major for every other
+// port count, as the format specifies.  Note: .s3p and larger files written
+// by earlier versions of TouchstoneDataArrayWriter are column-major, and
+// read back transposed (S[i,j] <-> S[j,i]); re-export them to fix this.
+// =========================================================================
 
 class TouchstoneDataArrayReader : public IDataArrayReader
 {
@@ -58,13 +64,15 @@ private:
 // =========================================================================
 //
 // Convenience: wraps the DataArray reader and packages the result into a
-// Dataset with a "SP" block.
+// Dataset with a "SP" block.  A directory path loads every .sNp file in it,
+// in parallel (DatasetIOOptions::threads), one "<file stem>/SP" block each.
 // =========================================================================
 
 class TouchstoneReader : public IDatasetReader
 {
 public:
-    explicit TouchstoneReader(const std::string& file_path);
+    explicit TouchstoneReader(const std::string& file_path,
+                              const DatasetIOOptions& options = DatasetIOOptions());
     ~TouchstoneReader() override;
 
     Dataset Read() override;
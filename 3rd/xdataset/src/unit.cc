@@ -1,14 +1,71 @@
 #include "unit.h"
 
 #include <cmath>
+#include <deque>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "unit_registry.h"
 
 namespace xdataset
 {
 
+namespace
+{
+
+// =========================================================================
+//  UnitInternTable — memoised Unit::parse
+// =========================================================================
+//
+//  parse() runs for every suffixed literal the evaluator visits and for
+//  every unit the I/O readers meet, often from several threads.  Each
+//  distinct spelling is resolved against the registry once and interned:
+//  the table maps it to an id, the id to the parsed Unit.  Spellings that
+//  fail to parse are not interned, so the table only holds valid units
+//  and stays as small as the vocabulary actually used.
+
+class UnitInternTable
+{
+public:
+    static UnitInternTable& Instance()
+    {
+        static UnitInternTable table;
+        return table;
+    }
+
+    /// Copy the unit interned for `s` into `out`; false if not interned.
+    bool find(const std::string& s, Unit& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, std::size_t>::const_iterator it = ids_.find(s);
+        if (it == ids_.end())
+            return false;
+        out = units_[it->second];
+        return true;
+    }
+
+    void insert(const std::string& s, const Unit& u)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ids_.size() >= kMaxEntries)
+            return;
+        if (ids_.emplace(s, units_.size()).second)
+            units_.push_back(u);
+    }
+
+private:
+    // Bounds memory if callers feed arbitrary generated spellings.
+    static const std::size_t kMaxEntries = 4096;
+
+    std::mutex                                   mutex_;
+    std::unordered_map<std::string, std::size_t> ids_;
+    std::deque<Unit>                             units_;
+};
+
+} // anonymous namespace
+
 // =========================================================================
 //  UnitData implementation
 // =========================================================================
@@ -123,6 +180,18 @@ Unit::Unit(double mult, UnitData dim) : mult_(mult), dim_(dim) {}
 // =========================================================================
 
 Unit Unit::parse(const std::string& s)
+{
+    UnitInternTable& table = UnitInternTable::Instance();
+    Unit u;
+    if (table.find(s, u))
+        return u;
+
+    u = parse_uncached(s);
+    table.insert(s, u);
+    return u;
+}
+
+Unit Unit::parse_uncached(const std::string& s)
 {
     if (s.empty())
         throw std::invalid_argument("Empty unit string");
@@ -178,6 +178,10 @@ UnitRegistry::UnitRegistry()
     register_predef("nmi",  1852.0,          UnitData(1,0,0,0,0,0,0));    // nautical mile
     register_predef("PHz",  1e15,            UnitData(0,0,-1,0,0,0,0));   // petahertz
     register_predef("dB",   1.0,             UnitData(0,0,0,0,0,0,0));    // decibel (dimensionless)
+
+    // Built eagerly: the registry never changes after construction and
+    // to_string() may run on several threads at once.
+    build_reverse_map();
 }
 
 void UnitRegistry::register_base(const std::string& name, const UnitData& dim)
@@ -119,7 +119,7 @@ private:
     std::map<std::string, double>                 scale_map_;                          
 
     // reverse: dim.key() -> type-A canonical name
-    // Populated lazily on first reverse_lookup() call.
+    // Populated at the end of the constructor.
     mutable std::map<std::string, std::string>    reverse_map_;
     mutable bool                                  reverse_built_ = false;
     void build_reverse_map() const;
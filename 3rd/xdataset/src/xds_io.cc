@@ -0,0 +1,488 @@
+#include "xds_io.h"
+
+#include "block.h"
+#include "data_series.h"
+#include "dataset.h"
+#include "dimension_spec.h"
+#include "file_mapping.h"
+
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace xdataset
+{
+
+namespace
+{
+
+const char          kMagic[4]      = {'X', 'D', 'S', '\0'};
+const std::uint32_t kVersion       = 1;
+const std::uint32_t kByteOrderMark = 0x01020304u;
+const std::size_t   kPrefixSize    = 24;
+const std::size_t   kAlignment     = 64;
+
+std::size_t align_up(std::size_t n)
+{
+    return (n + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::size_t cell_bytes(DataType dtype)
+{
+    switch (dtype)
+    {
+    case DataType::kReal:    return sizeof(double);
+    case DataType::kInteger: return sizeof(int);
+    case DataType::kComplex: return sizeof(std::complex<double>);
+    default:                 return 0;
+    }
+}
+
+/// out = a * b; false when the product does not fit in 64 bits.
+bool checked_mul(std::uint64_t a, std::uint64_t b, std::uint64_t& out)
+{
+    if (a != 0 && b > std::numeric_limits<std::uint64_t>::max() / a)
+        return false;
+    out = a * b;
+    return true;
+}
+
+const void* column_data(const DataSeries& series)
+{
+    switch (series.data_type())
+    {
+    case DataType::kReal:    return series.contiguous_data<double>();
+    case DataType::kInteger: return series.contiguous_data<int>();
+    case DataType::kComplex: return series.contiguous_data<std::complex<double>>();
+    default:                 return nullptr;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Header encoding
+// -----------------------------------------------------------------------
+
+class HeaderWriter
+{
+public:
+    template <typename T>
+    void put(T value)
+    {
+        const char* p = reinterpret_cast<const char*>(&value);
+        bytes_.insert(bytes_.end(), p, p + sizeof(T));
+    }
+
+    void put_str(const std::string& s)
+    {
+        put<std::uint64_t>(s.size());
+        bytes_.insert(bytes_.end(), s.begin(), s.end());
+    }
+
+    const std::vector<char>& bytes() const { return bytes_; }
+
+private:
+    std::vector<char> bytes_;
+};
+
+class HeaderReader
+{
+public:
+    HeaderReader(const char* data, std::size_t size)
+        : data_(data), size_(size), pos_(0)
+    {}
+
+    template <typename T>
+    T get()
+    {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string get_str()
+    {
+        const std::uint64_t n = get<std::uint64_t>();
+        require(n);
+        std::string s(data_ + pos_, static_cast<std::size_t>(n));
+        pos_ += static_cast<std::size_t>(n);
+        return s;
+    }
+
+private:
+    void require(std::uint64_t n) const
+    {
+        if (n > size_ - pos_)
+            throw std::runtime_error("xds: truncated header");
+    }
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_;
+};
+
+// -----------------------------------------------------------------------
+// Writing
+// -----------------------------------------------------------------------
+
+/// Numeric series in the order their columns are laid out.
+struct ColumnPlan
+{
+    std::vector<const DataSeries*> series;
+    std::size_t                    end = 0;   // bytes from data start
+};
+
+void put_dimension(HeaderWriter& out, const DimensionSpec& dim)
+{
+    if (dim.is_regular())
+    {
+        out.put<std::uint8_t>(0);
+        out.put<std::uint64_t>(dim.regular_size());
+        return;
+    }
+    out.put<std::uint8_t>(1);
+    const std::vector<std::size_t>& sizes = dim.ragged_sizes();
+    out.put<std::uint64_t>(sizes.size());
+    for (std::size_t s : sizes)
+        out.put<std::uint64_t>(s);
+}
+
+void put_series(HeaderWriter& out, ColumnPlan& columns, const DataSeries& series)
+{
+    const DataShape shape = series.data_shape();
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(series.data_type()));
+    out.put<std::uint8_t>(static_cast<std::uint8_t>(series.data_kind()));
+    out.put<std::int64_t>(shape.size() > 0 ? shape[0] : 0);
+    out.put<std::int64_t>(shape.size() > 1 ? shape[1] : 0);
+    out.put<std::uint64_t>(series.size());
+    out.put_str(series.unit().to_string());
+
+    const Index n = static_cast<Index>(series.size());
+    const Index width = series.element_count();
+    switch (series.data_type())
+    {
+    case DataType::kString:
+        for (Index i = 0; i < n; ++i)
+        {
+            if (series.data_kind() == DataKind::kScalar)
+            {
+                out.put_str(series.scalar_at<std::string>(i));
+            }
+            else if (series.data_kind() == DataKind::kVector)
+            {
+                const VecXs& row = series.vector_at<std::string>(i);
+                for (Index j = 0; j < width; ++j)
+                    out.put_str(row(j));
+            }
+            else
+            {
+                const MatXs& cell = series.matrix_at<std::string>(i);
+                for (Index r = 0; r < shape[0]; ++r)
+                    for (Index c = 0; c < shape[1]; ++c)
+                        out.put_str(cell(r, c));
+            }
+        }
+        break;
+    default:
+    {
+        const std::size_t bytes = series.contiguous_elements() * cell_bytes(series.data_type());
+        const std::size_t offset = align_up(columns.end);
+        out.put<std::uint64_t>(offset);
+        out.put<std::uint64_t>(bytes);
+        columns.series.push_back(&series);
+        columns.end = offset + bytes;
+        break;
+    }
+    }
+}
+
+void write_padding(std::ofstream& out, std::size_t from, std::size_t to)
+{
+    static const char zeros[kAlignment] = {};
+    out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+
+// -----------------------------------------------------------------------
+// Reading
+// -----------------------------------------------------------------------
+
+DimensionSpec get_dimension(HeaderReader& in)
+{
+    const std::uint8_t type = in.get<std::uint8_t>();
+    if (type == 0)
+        return DimensionSpec::Regular(static_cast<std::size_t>(in.get<std::uint64_t>()));
+    if (type != 1)
+        throw std::runtime_error("xds: unknown dimension type");
+
+    std::vector<std::size_t> sizes(static_cast<std::size_t>(in.get<std::uint64_t>()));
+    for (std::size_t& s : sizes)
+        s = static_cast<std::size_t>(in.get<std::uint64_t>());
+    return DimensionSpec::Ragged(sizes);
+}
+
+/// Series whose numeric cells borrow the mapped column at data start + offset.
+DataSeries get_series(HeaderReader& in, const std::shared_ptr<const FileMapping>& file, std::size_t data_start)
+{
+    const std::uint8_t dtype_tag = in.get<std::uint8_t>();
+    const std::uint8_t kind_tag = in.get<std::uint8_t>();
+    const Index dim0 = static_cast<Index>(in.get<std::int64_t>());
+    const Index dim1 = static_cast<Index>(in.get<std::int64_t>());
+    const std::size_t rows = static_cast<std::size_t>(in.get<std::uint64_t>());
+    const std::string unit_str = in.get_str();
+
+    if (dtype_tag > static_cast<std::uint8_t>(DataType::kString) ||
+        kind_tag > static_cast<std::uint8_t>(DataKind::kMatrix) || dim0 < 0 || dim1 < 0)
+        throw std::runtime_error("xds: bad series schema");
+
+    // rows x cells per row x cell size must fit before any of it is trusted.
+    std::uint64_t row_cells = 1;
+    if (kind_tag == static_cast<std::uint8_t>(DataKind::kVector))
+        row_cells = static_cast<std::uint64_t>(dim0);
+    else if (kind_tag == static_cast<std::uint8_t>(DataKind::kMatrix) &&
+             !checked_mul(static_cast<std::uint64_t>(dim0), static_cast<std::uint64_t>(dim1), row_cells))
+        throw std::runtime_error("xds: bad series schema");
+    std::uint64_t cells = 0;
+    if (!checked_mul(static_cast<std::uint64_t>(rows), row_cells, cells) ||
+        cells > static_cast<std::uint64_t>(std::numeric_limits<Index>::max()))
+        throw std::runtime_error("xds: bad series schema");
+
+    const DataType dtype = static_cast<DataType>(dtype_tag);
+    const DataShape shape = kind_tag == static_cast<std::uint8_t>(DataKind::kScalar) ? DataShape::Scalar()
+                          : kind_tag == static_cast<std::uint8_t>(DataKind::kVector) ? DataShape::Vector(dim0)
+                                                                                      : DataShape::Matrix(dim0, dim1);
+    const Unit unit = unit_str.empty() ? Unit() : Unit::parse(unit_str);
+
+    if (dtype != DataType::kString)
+    {
+        const std::uint64_t offset = in.get<std::uint64_t>();
+        const std::uint64_t bytes = in.get<std::uint64_t>();
+        std::uint64_t expected = 0;
+        if (!checked_mul(cells, cell_bytes(dtype), expected) || bytes != expected || offset % kAlignment != 0 || data_start > file->size() ||
+            offset > file->size() - data_start || bytes > file->size() - data_start - offset)
+            throw std::runtime_error("xds: column out of bounds");
+        return DataSeries::CreateBorrowed(dtype, shape, file->data() + data_start + offset, rows, unit, file);
+    }
+
+    DataSeries series(DataType::kString, shape);
+    series.set_unit(unit);
+    series.resize(rows);
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        const Index row = static_cast<Index>(i);
+        if (shape.kind() == DataKind::kScalar)
+        {
+            series.scalar_at<std::string>(row) = in.get_str();
+        }
+        else if (shape.kind() == DataKind::kVector)
+        {
+            VecXs& cells = series.vector_at<std::string>(row);
+            for (Index j = 0; j < dim0; ++j)
+                cells(j) = in.get_str();
+        }
+        else
+        {
+            MatXs& cells = series.matrix_at<std::string>(row);
+            for (Index r = 0; r < dim0; ++r)
+                for (Index c = 0; c < dim1; ++c)
+                    cells(r, c) = in.get_str();
+        }
+    }
+    return series;
+}
+
+} // anonymous namespace
+
+// =========================================================================
+// XdsWriter::Impl
+// =========================================================================
+
+class XdsWriter::Impl
+{
+public:
+    explicit Impl(const std::string& path)
+        : path_(path)
+    {}
+
+    void write(const Dataset& dataset)
+    {
+        HeaderWriter header;
+        ColumnPlan columns;
+
+        header.put_str(dataset.name());
+        const std::vector<std::string> paths = dataset.GetAllBlockPaths();
+        header.put<std::uint64_t>(paths.size());
+        for (const auto& path : paths)
+        {
+            const Block& block = dataset.GetBlock(path);
+            header.put_str(path);
+
+            const std::vector<std::string> independents = block.independents();
+            header.put<std::uint64_t>(independents.size());
+            for (const auto& name : independents)
+            {
+                const IndependentSpec& spec = block.independent_spec(name);
+                header.put_str(name);
+                put_dimension(header, spec.dimension);
+                put_series(header, columns, spec.data);
+            }
+
+            const std::vector<std::string> dependents = block.dependents();
+            header.put<std::uint64_t>(dependents.size());
+            for (const auto& name : dependents)
+            {
+                header.put_str(name);
+                put_series(header, columns, block.dependent_spec(name).data);
+            }
+        }
+
+        // The dataset may borrow its columns from a mapping of path_ itself,
+        // so write a temporary file and replace the target only when done.
+        const std::string temp_path = path_ + ".tmp";
+        std::ofstream out(temp_path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("cannot create xds file: " + temp_path);
+
+        const std::vector<char>& bytes = header.bytes();
+        const std::uint32_t reserved = 0;
+        const std::uint64_t header_size = bytes.size();
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+        out.write(reinterpret_cast<const char*>(&kByteOrderMark), sizeof(kByteOrderMark));
+        out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+        out.write(reinterpret_cast<const char*>(&header_size), sizeof(header_size));
+        if (!bytes.empty())
+            out.write(&bytes[0], static_cast<std::streamsize>(bytes.size()));
+
+        const std::size_t header_end = kPrefixSize + bytes.size();
+        write_padding(out, header_end, align_up(header_end));
+
+        std::size_t pos = 0;   // from data start
+        for (const DataSeries* series : columns.series)
+        {
+            const std::size_t offset = align_up(pos);
+            write_padding(out, pos, offset);
+            const std::size_t n = series->contiguous_elements() * cell_bytes(series->data_type());
+            if (n > 0)
+                out.write(static_cast<const char*>(column_data(*series)), static_cast<std::streamsize>(n));
+            pos = offset + n;
+        }
+
+        out.close();
+        if (!out)
+        {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("cannot write xds file: " + path_);
+        }
+        if (std::rename(temp_path.c_str(), path_.c_str()) != 0)
+        {
+            // Windows: rename does not replace an existing file.
+            std::remove(path_.c_str());
+            if (std::rename(temp_path.c_str(), path_.c_str()) != 0)
+            {
+                std::remove(temp_path.c_str());
+                throw std::runtime_error("cannot replace xds file: " + path_);
+            }
+        }
+    }
+
+private:
+    std::string path_;
+};
+
+XdsWriter::XdsWriter(const std::string& file_path)
+    : impl_(new Impl(file_path))
+{}
+
+XdsWriter::~XdsWriter() = default;
+
+void XdsWriter::Write(const Dataset& dataset)
+{
+    impl_->write(dataset);
+}
+
+// =========================================================================
+// XdsReader::Impl
+// =========================================================================
+
+class XdsReader::Impl
+{
+public:
+    explicit Impl(const std::string& path)
+        : path_(path)
+    {}
+
+    Dataset read()
+    {
+        std::shared_ptr<const FileMapping> file = std::make_shared<FileMapping>(path_);
+
+        HeaderReader prefix(file->data(), file->size());
+        char magic[4];
+        for (char& c : magic)
+            c = prefix.get<char>();
+        const std::uint32_t version = prefix.get<std::uint32_t>();
+        const std::uint32_t bom = prefix.get<std::uint32_t>();
+        prefix.get<std::uint32_t>();
+        const std::uint64_t header_size = prefix.get<std::uint64_t>();
+
+        if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("not an xds file: " + path_);
+        if (version != kVersion)
+            throw std::runtime_error("unsupported xds version in " + path_);
+        if (bom != kByteOrderMark)
+            throw std::runtime_error("xds file written with a different byte order: " + path_);
+        if (header_size > file->size() - kPrefixSize)
+            throw std::runtime_error("xds: truncated header");
+
+        const std::size_t data_start = align_up(kPrefixSize + static_cast<std::size_t>(header_size));
+        HeaderReader in(file->data() + kPrefixSize, static_cast<std::size_t>(header_size));
+
+        Dataset ds(in.get_str());
+        const std::uint64_t block_count = in.get<std::uint64_t>();
+        for (std::uint64_t b = 0; b < block_count; ++b)
+        {
+            const std::string path = in.get_str();
+            BlockCreateInfo info;
+
+            const std::uint64_t independents = in.get<std::uint64_t>();
+            for (std::uint64_t i = 0; i < independents; ++i)
+            {
+                std::string name = in.get_str();
+                DimensionSpec dim = get_dimension(in);
+                DataSeries data = get_series(in, file, data_start);
+                info.independent_specs.push_back(IndependentSpec{std::move(name), std::move(data), dim});
+            }
+
+            const std::uint64_t dependents = in.get<std::uint64_t>();
+            for (std::uint64_t i = 0; i < dependents; ++i)
+            {
+                std::string name = in.get_str();
+                info.dependent_specs.push_back(DependentSpec{std::move(name), get_series(in, file, data_start)});
+            }
+
+            ds.AddBlock(path, Block(info));
+        }
+        return ds;
+    }
+
+private:
+    std::string path_;
+};
+
+XdsReader::XdsReader(const std::string& file_path)
+    : impl_(new Impl(file_path))
+{}
+
+XdsReader::~XdsReader() = default;
+
+Dataset XdsReader::Read()
+{
+    return impl_->read();
+}
+
+} // namespace xdataset
@@ -0,0 +1,83 @@
+#ifndef XDATASET_XDS_IO_H
+#define XDATASET_XDS_IO_H
+
+// =========================================================================
+// Native "xds" IO class declarations (private to the library build).
+//
+// Instantiated only by the DatasetIO factories in src/hdf5_io.cc.
+// =========================================================================
+
+#include "dataset_io.h"
+
+#include <memory>
+#include <string>
+
+namespace xdataset
+{
+
+// =========================================================================
+// File layout (little-endian, version 1)
+// =========================================================================
+//
+//   offset 0    "XDS\0"                  magic
+//          4    u32 version              1
+//          8    u32 byte-order mark      0x01020304 as written by the host
+//         12    u32 reserved             0
+//         16    u64 header size H
+//         24    header (H bytes)
+//               zero padding to a 64-byte boundary = data start
+//               numeric columns, each starting on a 64-byte boundary
+//
+//   header:  str dataset name, u64 block count, then per block
+//            str path,
+//            u64 n, n x {str name, dimension, series}   independents
+//            u64 m, m x {str name, series}              dependents
+//   dimension:  u8 0 + u64 size                  (regular)
+//               u8 1 + u64 n + n x u64 size      (ragged)
+//   series:  u8 DataType, u8 DataKind, i64 shape[0], i64 shape[1],
+//            u64 rows, str unit, then
+//            numeric: u64 column offset (from data start), u64 bytes
+//            string:  rows * element_count x str, row-major
+//   str:     u64 length + bytes
+//
+// Numeric columns hold the series' contiguous_data() as is, so a reader
+// can map the file and hand the columns to DataSeries::CreateBorrowed().
+// =========================================================================
+
+// =========================================================================
+// XdsWriter -- write a Dataset to an .xds file
+// =========================================================================
+
+class XdsWriter : public IDatasetWriter
+{
+public:
+    explicit XdsWriter(const std::string& file_path);
+    ~XdsWriter() override;
+
+    void Write(const Dataset& dataset) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// =========================================================================
+// XdsReader -- map an .xds file; numeric series borrow the mapped pages
+// =========================================================================
+
+class XdsReader : public IDatasetReader
+{
+public:
+    explicit XdsReader(const std::string& file_path);
+    ~XdsReader() override;
+
+    Dataset Read() override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace xdataset
+
+#endif // XDATASET_XDS_IO_H
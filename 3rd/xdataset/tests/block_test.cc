@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 namespace xdataset
 {
     using namespace block_fixtures;
@@ -102,6 +105,28 @@ namespace xdataset
         const DataArray& second = block.GetOrCreateDataArray("z");  EXPECT_EQ(&first, &second);
     }
 
+    TEST(BlockVariableCacheTest, ConcurrentLookupsShareOneCachedVariable)
+    {
+        Block block(MakeBaseCreateInfo());
+
+        const char* names[] = {"x", "y", "z"};
+        std::vector<const DataArray*> seen(8 * 3);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&block, &names, &seen, t]() {
+                for (std::size_t i = 0; i < 3; ++i)
+                    seen[t * 3 + i] = &block.GetOrCreateDataArray(names[(t + i) % 3]);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (std::size_t t = 0; t < 8; ++t)
+            for (std::size_t i = 0; i < 3; ++i)
+                EXPECT_EQ(seen[t * 3 + i], &block.GetOrCreateDataArray(names[(t + i) % 3]));
+    }
+
     TEST(BlockVariableCacheTest, BuildsIndependentVariableWithPrefixDims)
     {
         Block block(MakeBaseCreateInfo());
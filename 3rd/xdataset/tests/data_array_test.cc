@@ -1,4 +1,5 @@
 #include "block_fixtures.h"
+#include "data_array_view.h"
 
 #include <gtest/gtest.h>
 #include <complex>
@@ -956,4 +957,126 @@ namespace xdataset
         EXPECT_EQ(labels.data().scalar_at<std::string>(1), "val_2");
         EXPECT_EQ(labels.data().scalar_at<std::string>(2), "val_3");
     }
+
+    TEST(MultiIndexSelectorTest, RangeResolvesAndMatches)
+    {
+        MultiIndexSelector range = MultiIndexSelector::Range(2, 12, 3);
+        EXPECT_TRUE(range.is_range());
+        EXPECT_EQ(range.range_start(), 2);
+        EXPECT_EQ(range.range_step(), 3);
+        EXPECT_EQ(range.range_count(), 4);
+        EXPECT_EQ(range.resolve(12), (std::vector<Index>{2, 5, 8, 11}));
+        EXPECT_TRUE(range.matches(8));
+        EXPECT_FALSE(range.matches(9));
+        EXPECT_FALSE(range.matches(14));
+        EXPECT_THROW(range.resolve(11), std::out_of_range);
+
+        EXPECT_THROW(MultiIndexSelector::Range(3, 3), std::invalid_argument);
+        EXPECT_THROW(MultiIndexSelector::Range(0, 4, 0), std::invalid_argument);
+        EXPECT_THROW(MultiIndexSelector::Range(-1, 4), std::invalid_argument);
+    }
+
+    TEST(DataArraySelectTest, RangeSelectMatchesEquivalentIn)
+    {
+        Block block(MakeThreeDimMultiDepCreateInfo());
+        DataArray p_data = block.GetOrCreateDataArray("p");
+        DataArray c_data = block.GetOrCreateDataArray("c");
+        Block rich(MakeValueRichCreateInfo());
+        DataArray z_data = rich.GetOrCreateDataArray("z");
+
+        // In always takes the generic dimension walk; Range on regular
+        // dimensions goes through DataArrayView.
+        struct Case
+        {
+            const DataArray* source;
+            std::vector<MultiIndexSelector> by_in;
+            std::vector<MultiIndexSelector> by_range;
+        };
+        const std::vector<Case> cases = {
+            {&z_data,
+             {MultiIndexSelector::In({0, 1}), MultiIndexSelector::In({0, 2})},
+             {MultiIndexSelector::Range(0, 2), MultiIndexSelector::Range(0, 3, 2)}},
+            {&z_data,
+             {MultiIndexSelector::In({1}), MultiIndexSelector::In({1})},
+             {MultiIndexSelector::Range(1, 2), MultiIndexSelector::Range(1, 2)}},
+            {&p_data,
+             {MultiIndexSelector::In({0, 1}), MultiIndexSelector::In({0, 2}), MultiIndexSelector::In({1, 3})},
+             {MultiIndexSelector::Range(0, 2), MultiIndexSelector::Range(0, 3, 2), MultiIndexSelector::Range(1, 4, 2)}},
+            {&p_data,
+             {MultiIndexSelector::Equal(1), MultiIndexSelector::In({1, 2}), MultiIndexSelector::Any()},
+             {MultiIndexSelector::Equal(1), MultiIndexSelector::Range(1, 3), MultiIndexSelector::Any()}},
+            {&p_data,
+             {MultiIndexSelector::In({3})},
+             {MultiIndexSelector::Range(3, 4)}},
+            {&c_data,
+             {MultiIndexSelector::Any(), MultiIndexSelector::In({0, 2}), MultiIndexSelector::In({1, 2})},
+             {MultiIndexSelector::Any(), MultiIndexSelector::Range(0, 3, 2), MultiIndexSelector::Range(1, 3)}},
+        };
+
+        for (const Case& c : cases)
+        {
+            DataArray expected = c.source->select(c.by_in);
+            DataArray actual = c.source->select(c.by_range);
+            EXPECT_EQ(actual.data_kind(), expected.data_kind());
+            ASSERT_EQ(actual.multi_dimension_spec().rank(), expected.multi_dimension_spec().rank());
+            EXPECT_EQ(actual.indep_names(), expected.indep_names());
+            EXPECT_EQ(actual.GetOrCreateDataFrame().ToCsv(), expected.GetOrCreateDataFrame().ToCsv());
+        }
+    }
+
+    TEST(DataArrayViewTest, SingleCellReadsParentRow)
+    {
+        Block block(MakeValueRichCreateInfo());
+        DataArray z_data = block.GetOrCreateDataArray("z");
+
+        DataArrayView view(z_data, {MultiIndexSelector::Equal(1), MultiIndexSelector::Equal(2)});
+        EXPECT_EQ(&view.parent(), &z_data);
+        EXPECT_EQ(view.rank(), 0u);
+        ASSERT_EQ(view.size(), 1);
+        EXPECT_EQ(view.parent_row(0), 5);
+        EXPECT_EQ(view.measurement_at(0).to_string(), "105");
+        EXPECT_THROW(view.parent_row(1), std::out_of_range);
+
+        DataArrayView column(z_data, {MultiIndexSelector::Any(), MultiIndexSelector::Range(0, 3, 2)});
+        EXPECT_EQ(column.rank(), 2u);
+        ASSERT_EQ(column.size(), 4);
+        EXPECT_EQ(column.parent_row(1), 2);
+        EXPECT_EQ(column.parent_row(2), 3);
+        EXPECT_EQ(column.measurement_at(3).to_string(), "105");
+    }
+
+    TEST(DataArrayViewTest, FullDimensionsShareParentStorage)
+    {
+        Block block(MakeValueRichCreateInfo());
+        DataArray z_data = block.GetOrCreateDataArray("z");
+
+        DataArray all = DataArrayView(z_data, {}).materialize();
+        EXPECT_EQ(all.data().contiguous_data<double>(), z_data.data().contiguous_data<double>());
+        EXPECT_EQ(all.datas().begin()->second.contiguous_data<double>(),
+                  z_data.datas().begin()->second.contiguous_data<double>());
+
+        // Only the sliced dimension is copied.
+        DataArray row = DataArrayView(z_data, {MultiIndexSelector::Equal(1), MultiIndexSelector::Any()}).materialize();
+        EXPECT_EQ(row.datas().begin()->second.contiguous_data<double>(),
+                  z_data.datas().find("y")->second.contiguous_data<double>());
+        ASSERT_EQ(row.data().size(), 3u);
+        EXPECT_DOUBLE_EQ(row.data().scalar_at<double>(0), 103.0);
+    }
+
+    TEST(DataArrayViewTest, RejectsRaggedDimensionsAndInSelectors)
+    {
+        Block ragged(MakeRaggedCreateInfo());
+        DataArray ragged_z = ragged.GetOrCreateDataArray("z");
+        EXPECT_FALSE(DataArrayView::CanView(ragged_z, {}));
+        EXPECT_THROW(DataArrayView(ragged_z, {}), std::invalid_argument);
+
+        Block regular(MakeValueRichCreateInfo());
+        DataArray z_data = regular.GetOrCreateDataArray("z");
+        EXPECT_TRUE(DataArrayView::CanView(z_data, {MultiIndexSelector::Range(0, 2)}));
+        EXPECT_FALSE(DataArrayView::CanView(z_data, {MultiIndexSelector::In({0, 2})}));
+        EXPECT_THROW(DataArrayView(z_data, {MultiIndexSelector::Range(1, 4)}), std::out_of_range);
+        EXPECT_THROW(DataArrayView(z_data, {MultiIndexSelector::Any(), MultiIndexSelector::Any(),
+                                            MultiIndexSelector::Any()}),
+                     std::invalid_argument);
+    }
 } // namespace xdataset
\ No newline at end of file
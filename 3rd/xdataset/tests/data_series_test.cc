@@ -4,6 +4,7 @@
 
 #include <complex>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -212,6 +213,29 @@ TEST(CopyMoveTest, CopyAssignmentIsDeep) {
     EXPECT_DOUBLE_EQ(orig.scalar_at<double>(1), 2.0);
 }
 
+TEST(CopyMoveTest, CopySharesStorageUntilWrite) {
+    DataSeries orig = DataSeries::CreateScalar<double>(3, Unit(), 1.0);
+    DataSeries copy(orig);
+    const DataSeries& corig = orig;
+    const DataSeries& ccopy = copy;
+    EXPECT_EQ(ccopy.contiguous_data<double>(), corig.contiguous_data<double>());
+
+    copy.mutable_contiguous_data<double>()[2] = 5.0;
+    EXPECT_NE(ccopy.contiguous_data<double>(), corig.contiguous_data<double>());
+    EXPECT_DOUBLE_EQ(orig.scalar_at<double>(2), 1.0);
+    EXPECT_DOUBLE_EQ(copy.scalar_at<double>(2), 5.0);
+}
+
+TEST(CopyMoveTest, WriteToOriginalDoesNotReachCopy) {
+    DataSeries orig = DataSeries::CreateScalar<std::string>(2, Unit(), std::string("a"));
+    DataSeries copy(orig);
+    orig.resize(3);
+    orig.scalar_at<std::string>(0) = "z";
+    ASSERT_EQ(copy.size(), 2u);
+    EXPECT_EQ(copy.scalar_at<std::string>(0), "a");
+    EXPECT_EQ(orig.scalar_at<std::string>(0), "z");
+}
+
 TEST(CopyMoveTest, MoveConstructorTransfersOwnership) {
     DataSeries orig = DataSeries::CreateScalar<double>(3, Unit(), 5.0);
     DataSeries moved(std::move(orig));
@@ -1036,3 +1060,108 @@ TEST(TransformTest, MatrixElementwiseAbsolute) {
 }
 
 // =========================================================================
+
+// ---------------------------------------------------------------------------
+//  DataSeries::CreateDeferred
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Rows i -> 10 * i; counts the rows handed out.
+class CountingLoader : public xdataset::SeriesLoader {
+public:
+    explicit CountingLoader(std::size_t* rows_read) : rows_read_(rows_read) {}
+
+    DataSeries load(Index start, Index step, std::size_t count) const override {
+        *rows_read_ += count;
+        std::vector<double> values;
+        for (std::size_t k = 0; k < count; ++k)
+            values.push_back(10.0 * static_cast<double>(start + static_cast<Index>(k) * step));
+        return DataSeries::CreateScalarFromVector(values, Unit::parse("V"));
+    }
+
+private:
+    std::size_t* rows_read_;
+};
+
+DataSeries MakeDeferred(std::size_t rows, std::size_t* rows_read) {
+    return DataSeries::CreateDeferred(DataType::kReal, xdataset::DataShape::Scalar(), rows,
+                                      Unit::parse("V"), std::make_shared<CountingLoader>(rows_read));
+}
+
+}  // namespace
+
+TEST(DeferredSeriesTest, ReadRowsLoadsOnlyRequestedRows) {
+    std::size_t rows_read = 0;
+    DataSeries s = MakeDeferred(100, &rows_read);
+    EXPECT_EQ(s.size(), 100u);
+    EXPECT_TRUE(s.is_deferred());
+    EXPECT_EQ(rows_read, 0u);
+
+    DataSeries strided = s.read_rows(10, 20, 3);
+    ASSERT_EQ(strided.size(), 3u);
+    EXPECT_DOUBLE_EQ(strided.scalar_at<double>(2), 500.0);
+    EXPECT_TRUE(strided.unit().same_dimension(Unit::parse("V")));
+
+    DataSeries head = s.iloc(0, 2);
+    EXPECT_DOUBLE_EQ(head.scalar_at<double>(1), 10.0);
+    EXPECT_EQ(rows_read, 5u);
+    EXPECT_TRUE(s.is_deferred());
+
+    EXPECT_THROW(s.read_rows(95, 5, 2), std::out_of_range);
+}
+
+TEST(DeferredSeriesTest, CopiesShareLoadedRowsAndWritesDetach) {
+    std::size_t rows_read = 0;
+    DataSeries s = MakeDeferred(4, &rows_read);
+    const DataSeries copy(s);
+
+    // Reads go through const access; non-const access detaches like a write.
+    const DataSeries& reader = s;
+    EXPECT_DOUBLE_EQ(reader.scalar_at<double>(3), 30.0);
+    EXPECT_FALSE(s.is_deferred());
+    EXPECT_TRUE(copy.is_deferred());
+    EXPECT_DOUBLE_EQ(copy.contiguous_data<double>()[2], 20.0);
+    EXPECT_EQ(rows_read, 4u);
+
+    s.scalar_at<double>(0) = -1.0;
+    EXPECT_DOUBLE_EQ(s.scalar_at<double>(0), -1.0);
+    EXPECT_DOUBLE_EQ(copy.scalar_at<double>(0), 0.0);
+
+    const DataSeries later = MakeDeferred(4, &rows_read);
+    EXPECT_DOUBLE_EQ(later.scalar_at<double>(1), 10.0);
+    EXPECT_EQ(rows_read, 8u);
+}
+
+TEST(DeferredSeriesTest, NeverLoadedCopySeesOriginalRowsAfterSiblingWrite) {
+    std::size_t rows_read = 0;
+    {
+        // Loaded sibling still holds the rows: the writer clones them and
+        // leaves the originals to the cache.  Once the sibling lets go, the
+        // never-loaded copy reloads instead of seeing the writer's cells.
+        DataSeries s = MakeDeferred(4, &rows_read);
+        const DataSeries never_loaded(s);
+        std::unique_ptr<const DataSeries> sibling(new DataSeries(s));
+        EXPECT_DOUBLE_EQ(sibling->scalar_at<double>(1), 10.0);
+
+        s.scalar_at<double>(1) = -1.0;
+        EXPECT_EQ(rows_read, 4u);
+        sibling.reset();
+        EXPECT_DOUBLE_EQ(never_loaded.scalar_at<double>(1), 10.0);
+        EXPECT_DOUBLE_EQ(s.scalar_at<double>(1), -1.0);
+    }
+    EXPECT_EQ(rows_read, 8u);
+
+    {
+        // Writer is the only holder: rows are written in place and leave the
+        // cache, so the never-loaded copy reloads the originals.
+        DataSeries s = MakeDeferred(4, &rows_read);
+        const DataSeries never_loaded(s);
+        const DataSeries& reader = s;
+        EXPECT_DOUBLE_EQ(reader.scalar_at<double>(2), 20.0);
+        s.scalar_at<double>(2) = -2.0;
+        EXPECT_DOUBLE_EQ(never_loaded.scalar_at<double>(2), 20.0);
+        EXPECT_DOUBLE_EQ(s.scalar_at<double>(2), -2.0);
+    }
+    EXPECT_EQ(rows_read, 16u);
+}
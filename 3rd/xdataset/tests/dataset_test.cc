@@ -3,7 +3,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace xdataset
 {
@@ -234,6 +237,64 @@ namespace xdataset
         EXPECT_FALSE(ds.HasUniqueDataArray("iv0"));
     }
 
+    TEST(DatasetTest, NameIndexFollowsAddAndRemove)
+    {
+        Dataset ds("noise");
+        ds.AddBlock("simulation/SP", make_block_info());
+        ds.AddBlock("/simulation/HB/", make_block_info());
+        ds.AddBlock("other/AC", make_block_info(1, 0));
+
+        EXPECT_EQ(ds.FindDataArrayPaths("iv0"),
+                  (std::vector<std::string>{"simulation/SP", "simulation/HB", "other/AC"}));
+        EXPECT_EQ(ds.FindDataArrayPaths("dv0"),
+                  (std::vector<std::string>{"simulation/SP", "simulation/HB"}));
+        EXPECT_TRUE(ds.FindDataArrayPaths("missing").empty());
+
+        EXPECT_EQ(ds.RemoveBlock("simulation/SP"), 1u);
+        EXPECT_TRUE(ds.HasUniqueDataArray("dv0"));
+        EXPECT_EQ(ds.FindUniqueDataArray("dv0"), "simulation/HB");
+
+        EXPECT_EQ(ds.RemoveGroup("simulation"), 1u);
+        EXPECT_TRUE(ds.FindDataArrayPaths("dv0").empty());
+        EXPECT_EQ(ds.FindUniqueDataArray("iv0"), "other/AC");
+
+        EXPECT_EQ(ds.RemoveGroup(""), 1u);
+        EXPECT_TRUE(ds.FindDataArrayPaths("iv0").empty());
+    }
+
+    TEST(DatasetTest, AddBlockOverGroupDropsItsNamesFromIndex)
+    {
+        Dataset ds("noise");
+        ds.AddBlock("a/b/c", make_block_info(1, 1));
+        ds.AddBlock("a/b", make_block_info(1, 0));
+
+        EXPECT_EQ(ds.block_count(), 1u);
+        EXPECT_TRUE(ds.FindDataArrayPaths("dv0").empty());
+        EXPECT_EQ(ds.FindDataArrayPaths("iv0"), (std::vector<std::string>{"a/b"}));
+    }
+
+    TEST(DatasetTest, RevisionChangesOnMutationAndMove)
+    {
+        Dataset ds("noise");
+        const std::uint64_t empty = ds.revision();
+        ds.AddBlock("SP", make_block_info());
+        const std::uint64_t added = ds.revision();
+        EXPECT_NE(added, empty);
+
+        ds.RemoveBlock("missing");
+        EXPECT_EQ(ds.revision(), added);
+        ds.RemoveBlock("SP");
+        EXPECT_NE(ds.revision(), added);
+
+        Dataset other("other");
+        EXPECT_NE(other.revision(), ds.revision());
+        ds.AddBlock("HB", make_block_info());
+        const std::uint64_t before_move = ds.revision();
+        Dataset moved(std::move(ds));
+        EXPECT_NE(moved.revision(), before_move);
+        EXPECT_TRUE(moved.HasUniqueDataArray("iv0"));
+    }
+
     // ========================================================================
     // GetDataArray
     // ========================================================================
@@ -2,8 +2,10 @@
 #include "dataset.h"
 #include "block.h"
 #include "block_fixtures.h"
+#include "multi_index_selector.h"
 
 #include <gtest/gtest.h>
+#include <hdf5.h>
 
 #include <complex>
 #include <cmath>
@@ -40,6 +42,26 @@ namespace xdataset
             return info;
         }
 
+        // sweep(4) x t(250): 1000 rows, Vout(row) = row.  Independents are
+        // named in alphabetical order, the order HDF5 lists them back in.
+        BlockCreateInfo make_long_info()
+        {
+            std::vector<double> t(250);
+            std::vector<double> vout(1000);
+            for (std::size_t i = 0; i < t.size(); ++i) t[i] = 1e-3 * static_cast<double>(i);
+            for (std::size_t i = 0; i < vout.size(); ++i) vout[i] = static_cast<double>(i);
+
+            BlockCreateInfo info;
+            info.independent_specs.push_back(
+                IndependentSpec{"sweep", MakeScalarSeriesFrom({0.0, 1.0, 2.0, 3.0}),
+                                DimensionSpec::Regular(4)});
+            info.independent_specs.push_back(
+                IndependentSpec{"t", MakeScalarSeriesFrom(t), DimensionSpec::Regular(250)});
+            info.dependent_specs.push_back(
+                DependentSpec{"Vout", MakeScalarSeriesFrom(vout)});
+            return info;
+        }
+
         BlockCreateInfo make_vector_info()
         {
             // Regular(2) �?2 rows, vector width 3
@@ -183,6 +205,72 @@ namespace xdataset
         EXPECT_TRUE(loaded.IsLeaf("a"));
     }
 
+    TEST(Hdf5IoTest, ChunkedCompressedRoundtrip)
+    {
+        Dataset ds("chunked");
+        ds.AddBlock("tran", make_long_info());
+
+        DatasetIOOptions options;
+        options.chunk_rows = 64;
+        options.deflate_level = 6;
+        options.shuffle = true;
+        DatasetIO::Save(ds, "hdf5", "test_chunked.h5", options);
+
+        {
+            hid_t file = H5Fopen("test_chunked.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+            hid_t dset = H5Dopen2(file, "/chunked/tran/Vout", H5P_DEFAULT);
+            hid_t dcpl = H5Dget_create_plist(dset);
+            hsize_t chunk = 0;
+            EXPECT_EQ(H5Pget_layout(dcpl), H5D_CHUNKED);
+            EXPECT_EQ(H5Pget_chunk(dcpl, 1, &chunk), 1);
+            EXPECT_EQ(chunk, 64u);
+            EXPECT_EQ(H5Pget_nfilters(dcpl), 2);
+            H5Pclose(dcpl);
+            H5Dclose(dset);
+            H5Fclose(file);
+        }
+
+        Dataset loaded = DatasetIO::Load("hdf5", "test_chunked.h5");
+        const DataSeries& vout = loaded.GetBlock("tran").dependent_spec("Vout").data;
+        ASSERT_EQ(vout.size(), 1000u);
+        EXPECT_DOUBLE_EQ(vout.scalar_at<double>(0), 0.0);
+        EXPECT_DOUBLE_EQ(vout.scalar_at<double>(999), 999.0);
+
+        options.deflate_level = 10;
+        EXPECT_THROW(DatasetIO::Save(ds, "hdf5", "test_chunked.h5", options), std::invalid_argument);
+    }
+
+    TEST(Hdf5IoTest, LazyLoadReadsSelectedRows)
+    {
+        Dataset ds("lazy");
+        ds.AddBlock("tran", make_long_info());
+        DatasetIOOptions write_options;
+        write_options.chunk_rows = 100;
+        DatasetIO::Save(ds, "hdf5", "test_lazy.h5", write_options);
+
+        DatasetIOOptions options;
+        options.lazy = true;
+        Dataset loaded = DatasetIO::Load("hdf5", "test_lazy.h5", options);
+        const Block& b = loaded.GetBlock("tran");
+        EXPECT_TRUE(b.dependent_spec("Vout").data.is_deferred());
+        EXPECT_EQ(b.dependent_spec("Vout").data.size(), 1000u);
+
+        // sweep = 2, t = 10, 20, ..., 50 -> rows 510 .. 550
+        const DataArray& vout = loaded.GetDataArray("tran", "Vout");
+        DataArray sel = vout.select({MultiIndexSelector::Equal(2), MultiIndexSelector::Range(10, 51, 10)});
+        ASSERT_EQ(sel.data().size(), 5u);
+        EXPECT_DOUBLE_EQ(sel.data().scalar_at<double>(0), 510.0);
+        EXPECT_DOUBLE_EQ(sel.data().scalar_at<double>(4), 550.0);
+        EXPECT_TRUE(vout.data().is_deferred());
+
+        // Reading everything through a copy leaves the Block's series deferred.
+        DataArray whole = vout;
+        EXPECT_DOUBLE_EQ(whole.data().scalar_at<double>(999), 999.0);
+        EXPECT_FALSE(whole.data().is_deferred());
+        EXPECT_TRUE(b.dependent_spec("Vout").data.is_deferred());
+        EXPECT_DOUBLE_EQ(b.independent_spec("t").data.scalar_at<double>(249), 0.249);
+    }
+
     TEST(Hdf5IoTest, UnsupportedFormatThrows)
     {
         Dataset ds("test");
@@ -13,6 +13,13 @@
 #include <iostream>
 #include <stdexcept>
 
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -173,6 +180,115 @@ namespace xdataset
         EXPECT_EQ(da.data_kind(), DataArrayKind::kDependent);
     }
 
+    TEST(TouchstoneDataArrayIoTest, ReadsValuesExactly)
+    {
+        {
+            std::ofstream out("test_da_exact.s1p");
+            out << "# Hz S RI R 50\r\n";
+            out << "5.0E7 1.3145386801343174E-4 -7.817132525456352e-4 ! trailing comment\r\n";
+            out << "  +5.0754570186123446E7\t.5 -0.0000000000000000000012345678901234567890\r\n";
+            out << "[End]\r\n";
+        }
+        DataArray da = DataArrayIO::Load("touchstone", "test_da_exact.s1p");
+        std::remove("test_da_exact.s1p");
+
+        const DataSeries& freq = da.datas().find("freq")->second;
+        ASSERT_EQ(freq.size(), 2u);
+        EXPECT_EQ(freq.scalar_at<double>(0), 5.0E7);
+        EXPECT_EQ(freq.scalar_at<double>(1), 5.0754570186123446E7);
+
+        // Long literals still round exactly like the compiler does.
+        const DataSeries& s = da.data();
+        EXPECT_EQ(s.matrix_at<std::complex<double>>(0)(0, 0),
+                  std::complex<double>(1.3145386801343174E-4, -7.817132525456352e-4));
+        EXPECT_EQ(s.matrix_at<std::complex<double>>(1)(0, 0),
+                  std::complex<double>(0.5, -0.0000000000000000000012345678901234567890));
+    }
+
+    TEST(TouchstoneDataArrayIoTest, ReadS4PWithWrappedRows)
+    {
+        // 4-port rows span four lines of at most four value pairs.
+        {
+            std::ofstream out("test_da_wrapped.s4p");
+            out << "# MHz S RI R 50\n";
+            for (int f = 1; f <= 2; ++f)
+            {
+                out << f;
+                for (int k = 0; k < 16; ++k)
+                {
+                    out << "  " << f * 100 + k << " " << -k;
+                    if (k % 4 == 3)
+                        out << "\n";
+                }
+            }
+        }
+        DataArray da = DataArrayIO::Load("touchstone", "test_da_wrapped.s4p");
+        std::remove("test_da_wrapped.s4p");
+
+        const DataSeries& s = da.data();
+        ASSERT_EQ(s.size(), 2u);
+        EXPECT_EQ(s.data_shape()[0], 4);
+        EXPECT_DOUBLE_EQ(da.datas().find("freq")->second.scalar_at<double>(1), 2e6);
+
+        // 3+ port rows are row-major: pair k holds S[k / 4 + 1, k % 4 + 1].
+        const auto& mat1 = s.matrix_at<std::complex<double>>(1);
+        EXPECT_EQ(mat1(2, 1), std::complex<double>(209.0, -9.0));
+        EXPECT_EQ(mat1(0, 3), std::complex<double>(203.0, -3.0));
+    }
+
+    TEST(TouchstoneDataArrayIoTest, WriteAndReadS3PKeepsPortOrder)
+    {
+        std::vector<double> freqs = {1.0};
+        std::vector<std::complex<double>> s_flat;
+        for (int k = 0; k < 9; ++k)
+            s_flat.push_back(std::complex<double>(0.1 * (k + 1), 0.0));
+
+        DataArrayCreateInfo info;
+        info.datas["freq"] = DataSeries::CreateScalarFromMemory<double>(freqs.data(), freqs.size());
+        info.datas[DataArray::kSelf] = DataSeries::CreateMatrixFromMemory<std::complex<double>>(
+            3, 3, s_flat.data(), s_flat.size());
+        info.multi_dimension_spec.add_regular(1);
+        info.kind = DataArrayKind::kDependent;
+
+        DataArrayIO::Save(DataArray(info), "touchstone", "test_da_wr_s3p.s3p");
+        DataArray loaded = DataArrayIO::Load("touchstone", "test_da_wr_s3p.s3p");
+        std::remove("test_da_wr_s3p.s3p");
+
+        const auto& mat = loaded.data().matrix_at<std::complex<double>>(0);
+        EXPECT_NEAR(std::abs(mat(0, 1)), 0.2, 1e-6);
+        EXPECT_NEAR(std::abs(mat(1, 0)), 0.4, 1e-6);
+        EXPECT_NEAR(std::abs(mat(2, 1)), 0.8, 1e-6);
+    }
+
+    TEST(TouchstoneDataArrayIoTest, ReadS3PFromOldColumnMajorWriterIsTransposed)
+    {
+        // Earlier versions of the writer emitted 3+ port files column-major
+        // (S11 S21 S31 S12 ...).  Such files are now read by the format's
+        // row-major rule, so every off-diagonal cell comes back transposed.
+        {
+            std::ofstream out("test_da_old_s3p.s3p");
+            out << "# GHz S MA R 50\n";
+            out << "! Touchstone file generated by xdataset\n";
+            out << "! freq S11 S21 S31 S12 S22 S32 S13 S23 S33\n";
+            out << "1";
+            for (int col = 0; col < 3; ++col)
+                for (int row = 0; row < 3; ++row)
+                    out << " " << 0.1 * (row * 3 + col + 1) << " 0";
+            out << "\n";
+        }
+        DataArray da = DataArrayIO::Load("touchstone", "test_da_old_s3p.s3p");
+        std::remove("test_da_old_s3p.s3p");
+
+        // The old file meant S[r, c] = 0.1 * (3r + c + 1); it now reads as S[c, r].
+        const auto& mat = da.data().matrix_at<std::complex<double>>(0);
+        for (int row = 0; row < 3; ++row)
+            for (int col = 0; col < 3; ++col)
+                EXPECT_NEAR(std::abs(mat(row, col)), 0.1 * (col * 3 + row + 1), 1e-6)
+                    << "S" << row + 1 << col + 1;
+        EXPECT_NEAR(std::abs(mat(0, 1)), 0.4, 1e-6);
+        EXPECT_NEAR(std::abs(mat(1, 0)), 0.2, 1e-6);
+    }
+
     TEST(TouchstoneDataArrayIoTest, WriteAndReadS2P)
     {
         DataArray da = make_s2p_data_array();
@@ -258,6 +374,42 @@ namespace xdataset
         EXPECT_EQ(b.dependents().size(), 1u);
     }
 
+    TEST(TouchstoneDatasetReaderTest, ReadDirectoryInParallel)
+    {
+        const std::string dir = "test_ds_snp_dir";
+#ifdef _WIN32
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+        write_test_s2p_ri(dir + "/amp.s2p");
+        write_test_s2p_ma(dir + "/filter.s2p");
+        write_test_s1p_ri(dir + "/load.s1p");
+        std::ofstream(dir + "/notes.txt") << "not a touchstone file\n";
+
+        DatasetIOOptions options;
+        options.threads = 2;
+        Dataset ds = DatasetIO::Load("touchstone", dir, options);
+
+        for (const char* name : {"amp.s2p", "filter.s2p", "load.s1p", "notes.txt"})
+            std::remove((dir + "/" + name).c_str());
+#ifdef _WIN32
+        _rmdir(dir.c_str());
+#else
+        rmdir(dir.c_str());
+#endif
+
+        EXPECT_EQ(ds.name(), dir);
+        EXPECT_EQ(ds.block_count(), 3u);
+        EXPECT_TRUE(ds.IsLeaf("amp/SP"));
+        EXPECT_TRUE(ds.IsLeaf("filter/SP"));
+        EXPECT_EQ(ds.GetBlock("load/SP").dependent_spec("S").data.data_shape()[0], 1);
+
+        const auto& mat0 = ds.GetBlock("filter/SP").dependent_spec("S").data
+                               .matrix_at<std::complex<double>>(0);
+        EXPECT_NEAR(mat0(0, 0).real(), 0.1 * std::cos(45.0 * M_PI / 180.0), 1e-9);
+    }
+
     // ========================================================================
     // Error Handling
     // ========================================================================
@@ -283,6 +435,24 @@ namespace xdataset
         std::remove("test_bad.s2p");
     }
 
+    TEST(TouchstoneDataArrayIoTest, MalformedDataThrows)
+    {
+        {
+            std::ofstream out("test_bad_rows.s1p");
+            out << "# GHz S RI R 50\n";
+            out << "1.0 0.1\n";
+            out << "0.01 2.0 0.15 0.015\n";
+        }
+        EXPECT_THROW(DataArrayIO::Load("touchstone", "test_bad_rows.s1p"), std::runtime_error);
+        {
+            std::ofstream out("test_bad_rows.s1p");
+            out << "# GHz S RI R 50\n";
+            out << "1.0 0.1 0.0x1\n";
+        }
+        EXPECT_THROW(DataArrayIO::Load("touchstone", "test_bad_rows.s1p"), std::runtime_error);
+        std::remove("test_bad_rows.s1p");
+    }
+
     TEST(TouchstoneDataArrayIoTest, UnsupportedFormatThrows)
     {
         DataArray da = make_s2p_data_array();
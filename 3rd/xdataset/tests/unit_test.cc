@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 using xdataset::Unit;
 
 namespace xdataset
@@ -725,4 +729,56 @@ TEST(UnitTest, PredefRejectsScale)
     EXPECT_THROW(Unit::parse("Mmil"), std::invalid_argument);
 }
 
+// =========================================================================
+//  Memoised parse
+// =========================================================================
+
+TEST(UnitTest, RepeatedParseIsStable)
+{
+    const Unit first = Unit::parse("GHz");
+    for (int i = 0; i < 3; ++i)
+    {
+        Unit again = Unit::parse("GHz");
+        EXPECT_TRUE(again == first);
+        EXPECT_DOUBLE_EQ(again.multiplier(), 1e9);
+    }
+
+    // Failures are not remembered as units.
+    EXPECT_THROW(Unit::parse("kin"), std::invalid_argument);
+    EXPECT_THROW(Unit::parse("kin"), std::invalid_argument);
+    EXPECT_THROW(Unit::parse(""), std::invalid_argument);
+}
+
+TEST(UnitTest, ConcurrentParseAgrees)
+{
+    const std::vector<std::string> names = {"MHz", "kOhm", "mV", "ft", "uA", "dBm_unknown"};
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < mismatches.size(); ++t)
+    {
+        threads.emplace_back([&names, &mismatches, t]() {
+            for (int i = 0; i < 500; ++i)
+            {
+                const std::string& name = names[(i + t) % names.size()];
+                try
+                {
+                    if (Unit::parse(name).to_string().empty())
+                        ++mismatches[t];
+                }
+                catch (const std::invalid_argument&)
+                {
+                    if (name != "dBm_unknown")
+                        ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    for (int m : mismatches)
+        EXPECT_EQ(m, 0);
+    EXPECT_DOUBLE_EQ(Unit::parse("kOhm").multiplier(), 1e3);
+}
+
 } // namespace xdataset
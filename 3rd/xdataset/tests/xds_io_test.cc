@@ -0,0 +1,137 @@
+#include "dataset_io.h"
+#include "dataset.h"
+#include "block.h"
+#include "block_fixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace xdataset
+{
+    namespace
+    {
+        using namespace block_fixtures;
+
+        // freq(3) x bias(2), independents deliberately not in name order.
+        BlockCreateInfo make_mixed_info()
+        {
+            DataSeries freq = MakeScalarSeriesFrom({1e9, 2e9, 3e9});
+            freq.set_unit("Hz");
+
+            std::vector<std::complex<double>> s(6 * 4);
+            for (std::size_t i = 0; i < s.size(); ++i)
+                s[i] = std::complex<double>(static_cast<double>(i), -static_cast<double>(i));
+
+            DataSeries vout = MakeScalarSeriesFrom({0.5, 1.5, 2.5, 3.5, 4.5, 5.5});
+            vout.set_unit("V");
+
+            BlockCreateInfo info;
+            info.independent_specs.push_back(
+                IndependentSpec{"freq", freq, DimensionSpec::Regular(3)});
+            info.independent_specs.push_back(
+                IndependentSpec{"bias", MakeIntScalarSeriesFrom({1, 2}), DimensionSpec::Regular(2)});
+            info.dependent_specs.push_back(DependentSpec{"Vout", vout});
+            info.dependent_specs.push_back(
+                DependentSpec{"S", DataSeries::CreateMatrixFromVector<std::complex<double>>(2, 2, s)});
+            info.dependent_specs.push_back(
+                DependentSpec{"tag", MakeStringScalarSeriesFrom({"a", "b", "c", "d", "e", "f"})});
+            info.dependent_specs.push_back(DependentSpec{"vecs", MakeVectorSeries(6, 3)});
+            return info;
+        }
+
+    } // namespace
+
+    TEST(XdsIoTest, RoundtripKeepsSchemaValuesAndOrder)
+    {
+        Dataset ds("xds_ds");
+        ds.AddBlock("sim/SP", make_mixed_info());
+        ds.AddBlock("ragged", MakeRaggedCreateInfo());
+
+        DatasetIO::Save(ds, "xds", "test_roundtrip.xds");
+        Dataset loaded = DatasetIO::Load("xds", "test_roundtrip.xds");
+
+        EXPECT_EQ(loaded.name(), "xds_ds");
+        EXPECT_EQ(loaded.block_count(), 2u);
+
+        const Block& b = loaded.GetBlock("sim/SP");
+        ASSERT_EQ(b.independents().size(), 2u);
+        EXPECT_EQ(b.independents()[0], "freq");
+        EXPECT_EQ(b.independents()[1], "bias");
+
+        const DataSeries& freq = b.independent_spec("freq").data;
+        EXPECT_TRUE(freq.is_borrowed());
+        EXPECT_DOUBLE_EQ(freq.scalar_at<double>(2), 3e9);
+        EXPECT_TRUE(freq.unit().same_dimension(Unit::parse("Hz")));
+        EXPECT_EQ(b.independent_spec("bias").data.scalar_at<int>(1), 2);
+
+        const DataSeries& s = b.dependent_spec("S").data;
+        EXPECT_EQ(s.data_kind(), DataKind::kMatrix);
+        EXPECT_EQ(s.matrix_at<std::complex<double>>(5)(1, 0), std::complex<double>(22.0, -22.0));
+        EXPECT_DOUBLE_EQ(b.dependent_spec("vecs").data.vector_at<double>(1)(2), 6.0);
+        EXPECT_EQ(b.dependent_spec("tag").data.scalar_at<std::string>(4), "e");
+        EXPECT_FALSE(b.dependent_spec("tag").data.is_borrowed());
+
+        const DimensionSpec& y = loaded.GetBlock("ragged").independent_spec("y").dimension;
+        ASSERT_TRUE(y.is_ragged());
+        EXPECT_EQ(y.ragged_sizes()[1], 2u);
+
+        const DataArray& vout = loaded.GetDataArray("sim/SP", "Vout");
+        EXPECT_DOUBLE_EQ(vout.data().scalar_at<double>(5), 5.5);
+    }
+
+    TEST(XdsIoTest, WritesCopyBorrowedColumns)
+    {
+        Dataset ds("cow");
+        ds.AddBlock("b", make_mixed_info());
+        DatasetIO::Save(ds, "xds", "test_cow.xds");
+
+        Dataset loaded = DatasetIO::Load("xds", "test_cow.xds");
+        DataSeries vout = loaded.GetBlock("b").dependent_spec("Vout").data;
+        EXPECT_TRUE(vout.is_borrowed());
+
+        vout.scalar_at<double>(0) = -1.0;
+        EXPECT_FALSE(vout.is_borrowed());
+        EXPECT_DOUBLE_EQ(vout.scalar_at<double>(0), -1.0);
+        EXPECT_DOUBLE_EQ(loaded.GetBlock("b").dependent_spec("Vout").data.scalar_at<double>(0), 0.5);
+
+        // The mapping stays valid after the Dataset that loaded it is gone.
+        DataSeries freq = loaded.GetBlock("b").independent_spec("freq").data;
+        loaded = Dataset("other");
+        EXPECT_DOUBLE_EQ(freq.scalar_at<double>(1), 2e9);
+    }
+
+    TEST(XdsIoTest, SaveOverLoadedFileKeepsData)
+    {
+        Dataset ds("self");
+        ds.AddBlock("b", make_mixed_info());
+        DatasetIO::Save(ds, "xds", "test_self.xds");
+
+        // The loaded columns borrow the mapping of the file being replaced.
+        Dataset loaded = DatasetIO::Load("xds", "test_self.xds");
+        DatasetIO::Save(loaded, "xds", "test_self.xds");
+        EXPECT_DOUBLE_EQ(loaded.GetBlock("b").dependent_spec("Vout").data.scalar_at<double>(5), 5.5);
+
+        Dataset reloaded = DatasetIO::Load("xds", "test_self.xds");
+        const Block& b = reloaded.GetBlock("b");
+        EXPECT_DOUBLE_EQ(b.independent_spec("freq").data.scalar_at<double>(2), 3e9);
+        EXPECT_DOUBLE_EQ(b.dependent_spec("Vout").data.scalar_at<double>(5), 5.5);
+        EXPECT_EQ(b.dependent_spec("S").data.matrix_at<std::complex<double>>(5)(1, 0),
+                  std::complex<double>(22.0, -22.0));
+        EXPECT_EQ(b.dependent_spec("tag").data.scalar_at<std::string>(4), "e");
+    }
+
+    TEST(XdsIoTest, RejectsForeignFile)
+    {
+        {
+            std::ofstream out("test_foreign.xds", std::ios::binary | std::ios::trunc);
+            out << "definitely not an xds file, but long enough for a prefix";
+        }
+        EXPECT_THROW(DatasetIO::Load("xds", "test_foreign.xds"), std::runtime_error);
+        EXPECT_THROW(DatasetIO::Load("xds", "missing.xds"), std::runtime_error);
+    }
+} // namespace xdataset
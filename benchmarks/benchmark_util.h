@@ -0,0 +1,23 @@
+#pragma once
+// 各微基准共用的计时工具。
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+// 运行 iterations 次（fn 收到第几次的序号），返回单次最短耗时（毫秒）
+inline double MeasureMin(size_t iterations, const std::function<void(size_t)> &fn)
+{
+    double best = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn(i);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
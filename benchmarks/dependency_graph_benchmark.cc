@@ -0,0 +1,117 @@
+// 依赖图增删方程的延迟随图规模的变化。
+// 按 EquationManager::AddNodeToGraph 的方式（批量更新内加节点 + 依赖边）
+// 在已有 N 个方程的图上反复添加/删除一个方程，输出单次平均耗时。
+// 增量环检测只搜索拓扑序上受影响的区间，耗时应与 N 基本无关。
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/dependency_graph.h"
+
+using namespace xequation;
+
+namespace
+{
+
+std::string NodeName(size_t index)
+{
+    return "eq_" + std::to_string(index);
+}
+
+void AddEquation(DependencyGraph &graph, const std::string &name, const std::vector<std::string> &dependencies)
+{
+    DependencyGraph::BatchUpdateGuard guard(&graph);
+    graph.AddNode(name);
+    for (const std::string &dep : dependencies)
+    {
+        graph.AddEdge({name, dep});
+    }
+    guard.commit();
+}
+
+void RemoveEquation(DependencyGraph &graph, const std::string &name, const std::vector<std::string> &dependencies)
+{
+    graph.RemoveNode(name);
+    for (const std::string &dep : dependencies)
+    {
+        graph.RemoveEdge({name, dep});
+    }
+}
+
+// 每个方程依赖前面随机 fan_in 个方程
+void BuildGraph(DependencyGraph &graph, size_t node_count, size_t fan_in, std::mt19937 &rng)
+{
+    DependencyGraph::BatchUpdateGuard guard(&graph);
+    for (size_t i = 0; i < node_count; ++i)
+    {
+        graph.AddNode(NodeName(i));
+        for (size_t k = 0; k < fan_in && i > 0; ++k)
+        {
+            graph.AddEdge({NodeName(i), NodeName(rng() % i)});
+        }
+    }
+    guard.commit();
+}
+
+double MeasureAddRemove(DependencyGraph &graph, size_t node_count, size_t iterations, std::mt19937 &rng)
+{
+    std::chrono::steady_clock::duration total{0};
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::string> dependencies = {NodeName(rng() % node_count), NodeName(rng() % node_count)};
+        auto start = std::chrono::steady_clock::now();
+        AddEquation(graph, "new_eq", dependencies);
+        total += std::chrono::steady_clock::now() - start;
+        RemoveEquation(graph, "new_eq", dependencies);
+    }
+    return std::chrono::duration<double, std::micro>(total).count() / iterations;
+}
+
+double MeasureEditEquation(DependencyGraph &graph, size_t node_count, size_t iterations, std::mt19937 &rng)
+{
+    // 修改一个已有方程的依赖（删掉旧边，加一条指向更上游节点的新边），
+    // 被修改的方程有下游依赖者，需要走 Pearce–Kelly 的区间重排
+    std::chrono::steady_clock::duration total{0};
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const size_t index = node_count / 2 + rng() % (node_count / 2);
+        const std::string name = NodeName(index);
+        const std::string dependency = NodeName(rng() % index);
+        const bool existed = graph.IsEdgeExist({name, dependency});
+        auto start = std::chrono::steady_clock::now();
+        {
+            DependencyGraph::BatchUpdateGuard guard(&graph);
+            graph.AddEdge({name, dependency});
+            guard.commit();
+        }
+        total += std::chrono::steady_clock::now() - start;
+        if (!existed)
+        {
+            graph.RemoveEdge({name, dependency});
+        }
+    }
+    return std::chrono::duration<double, std::micro>(total).count() / iterations;
+}
+
+} // namespace
+
+int main()
+{
+    const size_t sizes[] = {1000, 5000, 20000, 50000};
+    const size_t iterations = 20000;
+    std::mt19937 rng(12345);
+
+    std::printf("%10s %18s %18s\n", "nodes", "add equation (us)", "edit equation (us)");
+    for (size_t node_count : sizes)
+    {
+        DependencyGraph graph;
+        BuildGraph(graph, node_count, 3, rng);
+        const double add_us = MeasureAddRemove(graph, node_count, iterations, rng);
+        const double edit_us = MeasureEditEquation(graph, node_count, iterations, rng);
+        std::printf("%10zu %18.2f %18.2f\n", node_count, add_us, edit_us);
+    }
+    return 0;
+}
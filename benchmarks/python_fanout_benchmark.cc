@@ -0,0 +1,90 @@
+// Python 引擎多进程求值的扩展性（PythonEquationEngine::SetWorkerCount）。
+// 一个 numpy 根数组 base（默认 200 万行）扇出 N 个互不依赖的方程（默认 16 个），
+// 每个对 base 做若干逐元素运算并产生同样大小的数组，最后 checksum 汇总。
+// 依次以 0（本地串行）/1/2/4 个工作进程各建一个 EquationManager，
+// 修改 base 触发整图重算，输出最短耗时、相对本地串行的加速比，并校验 checksum 一致。
+// 数组经共享内存往返，这部分开销计入耗时。需要 numpy。
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "benchmark_util.h"
+#include "core/equation_manager.h"
+#include "python/python_equation_engine.h"
+
+using namespace xequation;
+using namespace xequation::python;
+
+namespace
+{
+
+std::string RootStatement(size_t rows, size_t round)
+{
+    return "base = np.linspace(0.0, 1.0, " + std::to_string(rows) + ") + " + std::to_string(round);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000000;
+    size_t fanout = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 16;
+    size_t iterations = argc > 3 ? static_cast<size_t>(std::strtoull(argv[3], nullptr, 10)) : 3;
+
+    python_manager::PyEnvManager::SetDefaultPyEnvConfig();
+    PythonEquationEngine &engine = PythonEquationEngine::GetInstance();
+    pybind11::gil_scoped_acquire acquire;
+
+    const size_t worker_counts[] = {0, 1, 2, 4};
+
+    std::printf("rows = %zu, fanout = %zu, iterations = %zu, hardware threads = %zu\n", rows, fanout, iterations,
+                static_cast<size_t>(std::thread::hardware_concurrency()));
+    std::printf("%8s %12s %10s %8s\n", "workers", "min (ms)", "speedup", "same");
+
+    double serial_ms = 0.0;
+    double serial_checksum = 0.0;
+    for (size_t workers : worker_counts)
+    {
+        if (!engine.SetWorkerCount(workers))
+        {
+            std::printf("%8zu %12s\n", workers, "unavailable");
+            continue;
+        }
+
+        std::unique_ptr<EquationManager> manager = engine.CreateEquationManager();
+        manager->AddEquationGroup("import numpy as np");
+        EquationGroupId root = manager->AddEquationGroup(RootStatement(rows, 0));
+        std::string checksum = "checksum = 0.0";
+        for (size_t i = 0; i < fanout; ++i)
+        {
+            std::string name = "y" + std::to_string(i);
+            std::string k = std::to_string(i + 1);
+            manager->AddEquationGroup(name + " = np.sqrt(np.sin(base * " + k + ") ** 2 + np.cos(base / " + k +
+                                      ") ** 2) * np.exp(-base)");
+            checksum += " + float(" + name + ".sum())";
+        }
+        manager->AddEquationGroup(checksum);
+        manager->Update();
+
+        // 首轮已在 Update 中完成（含进程预热），计时的每一轮都改 base 并整图重算
+        double ms = MeasureMin(iterations, [&](size_t i) {
+            manager->EditEquationGroup(root, RootStatement(rows, i + 1));
+            manager->UpdateEquationGroup(root);
+        });
+        double value = pybind11::cast(manager->context().Get("checksum")).cast<double>();
+
+        if (workers == 0)
+        {
+            serial_ms = ms;
+            serial_checksum = value;
+        }
+        bool same = std::fabs(value - serial_checksum) <= 1e-9 * std::fabs(serial_checksum);
+        std::printf("%8zu %12.2f %10.2f %8s\n", workers, ms, ms > 0.0 ? serial_ms / ms : 0.0, same ? "yes" : "NO");
+    }
+
+    engine.SetWorkerCount(0);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// RelEquationContext 逐行查询的开销随变量数的变化。
+// 方程浏览器 / 变量查看器刷新时对每一行调用 Contains、Get、GetSymbolType、size，
+// 这里在含 N 个变量的上下文上模拟一次完整刷新，输出单行平均耗时。
+// 作为参考，同时给出旧实现（展开 VariableNames 后线性查找）的单行耗时。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rel_engine/rel_equation_context.h"
+#include "rel_engine/rel_equation_engine.h"
+
+using namespace xequation;
+using xequation::rel_engine::RelEquationContext;
+using xequation::rel_engine::RelEquationEngine;
+
+namespace
+{
+
+std::string VariableName(size_t index)
+{
+    return "var_" + std::to_string(index);
+}
+
+// 模拟一次界面刷新：每行查询一次，返回单行平均耗时（微秒）
+double MeasureRefresh(const RelEquationContext &context, size_t variable_count, size_t &sink)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < variable_count; ++i)
+    {
+        const std::string name = VariableName(i);
+        if (context.Contains(name))
+        {
+            sink += context.Get(name).IsNull() ? 0 : 1;
+        }
+        sink += context.GetSymbolType(name).size();
+        sink += context.size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / variable_count;
+}
+
+// 旧实现：每次 Contains 都展开全部变量名再线性查找；只抽样 sample 行
+double MeasureNameListLookup(const RelEquationContext &context, size_t variable_count, size_t sample, size_t &sink)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < sample; ++i)
+    {
+        const std::string name = VariableName((i * 7919) % variable_count);
+        const std::vector<std::string> names = context.env().VariableNames();
+        sink += std::find(names.begin(), names.end(), name) != names.end() ? 1 : 0;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / sample;
+}
+
+} // namespace
+
+int main()
+{
+    const size_t sizes[] = {100, 1000, 10000};
+    size_t sink = 0;
+
+    std::printf("%10s %20s %24s\n", "variables", "refresh row (us)", "name-list lookup (us)");
+    for (size_t variable_count : sizes)
+    {
+        std::unique_ptr<EquationContext> base = RelEquationEngine::GetInstance().CreateContext();
+        RelEquationContext &context = static_cast<RelEquationContext &>(*base);
+        for (size_t i = 0; i < variable_count; ++i)
+        {
+            context.env().Define(VariableName(i), rel::Value::Real(static_cast<double>(i)));
+        }
+
+        const double refresh_us = MeasureRefresh(context, variable_count, sink);
+        const double list_us = MeasureNameListLookup(context, variable_count, 200, sink);
+        std::printf("%10zu %20.3f %24.3f\n", variable_count, refresh_us, list_us);
+    }
+
+    // 防止查询被优化掉
+    std::printf("checksum: %zu\n", sink);
+    return 0;
+}
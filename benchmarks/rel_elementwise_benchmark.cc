@@ -0,0 +1,109 @@
+// REL 逐元素运算内核的吞吐量。
+// 在 N 行复数标量 DataArray 上分别测 OperationAdd / OperationMul 的
+// 数组与数组、数组与标量两种形态，并给出同规模裸循环作为参考下限。
+// 结果中除内核本身外还包含输出 DataArray 的分配（自变量列按写时复制共享，不再深拷贝）。
+// 最后对比表达式 a*b + c*d - e 逐个算子求值与求值器融合求值的耗时。
+
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "data_array.h"
+#include "environment.h"
+#include "operation/operator.h"
+#include "rel.h"
+#include "value.h"
+
+using rel::Value;
+
+namespace
+{
+
+using Complex = std::complex<double>;
+
+Value MakeComplexArray(size_t rows, double seed)
+{
+    std::vector<Complex> values(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        values[i] = Complex(seed + 1e-3 * (i % 1000), seed - 1e-3 * (i % 997));
+    }
+    auto series = xdataset::DataSeries::CreateScalarFromVector<Complex>(values);
+    return Value(xdataset::DataArray::CreateIndependent(std::move(series)));
+}
+
+void PrintRow(const char *name, size_t rows, double ms)
+{
+    double melem_per_s = ms > 0.0 ? rows / (ms * 1e3) : 0.0;
+    std::printf("%-28s %12.2f %14.1f\n", name, ms, melem_per_s);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 10000000;
+    size_t iterations = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 5;
+
+    Value lhs = MakeComplexArray(rows, 1.0);
+    Value rhs = MakeComplexArray(rows, 2.0);
+    Value scalar = Value::Complex(Complex(0.5, -0.25));
+
+    std::vector<Complex> raw_l(rows, Complex(1.0, 2.0));
+    std::vector<Complex> raw_r(rows, Complex(3.0, 4.0));
+    std::vector<Complex> raw_out(rows);
+
+    std::printf("rows = %zu, iterations = %zu\n", rows, iterations);
+    std::printf("%-28s %12s %14s\n", "case", "min (ms)", "Melem/s");
+
+    PrintRow("raw loop add", rows, MeasureMin(iterations, [&](size_t) {
+                 for (size_t i = 0; i < rows; ++i)
+                 {
+                     raw_out[i] = raw_l[i] + raw_r[i];
+                 }
+             }));
+    PrintRow("raw loop mul", rows, MeasureMin(iterations, [&](size_t) {
+                 for (size_t i = 0; i < rows; ++i)
+                 {
+                     raw_out[i] = raw_l[i] * raw_r[i];
+                 }
+             }));
+
+    Value sink;
+    PrintRow("OperationAdd array+array", rows, MeasureMin(iterations, [&](size_t) {
+                 sink = rel::operation::OperationAdd(lhs, rhs);
+             }));
+    PrintRow("OperationMul array*array", rows, MeasureMin(iterations, [&](size_t) {
+                 sink = rel::operation::OperationMul(lhs, rhs);
+             }));
+    PrintRow("OperationAdd array+scalar", rows, MeasureMin(iterations, [&](size_t) {
+                 sink = rel::operation::OperationAdd(lhs, scalar);
+             }));
+    PrintRow("OperationMul scalar*array", rows, MeasureMin(iterations, [&](size_t) {
+                 sink = rel::operation::OperationMul(scalar, rhs);
+             }));
+
+    Value c = MakeComplexArray(rows, 3.0);
+    Value d = MakeComplexArray(rows, 4.0);
+    Value e = MakeComplexArray(rows, 5.0);
+    PrintRow("a*b + c*d - e per operator", rows, MeasureMin(iterations, [&](size_t) {
+                 using namespace rel::operation;
+                 sink = OperationSub(OperationAdd(OperationMul(lhs, rhs), OperationMul(c, d)), e);
+             }));
+
+    rel::Environment env;
+    env.Define("a", lhs);
+    env.Define("b", rhs);
+    env.Define("c", c);
+    env.Define("d", d);
+    env.Define("e", e);
+    PrintRow("a*b + c*d - e fused (Eval)", rows, MeasureMin(iterations, [&](size_t) {
+                 sink = rel::Eval("a*b + c*d - e", &env);
+             }));
+
+    // 防止结果被优化掉
+    std::printf("checksum: %g\n", std::real(raw_out[rows / 2]) + static_cast<double>(sink.rows()));
+    return 0;
+}
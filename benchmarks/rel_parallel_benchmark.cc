@@ -0,0 +1,81 @@
+// REL 大数组逐元素运算的多线程扩展性。
+// 在 N 行实数标量 DataArray 上（默认 5000 万行），分别以 1/2/4/8 个线程
+// 通过 Environment::SetParallelOptions 求值若干表达式，输出最短耗时与相对单线程的加速比。
+// 含两个及以上逐元素算子的表达式（a * b + b 等）走融合求值路径，同样按行区间分给线程池。
+// 并行结果与单线程逐元素相同，这里同时做一次校验。
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "data_array.h"
+#include "environment.h"
+#include "rel.h"
+#include "value.h"
+
+using rel::Value;
+
+namespace
+{
+
+Value MakeRealArray(size_t rows, double seed)
+{
+    std::vector<double> values(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        values[i] = seed + 1e-3 * (i % 1000);
+    }
+    auto series = xdataset::DataSeries::CreateScalarFromVector<double>(values);
+    return Value(xdataset::DataArray::CreateIndependent(std::move(series)));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t rows = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 50000000;
+    size_t iterations = argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 3;
+
+    rel::Environment::InitBuiltinFunctions();
+    rel::Environment env;
+    env.Define("a", MakeRealArray(rows, 1.0));
+    env.Define("b", MakeRealArray(rows, 2.0));
+
+    const char *expressions[] = {"a * b", "a * b + b", "20 * log10(abs(a)) - b", "sin(a)", "sqrt(a) + exp(-b)"};
+    const size_t thread_counts[] = {1, 2, 4, 8};
+
+    std::printf("rows = %zu, iterations = %zu, hardware threads = %zu\n", rows, iterations,
+                static_cast<size_t>(std::thread::hardware_concurrency()));
+    std::printf("%-24s %8s %12s %10s %8s\n", "expression", "threads", "min (ms)", "speedup", "same");
+
+    for (const char *expression : expressions)
+    {
+        double serial_ms = 0.0;
+        std::string serial_text;
+        for (size_t threads : thread_counts)
+        {
+            rel::ParallelOptions options;
+            options.threads = threads;
+            env.SetParallelOptions(options);
+
+            Value result;
+            double ms = MeasureMin(iterations, [&](size_t) { result = rel::Eval(expression, &env); });
+            // 取首、中、尾三个元素比较，避免对整个大数组做字符串化
+            env.Define("r", result);
+            std::string text = rel::Eval("[r[0], r[" + std::to_string(rows / 2) + "], r[" + std::to_string(rows - 1) + "]]",
+                                         &env)
+                                   .to_string();
+            if (threads == 1)
+            {
+                serial_ms = ms;
+                serial_text = text;
+            }
+            std::printf("%-24s %8zu %12.2f %10.2f %8s\n", expression, threads, ms,
+                        ms > 0.0 ? serial_ms / ms : 0.0, text == serial_text ? "yes" : "NO");
+        }
+    }
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include <QVBoxLayout>
 #include <QWidget>
 #include <QSplitter>
+#include <QStandardPaths>
 #include <QMetaObject>
 #include <QtConcurrent/QtConcurrent>
 #include <memory>
@@ -54,6 +55,12 @@ DemoWidget::DemoWidget(QWidget *parent)
     // Python 环境配置/初始化委托给 REL 的 python_manager（引擎构造时幂等初始化）
     python_manager::PyEnvManager::SetDefaultPyEnvConfig();
     equation_manager_ = xequation::python::PythonEquationEngine::GetInstance().CreateEquationManager();
+    QString cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cache_dir.isEmpty() && QDir().mkpath(cache_dir))
+    {
+        xequation::python::PythonEquationEngine::GetInstance().SetParseCacheFile(
+            QDir(cache_dir).filePath("python_parse.cache").toStdString());
+    }
     mock_equation_list_widget_ = new MockEquationGroupListWidget(equation_manager_.get(), this);
     equation_browser_widget_ = new xequation::gui::EquationBrowserWidget(this);
     variable_inspect_widget_ = new xequation::gui::VariableInspectWidget(this);
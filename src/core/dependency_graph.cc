@@ -1,13 +1,14 @@
 #include "dependency_graph.h"
+#include <algorithm>
 #include <iostream>
-#include <queue>
 #include <string>
 #include <fstream>
 #include <tsl/ordered_set.h>
-#include <unordered_set>
 
 using namespace xequation;
 
+constexpr DependencyGraph::NodeId DependencyGraph::kInvalidNodeId;
+
 std::string DependencyCycleException::BuildErrorMessage(const std::vector<std::string> &cycle_path)
 {
     std::string msg = "Dependency cycle detected: ";
@@ -22,39 +23,98 @@ std::string DependencyCycleException::BuildErrorMessage(const std::vector<std::s
     return msg;
 }
 
-const DependencyGraph::Node *DependencyGraph::GetNode(const std::string &node_name) const
+tsl::ordered_set<std::string> DependencyGraph::Node::dependencies() const
 {
-    auto it = node_map_.find(node_name);
-    if (it != node_map_.end())
+    tsl::ordered_set<std::string> names;
+    for (const Node *dependency : dependencies_)
     {
-        return it->second.get();
+        if (dependency->active_)
+        {
+            names.insert(dependency->name_);
+        }
     }
-    return nullptr;
+    return names;
 }
 
-DependencyGraph::EdgeContainer::RangeByFrom DependencyGraph::GetEdgesByFrom(const std::string &from) const
+tsl::ordered_set<std::string> DependencyGraph::Node::dependents() const
 {
-    return edge_container_.get<EdgeContainer::ByFrom>().equal_range(from);
+    tsl::ordered_set<std::string> names;
+    for (const Node *dependent : dependents_)
+    {
+        if (dependent->active_)
+        {
+            names.insert(dependent->name_);
+        }
+    }
+    return names;
 }
 
-DependencyGraph::EdgeContainer::RangeByTo DependencyGraph::GetEdgesByTo(const std::string &to) const
+const DependencyGraph::Node *DependencyGraph::GetNode(const std::string &node_name) const
 {
-    return edge_container_.get<EdgeContainer::ByTo>().equal_range(to);
+    return FindNode(node_name);
+}
+
+std::vector<DependencyGraph::Edge> DependencyGraph::GetEdgesByFrom(const std::string &from) const
+{
+    std::vector<Edge> edges;
+    const Node *node = FindSymbol(from);
+    if (node)
+    {
+        edges.reserve(node->dependencies_.size());
+        for (const Node *dependency : node->dependencies_)
+        {
+            edges.emplace_back(node->name_, dependency->name_);
+        }
+    }
+    return edges;
+}
+
+std::vector<DependencyGraph::Edge> DependencyGraph::GetEdgesByTo(const std::string &to) const
+{
+    std::vector<Edge> edges;
+    const Node *node = FindSymbol(to);
+    if (node)
+    {
+        edges.reserve(node->dependents_.size());
+        for (const Node *dependent : node->dependents_)
+        {
+            edges.emplace_back(dependent->name_, node->name_);
+        }
+    }
+    return edges;
 }
 
-DependencyGraph::EdgeContainer::Range DependencyGraph::GetAllEdges() const
+std::vector<DependencyGraph::Edge> DependencyGraph::GetAllEdges() const
 {
-    return std::make_pair(edge_container_.begin(), edge_container_.end());
+    std::vector<Edge> edges;
+    for (const auto &node : nodes_)
+    {
+        if (!node)
+        {
+            continue;
+        }
+        for (const Node *dependency : node->dependencies_)
+        {
+            edges.emplace_back(node->name_, dependency->name_);
+        }
+    }
+    return edges;
 }
 
 bool DependencyGraph::IsNodeExist(const std::string &node_name) const
 {
-    return node_map_.find(node_name) != node_map_.end();
+    return FindNode(node_name) != nullptr;
 }
 
 bool DependencyGraph::IsEdgeExist(const Edge &edge) const
 {
-    return edge_container_.contains(edge);
+    const Node *from = FindSymbol(edge.from());
+    const Node *to = FindSymbol(edge.to());
+    if (!from || !to)
+    {
+        return false;
+    }
+    return std::find(from->dependencies_.begin(), from->dependencies_.end(), to) != from->dependencies_.end();
 }
 
 bool DependencyGraph::BeginBatchUpdate()
@@ -85,6 +145,7 @@ bool DependencyGraph::EndBatchUpdate()
     if (CheckCycle(cycle_path))
     {
         RollBack();
+        EnsureOrder();
         throw DependencyCycleException(cycle_path);
     }
     else
@@ -94,6 +155,7 @@ bool DependencyGraph::EndBatchUpdate()
             operation_stack_.pop();
         }
     }
+    EnsureOrder();
     return true;
 }
 
@@ -117,6 +179,7 @@ bool DependencyGraph::EndBatchUpdateNoThrow() noexcept
             operation_stack_.pop();
         }
     }
+    EnsureOrder();
     return true;
 }
 
@@ -127,18 +190,42 @@ bool DependencyGraph::AddNode(const std::string &node_name)
         return false;
     }
 
-    node_map_.insert({node_name, std::unique_ptr<Node>(new Node())});
+    const bool order_was_valid = order_valid_;
+    Node *node = InternNode(node_name);
+    node->active_ = true;
+    node->dirty_flag_ = false;
+    ++node_count_;
 
-    auto node_dependency_edges = GetEdgesByFrom(node_name);
-    for (auto it = node_dependency_edges.first; it != node_dependency_edges.second; it++)
+    // 没有已激活依赖的节点放在序首，否则放在序尾：
+    // 前者对其依赖者天然成立，后者对其依赖天然成立，常见情况下无需调整已有节点
+    if (HasActive(node->dependencies_))
+    {
+        order_.push_back(node->id_);
+        node->rank_ = order_base_ + static_cast<int64_t>(order_.size()) - 1;
+    }
+    else
     {
-        ActiveEdge(*it);
+        order_.push_front(node->id_);
+        node->rank_ = --order_base_;
     }
 
-    auto node_dependent_edges = GetEdgesByTo(node_name);
-    for (auto it = node_dependent_edges.first; it != node_dependent_edges.second; it++)
+    // 信号回调可能读取图，先拷贝邻接表再逐条激活
+    const std::vector<Node *> dependencies = node->dependencies_;
+    for (Node *dependency : dependencies)
     {
-        ActiveEdge(*it);
+        if (dependency->active_)
+        {
+            ActiveEdge(node, dependency);
+        }
+    }
+
+    const std::vector<Node *> dependents = node->dependents_;
+    for (Node *dependent : dependents)
+    {
+        if (dependent->active_)
+        {
+            ActiveEdge(dependent, node);
+        }
     }
 
     if (batch_update_in_progress_ == true)
@@ -147,10 +234,14 @@ bool DependencyGraph::AddNode(const std::string &node_name)
         return true;
     }
 
-    std::vector<std::string> cycle_path;
-    if (CheckCycle(cycle_path))
+    // 激活边时已做增量检测（只搜索拓扑序上受影响的区间），无需全图 DFS
+    if (order_was_valid && !order_valid_)
     {
+        std::vector<std::string> cycle_path;
+        cycle_path.swap(cycle_path_);
         RemoveNode(node_name);
+        // 成环的边都连着该节点，节点移除后原有拓扑序依然有效
+        order_valid_ = true;
         throw DependencyCycleException(cycle_path);
     }
     return true;
@@ -158,23 +249,33 @@ bool DependencyGraph::AddNode(const std::string &node_name)
 
 bool DependencyGraph::RemoveNode(const std::string &node_name) noexcept
 {
-    if (IsNodeExist(node_name) == false)
+    Node *node = FindNode(node_name);
+    if (!node)
     {
         return false;
     }
 
-    node_map_.erase(node_name);
+    // 边仍保留在邻接表中，节点重新加入时自动恢复；删边不会破坏已有拓扑序
+    node->active_ = false;
+    --node_count_;
+    RemoveFromOrder(node);
 
-    auto node_dependency_edges = GetEdgesByFrom(node_name);
-    for (auto it = node_dependency_edges.first; it != node_dependency_edges.second; it++)
+    const std::vector<Node *> dependencies = node->dependencies_;
+    for (Node *dependency : dependencies)
     {
-        DeactiveEdge(*it);
+        if (dependency->active_)
+        {
+            node_dependent_changed_signal_(dependency->name_);
+        }
     }
 
-    auto node_dependent_edges = GetEdgesByTo(node_name);
-    for (auto it = node_dependent_edges.first; it != node_dependent_edges.second; it++)
+    const std::vector<Node *> dependents = node->dependents_;
+    for (Node *dependent : dependents)
     {
-        DeactiveEdge(*it);
+        if (dependent->active_)
+        {
+            node_dependency_changed_signal_(dependent->name_);
+        }
     }
 
     if (batch_update_in_progress_ == true)
@@ -182,19 +283,27 @@ bool DependencyGraph::RemoveNode(const std::string &node_name) noexcept
         operation_stack_.push(Operation(Operation::Type::kRemoveNode, node_name));
     }
 
+    ReleaseIfUnused(node);
     return true;
 }
 
 bool DependencyGraph::AddEdge(const Edge &edge)
 {
-    if (edge_container_.contains(edge) == true)
+    if (IsEdgeExist(edge) == true)
     {
         return false;
     }
 
-    edge_container_.insert(edge);
+    const bool order_was_valid = order_valid_;
+    Node *from = InternNode(edge.from());
+    Node *to = InternNode(edge.to());
+    from->dependencies_.push_back(to);
+    to->dependents_.push_back(from);
 
-    ActiveEdge(edge);
+    if (from->active_ && to->active_)
+    {
+        ActiveEdge(from, to);
+    }
 
     if (batch_update_in_progress_ == true)
     {
@@ -202,10 +311,13 @@ bool DependencyGraph::AddEdge(const Edge &edge)
         return true;
     }
 
-    std::vector<std::string> cycle_path;
-    if (CheckCycle(cycle_path))
+    if (order_was_valid && !order_valid_)
     {
+        std::vector<std::string> cycle_path;
+        cycle_path.swap(cycle_path_);
         RemoveEdge(edge);
+        // 成环时 ReorderForEdge 未改动拓扑序，撤销该边后原序依然有效
+        order_valid_ = true;
         throw DependencyCycleException(cycle_path);
     }
     return true;
@@ -213,16 +325,33 @@ bool DependencyGraph::AddEdge(const Edge &edge)
 
 bool DependencyGraph::RemoveEdge(const Edge &edge) noexcept
 {
-    if (edge_container_.contains(edge) == false)
+    Node *from = FindSymbol(edge.from());
+    Node *to = FindSymbol(edge.to());
+    if (!from || !to || !EraseNode(from->dependencies_, to))
     {
         return false;
     }
-    edge_container_.erase(edge);
-    DeactiveEdge(edge);
+    EraseNode(to->dependents_, from);
+
+    // 删边不会破坏已有拓扑序，无需调整 rank
+    if (from->active_)
+    {
+        node_dependency_changed_signal_(from->name_);
+    }
+    if (to->active_)
+    {
+        node_dependent_changed_signal_(to->name_);
+    }
     if (batch_update_in_progress_ == true)
     {
         operation_stack_.push(Operation(Operation::Type::kRemoveEdge, edge));
     }
+
+    ReleaseIfUnused(from);
+    if (to != from)
+    {
+        ReleaseIfUnused(to);
+    }
     return true;
 }
 
@@ -277,322 +406,723 @@ std::vector<std::string> DependencyGraph::TopologicalSort(const std::vector<std:
         return {};
     }
 
-    // Kahn's Algorithm for specific nodes and their dependencies
-    std::unordered_map<std::string, int> in_degree;
-    std::queue<std::string> zero_in_degree_queue;
-    std::vector<std::string> topo_order;
-
-    std::unordered_set<std::string> relevant_nodes;
-    std::queue<std::string> node_queue;
-    
-    for (const auto &node : nodes)
+    std::vector<NodeId> seeds;
+    seeds.reserve(nodes.size());
+    for (const auto &node_name : nodes)
     {
-        if (node_map_.find(node) == node_map_.end())
+        const Node *node = FindNode(node_name);
+        if (node)
         {
-            continue;
+            seeds.push_back(node->id_);
         }
-        node_queue.push(node);
-        relevant_nodes.insert(node);
     }
 
-    while (!node_queue.empty())
+    return SortByRank(CollectDependents(seeds));
+}
+
+std::vector<std::string> DependencyGraph::TopologicalSort(const std::string &node) const
+{
+    const Node *start = FindNode(node);
+    if (!start)
     {
-        auto current_node = node_queue.front();
-        node_queue.pop();
+        return {};
+    }
+
+    return SortByRank(CollectDependents({start->id_}));
+}
 
-        for (const auto &dep : node_map_.at(current_node)->dependents_)
+std::vector<std::string> DependencyGraph::TopologicalSort() const
+{
+    std::vector<std::string> topo_order;
+    topo_order.reserve(node_count_);
+
+    if (order_valid_)
+    {
+        for (NodeId id : order_)
         {
-            if (relevant_nodes.find(dep) == relevant_nodes.end())
+            if (id != kInvalidNodeId)
             {
-                relevant_nodes.insert(dep);
-                node_queue.push(dep);
+                topo_order.push_back(nodes_[id]->name_);
             }
         }
+        return topo_order;
     }
 
-    for (const auto &node_name : relevant_nodes)
+    // 批量更新中途（可能暂时成环）：退化为 Kahn，只输出无环部分
+    std::vector<NodeId> ids;
+    ids.reserve(node_count_);
+    for (NodeId id : order_)
     {
-        int count = 0;
-        for (const auto &dep : node_map_.at(node_name)->dependencies_)
+        if (id != kInvalidNodeId)
         {
-            if (relevant_nodes.find(dep) != relevant_nodes.end())
-            {
-                count++;
-            }
+            ids.push_back(id);
         }
-        in_degree[node_name] = count;
+    }
+    for (NodeId id : KahnOrder(ids, true))
+    {
+        topo_order.push_back(nodes_[id]->name_);
+    }
+    return topo_order;
+}
 
-        if (in_degree[node_name] == 0)
+DependencyGraph::Schedule DependencyGraph::BuildSchedule(const std::vector<std::string> &topo_order) const
+{
+    Schedule schedule;
+    schedule.nodes.reserve(topo_order.size());
+    schedule.dependent_offsets.reserve(topo_order.size() + 1);
+    schedule.in_degree.assign(topo_order.size(), 0);
+
+    // id -> 快照下标；不在快照中的节点为 UINT32_MAX
+    std::vector<uint32_t> index_of(nodes_.size(), UINT32_MAX);
+    std::vector<const Node *> members;
+    members.reserve(topo_order.size());
+    for (const std::string &name : topo_order)
+    {
+        const Node *node = FindNode(name);
+        if (!node || index_of[node->id_] != UINT32_MAX)
         {
-            zero_in_degree_queue.push(node_name);
+            continue;
         }
+        index_of[node->id_] = static_cast<uint32_t>(schedule.nodes.size());
+        schedule.nodes.push_back(name);
+        members.push_back(node);
     }
+    schedule.in_degree.resize(schedule.nodes.size());
 
-    while (!zero_in_degree_queue.empty())
+    for (const Node *node : members)
     {
-        auto node_name = zero_in_degree_queue.front();
-        zero_in_degree_queue.pop();
-        topo_order.push_back(node_name);
-
-        for (const auto &dependent : node_map_.at(node_name)->dependents_)
+        schedule.dependent_offsets.push_back(static_cast<uint32_t>(schedule.dependents.size()));
+        for (const Node *dependent : node->dependents_)
         {
-            if (relevant_nodes.find(dependent) != relevant_nodes.end())
+            uint32_t index = index_of[dependent->id_];
+            if (index != UINT32_MAX)
             {
-                if (--in_degree[dependent] == 0)
-                {
-                    zero_in_degree_queue.push(dependent);
-                }
+                schedule.dependents.push_back(index);
+                schedule.in_degree[index]++;
             }
         }
     }
+    schedule.dependent_offsets.push_back(static_cast<uint32_t>(schedule.dependents.size()));
+    return schedule;
+}
 
-    if (topo_order.size() != relevant_nodes.size())
-    {
-        return {};
-    }
-
-    return topo_order;
+void DependencyGraph::InvalidateNode(const std::string &node_name)
+{
+    MakeNodeDirty(node_name, true, true);
 }
 
-std::vector<std::string> DependencyGraph::TopologicalSort(const std::string &node) const
+void DependencyGraph::MakeNodeDirty(const std::string &node_name, bool dirty, bool make_dependent)
 {
-    if (node_map_.find(node) == node_map_.end())
+    Node *start = FindNode(node_name);
+    if (!start)
     {
-        return {};
+        return;
     }
-
-    // Kahn's Algorithm for specific node and its dependencies
-    std::unordered_map<std::string, int> in_degree;
-    std::queue<std::string> zero_in_degree_queue;
-    std::vector<std::string> topo_order;
-
-    std::unordered_set<std::string> relevant_nodes;
-    std::queue<std::string> node_queue;
-    node_queue.push(node);
-    relevant_nodes.insert(node);
-
-    while (!node_queue.empty())
+    start->set_dirty_flag(dirty);
+    if (!make_dependent)
     {
-        auto current_node = node_queue.front();
-        node_queue.pop();
+        return;
+    }
 
-        for (const auto &dep : node_map_.at(current_node)->dependents_)
+    const uint32_t epoch = NextVisitEpoch();
+    std::vector<Node *> stack(1, start);
+    visit_mark_[start->id_] = epoch;
+    while (!stack.empty())
+    {
+        const Node *node = stack.back();
+        stack.pop_back();
+        for (Node *dependent : node->dependents_)
         {
-            if (relevant_nodes.find(dep) == relevant_nodes.end())
+            if (dependent->active_ && visit_mark_[dependent->id_] != epoch)
             {
-                relevant_nodes.insert(dep);
-                node_queue.push(dep);
+                visit_mark_[dependent->id_] = epoch;
+                dependent->set_dirty_flag(dirty);
+                stack.push_back(dependent);
             }
         }
     }
+}
 
-    for (const auto &node_name : relevant_nodes)
+void DependencyGraph::Traversal(std::function<void(const std::string &)> callback) const
+{
+    // 先拷贝名字快照，回调中即使修改了图（删除节点、id 被复用）也不会使遍历失效
+    for (const auto &node_name : TopologicalSort())
     {
-        int count = 0;
-        for (const auto &dep : node_map_.at(node_name)->dependencies_)
+        callback(node_name);
+    }
+}
+
+void DependencyGraph::Reset()
+{
+    node_ids_.clear();
+    nodes_.clear();
+    free_ids_.clear();
+    node_count_ = 0;
+    order_.clear();
+    order_base_ = 0;
+    order_holes_ = 0;
+    order_valid_ = true;
+    reorder_mark_.clear();
+    reorder_parent_.clear();
+    visit_mark_.clear();
+    visit_epoch_ = 0;
+    cycle_path_.clear();
+    while (!operation_stack_.empty())
+    {
+        operation_stack_.pop();
+    }
+    batch_update_in_progress_ = false;
+}
+
+void DependencyGraph::ActiveEdge(Node *from, Node *to)
+{
+    std::vector<NodeId> cycle;
+    if (order_valid_ && !ReorderForEdge(to->id_, from->id_, cycle))
+    {
+        order_valid_ = false;
+        cycle_path_.clear();
+        for (NodeId id : cycle)
         {
-            if (relevant_nodes.find(dep) != relevant_nodes.end())
-            {
-                count++;
-            }
+            cycle_path_.push_back(nodes_[id]->name_);
         }
-        in_degree[node_name] = count;
+    }
+    node_dependency_changed_signal_(from->name_);
+    node_dependent_changed_signal_(to->name_);
+}
 
-        if (in_degree[node_name] == 0)
+bool DependencyGraph::CheckCycle(std::vector<std::string> &cycle_path)
+{
+    // 每条边激活时都做过增量检测：拓扑序仍有效即无环；
+    // 否则（批量更新中出现过环）重建拓扑序，成功说明环已被后续操作消除
+    if (order_valid_ || RebuildOrder())
+    {
+        return false;
+    }
+
+    // Kahn 排不出的剩余节点（环及其下游）中必然有环，只在这部分上 DFS 求路径
+    std::vector<NodeId> ids;
+    ids.reserve(node_count_);
+    for (NodeId id : order_)
+    {
+        if (id != kInvalidNodeId)
         {
-            zero_in_degree_queue.push(node_name);
+            ids.push_back(id);
         }
     }
 
-    while (!zero_in_degree_queue.empty())
+    std::vector<int> visited(nodes_.size(), 2); // 0: unvisited, 1: visiting, 2: visited
+    for (NodeId id : ids)
+    {
+        visited[id] = 0;
+    }
+    for (NodeId id : KahnOrder(ids, true))
     {
-        auto node_name = zero_in_degree_queue.front();
-        zero_in_degree_queue.pop();
-        topo_order.push_back(node_name);
+        visited[id] = 2;
+    }
+
+    std::stack<std::pair<NodeId, size_t>> stack;
+    std::vector<NodeId> path_predecessor(nodes_.size(), kInvalidNodeId);
 
-        for (const auto &dependent : node_map_.at(node_name)->dependents_)
+    for (NodeId start_node = 0; start_node < nodes_.size(); ++start_node)
+    {
+        if (!nodes_[start_node] || visited[start_node] != 0)
         {
-            if (relevant_nodes.find(dependent) != relevant_nodes.end())
+            continue;
+        }
+
+        stack.push(std::make_pair(start_node, size_t(0)));
+        visited[start_node] = 1;
+
+        while (!stack.empty())
+        {
+            const NodeId current_node = stack.top().first;
+            size_t &current_index = stack.top().second;
+            const std::vector<Node *> &dependencies = nodes_[current_node]->dependencies_;
+
+            if (current_index < dependencies.size())
             {
-                if (--in_degree[dependent] == 0)
+                // 未加入图的端点在 visited 中为 2，自然被跳过
+                const NodeId next_neighbor = dependencies[current_index]->id_;
+                ++current_index;
+
+                if (visited[next_neighbor] == 0)
                 {
-                    zero_in_degree_queue.push(dependent);
+                    visited[next_neighbor] = 1;
+                    stack.push(std::make_pair(next_neighbor, size_t(0)));
+                    path_predecessor[next_neighbor] = current_node;
                 }
+                else if (visited[next_neighbor] == 1)
+                {
+                    cycle_path.clear();
+                    cycle_path.push_back(nodes_[next_neighbor]->name_);
+                    NodeId temp = current_node;
+                    while (temp != next_neighbor)
+                    {
+                        cycle_path.push_back(nodes_[temp]->name_);
+                        temp = path_predecessor[temp];
+                    }
+                    cycle_path.push_back(nodes_[next_neighbor]->name_);
+                    std::reverse(cycle_path.begin(), cycle_path.end());
+                    return true;
+                }
+            }
+            else
+            {
+                visited[current_node] = 2;
+                stack.pop();
             }
         }
     }
+    return false;
+}
+
+DependencyGraph::Node *DependencyGraph::FindNode(const std::string &node_name) const
+{
+    Node *node = FindSymbol(node_name);
+    return node && node->active_ ? node : nullptr;
+}
 
-    if (topo_order.size() != relevant_nodes.size())
+DependencyGraph::Node *DependencyGraph::FindSymbol(const std::string &node_name) const
+{
+    auto it = node_ids_.find(node_name);
+    if (it != node_ids_.end())
     {
-        return {};
+        return nodes_[it->second].get();
     }
+    return nullptr;
+}
 
-    return topo_order;
+DependencyGraph::Node *DependencyGraph::InternNode(const std::string &node_name)
+{
+    Node *existing = FindSymbol(node_name);
+    if (existing)
+    {
+        return existing;
+    }
+
+    NodeId id;
+    if (!free_ids_.empty())
+    {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    }
+    else
+    {
+        id = static_cast<NodeId>(nodes_.size());
+        nodes_.emplace_back();
+        reorder_mark_.push_back(0);
+        reorder_parent_.push_back(kInvalidNodeId);
+        visit_mark_.push_back(0);
+    }
+
+    std::unique_ptr<Node> node(new Node());
+    node->name_ = node_name;
+    node->id_ = id;
+    nodes_[id] = std::move(node);
+    node_ids_.insert({node_name, id});
+    return nodes_[id].get();
 }
 
-std::vector<std::string> DependencyGraph::TopologicalSort() const
+void DependencyGraph::ReleaseIfUnused(Node *node)
 {
-    // Kahn's Algorithm
-    std::unordered_map<std::string, int> in_degree;
-    std::queue<std::string> zero_in_degree_queue;
-    std::vector<std::string> topo_order;
+    if (node->active_ || !node->dependencies_.empty() || !node->dependents_.empty())
+    {
+        return;
+    }
+
+    const NodeId id = node->id_;
+    node_ids_.erase(node->name_);
+    nodes_[id].reset();
+    free_ids_.push_back(id);
+}
+
+void DependencyGraph::RemoveFromOrder(Node *node)
+{
+    order_[node->rank_ - order_base_] = kInvalidNodeId;
+    ++order_holes_;
+    TrimOrder();
+}
 
-    for (const auto &entry : node_map_)
+bool DependencyGraph::HasActive(const std::vector<Node *> &nodes)
+{
+    for (const Node *node : nodes)
     {
-        in_degree[entry.first] = entry.second->dependencies_.size();
-        if (in_degree[entry.first] == 0)
+        if (node->active_)
         {
-            zero_in_degree_queue.push(entry.first);
+            return true;
         }
     }
+    return false;
+}
 
-    while (!zero_in_degree_queue.empty())
+bool DependencyGraph::EraseNode(std::vector<Node *> &nodes, const Node *node)
+{
+    auto it = std::find(nodes.begin(), nodes.end(), node);
+    if (it == nodes.end())
     {
-        auto node_name = zero_in_degree_queue.front();
-        zero_in_degree_queue.pop();
-        topo_order.push_back(node_name);
+        return false;
+    }
+    // 保持插入顺序，dependencies()/dependents() 按此顺序输出
+    nodes.erase(it);
+    return true;
+}
 
-        for (const auto &dependent : node_map_.at(node_name)->dependents_)
-        {
-            if (--in_degree[dependent] == 0)
-            {
-                zero_in_degree_queue.push(dependent);
-            }
-        }
+uint32_t DependencyGraph::NextVisitEpoch()
+{
+    if (++visit_epoch_ == 0)
+    {
+        std::fill(visit_mark_.begin(), visit_mark_.end(), 0);
+        visit_epoch_ = 1;
     }
+    return visit_epoch_;
+}
 
-    return topo_order;
+DependencyGraph::Node *DependencyGraph::NodeAtRank(int64_t rank) const
+{
+    const NodeId id = order_[rank - order_base_];
+    return id == kInvalidNodeId ? nullptr : nodes_[id].get();
 }
 
-void DependencyGraph::InvalidateNode(const std::string &node_name)
+void DependencyGraph::PlaceNodeAtRank(Node *node, int64_t rank)
 {
-    MakeNodeDirty(node_name, true, true);
+    node->rank_ = rank;
+    order_[rank - order_base_] = node->id_;
 }
 
-void DependencyGraph::MakeNodeDirty(const std::string &node_name, bool dirty, bool make_dependent)
+void DependencyGraph::MoveNodeToEnd(Node *node, bool front)
 {
-    if(node_map_.count(node_name) == 0)
+    order_[node->rank_ - order_base_] = kInvalidNodeId;
+    ++order_holes_;
+    if (front)
     {
-        return;
+        order_.push_front(node->id_);
+        node->rank_ = --order_base_;
     }
-    auto node = node_map_.at(node_name).get();
-    node->set_dirty_flag(dirty);
-    if (make_dependent)
+    else
+    {
+        order_.push_back(node->id_);
+        node->rank_ = order_base_ + static_cast<int64_t>(order_.size()) - 1;
+    }
+    TrimOrder();
+}
+
+void DependencyGraph::TrimOrder()
+{
+    while (!order_.empty() && order_.front() == kInvalidNodeId)
+    {
+        order_.pop_front();
+        ++order_base_;
+        --order_holes_;
+    }
+    while (!order_.empty() && order_.back() == kInvalidNodeId)
+    {
+        order_.pop_back();
+        --order_holes_;
+    }
+
+    if (order_holes_ > 64 && order_holes_ * 2 > order_.size())
     {
-        for (const auto &dependent : node->dependents_)
+        CompactOrder();
+    }
+}
+
+// Pearce–Kelly：加入 dependency -> dependent 后若 rank 倒置，只重排受影响区间
+// [rank(dependent), rank(dependency)] 内可达的节点。成环时返回 false 且不改动拓扑序。
+bool DependencyGraph::ReorderForEdge(NodeId dependency, NodeId dependent, std::vector<NodeId> &cycle)
+{
+    Node *upper = nodes_[dependency].get();
+    Node *lower = nodes_[dependent].get();
+    if (upper->rank_ < lower->rank_)
+    {
+        return true;
+    }
+    if (upper == lower)
+    {
+        cycle.assign(2, dependent);
+        return false;
+    }
+
+    // 常见情况：新方程还没有依赖者，挪到序尾即可；依赖还没有依赖项，挪到序首即可
+    if (!HasActive(lower->dependents_))
+    {
+        MoveNodeToEnd(lower, false);
+        return true;
+    }
+    if (!HasActive(upper->dependencies_))
+    {
+        MoveNodeToEnd(upper, true);
+        return true;
+    }
+
+    const int64_t lower_bound = lower->rank_;
+    const int64_t upper_bound = upper->rank_;
+    std::vector<NodeId> forward;
+    std::vector<NodeId> backward;
+    std::vector<NodeId> stack;
+
+    auto clear_marks = [&]() {
+        for (NodeId id : forward)
+            reorder_mark_[id] = 0;
+        for (NodeId id : backward)
+            reorder_mark_[id] = 0;
+        for (NodeId id : stack)
+            reorder_mark_[id] = 0;
+    };
+
+    // 正向：dependent 的下游中 rank < upper_bound 的部分；碰到 dependency 即成环
+    stack.push_back(dependent);
+    reorder_mark_[dependent] = 1;
+    while (!stack.empty())
+    {
+        const NodeId current = stack.back();
+        stack.pop_back();
+        forward.push_back(current);
+        for (const Node *next_node : nodes_[current]->dependents_)
         {
-            MakeNodeDirty(dependent, dirty, make_dependent);
+            if (!next_node->active_)
+            {
+                continue;
+            }
+            const NodeId next = next_node->id_;
+            const int64_t rank = next_node->rank_;
+            if (rank == upper_bound)
+            {
+                // 环（依赖方向）：dependent -> dependency -> current -> ... -> dependent
+                cycle.clear();
+                cycle.push_back(dependent);
+                cycle.push_back(dependency);
+                for (NodeId id = current; id != dependent; id = reorder_parent_[id])
+                {
+                    cycle.push_back(id);
+                }
+                cycle.push_back(dependent);
+                clear_marks();
+                return false;
+            }
+            if (!reorder_mark_[next] && rank < upper_bound)
+            {
+                reorder_mark_[next] = 1;
+                reorder_parent_[next] = current;
+                stack.push_back(next);
+            }
         }
     }
+
+    // 反向：dependency 的上游中 rank > lower_bound 的部分
+    stack.push_back(dependency);
+    reorder_mark_[dependency] = 2;
+    while (!stack.empty())
+    {
+        const NodeId current = stack.back();
+        stack.pop_back();
+        backward.push_back(current);
+        for (const Node *prev_node : nodes_[current]->dependencies_)
+        {
+            const NodeId prev = prev_node->id_;
+            if (prev_node->active_ && !reorder_mark_[prev] && prev_node->rank_ > lower_bound)
+            {
+                reorder_mark_[prev] = 2;
+                stack.push_back(prev);
+            }
+        }
+    }
+    clear_marks();
+
+    auto by_rank = [this](NodeId lhs, NodeId rhs) { return nodes_[lhs]->rank_ < nodes_[rhs]->rank_; };
+    std::sort(forward.begin(), forward.end(), by_rank);
+    std::sort(backward.begin(), backward.end(), by_rank);
+
+    // 复用两组节点原有的 rank 槽位：上游整体排在下游之前
+    std::vector<int64_t> ranks;
+    ranks.reserve(forward.size() + backward.size());
+    for (NodeId id : backward)
+        ranks.push_back(nodes_[id]->rank_);
+    for (NodeId id : forward)
+        ranks.push_back(nodes_[id]->rank_);
+    std::sort(ranks.begin(), ranks.end());
+
+    size_t slot = 0;
+    for (NodeId id : backward)
+        PlaceNodeAtRank(nodes_[id].get(), ranks[slot++]);
+    for (NodeId id : forward)
+        PlaceNodeAtRank(nodes_[id].get(), ranks[slot++]);
+    return true;
 }
 
-void DependencyGraph::Traversal(std::function<void(const std::string &)> callback) const
+bool DependencyGraph::RebuildOrder()
 {
-    auto topo_order = TopologicalSort();
+    std::vector<NodeId> ids;
+    ids.reserve(node_count_);
+    for (NodeId id : order_)
+    {
+        if (id != kInvalidNodeId)
+        {
+            ids.push_back(id);
+        }
+    }
 
-    for (const auto &node_name : topo_order)
+    std::vector<NodeId> sorted = KahnOrder(ids, false);
+    if (sorted.size() != ids.size())
     {
-        callback(node_name);
+        return false;
     }
+
+    order_.assign(sorted.begin(), sorted.end());
+    order_base_ = 0;
+    order_holes_ = 0;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        nodes_[sorted[i]]->rank_ = static_cast<int64_t>(i);
+    }
+    order_valid_ = true;
+    return true;
 }
 
-void DependencyGraph::Reset()
+void DependencyGraph::CompactOrder()
 {
-    node_map_.clear();
-    edge_container_.clear();
-    while (!operation_stack_.empty())
+    std::deque<NodeId> compacted;
+    for (NodeId id : order_)
     {
-        operation_stack_.pop();
+        if (id != kInvalidNodeId)
+        {
+            nodes_[id]->rank_ = static_cast<int64_t>(compacted.size());
+            compacted.push_back(id);
+        }
     }
-    batch_update_in_progress_ = false;
+    order_.swap(compacted);
+    order_base_ = 0;
+    order_holes_ = 0;
 }
 
-void DependencyGraph::ActiveEdge(const DependencyGraph::Edge &edge)
+void DependencyGraph::EnsureOrder()
 {
-    if (node_map_.count(edge.from()) && node_map_.count(edge.to()))
+    if (!order_valid_)
     {
-        node_map_[edge.from()]->dependencies_.insert(edge.to());
-        node_map_[edge.to()]->dependents_.insert(edge.from());
-        node_dependency_changed_signal_(edge.from());
-        node_dependent_changed_signal_(edge.to());
+        RebuildOrder();
     }
 }
 
-void DependencyGraph::DeactiveEdge(const DependencyGraph::Edge &edge)
+std::vector<std::string> DependencyGraph::SortByRank(const std::vector<NodeId> &ids) const
 {
-    if (node_map_.count(edge.from()))
+    std::vector<std::string> topo_order;
+    if (ids.empty())
+    {
+        return topo_order;
+    }
+    topo_order.reserve(ids.size());
+
+    if (!order_valid_)
+    {
+        std::vector<NodeId> sorted = KahnOrder(ids, false);
+        for (NodeId id : sorted)
+        {
+            topo_order.push_back(nodes_[id]->name_);
+        }
+        return topo_order;
+    }
+
+    // 子图占比大时直接扫全序，否则按 rank 排序
+    if (ids.size() * 16 >= order_.size())
     {
-        node_map_[edge.from()]->dependencies_.erase(edge.to());
-        node_dependency_changed_signal_(edge.from());
+        std::vector<char> selected(nodes_.size(), 0);
+        for (NodeId id : ids)
+        {
+            selected[id] = 1;
+        }
+        for (NodeId id : order_)
+        {
+            if (id != kInvalidNodeId && selected[id])
+            {
+                topo_order.push_back(nodes_[id]->name_);
+            }
+        }
+        return topo_order;
     }
-    if (node_map_.count(edge.to()))
+
+    std::vector<NodeId> sorted(ids);
+    std::sort(sorted.begin(), sorted.end(), [this](NodeId lhs, NodeId rhs) {
+        return nodes_[lhs]->rank_ < nodes_[rhs]->rank_;
+    });
+    for (NodeId id : sorted)
     {
-        node_map_[edge.to()]->dependents_.erase(edge.from());
-        node_dependent_changed_signal_(edge.to());
+        topo_order.push_back(nodes_[id]->name_);
     }
+    return topo_order;
 }
 
-bool DependencyGraph::CheckCycle(std::vector<std::string> &cycle_path) const
+std::vector<DependencyGraph::NodeId> DependencyGraph::KahnOrder(const std::vector<NodeId> &ids, bool allow_partial) const
 {
-    std::unordered_map<std::string, int> visited; // 0: unvisited, 1: visiting, 2: visited
-    std::stack<std::pair<std::string, tsl::ordered_set<std::string>::iterator>>
-        stack;
-    std::unordered_map<std::string, std::string> path_predecessor;
-
-    for (const auto &entry : node_map_)
+    // in_degree 为 -1 表示不在子图中
+    std::vector<int> in_degree(nodes_.size(), -1);
+    for (NodeId id : ids)
+    {
+        in_degree[id] = 0;
+    }
+    for (NodeId id : ids)
     {
-        visited[entry.first] = 0;
+        // 未加入图的端点 in_degree 为 -1，不计入
+        for (const Node *dependency : nodes_[id]->dependencies_)
+        {
+            if (in_degree[dependency->id_] >= 0)
+            {
+                ++in_degree[id];
+            }
+        }
     }
 
-    for (const auto &entry : node_map_)
+    std::vector<NodeId> topo_order;
+    topo_order.reserve(ids.size());
+    for (NodeId id : ids)
     {
-        const std::string &start_node = entry.first;
-        if (visited[start_node] == 0)
+        if (in_degree[id] == 0)
         {
-            stack.push(std::make_pair(start_node, node_map_.at(start_node)->dependencies_.begin()));
-            visited[start_node] = 1;
-            path_predecessor[start_node] = "";
+            topo_order.push_back(id);
+        }
+    }
 
-            while (!stack.empty())
+    for (size_t head = 0; head < topo_order.size(); ++head)
+    {
+        for (const Node *dependent : nodes_[topo_order[head]]->dependents_)
+        {
+            if (in_degree[dependent->id_] > 0 && --in_degree[dependent->id_] == 0)
             {
-                std::string current_node = stack.top().first;
-                auto &current_iter = stack.top().second;
+                topo_order.push_back(dependent->id_);
+            }
+        }
+    }
 
-                if (current_iter != node_map_.at(current_node)->dependencies_.end())
-                {
-                    std::string next_neighbor = *current_iter;
-                    ++current_iter;
+    if (!allow_partial && topo_order.size() != ids.size())
+    {
+        return {};
+    }
+    return topo_order;
+}
 
-                    if (visited[next_neighbor] == 0)
-                    {
-                        visited[next_neighbor] = 1;
-                        stack.push(std::make_pair(next_neighbor, node_map_.at(next_neighbor)->dependencies_.begin()));
-                        path_predecessor[next_neighbor] = current_node; 
-                    }
-                    else if (visited[next_neighbor] == 1)
-                    {
-                        cycle_path.clear();
-                        cycle_path.push_back(next_neighbor);
-                        std::string temp = current_node;
-                        while (temp != next_neighbor)
-                        {
-                            cycle_path.push_back(temp);
-                            temp = path_predecessor[temp];
-                        }
-                        cycle_path.push_back(next_neighbor);
-                        std::reverse(cycle_path.begin(), cycle_path.end());
-                        return true;
-                    }
-                }
-                else
-                {
-                    visited[current_node] = 2;
-                    stack.pop();
-                }
+std::vector<DependencyGraph::NodeId> DependencyGraph::CollectDependents(const std::vector<NodeId> &seeds) const
+{
+    std::vector<char> visited(nodes_.size(), 0);
+    std::vector<NodeId> relevant_nodes;
+    for (NodeId id : seeds)
+    {
+        if (!visited[id])
+        {
+            visited[id] = 1;
+            relevant_nodes.push_back(id);
+        }
+    }
+
+    for (size_t head = 0; head < relevant_nodes.size(); ++head)
+    {
+        for (const Node *dependent : nodes_[relevant_nodes[head]]->dependents_)
+        {
+            if (dependent->active_ && !visited[dependent->id_])
+            {
+                visited[dependent->id_] = 1;
+                relevant_nodes.push_back(dependent->id_);
             }
         }
     }
-    return false;
+    return relevant_nodes;
 }
 
 void DependencyGraph::RollBack() noexcept
@@ -656,9 +1186,13 @@ bool DependencyGraph::WriteDotFile(const std::string &file_path, std::function<s
     ofs << "  \n";
 
     // Write all nodes with their labels
-    for (const auto &node_entry : node_map_)
+    for (const auto &node : nodes_)
     {
-        const std::string &node_name = node_entry.first;
+        if (!node || !node->active_)
+        {
+            continue;
+        }
+        const std::string &node_name = node->name_;
         std::string label;
 
         // Use the provided label handler or default to node name
@@ -686,10 +1220,13 @@ bool DependencyGraph::WriteDotFile(const std::string &file_path, std::function<s
     ofs << "  \n";
 
     // Write all edges based on node dependents
-    for (const auto &node_entry : node_map_)
+    for (const auto &node : nodes_)
     {
-        const std::string &node_name = node_entry.first;
-        const auto &node = node_entry.second;
+        if (!node || !node->active_)
+        {
+            continue;
+        }
+        const std::string &node_name = node->name_;
 
         // For each dependent of this node, create an edge from this node to the dependent
         for (const auto &dependent : node->dependents())
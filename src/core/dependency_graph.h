@@ -1,14 +1,14 @@
 #pragma once
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <stack>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index_container.hpp>
 #include <boost/signals2.hpp>
 #include <tsl/ordered_set.h>
 
@@ -38,13 +38,20 @@ class DependencyCycleException : public std::runtime_error
     std::vector<std::string> cycle_path_;
 };
 
+// 依赖图。字符串 API 只是外观：节点与边的端点在内部被驻留为整数 NodeId，
+// 每条边只在两端节点的邻接表中各记一次（端点尚未加入图时也保留，待其加入后生效）；
+// 同时维护一个增量更新的拓扑序（Pearce–Kelly），
+// Traversal / TopologicalSort 直接读取该序而不再每次跑 Kahn。
 class DependencyGraph
 {
   public:
+    using NodeId = uint32_t;
+    static constexpr NodeId kInvalidNodeId = UINT32_MAX;
+
     class Node
     {
       public:
-        Node() : dirty_flag_(false) {}
+        Node() : id_(kInvalidNodeId), rank_(0), active_(false), dirty_flag_(false) {}
 
         ~Node() = default;
         Node(const Node &) = default;
@@ -52,29 +59,40 @@ class DependencyGraph
         Node(Node &&) = default;
         Node &operator=(Node &&) = default;
 
-        const tsl::ordered_set<std::string> &dependencies() const
+        // 只包含两端都已加入图的边，名字在调用时才生成
+        tsl::ordered_set<std::string> dependencies() const;
+        tsl::ordered_set<std::string> dependents() const;
+
+        bool dirty_flag() const
         {
-            return dependencies_;
+            return dirty_flag_;
         }
 
-        const tsl::ordered_set<std::string> &dependents() const
+        void set_dirty_flag(bool dirty_flag)
         {
-            return dependents_;
+            dirty_flag_ = dirty_flag;
         }
 
-        bool dirty_flag() const
+        const std::string &name() const
         {
-            return dirty_flag_;
+            return name_;
         }
 
-        void set_dirty_flag(bool dirty_flag)
+        NodeId id() const
         {
-            dirty_flag_ = dirty_flag;
+            return id_;
         }
 
       private:
-        tsl::ordered_set<std::string> dependencies_;
-        tsl::ordered_set<std::string> dependents_;
+        std::string name_;
+        NodeId id_;
+        // 拓扑序中的位置：依赖的 rank 恒小于依赖者的 rank
+        int64_t rank_;
+        // 以该节点为端点的全部边，按加入顺序；另一端未 active_ 的边不参与排序与遍历
+        std::vector<Node *> dependencies_;
+        std::vector<Node *> dependents_;
+        // 节点已加入图；为 false 时只是某条边的端点
+        bool active_;
         bool dirty_flag_;
         
         friend class DependencyGraph;
@@ -105,51 +123,6 @@ class DependencyGraph
         std::string to_;
     };
 
-    struct EdgeContainer
-    {
-        struct ByFrom
-        {};
-
-        struct ByTo
-        {};
-
-        struct EdgeHash
-        {
-            size_t operator()(const Edge &edge) const
-            {
-                size_t seed = 0;
-                boost::hash_combine(seed, edge.from());
-                boost::hash_combine(seed, edge.to());
-                return seed;
-            }
-        };
-
-        struct EdgeEqual
-        {
-            bool operator()(const Edge &lhs, const Edge &rhs) const
-            {
-                return lhs.from() == rhs.from() && lhs.to() == rhs.to();
-            }
-        };
-
-        typedef boost::multi_index::multi_index_container<
-            Edge, boost::multi_index::indexed_by<
-                      boost::multi_index::hashed_unique<boost::multi_index::identity<Edge>, EdgeHash, EdgeEqual>,
-                      boost::multi_index::hashed_non_unique<
-                          boost::multi_index::tag<ByFrom>, boost::multi_index::const_mem_fun<Edge, const std::string&, &Edge::from>>,
-                      boost::multi_index::hashed_non_unique<
-                          boost::multi_index::tag<ByTo>, boost::multi_index::const_mem_fun<Edge, const std::string&, &Edge::to>>>>
-            Type;
-
-        typedef std::pair<
-            Type::index<ByFrom>::type::const_iterator, EdgeContainer::Type::index<ByFrom>::type::const_iterator>
-            RangeByFrom;
-        typedef std::pair<
-            Type::index<ByTo>::type::const_iterator, EdgeContainer::Type::index<ByTo>::type::const_iterator>
-            RangeByTo;
-        typedef std::pair<Type::const_iterator, Type::const_iterator> Range;
-    };
-
     class BatchUpdateGuard
     {
       public:
@@ -189,9 +162,9 @@ class DependencyGraph
     DependencyGraph &operator=(DependencyGraph &&) = default;
 
     const Node* GetNode(const std::string& node_name) const;
-    EdgeContainer::RangeByFrom GetEdgesByFrom(const std::string &from) const;
-    EdgeContainer::RangeByTo GetEdgesByTo(const std::string &to) const;
-    EdgeContainer::Range GetAllEdges() const;
+    std::vector<Edge> GetEdgesByFrom(const std::string &from) const;
+    std::vector<Edge> GetEdgesByTo(const std::string &to) const;
+    std::vector<Edge> GetAllEdges() const;
     bool IsNodeExist(const std::string &node_name) const;
     bool IsEdgeExist(const Edge &edge) const;
 
@@ -221,6 +194,17 @@ class DependencyGraph
     std::vector<std::string> TopologicalSort(const std::string& node) const;
     std::vector<std::string> TopologicalSort(const std::vector<std::string>& nodes) const;
 
+    // 并行调度快照：按给定拓扑序给节点编号（下标即顺序），依赖者邻接以 CSR 存放，
+    // in_degree 只统计快照内部的依赖。调度器据此用原子计数驱动波前执行。
+    struct Schedule
+    {
+        std::vector<std::string> nodes;
+        std::vector<uint32_t> dependent_offsets;  // 大小为 nodes.size() + 1
+        std::vector<uint32_t> dependents;
+        std::vector<uint32_t> in_degree;
+    };
+    Schedule BuildSchedule(const std::vector<std::string>& topo_order) const;
+
     boost::signals2::scoped_connection ConnectNodeDependencyChangedSignal(
         const boost::signals2::signal<void(const std::string &)> ::slot_type &slot);
     boost::signals2::scoped_connection ConnectNodeDependentChangedSignal(
@@ -324,12 +308,53 @@ class DependencyGraph
     };
 
     void RollBack() noexcept;
-    void ActiveEdge(const Edge &edge);
-    void DeactiveEdge(const Edge &edge);
-    bool CheckCycle(std::vector<std::string>& cycle_path) const;
+    void ActiveEdge(Node *from, Node *to);
+    bool CheckCycle(std::vector<std::string>& cycle_path);
+
+    Node *FindNode(const std::string &node_name) const;
+    Node *FindSymbol(const std::string &node_name) const;
+    Node *InternNode(const std::string &node_name);
+    void ReleaseIfUnused(Node *node);
+    static bool HasActive(const std::vector<Node *> &nodes);
+    static bool EraseNode(std::vector<Node *> &nodes, const Node *node);
+    uint32_t NextVisitEpoch();
+
+    // 拓扑序维护
+    Node *NodeAtRank(int64_t rank) const;
+    void PlaceNodeAtRank(Node *node, int64_t rank);
+    void MoveNodeToEnd(Node *node, bool front);
+    void RemoveFromOrder(Node *node);
+    void TrimOrder();
+    bool ReorderForEdge(NodeId dependency, NodeId dependent, std::vector<NodeId> &cycle);
+    bool RebuildOrder();
+    void CompactOrder();
+    void EnsureOrder();
+    std::vector<std::string> SortByRank(const std::vector<NodeId> &ids) const;
+    std::vector<NodeId> KahnOrder(const std::vector<NodeId> &ids, bool allow_partial) const;
+    std::vector<NodeId> CollectDependents(const std::vector<NodeId> &seeds) const;
+
+    // 名字 -> NodeId，包括只作为边端点出现、尚未加入图的名字
+    std::unordered_map<std::string, NodeId> node_ids_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<NodeId> free_ids_;
+    // 已加入图（active_）的节点数
+    size_t node_count_{0};
+
+    // order_[rank - order_base_] -> NodeId；删除节点留下 kInvalidNodeId 空洞
+    std::deque<NodeId> order_;
+    int64_t order_base_{0};
+    size_t order_holes_{0};
+    // 批量更新中出现过（暂时的）环时置 false，提交/回滚后重建
+    bool order_valid_{true};
+    // ReorderForEdge 的访问标记与正向搜索父节点，按 id 索引；每次只清理访问过的项
+    std::vector<uint8_t> reorder_mark_;
+    std::vector<NodeId> reorder_parent_;
+    // MakeNodeDirty 的访问标记：等于 visit_epoch_ 即本轮已访问，换轮只需递增 epoch
+    std::vector<uint32_t> visit_mark_;
+    uint32_t visit_epoch_{0};
+    // 最近一次边激活时增量检测到的环（依赖方向，首尾相同）
+    std::vector<std::string> cycle_path_;
 
-    std::unordered_map<std::string, std::unique_ptr<Node>> node_map_;
-    EdgeContainer::Type edge_container_;
     bool batch_update_in_progress_{false};
     std::stack<Operation> operation_stack_;
 
@@ -45,12 +45,12 @@ EquationValue Equation::GetValue() const
     return manager_->context().Get(name_);
 }
 
-const tsl::ordered_set<std::string> &Equation::GetDependencies() const
+tsl::ordered_set<std::string> Equation::GetDependencies() const
 {
     return manager_->graph().GetNode(name_)->dependencies();
 }
 
-const tsl::ordered_set<std::string> &Equation::GetDependents() const
+tsl::ordered_set<std::string> Equation::GetDependents() const
 {
     return manager_->graph().GetNode(name_)->dependents();
 }
@@ -48,6 +48,11 @@ class Equation
         message_ = message;
     }
 
+    void set_compiled_code(CompiledCodePtr compiled_code)
+    {
+        compiled_code_ = std::move(compiled_code);
+    }
+
     const std::string &name() const
     {
         return name_;
@@ -73,6 +78,11 @@ class Equation
         return message_;
     }
 
+    const CompiledCodePtr &compiled_code() const
+    {
+        return compiled_code_;
+    }
+
     const EquationManager *manager() const
     {
         return manager_;
@@ -84,8 +94,8 @@ class Equation
     }
 
     EquationValue GetValue() const;
-    const tsl::ordered_set<std::string> & GetDependencies() const;
-    const tsl::ordered_set<std::string> & GetDependents() const;
+    tsl::ordered_set<std::string> GetDependencies() const;
+    tsl::ordered_set<std::string> GetDependents() const;
 
     bool operator==(const Equation &other) const;
     bool operator!=(const Equation &other) const;
@@ -96,6 +106,7 @@ class Equation
     ItemType type_;
     ResultStatus status_;
     std::string message_;
+    CompiledCodePtr compiled_code_;
     EquationGroupId group_id_;
     EquationManager *manager_ = nullptr;
 };
@@ -2,6 +2,7 @@
 
 #include <exception>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,34 @@ struct InterpretResult
     EquationValue value;
 };
 
+// 引擎预编译产物（REL: AST；Python: code object）。方程内容变化时编译一次，
+// 重算时直接解释执行，不再从源码重新扫描/解析。具体类型由各引擎派生。
+class CompiledCode
+{
+  public:
+    CompiledCode(const std::string &source, InterpretMode mode) : source_(source), mode_(mode) {}
+    virtual ~CompiledCode() = default;
+
+    CompiledCode(const CompiledCode &) = delete;
+    CompiledCode &operator=(const CompiledCode &) = delete;
+
+    const std::string &source() const
+    {
+        return source_;
+    }
+
+    InterpretMode mode() const
+    {
+        return mode_;
+    }
+
+  private:
+    std::string source_;
+    InterpretMode mode_;
+};
+
+using CompiledCodePtr = std::shared_ptr<const CompiledCode>;
+
 enum class ItemType
 {
     kUnknown,
@@ -282,6 +311,10 @@ inline std::ostream &operator<<(std::ostream &os, ResultStatus status)
 
 using InterpretHandler = std::function<InterpretResult(const std::string &, EquationContext *, InterpretMode)>;
 using ParseHandler = std::function<ParseResult(const std::string &, ParseMode)>;
+using CompileHandler = std::function<CompiledCodePtr(const std::string &, InterpretMode)>;
+using CompiledInterpretHandler = std::function<InterpretResult(const CompiledCode &, EquationContext *)>;
+// 包裹调用线程上的阻塞等待（例如等待期间释放 GIL），须在返回前调用传入的 wait
+using WaitHandler = std::function<void(const std::function<void()> &)>;
 } // namespace xequation
 
 namespace std
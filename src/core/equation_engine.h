@@ -24,7 +24,33 @@ class EquationEngine
 
     virtual InterpretResult Interpret(const std::string& code, const EquationContext *context = nullptr, InterpretMode mode = InterpretMode::kExec) = 0;
     virtual ParseResult Parse(const std::string & code, ParseMode mode = ParseMode::kExpression) = 0;
+
+    // 预编译源码；返回 nullptr 表示不支持或编译失败，调用方应回退到源码解释
+    virtual CompiledCodePtr Compile(const std::string &/*code*/, InterpretMode /*mode*/ = InterpretMode::kExec)
+    {
+        return nullptr;
+    }
+
+    // 执行预编译产物；默认实现退化为按源码解释
+    virtual InterpretResult Interpret(const CompiledCode &compiled, const EquationContext *context = nullptr)
+    {
+        return Interpret(compiled.source(), context, compiled.mode());
+    }
     
+    // 能否在多个线程上同时对同一上下文调用 Interpret（无 GIL 等全局锁）。
+    // 返回 true 时 CreateEquationManager 开启并行波前更新
+    virtual bool SupportsConcurrentInterpret() const
+    {
+        return false;
+    }
+
+    // 并行更新时调用线程的阻塞等待都经由这里；持有全局锁的引擎应在等待期间释放，
+    // 否则工作线程上的 Interpret 无法推进
+    virtual void BlockingWait(const std::function<void()> &wait)
+    {
+        wait();
+    }
+
     const EquationEngineInfo& GetEngineInfo() const { return engine_info_; }
     
     // 设置输出处理函数（用于捕获Python输出等）
@@ -40,8 +66,23 @@ class EquationEngine
         ParseHandler parse_callback = [this](const std::string &code, ParseMode mode) -> ParseResult {
             return Parse(code, mode);
         };
+
+        CompileHandler compile_handler = [this](const std::string &code, InterpretMode mode) -> CompiledCodePtr {
+            return Compile(code, mode);
+        };
+
+        CompiledInterpretHandler compiled_interpret_handler = [this](const CompiledCode &compiled, EquationContext *context) -> InterpretResult {
+            return Interpret(compiled, context);
+        };
         
-        return std::unique_ptr<EquationManager>(new EquationManager(CreateContext(), interpret_handler, parse_callback, engine_info_));
+        std::unique_ptr<EquationManager> manager(new EquationManager(
+            CreateContext(), interpret_handler, parse_callback, engine_info_, compile_handler, compiled_interpret_handler));
+        if (SupportsConcurrentInterpret())
+        {
+            manager->set_max_threads(0);
+            manager->set_wait_handler([this](const std::function<void()> &wait) { BlockingWait(wait); });
+        }
+        return manager;
     }
 
     virtual std::unique_ptr<EquationContext> CreateContext() = 0;
@@ -1,3 +1,7 @@
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include "equation_manager.h"
@@ -7,13 +11,16 @@
 namespace xequation
 {
 EquationManager::EquationManager(
-    std::unique_ptr<EquationContext> context, InterpretHandler interpret_handler, ParseHandler parse_handler, const EquationEngineInfo &engine_info
+    std::unique_ptr<EquationContext> context, InterpretHandler interpret_handler, ParseHandler parse_handler, const EquationEngineInfo &engine_info,
+    CompileHandler compile_handler, CompiledInterpretHandler compiled_interpret_handler
 ) noexcept
     : graph_(std::unique_ptr<DependencyGraph>(new DependencyGraph())),
       signals_manager_(std::unique_ptr<EquationSignalsManager>(new EquationSignalsManager())),
       context_(std::move(context)),
       interpret_handler_(interpret_handler),
       parse_handler_(parse_handler),
+      compile_handler_(compile_handler),
+      compiled_interpret_handler_(compiled_interpret_handler),
       engine_info_(engine_info)
 {
 }
@@ -133,6 +140,7 @@ EquationGroupId EquationManager::AddEquationGroup(const std::string &equation_st
     {
         graph_->InvalidateNode(item.name);
         EquationPtr equation = Equation::Create(item, id, this);
+        CompileEquation(equation.get());
         AddEquationToGroup(group_ptr, std::move(equation));
         signals_manager_->Emit<EquationEvent::kEquationAdded>(group_ptr->GetEquation(item.name));
     }
@@ -261,10 +269,9 @@ void EquationManager::EditEquationGroup(const EquationGroupId &group_id, const s
 
     for (const auto &remove_eqn_name : to_remove_equation_names)
     {
-        auto range = graph_->GetEdgesByTo(remove_eqn_name);
-        for (auto it = range.first; it != range.second; it++)
+        for (const auto &edge : graph_->GetEdgesByTo(remove_eqn_name))
         {
-            graph_->InvalidateNode(it->from());
+            graph_->InvalidateNode(edge.from());
         }
         signals_manager_->Emit<EquationEvent::kEquationRemoving>(group->GetEquation(remove_eqn_name));
         RemoveEquationInGroup(group, remove_eqn_name);
@@ -279,6 +286,7 @@ void EquationManager::EditEquationGroup(const EquationGroupId &group_id, const s
         update_eqn->set_content(update_item.content);
         update_eqn->set_type(update_item.type);
         update_eqn->set_status(ResultStatus::kPending);
+        CompileEquation(update_eqn);
         context_->Remove(update_item.name);
         signals_manager_->Emit<EquationEvent::kEquationUpdated>(
             update_eqn, EquationUpdateFlag::kContent | EquationUpdateFlag::kType | EquationUpdateFlag::kValue | EquationUpdateFlag::kStatus
@@ -289,6 +297,7 @@ void EquationManager::EditEquationGroup(const EquationGroupId &group_id, const s
     {
         graph_->InvalidateNode(add_item.name);
         EquationPtr equation = Equation::Create(add_item, group->id(), this);
+        CompileEquation(equation.get());
         AddEquationToGroup(group, std::move(equation));
         signals_manager_->Emit<EquationEvent::kEquationAdded>(group->GetEquation(add_item.name));
     }
@@ -470,10 +479,7 @@ void EquationManager::UpdateEquationInternal(const std::string &equation_name)
         equation, EquationUpdateFlag::kStatus | EquationUpdateFlag::kMessage
     );
 
-    const std::string &equation_statement = equation->type() == ItemType::kVariable
-                                                ? equation->name() + " = " + equation->content()
-                                                : equation->content();
-    InterpretResult result = interpret_handler_(equation_statement, context_.get(), InterpretMode::kExec);
+    InterpretResult result = InterpretEquation(equation);
     equation->set_status(result.status);
     equation->set_message(result.message);
     if (equation->status() != ResultStatus::kSuccess)
@@ -485,17 +491,231 @@ void EquationManager::UpdateEquationInternal(const std::string &equation_name)
     );
 }
 
+InterpretResult EquationManager::InterpretEquation(const Equation *equation)
+{
+    if (equation->compiled_code() && compiled_interpret_handler_)
+    {
+        return compiled_interpret_handler_(*equation->compiled_code(), context_.get());
+    }
+    return interpret_handler_(BuildEquationStatement(equation), context_.get(), InterpretMode::kExec);
+}
+
+// 一次并行更新的共享状态。任务按值持有 shared_ptr，调用线程提前返回（异常）时也不会悬空
+struct EquationManager::ParallelUpdateState
+{
+    std::vector<Equation *> equations;
+    std::vector<char> dirty;
+    std::vector<uint32_t> dependent_offsets;
+    std::vector<uint32_t> dependents;
+    std::unique_ptr<std::atomic<uint32_t>[]> in_degree;
+
+    // 由工作线程写入，调用线程在对应 done 置位后读取
+    std::vector<InterpretResult> results;
+    std::vector<std::exception_ptr> errors;
+    std::atomic<bool> aborted{false};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<char> done;
+    size_t done_count = 0;
+};
+
+void EquationManager::RunScheduledEquation(const std::shared_ptr<ParallelUpdateState> &state, uint32_t index)
+{
+    // 某个方程抛出异常后停止求值（与串行路径一致），但仍推进依赖计数，让调度自然收尾
+    if (state->dirty[index] && !state->aborted.load())
+    {
+        try
+        {
+            Equation *equation = state->equations[index];
+            state->results[index] = InterpretEquation(equation);
+            if (state->results[index].status != ResultStatus::kSuccess)
+            {
+                // 在依赖者开始求值前移除，保证它们看到的上下文与串行一致
+                context_->Remove(equation->name());
+            }
+        }
+        catch (...)
+        {
+            state->errors[index] = std::current_exception();
+            state->aborted.store(true);
+        }
+    }
+
+    for (uint32_t i = state->dependent_offsets[index]; i < state->dependent_offsets[index + 1]; i++)
+    {
+        uint32_t dependent = state->dependents[i];
+        if (state->in_degree[dependent].fetch_sub(1) == 1)
+        {
+            std::shared_ptr<ParallelUpdateState> shared_state = state;
+            task_pool_->Submit([this, shared_state, dependent]() { RunScheduledEquation(shared_state, dependent); });
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done[index] = 1;
+        state->done_count++;
+    }
+    state->finished.notify_one();
+}
+
+void EquationManager::UpdateEquationsParallel(const std::vector<std::string> &topo_order)
+{
+    DependencyGraph::Schedule schedule = graph_->BuildSchedule(topo_order);
+    size_t count = schedule.nodes.size();
+
+    std::shared_ptr<ParallelUpdateState> state = std::make_shared<ParallelUpdateState>();
+    state->equations.reserve(count);
+    state->dirty.reserve(count);
+    for (const std::string &node_name : schedule.nodes)
+    {
+        if (IsEquationExist(node_name) == false)
+        {
+            throw EquationException::EquationNotFound(node_name);
+        }
+        state->equations.push_back(GetEquationInternal(node_name));
+        state->dirty.push_back(graph_->GetNode(node_name)->dirty_flag() ? 1 : 0);
+    }
+    state->dependent_offsets = std::move(schedule.dependent_offsets);
+    state->dependents = std::move(schedule.dependents);
+    state->in_degree.reset(new std::atomic<uint32_t>[count]);
+    for (size_t i = 0; i < count; i++)
+    {
+        state->in_degree[i].store(schedule.in_degree[i]);
+    }
+    state->results.resize(count);
+    state->errors.resize(count);
+    state->done.assign(count, 0);
+
+    if (!task_pool_)
+    {
+        task_pool_ = std::unique_ptr<TaskPool>(new TaskPool(max_threads_));
+    }
+
+    // 派发前在调用线程上把本次要求值的方程统一标为计算中；结果信号随后按拓扑序发出。
+    // 原状态留作出错时恢复，未得出结果的方程不会停在计算中
+    std::vector<std::pair<ResultStatus, std::string>> previous(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!state->dirty[i])
+        {
+            continue;
+        }
+        Equation *equation = state->equations[i];
+        previous[i] = std::make_pair(equation->status(), equation->message());
+        equation->set_status(ResultStatus::kCalculating);
+        equation->set_message("Calculating...");
+        signals_manager_->Emit<EquationEvent::kEquationUpdated>(
+            equation, EquationUpdateFlag::kStatus | EquationUpdateFlag::kMessage
+        );
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (schedule.in_degree[i] == 0)
+        {
+            task_pool_->Submit([this, state, i]() { RunScheduledEquation(state, i); });
+        }
+    }
+
+    // 调用线程按拓扑序等待每个方程完成并发出结果信号
+    std::exception_ptr error;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto wait = [&state, i]() {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->finished.wait(lock, [&state, i]() { return state->done[i] != 0; });
+        };
+        if (wait_handler_)
+        {
+            wait_handler_(wait);
+        }
+        else
+        {
+            wait();
+        }
+
+        if (!state->dirty[i])
+        {
+            continue;
+        }
+
+        Equation *equation = state->equations[i];
+        if (error)
+        {
+            equation->set_status(previous[i].first);
+            equation->set_message(previous[i].second);
+            signals_manager_->Emit<EquationEvent::kEquationUpdated>(
+                equation, EquationUpdateFlag::kStatus | EquationUpdateFlag::kMessage
+            );
+            continue;
+        }
+
+        if (state->errors[i])
+        {
+            // 等其余已派发的任务收尾后再抛出，避免它们在栈展开后仍访问本对象
+            error = state->errors[i];
+            continue;
+        }
+
+        equation->set_status(state->results[i].status);
+        equation->set_message(state->results[i].message);
+        signals_manager_->Emit<EquationEvent::kEquationUpdated>(
+            equation, EquationUpdateFlag::kStatus | EquationUpdateFlag::kMessage | EquationUpdateFlag::kValue
+        );
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void EquationManager::UpdateEquations(const std::vector<std::string> &topo_order)
+{
+    if (max_threads_ == 1 || topo_order.size() < 2)
+    {
+        for (const auto &node_name : topo_order)
+        {
+            UpdateEquationInternal(node_name);
+        }
+        return;
+    }
+
+    UpdateEquationsParallel(topo_order);
+}
+
+void EquationManager::CompileEquation(Equation *equation)
+{
+    // content 变化（kContent）即作废旧的编译产物
+    equation->set_compiled_code(nullptr);
+    if (!compile_handler_ || !compiled_interpret_handler_)
+    {
+        return;
+    }
+
+    // 编译失败（语法错误等）不缓存：UpdateEquationInternal 回退到源码解释，由其报告错误
+    try
+    {
+        equation->set_compiled_code(compile_handler_(BuildEquationStatement(equation), InterpretMode::kExec));
+    }
+    catch (const std::exception &)
+    {
+    }
+}
+
+std::string EquationManager::BuildEquationStatement(const Equation *equation)
+{
+    return equation->type() == ItemType::kVariable ? equation->name() + " = " + equation->content()
+                                                   : equation->content();
+}
+
 void EquationManager::AddNodeToGraph(const std::string &node_name, const std::vector<std::string> &dependencies)
 {
     DependencyGraph::BatchUpdateGuard guard(graph_.get());
     graph_->AddNode(node_name);
-    const DependencyGraph::EdgeContainer::RangeByFrom edges = graph_->GetEdgesByFrom(node_name);
-    std::vector<DependencyGraph::Edge> edges_to_remove;
-    for (auto it = edges.first; it != edges.second; it++)
-    {
-        edges_to_remove.push_back(*it);
-    }
-    graph_->RemoveEdges(edges_to_remove);
+    graph_->RemoveEdges(graph_->GetEdgesByFrom(node_name));
     for (const std::string &dep : dependencies)
     {
         graph_->AddEdge({node_name, dep});
@@ -506,13 +726,7 @@ void EquationManager::AddNodeToGraph(const std::string &node_name, const std::ve
 void EquationManager::RemoveNodeInGraph(const std::string &node_name)
 {
     graph_->RemoveNode(node_name);
-    auto edges = graph_->GetEdgesByFrom(node_name);
-    std::vector<DependencyGraph::Edge> edges_to_remove;
-    for (auto it = edges.first; it != edges.second; it++)
-    {
-        edges_to_remove.push_back(*it);
-    }
-    graph_->RemoveEdges(edges_to_remove);
+    graph_->RemoveEdges(graph_->GetEdgesByFrom(node_name));
 }
 
 void EquationManager::AddEquationToGroup(EquationGroup *group, EquationPtr equation)
@@ -529,7 +743,7 @@ void EquationManager::RemoveEquationInGroup(EquationGroup *group, const std::str
 
 void EquationManager::Update()
 {
-    graph_->Traversal([&](const std::string &eqn_name) { UpdateEquationInternal(eqn_name); });
+    UpdateEquations(graph_->TopologicalSort());
 }
 
 void EquationManager::UpdateEquation(const std::string &equation_name)
@@ -539,12 +753,7 @@ void EquationManager::UpdateEquation(const std::string &equation_name)
         throw EquationException::EquationNotFound(equation_name);
     }
 
-    auto topo_order = graph_->TopologicalSort(equation_name);
-
-    for (const auto &node_name : topo_order)
-    {
-        UpdateEquationInternal(node_name);
-    }
+    UpdateEquations(graph_->TopologicalSort(equation_name));
 }
 
 void EquationManager::UpdateEquationGroup(const EquationGroupId &group_id)
@@ -556,12 +765,7 @@ void EquationManager::UpdateEquationGroup(const EquationGroupId &group_id)
 
     const EquationGroup *group = GetEquationGroup(group_id);
 
-    auto topo_order = graph_->TopologicalSort(group->GetEquationNames());
-
-    for (const auto &node_name : topo_order)
-    {
-        UpdateEquationInternal(node_name);
-    }
+    UpdateEquations(graph_->TopologicalSort(group->GetEquationNames()));
 }
 
 void EquationManager::UpdateEquationWithoutPropagate(const std::string &equation_name)
@@ -574,6 +778,17 @@ void EquationManager::UpdateEquationWithoutPropagate(const std::string &equation
     UpdateEquationInternal(equation_name);
 }
 
+void EquationManager::set_max_threads(size_t max_threads)
+{
+    if (max_threads == max_threads_)
+    {
+        return;
+    }
+    max_threads_ = max_threads;
+    // 线程池按需以新的线程数重建
+    task_pool_.reset();
+}
+
 void EquationManager::UpdateEquationStatus(const std::string &equation_name, ResultStatus status, const std::string& message)
 {
     if (IsEquationExist(equation_name) == false)
@@ -12,6 +12,7 @@
 #include "equation_context.h"
 #include "equation_group.h"
 #include "equation_signals_manager.h"
+#include "task_pool.h"
 
 namespace xequation
 {
@@ -128,7 +129,8 @@ class EquationManager
 {
   public:
     EquationManager(
-        std::unique_ptr<EquationContext> context, InterpretHandler interpret_handler, ParseHandler parse_handler, const EquationEngineInfo &engine_info) noexcept;
+        std::unique_ptr<EquationContext> context, InterpretHandler interpret_handler, ParseHandler parse_handler, const EquationEngineInfo &engine_info,
+        CompileHandler compile_handler = nullptr, CompiledInterpretHandler compiled_interpret_handler = nullptr) noexcept;
 
     virtual ~EquationManager() noexcept = default;
 
@@ -174,6 +176,22 @@ class EquationManager
 
     void UpdateEquationStatus(const std::string &equation_name, ResultStatus status, const std::string& message = "");
 
+    // 更新时的最大工作线程数：1（默认）在调用线程上串行求值；0 取硬件并发数；
+    // 大于 1 时按依赖波前并行求值。无论哪种方式，信号都在调用线程上按拓扑序发出。
+    // 只应对 SupportsConcurrentInterpret 的引擎开启
+    void set_max_threads(size_t max_threads);
+
+    size_t max_threads() const
+    {
+        return max_threads_;
+    }
+
+    // 并行更新时调用线程等待方程完成的方式；为空则直接等待
+    void set_wait_handler(WaitHandler wait_handler)
+    {
+        wait_handler_ = std::move(wait_handler);
+    }
+
     bool WriteDependencyGraphToDotFile(const std::string &file_path) const;
 
     const DependencyGraph &graph()
@@ -206,6 +224,13 @@ class EquationManager
     Equation *GetEquationInternal(const std::string &equation_name);
     EquationGroup *GetEquationGroupInternal(const EquationGroupId &group_id);
     void UpdateEquationInternal(const std::string &equation_name);
+    void UpdateEquations(const std::vector<std::string> &topo_order);
+    void UpdateEquationsParallel(const std::vector<std::string> &topo_order);
+    InterpretResult InterpretEquation(const Equation *equation);
+    struct ParallelUpdateState;
+    void RunScheduledEquation(const std::shared_ptr<ParallelUpdateState> &state, uint32_t index);
+    void CompileEquation(Equation *equation);
+    static std::string BuildEquationStatement(const Equation *equation);
 
     void AddNodeToGraph(const std::string &node_name, const std::vector<std::string> &dependencies);
     void RemoveNodeInGraph(const std::string &node_name);
@@ -230,6 +255,12 @@ class EquationManager
 
     InterpretHandler interpret_handler_ = nullptr;
     ParseHandler parse_handler_ = nullptr;
+    CompileHandler compile_handler_ = nullptr;
+    CompiledInterpretHandler compiled_interpret_handler_ = nullptr;
+    WaitHandler wait_handler_ = nullptr;
     EquationEngineInfo engine_info_{};
+
+    size_t max_threads_ = 1;
+    std::unique_ptr<TaskPool> task_pool_;
 };
 } // namespace xequation
\ No newline at end of file
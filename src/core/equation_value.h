@@ -1,6 +1,7 @@
 #pragma once
 #include <boost/blank.hpp>
 #include <boost/variant.hpp>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -16,6 +17,10 @@ namespace xequation
 //   rel::Value  —— REL 值（标量/向量/矩阵/DataArray，含 unit）
 //   PyObjectRef —— 不透明 Python 对象（list/dict/自定义类/callable…）
 //
+// Python 数值（int/float/complex/bool、C 连续的数值数组）在转换时额外附带
+// 一份原生 rel::Value 视图（NativeValue），读取数值无需再持有 GIL；
+// 对象本身仍是 PyObjectRef，往返 Python 时保持同一个引用。
+//
 // 相比旧版类型擦除（unique_ptr<ValueBase> + 每值一次堆分配），
 // variant 将 payload 内联存储，零堆分配；类型由 which() 确定，
 // 不依赖 typeid / dynamic_cast，跨 DLL（rel_runtime 是 SHARED）安全。
@@ -71,6 +76,24 @@ class EquationValue
     }
     Kind kind() const noexcept;
 
+    // 是否可以按 rel::Value 读取：rel::Value 载荷，或附带原生视图的 Python 对象
+    bool HasNativeValue() const noexcept
+    {
+        return IsRelValue() || (IsPyObject() && native_);
+    }
+
+    // rel::Value 载荷本身，或 Python 对象的原生视图；两者都没有时抛 boost::bad_get
+    const rel::Value &NativeValue() const
+    {
+        return IsPyObject() && native_ ? *native_ : AsRel();
+    }
+
+    // 由 Python 转换层在持有 GIL 时调用；视图与对象一起拷贝，拷贝本身不需要 GIL
+    void set_native_value(rel::Value native)
+    {
+        native_ = std::make_shared<const rel::Value>(std::move(native));
+    }
+
     // rel::Value 便捷类型查询（仅当 IsRelValue() 且为 Measurement 标量时有意义）
     bool IsInteger() const;
     bool IsReal() const;
@@ -132,8 +155,8 @@ class EquationValue
     template <typename D>
     D CastImpl(std::false_type, std::false_type) const
     {
-        // 标量提取：从 rel::Value 的 Measurement 取
-        const rel::Value &rv = AsRel();
+        // 标量提取：从 rel::Value（或 Python 数值的原生视图）的 Measurement 取
+        const rel::Value &rv = NativeValue();
         if (!rv.is_measurement())
         {
             throw std::runtime_error("Cannot cast non-measurement EquationValue to scalar");
@@ -142,6 +165,7 @@ class EquationValue
     }
 
     boost::variant<boost::blank, rel::Value, PyObjectRef> storage_;
+    std::shared_ptr<const rel::Value> native_;  // 仅 PyObjectRef 状态下可能非空
 };
 
 } // namespace xequation
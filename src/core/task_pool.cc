@@ -0,0 +1,122 @@
+#include "task_pool.h"
+
+namespace xequation
+{
+namespace
+{
+// 当前线程所属的线程池与队列下标，用于把工作线程内提交的任务放回本地队列
+thread_local const TaskPool *tls_pool = nullptr;
+thread_local size_t tls_queue_index = 0;
+} // namespace
+
+TaskPool::TaskPool(size_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    queues_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        queues_.emplace_back(new WorkQueue());
+    }
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        workers_.emplace_back(&TaskPool::WorkerLoop, this, i);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+bool TaskPool::InWorkerThread()
+{
+    return tls_pool != nullptr;
+}
+
+void TaskPool::Submit(Task task)
+{
+    size_t index = tls_pool == this ? tls_queue_index : next_queue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        pending_++;
+    }
+    wake_.notify_one();
+}
+
+bool TaskPool::PopLocal(size_t index, Task &task)
+{
+    WorkQueue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskPool::Steal(size_t index, Task &task)
+{
+    for (size_t offset = 1; offset < queues_.size(); offset++)
+    {
+        WorkQueue &queue = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::WorkerLoop(size_t index)
+{
+    tls_pool = this;
+    tls_queue_index = index;
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+            if (pending_ == 0)
+            {
+                return;
+            }
+            // 占用名额与取任务都在 wake_mutex_ 内完成：Submit 先入队再计数，取任务的线程
+            // 又彼此互斥，因此 pending_ > 0 时队列里必有一个任务，一次扫描即可取到
+            pending_--;
+            if (!PopLocal(index, task))
+            {
+                Steal(index, task);
+            }
+        }
+        task();
+    }
+}
+} // namespace xequation
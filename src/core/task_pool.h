@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xequation
+{
+// 工作窃取线程池。每个工作线程有自己的双端队列：本线程提交的任务压入队尾并从队尾取
+// （LIFO，利于缓存局部性），空闲线程从其他队列的队头窃取；外部线程提交的任务轮转分配。
+// 任务不得抛出异常，需要时由调用方自行捕获。
+class TaskPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    // thread_count 为 0 时取 std::thread::hardware_concurrency()
+    explicit TaskPool(size_t thread_count);
+    ~TaskPool();
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    void Submit(Task task);
+
+    size_t thread_count() const
+    {
+        return workers_.size();
+    }
+
+    // 当前线程是否为某个 TaskPool 的工作线程
+    static bool InWorkerThread();
+
+  private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool PopLocal(size_t index, Task &task);
+    bool Steal(size_t index, Task &task);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+
+    // pending_ 为已提交未取走的任务数；空闲线程在 wake_ 上阻塞等待，取任务时持有 wake_mutex_
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    size_t pending_{0};
+    bool stop_{false};
+};
+} // namespace xequation
@@ -1,9 +1,9 @@
 #include "equation_manager_tasks.h"
 #include "core/equation_common.h"
+#include "python/python_gil_yield.h"
 #include "python/python_qt_wrapper.h"
 #include <QDir>
 #include <QProcess>
-#include <QThread>
 #include <QFont>
 #include <QFontDatabase>
 
@@ -27,7 +27,8 @@ void EquationManagerTask::RequestCancel()
     Task::RequestCancel();
     if (equation_manager_->engine_info().name == "Python" && internal_data_)
     {
-        pybind11::gil_scoped_acquire acquire;
+        // 后台任务可能正持有 GIL，登记等待使其在方程间隙让出
+        PythonGilYield::UiScopedAcquire acquire;
         void *data = internal_data_;
         PyThreadState *py_thread_state = static_cast<PyThreadState *>(data);
         PyThreadState_SetAsyncExc(py_thread_state->thread_id, PyExc_KeyboardInterrupt);
@@ -42,6 +43,50 @@ void EquationManagerTask::Cleanup()
     }
 }
 
+void EquationManagerTask::UpdateEquationsInOrder(const std::vector<std::string> &equation_names)
+{
+    auto manager = equation_manager_;
+    std::unique_ptr<pybind11::gil_scoped_acquire> gil;
+    if (manager->engine_info().name == "Python")
+    {
+        gil.reset(new pybind11::gil_scoped_acquire());
+        // 循环期间线程状态保持不变，取消时据此投递 KeyboardInterrupt
+        internal_data_ = static_cast<void *>(PyThreadState_Get());
+    }
+
+    progress_timer_.invalidate();
+    for (size_t i = 0; i < equation_names.size(); ++i)
+    {
+        if (cancel_requested_.load())
+        {
+            manager->UpdateEquationStatus(equation_names[i], ResultStatus::kKeyBoardInterrupt);
+            continue;
+        }
+        int progress = 10 + static_cast<int>(80.0 * i / equation_names.size());
+        SetProgressThrottled(progress, "Updating equation: " + QString::fromStdString(equation_names[i]));
+        manager->UpdateEquationWithoutPropagate(equation_names[i]);
+        if (gil)
+        {
+            PythonGilYield::YieldIfUiWaiting();
+        }
+    }
+    if (gil)
+    {
+        // 释放 GIL 后线程状态可能被销毁，不再允许向其投递异常
+        internal_data_ = nullptr;
+    }
+}
+
+void EquationManagerTask::SetProgressThrottled(int progress, const QString &message)
+{
+    if (progress_timer_.isValid() && progress_timer_.elapsed() < kProgressIntervalMs)
+    {
+        return;
+    }
+    progress_timer_.start();
+    SetProgress(progress, message);
+}
+
 void UpdateEquationGroupTask::Execute()
 {
     EquationManagerTask::Execute();
@@ -53,19 +98,7 @@ void UpdateEquationGroupTask::Execute()
 
     SetProgress(10, "Updating equations in the group...");
 
-    for (size_t i = 0; i < update_equation_names.size(); ++i)
-    {
-        if (cancel_requested_.load())
-        {
-            manager->UpdateEquationStatus(update_equation_names[i], ResultStatus::kKeyBoardInterrupt);
-            continue;
-        }
-        int progress = 10 + static_cast<int>(80.0 * i / update_equation_names.size());
-        SetProgress(progress, "Updating equation: " + QString::fromStdString(update_equation_names[i]));
-        manager->UpdateEquationWithoutPropagate(update_equation_names[i]);
-        // release GIL for main thread to update UI
-        QThread::msleep(200);
-    }
+    UpdateEquationsInOrder(update_equation_names);
     if (cancel_requested_.load())
     {
         return;
@@ -82,19 +115,7 @@ void UpdateManagerTask::Execute()
 
     SetProgress(10, "Updating equations...");
 
-    for (size_t i = 0; i < update_equation_names.size(); ++i)
-    {
-        if (cancel_requested_.load())
-        {
-            manager->UpdateEquationStatus(update_equation_names[i], ResultStatus::kKeyBoardInterrupt);
-            continue;
-        }
-        int progress = 10 + static_cast<int>(80.0 * i / update_equation_names.size());
-        SetProgress(progress, "Updating equation: " + QString::fromStdString(update_equation_names[i]));
-        manager->UpdateEquationWithoutPropagate(update_equation_names[i]);
-        // release GIL for main thread to update UI
-        QThread::msleep(200);
-    }
+    UpdateEquationsInOrder(update_equation_names);
     if (cancel_requested_.load())
     {
         return;
@@ -111,19 +132,7 @@ void UpdateEquationsTask::Execute()
 
     SetProgress(10, "Updating equations...");
 
-    for (size_t i = 0; i < update_equation_names.size(); ++i)
-    {
-        if (cancel_requested_.load())
-        {
-            manager->UpdateEquationStatus(update_equation_names[i], ResultStatus::kKeyBoardInterrupt);
-            continue;
-        }
-        int progress = 10 + static_cast<int>(80.0 * i / update_equation_names.size());
-        SetProgress(progress, "Updating equation: " + QString::fromStdString(update_equation_names[i]));
-        manager->UpdateEquationWithoutPropagate(update_equation_names[i]);
-        // release GIL for main thread to update UI
-        QThread::msleep(200);
-    }
+    UpdateEquationsInOrder(update_equation_names);
     if (cancel_requested_.load())
     {
         return;
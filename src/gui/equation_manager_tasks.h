@@ -4,6 +4,7 @@
 #include "core/equation_manager.h"
 #include "task/task.h"
 
+#include <QElapsedTimer>
 #include <QSize>
 
 namespace xequation
@@ -25,8 +26,19 @@ class EquationManagerTask : public Task
         return equation_manager_;
     }
 
+  protected:
+    // 按给定的拓扑序逐个更新方程，处理取消请求；Python 引擎在整个循环中持有 GIL，
+    // 仅在界面线程等待时于方程间隙让出，REL 引擎不涉及 GIL
+    void UpdateEquationsInOrder(const std::vector<std::string> &equation_names);
+
+    // 进度通知按固定帧率合并，避免每个方程都向界面线程投递一次
+    void SetProgressThrottled(int progress, const QString &message);
+
   private:
+    static constexpr qint64 kProgressIntervalMs = 33;
+
     EquationManager *equation_manager_;
+    QElapsedTimer progress_timer_;
 };
 
 class UpdateEquationGroupTask : public EquationManagerTask
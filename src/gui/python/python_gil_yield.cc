@@ -0,0 +1,35 @@
+#include "python_gil_yield.h"
+
+#include <chrono>
+#include <thread>
+
+namespace xequation
+{
+namespace gui
+{
+std::atomic<int> PythonGilYield::ui_waiters_{0};
+
+PythonGilYield::UiScopedAcquire::UiScopedAcquire()
+{
+    ui_waiters_.fetch_add(1);
+    acquire_.reset(new pybind11::gil_scoped_acquire());
+    ui_waiters_.fetch_sub(1);
+}
+
+void PythonGilYield::YieldIfUiWaiting()
+{
+    if (!IsUiWaiting())
+    {
+        return;
+    }
+
+    pybind11::gil_scoped_release release;
+    // 等界面线程真正拿到 GIL（登记数归零）；设上限，避免等待方迟迟未被调度时卡住后台任务
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    while (IsUiWaiting() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+}
+} // namespace gui
+} // namespace xequation
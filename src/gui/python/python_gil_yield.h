@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <memory>
+
+#include "python_qt_wrapper.h"
+
+namespace xequation
+{
+namespace gui
+{
+// 界面线程与后台更新任务之间的 GIL 协作。后台任务在整个更新循环中持有 GIL，
+// 只有当界面线程登记了等待时才在方程间隙让出，取代逐方程固定休眠。
+class PythonGilYield
+{
+  public:
+    // 界面线程获取 GIL 时使用：获取期间登记为等待方，取得后即注销
+    class UiScopedAcquire
+    {
+      public:
+        UiScopedAcquire();
+        ~UiScopedAcquire() = default;
+
+        UiScopedAcquire(const UiScopedAcquire &) = delete;
+        UiScopedAcquire &operator=(const UiScopedAcquire &) = delete;
+
+      private:
+        std::unique_ptr<pybind11::gil_scoped_acquire> acquire_;
+    };
+
+    static bool IsUiWaiting()
+    {
+        return ui_waiters_.load() > 0;
+    }
+
+    // 后台线程在持有 GIL 时调用：界面线程正在等待则临时释放 GIL，待其取得后再重新竞争
+    static void YieldIfUiWaiting();
+
+  private:
+    static std::atomic<int> ui_waiters_;
+};
+} // namespace gui
+} // namespace xequation
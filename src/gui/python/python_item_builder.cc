@@ -1,4 +1,5 @@
 #include "python_item_builder.h"
+#include "python_gil_yield.h"
 #include "value_model/value_item.h"
 #include <string>
 
@@ -20,7 +21,7 @@ bool PythonDefaultItemBuilder::CanBuild(const EquationValue &value)
 ValueItem::UniquePtr
 PythonDefaultItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto item = ValueItem::Create(name, value, parent);
@@ -32,7 +33,7 @@ PythonDefaultItemBuilder::CreateValueItem(const QString &name, const EquationVal
 
 QString PythonDefaultItemBuilder::GetTypeName(py::handle obj, bool qualified)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     try
     {
@@ -67,7 +68,7 @@ QString PythonDefaultItemBuilder::GetTypeName(py::handle obj, bool qualified)
 
 QString PythonDefaultItemBuilder::GetObjectRepr(py::handle obj)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     try
     {
@@ -97,19 +98,21 @@ QString PythonDefaultItemBuilder::GetObjectRepr(py::handle obj)
 // PythonListItemBuilder implementation
 bool PythonListItemBuilder::CanBuild(const EquationValue &value)
 {
-    py::gil_scoped_acquire acquire;
-
-    if (!value.IsPyObject())
+    // 带原生视图的数值对象统一交给默认 builder，不必拿 GIL
+    if (!value.IsPyObject() || value.HasNativeValue())
     {
         return false;
     }
+
+    PythonGilYield::UiScopedAcquire acquire;
+
     auto obj = py::cast(value);
     return py::isinstance<py::list>(obj);
 }
 
 ValueItem::UniquePtr PythonListItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto list = py::cast<py::list>(obj);
@@ -130,7 +133,7 @@ void PythonListItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
         return;
     }
 
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(item->value());
     auto list = py::cast<py::list>(obj);
@@ -150,19 +153,21 @@ void PythonListItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
 // PythonTupleItemBuilder implementation
 bool PythonTupleItemBuilder::CanBuild(const EquationValue &value)
 {
-    py::gil_scoped_acquire acquire;
-
-    if (!value.IsPyObject())
+    // 带原生视图的数值对象统一交给默认 builder，不必拿 GIL
+    if (!value.IsPyObject() || value.HasNativeValue())
     {
         return false;
     }
+
+    PythonGilYield::UiScopedAcquire acquire;
+
     auto obj = py::cast(value);
     return py::isinstance<py::tuple>(obj);
 }
 
 ValueItem::UniquePtr PythonTupleItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto tuple = py::cast<py::tuple>(obj);
@@ -183,7 +188,7 @@ void PythonTupleItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
         return;
     }
 
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(item->value());
     auto tuple = py::cast<py::tuple>(obj);
@@ -202,19 +207,21 @@ void PythonTupleItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
 // PythonSetItemBuilder implementation
 bool PythonSetItemBuilder::CanBuild(const EquationValue &value)
 {
-    py::gil_scoped_acquire acquire;
-
-    if (!value.IsPyObject())
+    // 带原生视图的数值对象统一交给默认 builder，不必拿 GIL
+    if (!value.IsPyObject() || value.HasNativeValue())
     {
         return false;
     }
+
+    PythonGilYield::UiScopedAcquire acquire;
+
     auto obj = py::cast(value);
     return py::isinstance<py::set>(obj);
 }
 
 ValueItem::UniquePtr PythonSetItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto set = py::cast<py::set>(obj);
@@ -235,7 +242,7 @@ void PythonSetItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
         return;
     }
 
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(item->value());
     auto set = py::cast<py::set>(obj);
@@ -253,19 +260,21 @@ void PythonSetItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
 // PythonDictItemBuilder implementation
 bool PythonDictItemBuilder::CanBuild(const EquationValue &value)
 {
-    py::gil_scoped_acquire acquire;
-
-    if (!value.IsPyObject())
+    // 带原生视图的数值对象统一交给默认 builder，不必拿 GIL
+    if (!value.IsPyObject() || value.HasNativeValue())
     {
         return false;
     }
+
+    PythonGilYield::UiScopedAcquire acquire;
+
     auto obj = py::cast(value);
     return py::isinstance<py::dict>(obj);
 }
 
 ValueItem::UniquePtr PythonDictItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto dict = py::cast<py::dict>(obj);
@@ -286,7 +295,7 @@ void PythonDictItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
         return;
     }
 
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(item->value());
     auto dict = py::cast<py::dict>(obj);
@@ -304,19 +313,21 @@ void PythonDictItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
 
 bool PythonClassItemBuilder::CanBuild(const EquationValue &value)
 {
-    py::gil_scoped_acquire acquire;
-
-    if (!value.IsPyObject())
+    // 带原生视图的数值对象统一交给默认 builder，不必拿 GIL
+    if (!value.IsPyObject() || value.HasNativeValue())
     {
         return false;
     }
+
+    PythonGilYield::UiScopedAcquire acquire;
+
     auto obj = py::cast(value);
     return py::hasattr(obj, "__class__") && py::hasattr(obj, "__dict__");
 }
 
 ValueItem::UniquePtr PythonClassItemBuilder::CreateValueItem(const QString &name, const EquationValue &value, ValueItem *parent)
 {
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(value);
     auto dict = py::cast<py::dict>(obj.attr("__dict__"));
@@ -335,7 +346,7 @@ void PythonClassItemBuilder::LoadChildren(ValueItem *item, int begin, int end)
         return;
     }
 
-    py::gil_scoped_acquire acquire;
+    PythonGilYield::UiScopedAcquire acquire;
 
     auto obj = py::cast(item->value());
     auto dict = py::cast<py::dict>(obj.attr("__dict__"));
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
 #include "core/equation_common.h"
 #include "python_base.h"
 #include "value_pybind_converter.h"
@@ -8,15 +12,27 @@ namespace xequation
 {
 namespace python
 {
-inline ResultStatus MapPythonExceptionToStatus(const pybind11::error_already_set &e)
+// 源码内容哈希（FNV-1a 64 位），用作 C++ 侧缓存键。
+// 不同源码可能碰撞，命中后调用方需再比对源码本身。
+inline std::uint64_t HashSource(const char *data, std::size_t size)
 {
-    pybind11::gil_scoped_acquire acquire;
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
 
-    // Extract Python exception type
-    pybind11::object type = e.type();
-    pybind11::object type_name = type.attr("__name__");
-    std::string type_name_str = type_name.cast<std::string>();
+inline std::uint64_t HashSource(const std::string &source)
+{
+    return HashSource(source.data(), source.size());
+}
 
+// 按异常类型名映射（工作进程只回传类型名）
+inline ResultStatus MapPythonExceptionNameToStatus(const std::string &type_name_str)
+{
     if (type_name_str == "SyntaxError")
     {
         return ResultStatus::kSyntaxError;
@@ -68,5 +84,15 @@ inline ResultStatus MapPythonExceptionToStatus(const pybind11::error_already_set
 
     return ResultStatus::kUnknownError;
 }
+
+inline ResultStatus MapPythonExceptionToStatus(const pybind11::error_already_set &e)
+{
+    pybind11::gil_scoped_acquire acquire;
+
+    // Extract Python exception type
+    pybind11::object type = e.type();
+    pybind11::object type_name = type.attr("__name__");
+    return MapPythonExceptionNameToStatus(type_name.cast<std::string>());
+}
 } // namespace python
 } // namespace xequation
\ No newline at end of file
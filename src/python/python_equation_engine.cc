@@ -5,6 +5,7 @@
 #include "python/python_equation_context.h"
 #include "value_pybind_converter.h"
 #include <memory>
+#include <stdexcept>
 
 using namespace xequation;
 using namespace xequation::python;
@@ -42,6 +43,44 @@ InterpretResult PythonEquationEngine::Interpret(const std::string &code, const E
     }
 }
 
+CompiledCodePtr PythonEquationEngine::Compile(const std::string &code, InterpretMode mode)
+{
+    pybind11::gil_scoped_acquire acquire;
+    value_convert::FlushPendingDecrefs();
+    return code_executor->Compile(code, mode);
+}
+
+InterpretResult PythonEquationEngine::Interpret(const CompiledCode &compiled, const EquationContext *context)
+{
+    const PythonCompiledCode *py_compiled = dynamic_cast<const PythonCompiledCode *>(&compiled);
+    if (!py_compiled)
+    {
+        return Interpret(compiled.source(), context, compiled.mode());
+    }
+
+    pybind11::gil_scoped_acquire acquire;
+    value_convert::FlushPendingDecrefs();
+    const PythonEquationContext* py_context = dynamic_cast<const PythonEquationContext*>(context);
+    if (worker_pool_ && py_context && py_compiled->mode() == InterpretMode::kExec)
+    {
+        InterpretResult result;
+        std::string output;
+        if (worker_pool_->Run(*py_compiled, py_context->dict(), result, output))
+        {
+            code_executor->WriteOutput(output);
+            return result;
+        }
+    }
+    if (py_compiled->mode() == InterpretMode::kEval)
+    {
+        return code_executor->Eval(*py_compiled, py_context ? py_context->dict() : pybind11::dict());
+    }
+    else
+    {
+        return code_executor->Exec(*py_compiled, py_context ? py_context->dict() : pybind11::dict());
+    }
+}
+
 ParseResult PythonEquationEngine::Parse(const std::string &code, ParseMode mode)
 {
     pybind11::gil_scoped_acquire acquire;
@@ -65,6 +104,7 @@ PythonEquationEngine::~PythonEquationEngine()
     // 销毁 pybind11 对象需要持有 GIL。解释器生命周期由 python_manager 管理
     // （宿主可调用 python_manager::PyEnvManager::ShutdownPyEnv() 收尾）。
     pybind11::gil_scoped_acquire acquire;
+    worker_pool_.reset();
     code_parser.reset();
     code_executor.reset();
 }
@@ -75,4 +115,65 @@ void PythonEquationEngine::SetOutputHandler(OutputHandler handler)
     {
         code_executor->SetOutputHandler(handler);
     }
+}
+
+bool PythonEquationEngine::SetParseCacheFile(const std::string &path)
+{
+    return code_parser ? code_parser->SetCacheFile(path) : false;
+}
+
+bool PythonEquationEngine::SetWorkerCount(size_t count)
+{
+    if (count == worker_count())
+    {
+        return true;
+    }
+    worker_pool_.reset();
+    if (count == 0)
+    {
+        return true;
+    }
+    try
+    {
+        worker_pool_.reset(new PythonWorkerPool(count));
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    return true;
+}
+
+size_t PythonEquationEngine::worker_count() const
+{
+    return worker_pool_ ? worker_pool_->size() : 0;
+}
+
+bool PythonEquationEngine::SupportsConcurrentInterpret() const
+{
+    return worker_pool_ != nullptr;
+}
+
+void PythonEquationEngine::BlockingWait(const std::function<void()> &wait)
+{
+    if (Py_IsInitialized() && PyGILState_Check())
+    {
+        pybind11::gil_scoped_release release;
+        wait();
+    }
+    else
+    {
+        wait();
+    }
+}
+
+std::unique_ptr<EquationManager> PythonEquationEngine::CreateEquationManager()
+{
+    std::unique_ptr<EquationManager> manager = EquationEngine<PythonEquationEngine>::CreateEquationManager();
+    if (worker_pool_)
+    {
+        // 并行度由工作进程数决定，与本机核数无关；多一个线程留给本地回退的方程
+        manager->set_max_threads(worker_pool_->size() + 1);
+    }
+    return manager;
 }
\ No newline at end of file
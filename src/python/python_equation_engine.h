@@ -3,6 +3,7 @@
 #include "core/equation_engine.h"
 #include "python_executor.h"
 #include "python_parser.h"
+#include "python_worker_pool.h"
 #include <memory>
 #include <string>
 
@@ -20,10 +21,28 @@ class PythonEquationEngine : public EquationEngine<PythonEquationEngine>
     InterpretResult Interpret(const std::string &expr, const EquationContext *context = nullptr, InterpretMode mode = InterpretMode::kExec) override;
     ParseResult Parse(const std::string &expr, ParseMode mode = ParseMode::kExpression) override;
 
+    // 预编译为 code object，重算时跳过 compile
+    CompiledCodePtr Compile(const std::string &code, InterpretMode mode = InterpretMode::kExec) override;
+    InterpretResult Interpret(const CompiledCode &compiled, const EquationContext *context = nullptr) override;
+
     std::unique_ptr<EquationContext> CreateContext() override;
     
     // 实现基类的输出处理接口
     void SetOutputHandler(OutputHandler handler) override;
+
+    // 解析结果持久化文件，跨会话复用未改动方程的依赖分析；空路径关闭持久化
+    bool SetParseCacheFile(const std::string &path);
+
+    // 多进程求值：count 个工作进程并行执行互不依赖的 exec 方程（见 PythonWorkerPool），
+    // 0 关闭。只影响之后创建的 EquationManager，不能在更新进行中调用。启动失败返回 false 并保持关闭
+    bool SetWorkerCount(size_t count);
+    size_t worker_count() const;
+
+    // 开启工作进程后可并发 Interpret：等待工作进程时释放 GIL，本地执行时各自获取
+    bool SupportsConcurrentInterpret() const override;
+    // 调用线程通常持有 GIL，等待期间必须释放，否则工作线程无法推进
+    void BlockingWait(const std::function<void()> &wait) override;
+    std::unique_ptr<EquationManager> CreateEquationManager() override;
     
   private:
     friend class EquationEngine<PythonEquationEngine>;
@@ -34,6 +53,7 @@ class PythonEquationEngine : public EquationEngine<PythonEquationEngine>
   private:
     std::unique_ptr<PythonParser> code_parser = nullptr;
     std::unique_ptr<PythonExecutor> code_executor = nullptr;
+    std::unique_ptr<PythonWorkerPool> worker_pool_ = nullptr;
 };
 } // namespace python
 } // namespace xequation
\ No newline at end of file
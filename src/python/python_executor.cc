@@ -5,9 +5,19 @@ namespace xequation
 namespace python
 {
 
-PythonExecutor::PythonExecutor()
+namespace
 {
-    // 定义 Python 输出捕获类一次，缓存起来
+// 缓存键：源码哈希再混入模式，同一段源码的 eval/exec 编译结果分开存放
+std::uint64_t CodeCacheKey(const std::string &source, InterpretMode mode)
+{
+    std::uint64_t key = HashSource(source);
+    return mode == InterpretMode::kEval ? key ^ 0x9e3779b97f4a7c15ULL : key;
+}
+} // namespace
+
+PythonExecutor::PythonExecutor() : output_handler_(std::make_shared<OutputHandler>())
+{
+    // 定义 Python 输出捕获类并创建一个常驻实例，之后每次调用只做替换
     try
     {
         pybind11::gil_scoped_acquire acquire;
@@ -26,58 +36,144 @@ class _Output:
         pass
 )", main_dict);
         
-        output_class_ = main_dict["_Output"];
+        // 槽由 lambda 共享持有，执行器析构后残留的 Python 引用也不会悬空
+        std::shared_ptr<OutputHandler> slot = output_handler_;
+        pybind11::cpp_function write_func([slot](const std::string &msg) {
+            if (*slot)
+            {
+                (*slot)(msg);
+            }
+        });
+        output_object_ = main_dict["_Output"](write_func);
+    }
+    catch (const pybind11::error_already_set& e)
+    {
+        // 定义失败则不捕获输出，代码照常执行
+    }
+
+    try
+    {
+        pybind11::gil_scoped_acquire acquire;
+        builtins_ = pybind11::module_::import("builtins");
+        str_func_ = builtins_.attr("str");
+        compile_func_ = builtins_.attr("compile");
     }
     catch (const pybind11::error_already_set& e)
     {
-        // 定义失败，后续会再尝试
     }
 }
 
 PythonExecutor::~PythonExecutor()
 {
+    // 与 PythonParser 一致：解释器可能已先于执行器关闭，不在这里 DECREF
+    *output_handler_ = nullptr;
+    output_object_.release();
+    saved_stdout_.release();
+    saved_stderr_.release();
+    builtins_.release();
+    str_func_.release();
+    compile_func_.release();
 }
 
 void PythonExecutor::SetOutputHandler(OutputHandler handler)
 {
-    output_handler_ = handler;
+    *output_handler_ = handler;
 }
 
 void PythonExecutor::ClearOutputHandler()
 {
-    output_handler_ = nullptr;
+    *output_handler_ = nullptr;
+}
+
+bool PythonExecutor::RedirectOutput()
+{
+    // 如果设置了输出处理器，用常驻输出对象替换 stdout/stderr（借用引用，不走 import）
+    if (!*output_handler_ || !output_object_)
+    {
+        return false;
+    }
+    // 多个线程的执行会在 GIL 切换处交错：只有最外层保存并替换，最后一个退出的恢复
+    if (redirect_depth_++ == 0)
+    {
+        saved_stdout_ = pybind11::reinterpret_borrow<pybind11::object>(PySys_GetObject("stdout"));
+        saved_stderr_ = pybind11::reinterpret_borrow<pybind11::object>(PySys_GetObject("stderr"));
+        PySys_SetObject("stdout", output_object_.ptr());
+        PySys_SetObject("stderr", output_object_.ptr());
+    }
+    return true;
+}
+
+void PythonExecutor::RestoreOutput()
+{
+    if (--redirect_depth_ != 0)
+    {
+        return;
+    }
+    // 恢复原始 stdout/stderr；原先不存在时同样置回空
+    PySys_SetObject("stdout", saved_stdout_ ? saved_stdout_.ptr() : Py_None);
+    PySys_SetObject("stderr", saved_stderr_ ? saved_stderr_.ptr() : Py_None);
+    saved_stdout_ = pybind11::object();
+    saved_stderr_ = pybind11::object();
+}
+
+void PythonExecutor::WriteOutput(const std::string &text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+    pybind11::gil_scoped_acquire acquire;
+    bool redirected = RedirectOutput();
+    try
+    {
+        pybind11::module_::import("sys").attr("stdout").attr("write")(text);
+    }
+    catch (const pybind11::error_already_set &)
+    {
+    }
+    if (redirected)
+    {
+        RestoreOutput();
+    }
+}
+
+void PythonExecutor::FillError(const pybind11::error_already_set &e, InterpretResult &res) const
+{
+    res.status = MapPythonExceptionToStatus(e);
+    pybind11::object pv = e.value();
+    res.message = str_func_(pv).cast<std::string>();
+}
+
+pybind11::object PythonExecutor::EvalCodeObject(PyObject *code_object, const pybind11::dict &local_dict) const
+{
+    // 与 pybind11::exec/eval 一致：local_dict 同时作为 globals 与 locals
+    if (!local_dict.contains("__builtins__"))
+    {
+        local_dict["__builtins__"] = builtins_;
+    }
+    PyObject *result = PyEval_EvalCode(code_object, local_dict.ptr(), local_dict.ptr());
+    if (!result)
+    {
+        throw pybind11::error_already_set();
+    }
+    return pybind11::reinterpret_steal<pybind11::object>(result);
 }
 
 InterpretResult PythonExecutor::Exec(const std::string &code_string, const pybind11::dict &local_dict)
 {
     pybind11::gil_scoped_acquire acquire;
 
+    // 经缓存编译后走 code object 路径；编译失败时回到源码路径报告语法错误
+    std::shared_ptr<const PythonCompiledCode> compiled = Compile(code_string, InterpretMode::kExec);
+    if (compiled)
+    {
+        return Exec(*compiled, local_dict);
+    }
+
     InterpretResult res;
     res.mode = InterpretMode::kExec;
     
-    pybind11::object old_stdout;
-    pybind11::object old_stderr;
-    
-    // 如果设置了输出处理器，重定向 stdout/stderr
-    if (output_handler_ && output_class_)
-    {
-        try
-        {
-            pybind11::object sys_module = pybind11::module_::import("sys");
-            old_stdout = sys_module.attr("stdout");
-            old_stderr = sys_module.attr("stderr");
-            
-            pybind11::object handler_obj = pybind11::cast(output_handler_);
-            pybind11::object output_obj = output_class_(handler_obj);
-            
-            sys_module.attr("stdout") = output_obj;
-            sys_module.attr("stderr") = output_obj;
-        }
-        catch (const pybind11::error_already_set& e)
-        {
-            // 设置失败，继续执行
-        }
-    }
+    bool redirected = RedirectOutput();
     
     try
     {
@@ -86,30 +182,13 @@ InterpretResult PythonExecutor::Exec(const std::string &code_string, const pybin
     }
     catch (const pybind11::error_already_set &e)
     {
-        ResultStatus status = MapPythonExceptionToStatus(e);
-        res.status = status;
-        pybind11::object pv = e.value();
-        pybind11::object str_func = pybind11::module_::import("builtins").attr("str");
-        std::string error_msg = str_func(pv).cast<std::string>();
-        res.message = error_msg;
+        FillError(e, res);
     }
     
-    // 恢复原始 stdout/stderr
-    if (output_handler_ && output_class_)
-    {
-        try
-        {
-            pybind11::object sys_module = pybind11::module_::import("sys");
-            if (old_stdout)
-                sys_module.attr("stdout") = old_stdout;
-            if (old_stderr)
-                sys_module.attr("stderr") = old_stderr;
-        }
-        catch (const pybind11::error_already_set& e)
-        {
-        }
+    if (redirected)
+    {
+        RestoreOutput();
     }
-    
     return res;
 }
 
@@ -117,32 +196,16 @@ InterpretResult PythonExecutor::Eval(const std::string &expression, const pybind
 {
     pybind11::gil_scoped_acquire acquire;
 
+    std::shared_ptr<const PythonCompiledCode> compiled = Compile(expression, InterpretMode::kEval);
+    if (compiled)
+    {
+        return Eval(*compiled, local_dict);
+    }
+
     InterpretResult res;
     res.mode = InterpretMode::kEval;
     
-    pybind11::object old_stdout;
-    pybind11::object old_stderr;
-    
-    // 如果设置了输出处理器，重定向 stdout/stderr
-    if (output_handler_ && output_class_)
-    {
-        try
-        {
-            pybind11::object sys_module = pybind11::module_::import("sys");
-            old_stdout = sys_module.attr("stdout");
-            old_stderr = sys_module.attr("stderr");
-            
-            pybind11::object handler_obj = pybind11::cast(output_handler_);
-            pybind11::object output_obj = output_class_(handler_obj);
-            
-            sys_module.attr("stdout") = output_obj;
-            sys_module.attr("stderr") = output_obj;
-        }
-        catch (const pybind11::error_already_set& e)
-        {
-            // 设置失败，继续执行
-        }
-    }
+    bool redirected = RedirectOutput();
     
     try
     {
@@ -152,32 +215,97 @@ InterpretResult PythonExecutor::Eval(const std::string &expression, const pybind
     }
     catch (const pybind11::error_already_set &e)
     {
-        ResultStatus status = MapPythonExceptionToStatus(e);
         res.value = EquationValue::Null();
-        res.status = status;
-        pybind11::object pv = e.value();
-        pybind11::object str_func = pybind11::module_::import("builtins").attr("str");
-        std::string error_msg = str_func(pv).cast<std::string>();
-        res.message = error_msg;
+        FillError(e, res);
     }
     
-    // 恢复原始 stdout/stderr
-    if (output_handler_ && output_class_)
-    {
-        try
-        {
-            pybind11::object sys_module = pybind11::module_::import("sys");
-            if (old_stdout)
-                sys_module.attr("stdout") = old_stdout;
-            if (old_stderr)
-                sys_module.attr("stderr") = old_stderr;
-        }
-        catch (const pybind11::error_already_set& e)
-        {
-        }
+    if (redirected)
+    {
+        RestoreOutput();
+    }
+    return res;
+}
+
+std::shared_ptr<const PythonCompiledCode> PythonExecutor::Compile(const std::string &code_string, InterpretMode mode)
+{
+    pybind11::gil_scoped_acquire acquire;
+
+    // 哈希可能碰撞，命中后再比对源码与模式
+    std::uint64_t key = CodeCacheKey(code_string, mode);
+    boost::optional<std::shared_ptr<const PythonCompiledCode>> cached = code_cache_.get(key);
+    if (cached && (*cached)->mode() == mode && (*cached)->source() == code_string)
+    {
+        return *cached;
+    }
+
+    try
+    {
+        pybind11::object code_object =
+            compile_func_(code_string, "<string>", mode == InterpretMode::kEval ? "eval" : "exec");
+        std::shared_ptr<const PythonCompiledCode> compiled =
+            std::make_shared<PythonCompiledCode>(code_string, mode, PyObjectRef(code_object.release().ptr()));
+        // 语法错误不缓存；碰撞时 lru_cache 保留旧条目，本次结果只返回不入缓存
+        code_cache_.insert(key, compiled);
+        return compiled;
+    }
+    catch (const pybind11::error_already_set &e)
+    {
+        return nullptr;
+    }
+}
+
+InterpretResult PythonExecutor::Exec(const PythonCompiledCode &compiled, const pybind11::dict &local_dict)
+{
+    pybind11::gil_scoped_acquire acquire;
+
+    InterpretResult res;
+    res.mode = InterpretMode::kExec;
+
+    bool redirected = RedirectOutput();
+
+    try
+    {
+        EvalCodeObject(compiled.code_object(), local_dict);
+        res.status = ResultStatus::kSuccess;
+    }
+    catch (const pybind11::error_already_set &e)
+    {
+        FillError(e, res);
+    }
+
+    if (redirected)
+    {
+        RestoreOutput();
+    }
+    return res;
+}
+
+InterpretResult PythonExecutor::Eval(const PythonCompiledCode &compiled, const pybind11::dict &local_dict)
+{
+    pybind11::gil_scoped_acquire acquire;
+
+    InterpretResult res;
+    res.mode = InterpretMode::kEval;
+
+    bool redirected = RedirectOutput();
+
+    try
+    {
+        pybind11::object result = EvalCodeObject(compiled.code_object(), local_dict);
+        res.value = pybind11::cast<EquationValue>(result);
+        res.status = ResultStatus::kSuccess;
+    }
+    catch (const pybind11::error_already_set &e)
+    {
+        res.value = EquationValue::Null();
+        FillError(e, res);
+    }
+
+    if (redirected)
+    {
+        RestoreOutput();
     }
-    
     return res;
 }
 } // namespace python
-} // namespace xequation
\ No newline at end of file
+} // namespace xequation
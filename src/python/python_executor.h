@@ -1,10 +1,15 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <boost/compute/detail/lru_cache.hpp>
 
 #include "python_common.h"
 #include "core/equation_common.h"
+#include "core/py_object_ref.h"
 
 namespace xequation
 {
@@ -13,6 +18,19 @@ namespace python
 // 简单的输出回调类型
 using OutputHandler = std::function<void(const std::string&)>;
 
+// Python 预编译产物：builtins.compile 得到的 code object。
+// 用 PyObjectRef 持有，析构时走延迟 DECREF，可在无 GIL 的线程上释放。
+class PythonCompiledCode : public CompiledCode {
+ public:
+  PythonCompiledCode(const std::string& source, InterpretMode mode, PyObjectRef code_object)
+      : CompiledCode(source, mode), code_object_(std::move(code_object)) {}
+
+  PyObject* code_object() const { return code_object_.get(); }
+
+ private:
+  PyObjectRef code_object_;
+};
+
 class PythonExecutor {
  public:
   PythonExecutor();
@@ -33,10 +51,47 @@ class PythonExecutor {
   
   // Evaluates Python expression in the given local dictionary.
   InterpretResult Eval(const std::string& expression, const pybind11::dict& local_dict = pybind11::dict());
+
+  // 编译为 code object；语法错误返回 nullptr（由源码路径报告错误）。
+  // 结果按源码哈希缓存，相同源码与模式重复编译直接复用同一 code object。
+  std::shared_ptr<const PythonCompiledCode> Compile(const std::string& code_string, InterpretMode mode);
+
+  // 执行预编译的 code object，跳过源码编译
+  InterpretResult Exec(const PythonCompiledCode& compiled, const pybind11::dict& local_dict = pybind11::dict());
+  InterpretResult Eval(const PythonCompiledCode& compiled, const pybind11::dict& local_dict = pybind11::dict());
+
+  size_t GetCodeCacheSize() const { return code_cache_.size(); }
+
+  // 输出在别处捕获的文本（工作进程的 print 等），与本地执行走同一套重定向
+  void WriteOutput(const std::string& text);
   
  private:
-  OutputHandler output_handler_;
-  pybind11::object output_class_;  // 缓存 Python 输出类，避免重复定义
+  // 设置了输出处理器时把 sys.stdout/stderr 换成常驻的输出对象，返回是否已替换。
+  // 可嵌套（并发执行在 GIL 切换处交错），与 RestoreOutput 成对调用
+  bool RedirectOutput();
+  void RestoreOutput();
+
+  void FillError(const pybind11::error_already_set& e, InterpretResult& res) const;
+  pybind11::object EvalCodeObject(PyObject* code_object, const pybind11::dict& local_dict) const;
+
+  // 输出处理器放在共享槽里：常驻的 Python 输出对象持有同一个槽，
+  // 更换处理器只改槽内容，不必重建 Python 对象
+  std::shared_ptr<OutputHandler> output_handler_;
+  pybind11::object output_object_;  // 常驻的 _Output 实例，构造时创建一次
+  // 最外层重定向前的 stdout/stderr 及嵌套深度，均在 GIL 内访问
+  pybind11::object saved_stdout_;
+  pybind11::object saved_stderr_;
+  int redirect_depth_ = 0;
+
+  // 预先导入的常用对象，避免每次调用都 import
+  pybind11::object builtins_;
+  pybind11::object str_func_;
+  pybind11::object compile_func_;
+
+  // code object 缓存，键为源码哈希与模式的组合；所有访问都在 GIL 内，无需额外加锁
+  static constexpr size_t max_code_cache_size_ = 1024;
+  boost::compute::detail::lru_cache<std::uint64_t, std::shared_ptr<const PythonCompiledCode>> code_cache_{
+      max_code_cache_size_};
 };
 } // namespace python
 } // namespace xequation
\ No newline at end of file
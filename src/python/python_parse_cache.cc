@@ -0,0 +1,401 @@
+#include "python_parse_cache.h"
+#include "python_common.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace xequation
+{
+namespace python
+{
+
+namespace
+{
+const char kMagic[4] = {'X', 'P', 'C', '\0'};
+const size_t kHeaderSize = 16;
+const size_t kRecordHeaderSize = 16;
+
+std::uint64_t CacheKey(PythonParseCache::Kind kind, const std::string &source)
+{
+    return HashSource(source) + (static_cast<std::uint64_t>(kind) + 1) * 0x9e3779b97f4a7c15ULL;
+}
+
+std::uint32_t Checksum(const char *data, size_t size)
+{
+    return static_cast<std::uint32_t>(HashSource(data, size));
+}
+
+template <typename T>
+void PutPod(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void PutString(std::string &out, const std::string &s)
+{
+    PutPod(out, static_cast<std::uint32_t>(s.size()));
+    out.append(s);
+}
+
+// 映射区上的顺序读取，越界即失败，不抛异常
+struct Reader
+{
+    const char *p;
+    const char *end;
+
+    template <typename T>
+    bool Pod(T &value)
+    {
+        if (static_cast<size_t>(end - p) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    bool String(std::string &s)
+    {
+        std::uint32_t size = 0;
+        if (!Pod(size) || static_cast<size_t>(end - p) < size)
+        {
+            return false;
+        }
+        s.assign(p, size);
+        p += size;
+        return true;
+    }
+};
+
+std::string EncodePayload(const std::string &source, const ParseResult &result)
+{
+    std::string out;
+    PutString(out, source);
+    PutPod(out, static_cast<std::uint8_t>(result.mode));
+    PutPod(out, static_cast<std::uint32_t>(result.items.size()));
+    for (const auto &item : result.items)
+    {
+        PutString(out, item.name);
+        PutString(out, item.content);
+        PutPod(out, static_cast<std::uint8_t>(item.type));
+        PutPod(out, static_cast<std::uint32_t>(item.dependencies.size()));
+        for (const auto &dep : item.dependencies)
+        {
+            PutString(out, dep);
+        }
+        PutString(out, item.message);
+        PutPod(out, static_cast<std::uint8_t>(item.status));
+    }
+    return out;
+}
+
+bool DecodePayload(Reader &in, std::string &source, ParseResult &result)
+{
+    std::uint8_t mode = 0;
+    std::uint32_t count = 0;
+    if (!in.String(source) || !in.Pod(mode) || !in.Pod(count))
+    {
+        return false;
+    }
+    result.mode = static_cast<ParseMode>(mode);
+    result.items.clear();
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        ParseResultItem item;
+        std::uint8_t type = 0;
+        std::uint8_t status = 0;
+        std::uint32_t dep_count = 0;
+        if (!in.String(item.name) || !in.String(item.content) || !in.Pod(type) || !in.Pod(dep_count))
+        {
+            return false;
+        }
+        for (std::uint32_t j = 0; j < dep_count; ++j)
+        {
+            std::string dep;
+            if (!in.String(dep))
+            {
+                return false;
+            }
+            item.dependencies.push_back(std::move(dep));
+        }
+        if (!in.String(item.message) || !in.Pod(status))
+        {
+            return false;
+        }
+        item.type = static_cast<ItemType>(type);
+        item.status = static_cast<ResultStatus>(status);
+        result.items.push_back(std::move(item));
+    }
+    return in.p == in.end;
+}
+} // namespace
+
+class PythonParseCache::Mapping
+{
+  public:
+    explicit Mapping(const std::string &path)
+        : file_(path.c_str(), boost::interprocess::read_only), region_(file_, boost::interprocess::read_only)
+    {
+    }
+
+    const char *data() const
+    {
+        return static_cast<const char *>(region_.get_address());
+    }
+
+    size_t size() const
+    {
+        return region_.get_size();
+    }
+
+  private:
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+};
+
+PythonParseCache::PythonParseCache(std::uint64_t parser_version, size_t capacity)
+    : parser_version_(parser_version), entries_(capacity)
+{
+}
+
+PythonParseCache::~PythonParseCache() = default;
+
+bool PythonParseCache::Open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    mapping_.reset();
+    index_.clear();
+    file_size_ = 0;
+    path_ = path;
+    if (path_.empty())
+    {
+        return true;
+    }
+
+    if ((MapFile() || Reset()) && OpenAppend())
+    {
+        return true;
+    }
+    mapping_.reset();
+    index_.clear();
+    path_.clear();
+    return false;
+}
+
+void PythonParseCache::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    append_.close();
+    mapping_.reset();
+    index_.clear();
+    file_size_ = 0;
+    path_.clear();
+}
+
+bool PythonParseCache::Get(Kind kind, const std::string &source, ParseResult &result)
+{
+    std::uint64_t key = CacheKey(kind, source);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto cached = entries_.get(key);
+    if (cached && cached->source == source)
+    {
+        result = cached->result;
+        return true;
+    }
+
+    auto it = index_.find(key);
+    if (it == index_.end())
+    {
+        return false;
+    }
+    Entry entry;
+    if (!DecodeRecord(it->second, entry) || entry.source != source)
+    {
+        return false;
+    }
+    result = entry.result;
+    entries_.insert(key, std::move(entry));
+    return true;
+}
+
+void PythonParseCache::Put(Kind kind, const std::string &source, const ParseResult &result)
+{
+    std::uint64_t key = CacheKey(kind, source);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // lru_cache 不覆盖已有 key：哈希碰撞时保留旧条目，Get 比对源码后按未命中处理
+    entries_.insert(key, Entry{source, result});
+    if (path_.empty())
+    {
+        return;
+    }
+
+    std::string payload = EncodePayload(source, result);
+    std::string record;
+    record.reserve(kRecordHeaderSize + payload.size());
+    PutPod(record, key);
+    PutPod(record, static_cast<std::uint32_t>(payload.size()));
+    PutPod(record, Checksum(payload.data(), payload.size()));
+    record.append(payload);
+
+    // 超过上限就整体重建，已解码的条目仍留在内存
+    if (file_size_ + record.size() > kMaxFileBytes && !(Reset() && OpenAppend()))
+    {
+        append_.close();
+        path_.clear();
+        return;
+    }
+
+    // 新追加的记录不进索引（不在当前映射内），本次会话由内存 LRU 提供，下次打开时可见
+    append_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    append_.flush();
+    if (!append_)
+    {
+        // 写失败后文件尾可能残缺，停止持久化；下次打开时截掉残缺记录
+        append_.close();
+        path_.clear();
+        return;
+    }
+    file_size_ += record.size();
+}
+
+size_t PythonParseCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t PythonParseCache::persisted_size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+bool PythonParseCache::Reset()
+{
+    mapping_.reset();
+    index_.clear();
+    file_size_ = 0;
+
+    std::string header(kMagic, sizeof(kMagic));
+    PutPod(header, kFormatVersion);
+    PutPod(header, parser_version_);
+    if (!ReplaceFile(header.data(), header.size()))
+    {
+        return false;
+    }
+    file_size_ = kHeaderSize;
+    return true;
+}
+
+bool PythonParseCache::ReplaceFile(const char *data, size_t size)
+{
+    // 先写临时文件再替换：其他进程可能仍映射着旧文件，原地截断会让它们读到失效页
+    append_.close();
+    std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream out(temp_path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(data, static_cast<std::streamsize>(size));
+        if (!out)
+        {
+            return false;
+        }
+    }
+    if (std::rename(temp_path.c_str(), path_.c_str()) != 0)
+    {
+        // Windows 上 rename 不覆盖已存在的文件
+        std::remove(path_.c_str());
+        if (std::rename(temp_path.c_str(), path_.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PythonParseCache::OpenAppend()
+{
+    append_.close();
+    append_.clear();
+    append_.open(path_.c_str(), std::ios::binary | std::ios::app);
+    return append_.is_open();
+}
+
+bool PythonParseCache::MapFile()
+{
+    try
+    {
+        mapping_.reset(new Mapping(path_));
+    }
+    catch (const boost::interprocess::interprocess_exception &)
+    {
+        return false;
+    }
+
+    const char *data = mapping_->data();
+    size_t size = mapping_->size();
+    std::uint32_t format_version = 0;
+    std::uint64_t parser_version = 0;
+    Reader header{data, data + size};
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+    {
+        mapping_.reset();
+        return false;
+    }
+    header.p += sizeof(kMagic);
+    header.Pod(format_version);
+    header.Pod(parser_version);
+    if (format_version != kFormatVersion || parser_version != parser_version_)
+    {
+        mapping_.reset();
+        return false;
+    }
+
+    // 只走记录头建索引；尾部不完整（写入中断）时截到最后一条完整记录，之前的记录照常可用
+    size_t offset = kHeaderSize;
+    while (offset < size)
+    {
+        Reader record{data + offset, data + size};
+        std::uint64_t key = 0;
+        std::uint32_t payload_size = 0;
+        std::uint32_t checksum = 0;
+        if (!record.Pod(key) || !record.Pod(payload_size) || !record.Pod(checksum) ||
+            static_cast<size_t>(record.end - record.p) < payload_size)
+        {
+            std::string complete(data, offset);
+            mapping_.reset();
+            index_.clear();
+            return ReplaceFile(complete.data(), complete.size()) && MapFile();
+        }
+        index_[key] = offset;
+        offset += kRecordHeaderSize + payload_size;
+    }
+    file_size_ = size;
+    return true;
+}
+
+bool PythonParseCache::DecodeRecord(size_t offset, Entry &entry) const
+{
+    const char *data = mapping_->data();
+    Reader record{data + offset, data + mapping_->size()};
+    std::uint64_t key = 0;
+    std::uint32_t payload_size = 0;
+    std::uint32_t checksum = 0;
+    record.Pod(key);
+    record.Pod(payload_size);
+    record.Pod(checksum);
+    if (Checksum(record.p, payload_size) != checksum)
+    {
+        return false;
+    }
+    Reader payload{record.p, record.p + payload_size};
+    return DecodePayload(payload, entry.source, entry.result);
+}
+
+} // namespace python
+} // namespace xequation
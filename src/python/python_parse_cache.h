@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <boost/compute/detail/lru_cache.hpp>
+
+#include "core/equation_common.h"
+
+namespace xequation
+{
+namespace python
+{
+
+// PythonParser 的解析结果缓存：按源码哈希存取，可选持久化到本地文件。
+//
+// 文件布局（本机字节序，仅供本机复用）：
+//   header:  "XPC\0" | u32 格式版本 | u64 解析器版本
+//   record:  u64 key | u32 payload 长度 | u32 payload 校验和 | payload
+//   payload: str 源码 | u8 ParseMode | u32 条目数 | 条目...
+//   条目:    str name | str content | u8 ItemType | u32 依赖数 | str... | str message | u8 ResultStatus
+//   str:     u32 长度 + 字节
+//
+// 打开时映射整个文件，只遍历记录头建立 key -> 偏移 的索引，命中时才解码；
+// 新结果经常开的追加句柄写到文件末尾，同一 key 以最后一条为准。尾部记录不完整
+// （写入中断）时截掉残缺部分、保留之前的完整记录；解析器版本或格式不符、
+// 文件头损坏或超过大小上限时整体重建。内存里另有一个有界 LRU 存放已解码结果。
+class PythonParseCache
+{
+  public:
+    // 同一段源码在不同解析入口下结果不同，分开存放
+    enum class Kind : std::uint8_t
+    {
+        kStatement,
+        kStatements,
+        kExpression,
+    };
+
+    PythonParseCache(std::uint64_t parser_version, size_t capacity);
+    ~PythonParseCache();
+
+    PythonParseCache(const PythonParseCache &) = delete;
+    PythonParseCache &operator=(const PythonParseCache &) = delete;
+
+    // 绑定持久化文件（不存在则创建）；空路径表示只用内存。失败返回 false，缓存仍可在内存中使用。
+    bool Open(const std::string &path);
+    void Close();
+
+    bool Get(Kind kind, const std::string &source, ParseResult &result);
+    void Put(Kind kind, const std::string &source, const ParseResult &result);
+
+    // 内存中已解码的条目数
+    size_t size() const;
+    // 文件索引中的条目数
+    size_t persisted_size() const;
+
+    static constexpr std::uint32_t kFormatVersion = 1;
+    static constexpr std::uint64_t kMaxFileBytes = 64ull << 20;
+
+  private:
+    struct Entry
+    {
+        std::string source;
+        ParseResult result;
+    };
+
+    bool Reset();
+    bool MapFile();
+    // 以 contents 原子替换缓存文件（先写临时文件再改名）
+    bool ReplaceFile(const char *data, size_t size);
+    bool OpenAppend();
+    bool DecodeRecord(size_t offset, Entry &entry) const;
+
+    class Mapping;
+
+    std::uint64_t parser_version_;
+    mutable std::mutex mutex_;
+    boost::compute::detail::lru_cache<std::uint64_t, Entry> entries_;
+    std::string path_;
+    std::unique_ptr<Mapping> mapping_;
+    std::unordered_map<std::uint64_t, size_t> index_;  // key -> 映射区内记录偏移
+    std::ofstream append_;
+    std::uint64_t file_size_ = 0;
+};
+
+} // namespace python
+} // namespace xequation
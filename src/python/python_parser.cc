@@ -29,6 +29,12 @@ PythonParser::~PythonParser()
     parser_.release();
 }
 
+std::uint64_t PythonParser::ParserVersion()
+{
+    // 内嵌解析器源码与 Python 版本任一变化，已持久化的结果都作废
+    return HashSource(std::string(kPythonParserSource) + PY_VERSION);
+}
+
 std::vector<std::string> PythonParser::SplitStatements(const std::string &code)
 {
     pybind11::gil_scoped_acquire acquire;
@@ -55,17 +61,23 @@ std::vector<std::string> PythonParser::SplitStatements(const std::string &code)
 
 ParseResult PythonParser::ParseStatements(const std::string &code)
 {
+    ParseResult result;
+    if (source_cache_.Get(PythonParseCache::Kind::kStatements, code, result))
+    {
+        return result;
+    }
+
     pybind11::gil_scoped_acquire acquire;
     try
     {
         std::vector<std::string> statements = SplitStatements(code);
-        ParseResult result;
         result.mode = ParseMode::kStatement;
         for (const auto &stmt_code : statements)
         {
             ParseResult stmt_results = ParseSingleStatement(stmt_code);
             result.items.insert(result.items.end(), stmt_results.items.begin(), stmt_results.items.end());
         }
+        source_cache_.Put(PythonParseCache::Kind::kStatements, code, result);
         return result;
     }
     catch (const pybind11::error_already_set &e)
@@ -79,6 +91,12 @@ ParseResult PythonParser::ParseStatements(const std::string &code)
 
 ParseResult PythonParser::ParseSingleStatement(const std::string &code)
 {
+    ParseResult result;
+    if (source_cache_.Get(PythonParseCache::Kind::kStatement, code, result))
+    {
+        return result;
+    }
+
     pybind11::gil_scoped_acquire acquire;
     try
     {
@@ -87,12 +105,12 @@ ParseResult PythonParser::ParseSingleStatement(const std::string &code)
         auto cached_result = parse_result_cache_.get(code_hash);
         if (cached_result)
         {
+            source_cache_.Put(PythonParseCache::Kind::kStatement, code, *cached_result);
             return *cached_result;
         }
 
         pybind11::list py_parse_result = parser_.attr("parse_single_statement")(code);
 
-        ParseResult result;
         result.mode = ParseMode::kStatement;
         for (const auto &item : py_parse_result)
         {
@@ -115,6 +133,7 @@ ParseResult PythonParser::ParseSingleStatement(const std::string &code)
         }
 
         parse_result_cache_.insert(code_hash, result);
+        source_cache_.Put(PythonParseCache::Kind::kStatement, code, result);
 
         return result;
     }
@@ -129,12 +148,17 @@ ParseResult PythonParser::ParseSingleStatement(const std::string &code)
 
 ParseResult PythonParser::ParseExpression(const std::string &code)
 {
+    ParseResult parse_result;
+    if (source_cache_.Get(PythonParseCache::Kind::kExpression, code, parse_result))
+    {
+        return parse_result;
+    }
+
     pybind11::gil_scoped_acquire acquire;
     try
     {
         pybind11::list py_parse_result = parser_.attr("parse_expression_dependencies")(code);
 
-        ParseResult parse_result;
         parse_result.mode = ParseMode::kExpression;
         ParseResultItem parse_item;
         parse_item.name = "__expression__";
@@ -146,6 +170,7 @@ ParseResult PythonParser::ParseExpression(const std::string &code)
             parse_item.dependencies.push_back(item.cast<std::string>());
         }
         parse_result.items.push_back(parse_item);
+        source_cache_.Put(PythonParseCache::Kind::kExpression, code, parse_result);
         return parse_result;
     }
     catch (const pybind11::error_already_set &e)
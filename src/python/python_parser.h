@@ -4,6 +4,7 @@
 #include <boost/compute/detail/lru_cache.hpp>
 
 #include "python_common.h"
+#include "python_parse_cache.h"
 #include "core/equation_common.h"
 
 namespace xequation
@@ -26,12 +27,20 @@ class PythonParser
     ParseResult ParseSingleStatement(const std::string &code);
     size_t GetParseResultCacheSize() const { return parse_result_cache_.size(); }
 
+    // 把按源码哈希的结果缓存持久化到 path（空路径关闭持久化）。
+    // 解析器或 Python 版本变化时文件自动失效重建。
+    bool SetCacheFile(const std::string &path) { return source_cache_.Open(path); }
+
   private:
     void EvictLRU();
+    static std::uint64_t ParserVersion();
 
   private:
     pybind11::object parser_;
-    static constexpr size_t max_cache_size_ = 50;
+    static constexpr size_t max_cache_size_ = 4096;
+    // 第一层：按源码文本哈希，命中时完全不进 Python
+    PythonParseCache source_cache_{ParserVersion(), max_cache_size_};
+    // 第二层：按 AST 哈希（compute_code_hash），仅格式不同的源码共用结果
     boost::compute::detail::lru_cache<std::string, ParseResult> parse_result_cache_{max_cache_size_};
 };
 } // namespace python
@@ -0,0 +1,97 @@
+#include "python_worker_pool.h"
+#include "python_worker_pool_embedded.h"
+#include <pybind11/gil.h>
+#include <stdexcept>
+
+namespace xequation
+{
+namespace python
+{
+
+PythonWorkerPool::PythonWorkerPool(size_t worker_count, size_t shm_threshold)
+{
+    pybind11::gil_scoped_acquire acquire;
+    try
+    {
+        // 在独立的命名空间里加载，不污染 __main__；__name__ 不是 "__main__"，不会进入工作进程的主循环
+        pybind11::dict scope;
+        scope["__name__"] = "_xequation_worker_pool";
+        pybind11::exec(kPythonWorkerPoolSource, scope);
+        pool_ = scope["WorkerPool"](worker_count, kPythonWorkerPoolSource, shm_threshold);
+        size_ = pool_.attr("size")().cast<size_t>();
+    }
+    catch (const pybind11::error_already_set &e)
+    {
+        throw std::runtime_error(std::string("failed to start Python worker processes: ") + e.what());
+    }
+}
+
+PythonWorkerPool::~PythonWorkerPool()
+{
+    if (Py_IsInitialized() && pool_)
+    {
+        pybind11::gil_scoped_acquire acquire;
+        try
+        {
+            pool_.attr("close")();
+        }
+        catch (const pybind11::error_already_set &)
+        {
+        }
+        pool_ = pybind11::object();
+    }
+    // 解释器已终止时对象随之消失，不再 DECREF
+    pool_.release();
+}
+
+bool PythonWorkerPool::Run(const PythonCompiledCode &compiled, const pybind11::dict &local_dict,
+                           InterpretResult &result, std::string &output)
+{
+    if (compiled.mode() != InterpretMode::kExec || !compiled.code_object())
+    {
+        return false;
+    }
+
+    pybind11::gil_scoped_acquire acquire;
+    pybind11::object reply;
+    try
+    {
+        reply = pool_.attr("run")(pybind11::handle(compiled.code_object()), local_dict);
+    }
+    catch (const pybind11::error_already_set &e)
+    {
+        if (e.matches(PyExc_KeyboardInterrupt))
+        {
+            // 任务被取消：忙碌的 worker 已被终止并替换，不再回退到本地执行
+            result.mode = InterpretMode::kExec;
+            result.status = MapPythonExceptionToStatus(e);
+            result.message = pybind11::str(e.value()).cast<std::string>();
+            output.clear();
+            return true;
+        }
+        // 池自身出错（编码等意外情况）时同样交给本地执行，错误由本地执行给出
+        return false;
+    }
+    if (reply.is_none())
+    {
+        return false;
+    }
+
+    pybind11::tuple fields = reply.cast<pybind11::tuple>();
+    std::string type_name = fields[0].cast<std::string>();
+    result.mode = InterpretMode::kExec;
+    if (type_name.empty())
+    {
+        result.status = ResultStatus::kSuccess;
+    }
+    else
+    {
+        result.status = MapPythonExceptionNameToStatus(type_name);
+        result.message = fields[1].cast<std::string>();
+    }
+    output = fields[2].cast<std::string>();
+    return true;
+}
+
+} // namespace python
+} // namespace xequation
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "python_common.h"
+#include "python_executor.h"
+#include "core/equation_common.h"
+
+namespace xequation
+{
+namespace python
+{
+
+// 多进程求值后端：一组独立的 Python 工作进程（各自一个解释器与 GIL），
+// 宿主线程把 exec 模式的 code object 连同它读取的变量发给空闲进程执行，
+// 再把新绑定的变量写回上下文。逻辑在 python_worker_pool.py 中实现。
+//
+// - 变量按快照传递：模块按名字、非 object 的 numpy 数组（不小于 shm_threshold 字节）
+//   经共享内存、其余走 pickle；工作进程对输入的原地修改不会写回。
+// - 输入或结果无法跨进程（用户函数、类、打开的文件等），或工作进程异常退出时 Run 返回 false，
+//   由调用方本地执行；无法传递的 code object 之后不再尝试。
+// - 工作进程以独立解释器启动（不 fork 宿主），sys.path 与宿主一致。
+class PythonWorkerPool
+{
+  public:
+    // 启动 worker_count 个工作进程；找不到可用的 Python 可执行文件或启动失败时抛 std::runtime_error
+    explicit PythonWorkerPool(size_t worker_count, size_t shm_threshold = kDefaultShmThreshold);
+    ~PythonWorkerPool();
+
+    PythonWorkerPool(const PythonWorkerPool &) = delete;
+    PythonWorkerPool &operator=(const PythonWorkerPool &) = delete;
+
+    // 在工作进程中执行 exec 模式的 compiled，结果写回 local_dict。
+    // 返回 false 表示需本地执行（local_dict 未改动）；否则 result 为执行结果，
+    // output 为工作进程中捕获的 stdout/stderr。可在多个线程上同时调用，等待期间释放 GIL。
+    bool Run(const PythonCompiledCode &compiled, const pybind11::dict &local_dict, InterpretResult &result,
+             std::string &output);
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    static constexpr size_t kDefaultShmThreshold = 64 * 1024;
+
+  private:
+    pybind11::object pool_;
+    size_t size_ = 0;
+};
+
+} // namespace python
+} // namespace xequation
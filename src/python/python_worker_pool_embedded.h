@@ -0,0 +1,420 @@
+#pragma once
+// python_worker_pool.py -- 内嵌为 C++ raw string，运行时用 pybind11::exec 加载，
+// 同一份源码也作为工作进程的 -c 脚本。
+// 与 python_worker_pool.py 保持同步；编辑请改 python_worker_pool.py 后重新生成。
+static const char kPythonWorkerPoolSource[] = R"PYSRC(import builtins
+import dis
+import importlib
+import io
+import marshal
+import mmap
+import os
+import pickle
+import queue
+import secrets
+import select
+import subprocess
+import sys
+import time
+import types
+import weakref
+
+# Waits in the main process wake up this often, so that an exception
+# raised asynchronously in the waiting thread (cancellation from the host
+# through PyThreadState_SetAsyncExc) is delivered within this delay. A
+# blocking pipe read or lock acquire would never let it through.
+_POLL_SECONDS = 0.05
+
+
+class Untransferable(Exception):
+    """A value that cannot be sent to (or received from) a worker process."""
+
+
+def _python_executable():
+    """Locate a standalone Python interpreter for the worker processes.
+
+    In an embedded host sys.executable is the host program itself, so the
+    interpreter is looked up under the installation prefix first.
+    """
+    prefix = sys.base_exec_prefix
+    if os.name == "nt":
+        candidates = [os.path.join(prefix, "python.exe")]
+    else:
+        version = "python%d.%d" % sys.version_info[:2]
+        candidates = [
+            os.path.join(prefix, "bin", version),
+            os.path.join(prefix, "bin", "python3"),
+        ]
+    if sys.executable and os.path.basename(sys.executable).lower().startswith("python"):
+        candidates.append(sys.executable)
+    for candidate in candidates:
+        if os.path.isfile(candidate) and os.access(candidate, os.X_OK):
+            return candidate
+    return None
+
+
+class _Segment:
+    """A named shared memory block.
+
+    multiprocessing.shared_memory is not used: its resource tracker starts a
+    helper process through sys.executable, which in an embedded host is the
+    host program. Whoever creates a segment unlinks it.
+    """
+
+    def __init__(self, size, name=None):
+        create = name is None
+        if create:
+            name = "xeq_%d_%s" % (os.getpid(), secrets.token_hex(8))
+        self.name = name
+        if os.name == "nt":
+            self._mmap = mmap.mmap(-1, size, tagname=name)
+        else:
+            import _posixshmem
+            flags = os.O_RDWR | (os.O_CREAT | os.O_EXCL if create else 0)
+            fd = _posixshmem.shm_open("/" + name, flags, mode=0o600)
+            try:
+                if create:
+                    os.ftruncate(fd, size)
+                self._mmap = mmap.mmap(fd, size)
+            except OSError:
+                if create:
+                    self.unlink()
+                raise
+            finally:
+                os.close(fd)
+        self.buf = memoryview(self._mmap)
+
+    def close(self):
+        """Unmap; raises BufferError while an array still uses the block."""
+        if self.buf is not None:
+            self.buf.release()
+            self.buf = None
+        self._mmap.close()
+
+    def unlink(self):
+        if os.name != "nt":
+            import _posixshmem
+            try:
+                _posixshmem.shm_unlink("/" + self.name)
+            except FileNotFoundError:
+                pass
+
+
+def _loaded_names(code, names=None):
+    """Collect the global names read by a code object and its nested code."""
+    if names is None:
+        names = set()
+    for instruction in dis.get_instructions(code):
+        if instruction.opname in ("LOAD_NAME", "LOAD_GLOBAL", "LOAD_FROM_DICT_OR_GLOBALS"):
+            names.add(instruction.argval)
+    for const in code.co_consts:
+        if isinstance(const, types.CodeType):
+            _loaded_names(const, names)
+    return names
+
+
+def _encode(value, segments, threshold):
+    """Encode a value for the pipe.
+
+    Modules travel by name, large numeric numpy arrays through a new shared
+    memory segment (appended to segments), everything else by pickle.
+    """
+    if isinstance(value, types.ModuleType):
+        return ("module", value.__name__)
+    np = sys.modules.get("numpy")
+    if (np is not None and type(value) is np.ndarray and not value.dtype.hasobject
+            and value.nbytes > 0 and value.nbytes >= threshold):
+        segment = _Segment(value.nbytes)
+        segments.append(segment)
+        np.ndarray(value.shape, value.dtype, buffer=segment.buf)[...] = value
+        return ("ndarray", segment.name, value.nbytes, value.dtype, value.shape)
+    try:
+        return ("pickle", pickle.dumps(value, pickle.HIGHEST_PROTOCOL))
+    except Exception as e:
+        raise Untransferable("%s: %s" % (type(value).__name__, e))
+
+
+def _decode(item, segments):
+    """Decode an encoded value; arrays are views on the attached segment."""
+    kind = item[0]
+    if kind == "module":
+        return importlib.import_module(item[1])
+    if kind == "ndarray":
+        np = importlib.import_module("numpy")
+        segment = _Segment(item[2], item[1])
+        segments.append(segment)
+        return np.ndarray(item[4], item[3], buffer=segment.buf)
+    return pickle.loads(item[1])
+
+
+def _take(item):
+    """Decode a worker result into memory owned by this process."""
+    if item[0] != "ndarray":
+        return _decode(item, [])
+    segments = []
+    try:
+        view = _decode(item, segments)
+        value = view.copy()
+        del view
+        return value
+    finally:
+        _close(segments, unlink=True)
+
+
+def _close(segments, unlink=False):
+    for segment in segments:
+        try:
+            segment.close()
+        except BufferError:
+            # An array still references the segment; the mapping goes with it.
+            pass
+        if unlink:
+            segment.unlink()
+    del segments[:]
+
+
+# ---------------------------------------------------------------------------
+# Worker process side
+# ---------------------------------------------------------------------------
+
+def _run(code_bytes, inputs, threshold, results):
+    attached = []
+    output = io.StringIO()
+    saved = sys.stdout, sys.stderr
+    sys.stdout = sys.stderr = output
+    namespace = {"__builtins__": builtins}
+    values = {}
+    try:
+        for name, item in inputs.items():
+            values[name] = namespace[name] = _decode(item, attached)
+        try:
+            exec(marshal.loads(code_bytes), namespace)
+        except Exception as e:
+            return ("error", type(e).__name__, str(e), output.getvalue())
+
+        # New bindings (and rebound inputs) are the results. In-place changes
+        # to an input are not sent back: inputs are snapshots.
+        outputs = {}
+        try:
+            for name, value in namespace.items():
+                if name == "__builtins__" or (name in values and values[name] is value):
+                    continue
+                outputs[name] = _encode(value, results, threshold)
+        except Untransferable as e:
+            _close(results, unlink=True)
+            return ("local", str(e))
+        return ("ok", outputs, output.getvalue())
+    finally:
+        sys.stdout, sys.stderr = saved
+        namespace.clear()
+        values.clear()
+        _close(attached)
+
+
+def _serve():
+    # The pipe to the main process is the original stdout; fd 1 itself now
+    # points at stderr so stray writes cannot corrupt the stream.
+    reader = sys.stdin.buffer
+    writer = os.fdopen(os.dup(sys.stdout.fileno()), "wb")
+    os.dup2(sys.stderr.fileno(), sys.stdout.fileno())
+    sys.path[:], threshold = pickle.load(reader)
+
+    # Result segments stay open until the next request: by then the main
+    # process has copied them out (on Windows a segment dies with its last
+    # handle).
+    results = []
+    while True:
+        try:
+            message = pickle.load(reader)
+        except (EOFError, OSError, pickle.UnpicklingError):
+            break
+        _close(results)
+        if message[0] != "run":
+            break
+        pickle.dump(_run(message[1], message[2], threshold, results), writer, pickle.HIGHEST_PROTOCOL)
+        writer.flush()
+    _close(results, unlink=True)
+
+
+# ---------------------------------------------------------------------------
+# Main process side
+# ---------------------------------------------------------------------------
+
+class _Worker:
+    """One worker process; the pipes carry pickled messages."""
+
+    def __init__(self, executable, source, threshold):
+        self.process = subprocess.Popen(
+            [executable, "-c", source],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            creationflags=getattr(subprocess, "CREATE_NO_WINDOW", 0))
+        self.send((list(sys.path), threshold))
+
+    def send(self, message):
+        pickle.dump(message, self.process.stdin, pickle.HIGHEST_PROTOCOL)
+        self.process.stdin.flush()
+
+    def recv(self):
+        """Wait for the reply to the last request, polling the pipe."""
+        if os.name == "nt":
+            import msvcrt
+            import _winapi
+            handle = msvcrt.get_osfhandle(self.process.stdout.fileno())
+            while not _winapi.PeekNamedPipe(handle, 0)[0]:
+                time.sleep(_POLL_SECONDS)
+        else:
+            while not select.select([self.process.stdout], [], [], _POLL_SECONDS)[0]:
+                pass
+        return pickle.load(self.process.stdout)
+
+    def kill(self):
+        """Terminate a busy worker; its pipes are closed."""
+        try:
+            self.process.kill()
+        except OSError:
+            pass
+        self.process.wait()
+        for pipe in (self.process.stdin, self.process.stdout):
+            try:
+                pipe.close()
+            except OSError:
+                pass
+
+    def stop(self):
+        try:
+            self.send(("stop",))
+            self.process.stdin.close()
+        except OSError:
+            pass
+
+    def wait(self):
+        try:
+            self.process.wait(1.0)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        self.process.stdout.close()
+
+
+class WorkerPool:
+    """A fixed set of worker processes evaluating exec-mode code.
+
+    run() may be called from several threads at once; it releases the GIL
+    while waiting for an idle worker and for its reply.
+    """
+
+    def __init__(self, size, source, threshold):
+        self._executable = _python_executable()
+        if self._executable is None:
+            raise RuntimeError("no Python executable found for worker processes")
+        self._source = source
+        self._threshold = threshold
+        self._idle = queue.Queue()
+        self._workers = []
+        # Keyed weakly: code objects are replaced whenever an equation changes.
+        self._names = weakref.WeakKeyDictionary()
+        self._local_only = weakref.WeakSet()
+        try:
+            for _ in range(size):
+                worker = _Worker(self._executable, source, threshold)
+                self._workers.append(worker)
+                self._idle.put(worker)
+        except Exception:
+            self.close()
+            raise
+
+    def size(self):
+        return len(self._workers)
+
+    def run(self, code, namespace):
+        """Execute code in a worker and bind its results into namespace.
+
+        Returns None when the code must run locally instead (inputs or
+        results cannot cross processes, or the worker died); otherwise
+        (error type name or "", message, captured output). An exception
+        raised in the waiting thread (KeyboardInterrupt on cancel)
+        propagates; a worker busy with the request is killed and replaced.
+        """
+        if code in self._local_only:
+            return None
+        names = self._names.get(code)
+        if names is None:
+            names = self._names[code] = _loaded_names(code)
+
+        segments = []
+        try:
+            inputs = {}
+            for name in names:
+                if name in namespace and name != "__builtins__":
+                    inputs[name] = _encode(namespace[name], segments, self._threshold)
+            request = ("run", marshal.dumps(code), inputs)
+        except Untransferable:
+            _close(segments, unlink=True)
+            self._local_only.add(code)
+            return None
+
+        try:
+            worker = self._take_idle()
+        except BaseException:
+            _close(segments, unlink=True)
+            raise
+        try:
+            try:
+                worker.send(request)
+                reply = worker.recv()
+            except (EOFError, OSError, pickle.UnpicklingError):
+                worker = self._replace(worker)
+                return None
+            except BaseException:
+                # Cancelled while the worker is busy: the code running there
+                # cannot be interrupted, so the process is killed and replaced.
+                worker = self._replace(worker, kill=True)
+                raise
+            finally:
+                _close(segments, unlink=True)
+
+            if reply[0] == "local":
+                self._local_only.add(code)
+                return None
+            if reply[0] == "error":
+                return (reply[1], reply[2], reply[3])
+            values = {}
+            for name, item in reply[1].items():
+                values[name] = _take(item)
+        finally:
+            self._idle.put(worker)
+        namespace.update(values)
+        return ("", "", reply[2])
+
+    def _take_idle(self):
+        while True:
+            try:
+                return self._idle.get(timeout=_POLL_SECONDS)
+            except queue.Empty:
+                pass
+
+    def _replace(self, worker, kill=False):
+        if kill:
+            worker.kill()
+        else:
+            worker.stop()
+            worker.wait()
+        try:
+            fresh = _Worker(self._executable, self._source, self._threshold)
+        except Exception:
+            # Keep the dead one; the next request retries the restart.
+            return worker
+        self._workers[self._workers.index(worker)] = fresh
+        return fresh
+
+    def close(self):
+        for worker in self._workers:
+            worker.stop()
+        for worker in self._workers:
+            worker.wait()
+        self._workers = []
+
+
+if __name__ == "__main__":
+    _serve())PYSRC";
@@ -1,10 +1,13 @@
 #pragma once
 #include <pybind11/pybind11.h>
 #include <pybind11/pytypes.h>
+#include <climits>
+#include <complex>
 #include <string>
 #include <vector>
 
 #include "core/equation_value.h"
+#include "python/python_buffer.h"
 
 namespace xequation
 {
@@ -46,6 +49,8 @@ inline void FlushPendingDecrefs()
         Py_DECREF(p);
     }
     q.clear();
+    // 借用 buffer 的 memoryview（BufferToNativeValue）
+    rel::python::flush_pending_releases();
 }
 
 inline std::string PyObjectToString(PyObject *p)
@@ -77,6 +82,124 @@ inline void InstallPyObjectOps()
     SetPyObjectOps(ops);
 }
 
+// ---------------------------------------------------------------------------
+// 原生数值视图（调用方持有 GIL）
+// ---------------------------------------------------------------------------
+
+// 可写 buffer 只在不超过此大小时拷贝成原生视图，更大的只保留不透明引用
+const size_t kMaxCopiedBufferBytes = 64 * 1024;
+
+// C 连续的 double / int32 / complex128 buffer（numpy 数组、array.array…）转成 rel::Value。
+// 形状规则由 REL 的 rel::python::adopt_buffer 提供（与 rel.DataSeries.from_array 同一实现）：
+// 首维是行数，1/2/3 维分别是标量/向量/矩阵单元，0 维或单行退化为 Measurement。
+//   - 只读 buffer：借用同一块内存，不拷贝；持有的 memoryview 可在无 GIL 的线程上释放，
+//     由 FlushPendingDecrefs 一并冲刷；
+//   - 可写 buffer：借用会让导出方在视图存活期间无法改变大小（append/resize 抛
+//     BufferError），因此不超过 kMaxCopiedBufferBytes 时拷贝一份，memoryview 随即释放；
+//     更大的不附带原生视图。
+inline bool BufferToNativeValue(PyObject *obj, rel::Value &out)
+{
+    Py_buffer probe;
+    if (PyObject_GetBuffer(obj, &probe, PyBUF_RECORDS_RO) != 0)
+    {
+        PyErr_Clear();
+        return false;
+    }
+    const bool writable = probe.readonly == 0;
+    const size_t bytes = static_cast<size_t>(probe.len);
+    PyBuffer_Release(&probe);
+    if (writable && bytes > kMaxCopiedBufferBytes)
+    {
+        return false;
+    }
+
+    xdataset::DataSeries series;
+    if (!rel::python::adopt_buffer(obj, series))
+    {
+        return false;
+    }
+    if (writable)
+    {
+        // 任一可变访问都会把借用的单元拷贝到自有存储，并释放 memoryview（持有 GIL，立即释放）
+        switch (series.data_type())
+        {
+        case xdataset::DataType::kReal:
+            series.mutable_contiguous_data<double>();
+            break;
+        case xdataset::DataType::kInteger:
+            series.mutable_contiguous_data<int>();
+            break;
+        default:
+            series.mutable_contiguous_data<std::complex<double>>();
+            break;
+        }
+    }
+    if (series.size() == 1)
+    {
+        out = rel::Value(series.measurement_at(0));
+    }
+    else
+    {
+        out = rel::Value(xdataset::DataArray::CreateIndependent(std::move(series)));
+    }
+    return true;
+}
+
+// Python 数值 -> rel::Value：bool/int（int32 范围内）/float/complex 及其子类
+// （numpy 标量多数属于此类）、数值 buffer、REL 自己的 rel.Value 对象。
+// 其余对象返回 false，只保留不透明引用。
+inline bool ToNativeValue(pybind11::handle src, rel::Value &out)
+{
+    PyObject *p = src.ptr();
+    if (PyBool_Check(p))
+    {
+        out = rel::Value::Boolean(p == Py_True);
+        return true;
+    }
+    if (PyLong_Check(p))
+    {
+        int overflow = 0;
+        long long v = PyLong_AsLongLongAndOverflow(p, &overflow);
+        if (v == -1 && PyErr_Occurred())
+        {
+            PyErr_Clear();
+            return false;
+        }
+        if (overflow != 0 || v < INT_MIN || v > INT_MAX)
+        {
+            return false;
+        }
+        out = rel::Value::Integer(static_cast<int>(v));
+        return true;
+    }
+    if (PyFloat_Check(p))
+    {
+        out = rel::Value::Real(PyFloat_AS_DOUBLE(p));
+        return true;
+    }
+    if (PyComplex_Check(p))
+    {
+        Py_complex c = PyComplex_AsCComplex(p);
+        out = rel::Value::Complex(std::complex<double>(c.real, c.imag));
+        return true;
+    }
+    if (pybind11::isinstance<rel::Value>(src))
+    {
+        out = src.cast<rel::Value>();
+        return true;
+    }
+    try
+    {
+        return BufferToNativeValue(p, out);
+    }
+    catch (const std::exception &)
+    {
+        // 形状/类型不被 DataSeries 接受时退回不透明引用
+        return false;
+    }
+}
+
+
 } // namespace value_convert
 } // namespace xequation
 
@@ -92,7 +215,8 @@ struct type_caster<xequation::EquationValue>
     PYBIND11_TYPE_CASTER(xequation::EquationValue, _("EquationValue"));
 
     // py::object -> EquationValue
-    // 所有 Python 对象原样保留为不透明 PyObjectRef（零归一化）：
+    // 所有 Python 对象原样保留为不透明 PyObjectRef（零归一化），
+    // 数值另附原生 rel::Value 视图（见 ToNativeValue）：
     //   - 往返保真：同一 Python 对象进 C++ 再出去，是同一个引用；
     //   - load/cast 对称：Python 侧的值永不在此解包/归一化；
     //   - GUI builder 全覆盖（所有值都是 IsPyObject()）。
@@ -108,6 +232,13 @@ struct type_caster<xequation::EquationValue>
         // （use-after-free，Py_Finalize 时崩溃）。
         Py_XINCREF(src.ptr());
         value = xequation::EquationValue(xequation::PyObjectRef(src.ptr()));
+
+        // 数值额外附带原生视图：下游（REL 桥接、界面）读数值不必再拿 GIL
+        rel::Value native;
+        if (xequation::value_convert::ToNativeValue(src, native))
+        {
+            value.set_native_value(std::move(native));
+        }
         return true;
     }
 
@@ -12,27 +12,28 @@ RelEquationContext::RelEquationContext(const EquationEngineInfo &engine_info)
 
 bool RelEquationContext::Contains(const std::string &key) const
 {
-    const std::vector<std::string> names = env_.VariableNames();
-    return std::find(names.begin(), names.end(), key) != names.end();
+    return env_.Contains(key);
 }
 
 EquationValue RelEquationContext::Get(const std::string &key) const
 {
-    if (!Contains(key))
+    rel::Value value;
+    if (!env_.Find(key, value))
     {
         return EquationValue::Null();
     }
-    return EquationValue(env_.Get(key));
+    return EquationValue(std::move(value));
 }
 
 void RelEquationContext::Set(const std::string &key, const EquationValue &value)
 {
-    if (value.IsRelValue())
+    // rel::Value 载荷或 Python 数值的原生视图都可直接写入，无需 GIL
+    if (value.HasNativeValue())
     {
-        env_.Define(key, value.AsRel());
+        env_.Define(key, value.NativeValue());
         return;
     }
-    // PyObjectRef 等非 rel::Value 载荷无法直接写入 rel::Environment
+    // 其余 PyObjectRef 载荷无法直接写入 rel::Environment
     throw std::runtime_error(
         "RelEquationContext::Set: only rel::Value payloads can be stored in the REL environment"
     );
@@ -50,12 +51,12 @@ void RelEquationContext::Clear()
 
 size_t RelEquationContext::size() const
 {
-    return keys().size();
+    return env_.size();
 }
 
 bool RelEquationContext::empty() const
 {
-    return keys().empty();
+    return env_.size() == 0;
 }
 
 std::unordered_set<std::string> RelEquationContext::keys() const
@@ -101,9 +102,9 @@ std::string RelEquationContext::GetSymbolType(const std::string &symbol_name) co
         return "constant";
     }
     // 用户变量：按 rel::Value 的 data_type 归类
-    if (Contains(symbol_name))
+    rel::Value v;
+    if (env_.Find(symbol_name, v))
     {
-        const rel::Value &v = env_.Get(symbol_name);
         switch (v.data_type())
         {
             case xdataset::DataType::kReal:    return "real";
@@ -16,6 +16,7 @@ namespace rel_engine
 //
 // rel::Environment 提供 Define/Get/Remove/Clear/VariableNames（Remove/Clear
 // 由上游 REL 提供），删除语义直接委托给 Environment，无需本地模拟。
+// Contains/Get/size 走 Environment 的哈希查找，不再展开整张变量名表。
 class RelEquationContext : public EquationContext
 {
   public:
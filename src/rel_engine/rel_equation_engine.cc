@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "core/task_pool.h"
 #include "rel_equation_context.h"
 
 namespace xequation
@@ -27,17 +28,10 @@ RelEquationEngine::~RelEquationEngine() = default;
 InterpretResult RelEquationEngine::Interpret(const std::string &code, const EquationContext *context,
                                              InterpretMode mode)
 {
-    // 解析出 REL 环境：context 必须是 RelEquationContext（或 nullptr 用临时环境）
     rel::Environment env;
-    rel::Environment *target = &env;
-
-    const RelEquationContext *rel_context = dynamic_cast<const RelEquationContext *>(context);
-    if (rel_context)
-    {
-        // env() 返回非 const 引用；context 是 const 指针，这里显式转换以复用
-        // 方程管理器持有的上下文环境（变量跨方程可见）。
-        target = const_cast<rel::Environment *>(&rel_context->env());
-    }
+    rel::Environment *target = ResolveEnvironment(context, env);
+    // TaskPool 的每个工作线程已占用一个核，REL 算子在其中不再分块并行，避免线程数平方级超订
+    rel::SerialEvalScope serial(TaskPool::InWorkerThread());
 
     if (mode == InterpretMode::kEval)
     {
@@ -49,6 +43,46 @@ InterpretResult RelEquationEngine::Interpret(const std::string &code, const Equa
     }
 }
 
+CompiledCodePtr RelEquationEngine::Compile(const std::string &code, InterpretMode mode)
+{
+    return code_executor->Compile(code, mode);
+}
+
+InterpretResult RelEquationEngine::Interpret(const CompiledCode &compiled, const EquationContext *context)
+{
+    const RelCompiledCode *rel_compiled = dynamic_cast<const RelCompiledCode *>(&compiled);
+    if (!rel_compiled)
+    {
+        return Interpret(compiled.source(), context, compiled.mode());
+    }
+
+    rel::Environment env;
+    rel::Environment *target = ResolveEnvironment(context, env);
+    // TaskPool 的每个工作线程已占用一个核，REL 算子在其中不再分块并行，避免线程数平方级超订
+    rel::SerialEvalScope serial(TaskPool::InWorkerThread());
+
+    if (rel_compiled->mode() == InterpretMode::kEval)
+    {
+        return code_executor->Eval(*rel_compiled, *target);
+    }
+    else
+    {
+        return code_executor->Exec(*rel_compiled, *target);
+    }
+}
+
+rel::Environment *RelEquationEngine::ResolveEnvironment(const EquationContext *context, rel::Environment &fallback)
+{
+    const RelEquationContext *rel_context = dynamic_cast<const RelEquationContext *>(context);
+    if (rel_context)
+    {
+        // env() 返回非 const 引用；context 是 const 指针，这里显式转换以复用
+        // 方程管理器持有的上下文环境（变量跨方程可见）。
+        return const_cast<rel::Environment *>(&rel_context->env());
+    }
+    return &fallback;
+}
+
 ParseResult RelEquationEngine::Parse(const std::string &code, ParseMode mode)
 {
     if (mode == ParseMode::kExpression)
@@ -22,12 +22,25 @@ class RelEquationEngine : public EquationEngine<RelEquationEngine>
                               InterpretMode mode = InterpretMode::kExec) override;
     ParseResult Parse(const std::string &expr, ParseMode mode = ParseMode::kExpression) override;
 
+    // 预解析为 RelCompiledCode（AST），重算时直接求值
+    CompiledCodePtr Compile(const std::string &code, InterpretMode mode = InterpretMode::kExec) override;
+    InterpretResult Interpret(const CompiledCode &compiled, const EquationContext *context = nullptr) override;
+
     std::unique_ptr<EquationContext> CreateContext() override;
 
+    // REL 无全局解释器锁，rel::Environment 的变量表自带互斥：独立方程可并行求值
+    bool SupportsConcurrentInterpret() const override
+    {
+        return true;
+    }
+
     // 实现基类的输出处理接口（REL 无 stdout 捕获，留空）
     void SetOutputHandler(OutputHandler handler) override {}
 
   private:
+    // 解析出 REL 环境：context 必须是 RelEquationContext（或 nullptr 用 fallback 临时环境）
+    static rel::Environment *ResolveEnvironment(const EquationContext *context, rel::Environment &fallback);
+
     friend class EquationEngine<RelEquationEngine>;
 
     RelEquationEngine();
@@ -1,5 +1,7 @@
 #include "rel_executor.h"
 
+#include "rel_parser.h"
+
 namespace xequation
 {
 namespace rel_engine
@@ -83,5 +85,80 @@ InterpretResult RelExecutor::Eval(const std::string &expression, rel::Environmen
     return res;
 }
 
+std::shared_ptr<const RelCompiledCode> RelExecutor::Compile(const std::string &code, InterpretMode mode)
+{
+    std::string binding_name;
+    std::string expr_str = code;
+
+    if (mode == InterpretMode::kExec)
+    {
+        const std::size_t eq = RelParser::FindBindingEq(code);
+        if (eq != std::string::npos)
+        {
+            binding_name = RelParser::Trim(code.substr(0, eq));
+            expr_str = RelParser::Trim(code.substr(eq + 1));
+            if (!RelParser::IsValidIdentifier(binding_name))
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    try
+    {
+        // 编译结果会被反复求值：字面量与常量子表达式在此一次性折叠，再降为字节码
+        std::shared_ptr<const rel::Program> program = rel::Compile(rel::Optimize(rel::Parse(expr_str)));
+        return std::make_shared<RelCompiledCode>(code, mode, std::move(binding_name), std::move(program));
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+InterpretResult RelExecutor::Exec(const RelCompiledCode &compiled, rel::Environment &env)
+{
+    InterpretResult res;
+    res.mode = InterpretMode::kExec;
+
+    try
+    {
+        rel::Value value = rel::Eval(compiled.program(), env);
+        if (!compiled.binding_name().empty())
+        {
+            env.Define(compiled.binding_name(), value);
+        }
+        res.status = ResultStatus::kSuccess;
+        res.value = EquationValue::Null();
+    }
+    catch (const std::exception &e)
+    {
+        res.status = MapRelError(e.what());
+        res.message = e.what();
+        res.value = EquationValue::Null();
+    }
+    return res;
+}
+
+InterpretResult RelExecutor::Eval(const RelCompiledCode &compiled, rel::Environment &env)
+{
+    InterpretResult res;
+    res.mode = InterpretMode::kEval;
+
+    try
+    {
+        rel::Value value = rel::Eval(compiled.program(), env);
+        res.status = ResultStatus::kSuccess;
+        res.value = EquationValue(value);
+    }
+    catch (const std::exception &e)
+    {
+        res.status = MapRelError(e.what());
+        res.message = e.what();
+        res.value = EquationValue::Null();
+    }
+    return res;
+}
+
 } // namespace rel_engine
 } // namespace xequation
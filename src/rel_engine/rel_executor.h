@@ -1,8 +1,10 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "core/equation_common.h"
-#include "rel.h"      // rel::Eval / rel::Exec
+#include "rel.h"      // rel::Program / rel::Compile / rel::Eval
 #include "environment.h"  // rel::Environment
 
 namespace xequation
@@ -10,6 +12,26 @@ namespace xequation
 namespace rel_engine
 {
 
+// REL 预编译产物：`name = expr` 拆成绑定名 + 右侧字节码程序；纯表达式 binding_name 为空。
+class RelCompiledCode : public CompiledCode
+{
+  public:
+    RelCompiledCode(
+        const std::string &source, InterpretMode mode, std::string binding_name,
+        std::shared_ptr<const rel::Program> program
+    )
+        : CompiledCode(source, mode), binding_name_(std::move(binding_name)), program_(std::move(program))
+    {
+    }
+
+    const std::string &binding_name() const { return binding_name_; }
+    const rel::Program &program() const { return *program_; }
+
+  private:
+    std::string binding_name_;
+    std::shared_ptr<const rel::Program> program_;
+};
+
 // REL 表达式执行器：仿照 python/PythonExecutor，把 rel::Eval/rel::Exec
 // 包装成 xequation 的 InterpretResult（异常映射到 ResultStatus）。
 class RelExecutor
@@ -27,6 +49,13 @@ class RelExecutor
     // Evaluates a single REL expression in the given environment.
     InterpretResult Eval(const std::string &expression, rel::Environment &env);
 
+    // 预解析并编译为字节码；语法错误/非法绑定名返回 nullptr（由源码路径报告错误）
+    std::shared_ptr<const RelCompiledCode> Compile(const std::string &code, InterpretMode mode);
+
+    // 执行预编译产物，跳过扫描、解析与树遍历
+    InterpretResult Exec(const RelCompiledCode &compiled, rel::Environment &env);
+    InterpretResult Eval(const RelCompiledCode &compiled, rel::Environment &env);
+
   private:
     // 把 REL 抛出的 std::runtime_error 映射为 ResultStatus + message
     ResultStatus MapRelError(const std::string &message) const;
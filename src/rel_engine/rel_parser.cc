@@ -23,7 +23,7 @@ namespace
 //   - CallExpr 的 callee 若是单段标识符且注册在函数表 -> 函数调用，
 //     callee 不是依赖（只收参数）；否则按矩阵索引处理（callee 是依赖）；
 //   - 单段引用若是内置常量 -> 不是依赖；
-//   - 叶子节点（数字/布尔/字符串/空范围）无依赖。
+//   - 叶子节点（数字/布尔/字符串/空范围/折叠常量）无依赖。
 // ---------------------------------------------------------------------------
 class RelDependencyVisitor : public rel::ExprVisitor
 {
@@ -34,6 +34,7 @@ class RelDependencyVisitor : public rel::ExprVisitor
     void visit_boolean(const rel::BooleanExpr &) override {}
     void visit_string(const rel::StringExpr &) override {}
     void visit_null_range(const rel::NullRangeExpr &) override {}
+    void visit_constant(const rel::ConstantExpr &) override {}
 
     void visit_reference(const rel::ReferenceExpr &expr) override
     {
@@ -40,16 +40,16 @@ class RelParser
 
     size_t GetParseResultCacheSize() const { return parse_result_cache_.size(); }
 
+    // 仿 rel::Exec：找顶层绑定 '='（跳过 ==, !=, <=, >=）；RelExecutor::Compile 共用
+    static std::size_t FindBindingEq(const std::string &line);
+    static std::string Trim(const std::string &s);
+    static bool IsValidIdentifier(const std::string &name);
+
   private:
     // 遍历表达式 AST，提取引用路径依赖（去重保序）
     std::vector<std::string> ExtractDependencies(const std::string &expression) const;
     std::vector<std::string> ExtractDependencies(const rel::ExprPtr &expr) const;
 
-    // 仿 rel::Exec：找顶层绑定 '='（跳过 ==, !=, <=, >=）
-    static std::size_t FindBindingEq(const std::string &line);
-    static std::string Trim(const std::string &s);
-    static bool IsValidIdentifier(const std::string &name);
-
     void EvictLRU();
 
   private:
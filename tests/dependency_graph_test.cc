@@ -1,5 +1,7 @@
 #include "core/dependency_graph.h"
 #include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -285,7 +287,7 @@ TEST(DependencyGraphTest, MultipleCyclesDetection) {
   }
   
   // Verify all edges were rolled back (no edges added)
-  EXPECT_TRUE(graph.GetAllEdges().first == graph.GetAllEdges().second);
+  EXPECT_TRUE(graph.GetAllEdges().empty());
   
   // Verify nodes still exist
   EXPECT_TRUE(graph.IsNodeExist("A"));
@@ -739,7 +741,165 @@ TEST(DependencyGraphTest, Reset) {
   EXPECT_FALSE(graph.IsNodeExist("X"));
   EXPECT_FALSE(graph.IsNodeExist("Y"));
   EXPECT_FALSE(graph.IsNodeExist("Z"));
-  EXPECT_TRUE(graph.GetAllEdges().first == graph.GetAllEdges().second);
+  EXPECT_TRUE(graph.GetAllEdges().empty());
+}
+
+// Every active edge must point backwards in the maintained order
+static void ExpectValidOrder(const DependencyGraph &graph) {
+  auto sorted = graph.TopologicalSort();
+  std::unordered_map<std::string, size_t> position;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    position[sorted[i]] = i;
+  }
+  for (const auto &entry : position) {
+    for (const auto &dep : graph.GetNode(entry.first)->dependencies()) {
+      EXPECT_LT(position.at(dep), entry.second) << entry.first << " depends on " << dep;
+    }
+  }
+}
+
+// Test incremental order maintenance when an edge inverts the current order
+TEST(DependencyGraphTest, IncrementalOrderReorder) {
+  DependencyGraph graph;
+
+  graph.AddNodes({"A", "B", "C", "D"});
+  graph.AddEdge({"B", "A"});
+  graph.AddEdge({"C", "B"});
+  ExpectValidOrder(graph);
+
+  // A now depends on D, which was placed before A: A, B, C must move after D
+  graph.AddNode("E");
+  graph.AddEdge({"D", "E"});
+  graph.AddEdge({"A", "D"});
+  ExpectValidOrder(graph);
+
+  auto sorted = graph.TopologicalSort("D");
+  ASSERT_EQ(sorted.size(), 4);
+  EXPECT_EQ(sorted[0], "D");
+  EXPECT_EQ(sorted[1], "A");
+  EXPECT_EQ(sorted[2], "B");
+  EXPECT_EQ(sorted[3], "C");
+
+  // Rejected edge leaves the order untouched
+  EXPECT_THROW(graph.AddEdge({"E", "C"}), DependencyCycleException);
+  ExpectValidOrder(graph);
+  EXPECT_EQ(graph.TopologicalSort("E").size(), 5);
+}
+
+// Incremental cycle detection reports the cycle through the rejected edge
+TEST(DependencyGraphTest, IncrementalCyclePath) {
+  DependencyGraph graph;
+
+  graph.AddNodes({"A", "B", "C"});
+  graph.AddEdge({"A", "B"});
+  graph.AddEdge({"B", "C"});
+
+  try {
+    graph.AddEdge({"C", "A"});
+    FAIL() << "Expected DependencyCycleException";
+  } catch (const DependencyCycleException &e) {
+    EXPECT_EQ(e.cycle_path(), std::vector<std::string>({"C", "A", "B", "C"}));
+  }
+  EXPECT_FALSE(graph.IsEdgeExist({"C", "A"}));
+
+  // Self dependency
+  try {
+    graph.AddEdge({"B", "B"});
+    FAIL() << "Expected DependencyCycleException";
+  } catch (const DependencyCycleException &e) {
+    EXPECT_EQ(e.cycle_path(), std::vector<std::string>({"B", "B"}));
+  }
+
+  // Dangling edges closing a cycle when the node appears
+  graph.AddEdge({"C", "D"});
+  graph.AddEdge({"D", "A"});
+  EXPECT_THROW(graph.AddNode("D"), DependencyCycleException);
+  EXPECT_FALSE(graph.IsNodeExist("D"));
+  EXPECT_TRUE(graph.GetNode("C")->dependencies().empty());
+  ExpectValidOrder(graph);
+}
+
+// Randomized add/remove sequence: the maintained order stays a valid topological order
+TEST(DependencyGraphTest, IncrementalOrderRandomized) {
+  DependencyGraph graph;
+  std::mt19937 rng(42);
+  const int node_count = 40;
+
+  for (int i = 0; i < node_count; i++) {
+    graph.AddNode("N" + std::to_string(i));
+  }
+
+  for (int step = 0; step < 600; step++) {
+    std::string from = "N" + std::to_string(rng() % node_count);
+    std::string to = "N" + std::to_string(rng() % node_count);
+    switch (rng() % 4) {
+    case 0:
+      graph.RemoveEdge({from, to});
+      break;
+    case 1:
+      graph.RemoveNode(from);
+      graph.AddNode(from);
+      break;
+    default:
+      try {
+        graph.AddEdge({from, to});
+      } catch (const DependencyCycleException &) {
+        EXPECT_FALSE(graph.IsEdgeExist({from, to}));
+      }
+      break;
+    }
+  }
+
+  EXPECT_EQ(graph.TopologicalSort().size(), node_count);
+  ExpectValidOrder(graph);
+}
+
+// Traversal visits the names present when it started, even if the callback
+// removes nodes and their ids are reused by new nodes
+TEST(DependencyGraphTest, TraversalSurvivesNodeReuse) {
+  DependencyGraph graph;
+  graph.AddNodes({"A", "B", "C"});
+  graph.AddEdge({"B", "A"});
+  graph.AddEdge({"C", "B"});
+
+  std::vector<std::string> visited;
+  graph.Traversal([&](const std::string &name) {
+    visited.push_back(name);
+    if (name == "A") {
+      graph.RemoveNode("B");
+      graph.RemoveEdge({"B", "A"});
+      graph.RemoveEdge({"C", "B"});
+      graph.AddNode("X");
+    }
+  });
+  EXPECT_EQ(visited, std::vector<std::string>({"A", "B", "C"}));
+  EXPECT_TRUE(graph.IsNodeExist("X"));
+  EXPECT_FALSE(graph.IsNodeExist("B"));
+}
+
+// Repeated invalidation marks exactly the downstream nodes each time
+TEST(DependencyGraphTest, RepeatedInvalidation) {
+  DependencyGraph graph;
+  graph.AddNodes({"A", "B", "C", "D"});
+  graph.AddEdge({"B", "A"});
+  graph.AddEdge({"C", "B"});
+  graph.AddEdge({"D", "A"});
+
+  for (int round = 0; round < 3; round++) {
+    graph.InvalidateNode("B");
+    EXPECT_FALSE(graph.GetNode("A")->dirty_flag());
+    EXPECT_TRUE(graph.GetNode("B")->dirty_flag());
+    EXPECT_TRUE(graph.GetNode("C")->dirty_flag());
+    EXPECT_FALSE(graph.GetNode("D")->dirty_flag());
+    for (const char *name : {"A", "B", "C", "D"}) {
+      graph.MakeNodeDirty(name, false);
+    }
+  }
+
+  graph.InvalidateNode("A");
+  for (const char *name : {"A", "B", "C", "D"}) {
+    EXPECT_TRUE(graph.GetNode(name)->dirty_flag()) << name;
+  }
 }
 
 int main(int argc, char **argv) {
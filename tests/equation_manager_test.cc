@@ -610,6 +610,45 @@ TEST_F(EquationManagerTest, Eval)
     EXPECT_EQ(res.status, ResultStatus::kNameError);
 }
 
+TEST(EquationManagerCompiledTest, CompileOncePerContentChange)
+{
+    int compile_count = 0;
+    int compiled_interpret_count = 0;
+
+    CompileHandler compile = [&compile_count](const std::string &code, InterpretMode mode) -> CompiledCodePtr {
+        compile_count++;
+        return std::make_shared<CompiledCode>(code, mode);
+    };
+    CompiledInterpretHandler compiled_interpret = [&compiled_interpret_count](const CompiledCode &compiled, EquationContext *context) {
+        compiled_interpret_count++;
+        return Interpret(compiled.source(), context, compiled.mode());
+    };
+
+    EquationManager manager(
+        std::unique_ptr<MockExprContext>(new MockExprContext()), Interpret, Parse, EquationEngineInfo{"Mock"}, compile,
+        compiled_interpret
+    );
+
+    EquationGroupId id = manager.AddEquationGroup("A=B+1;B=2");
+    EXPECT_EQ(compile_count, 2);
+    manager.Update();
+    EXPECT_EQ(compiled_interpret_count, 2);
+    EXPECT_EQ(manager.context().Get("A").Cast<int>(), 3);
+
+    // 重算不重新编译
+    manager.UpdateEquation("B");
+    manager.UpdateEquationGroup(id);
+    EXPECT_EQ(compile_count, 2);
+    EXPECT_EQ(compiled_interpret_count, 6);
+
+    // 仅内容变化的方程重新编译
+    manager.EditEquationGroup(id, "A=B+1;B=5");
+    EXPECT_EQ(compile_count, 3);
+    manager.Update();
+    EXPECT_EQ(manager.context().Get("A").Cast<int>(), 6);
+    EXPECT_EQ(manager.GetEquation("B")->compiled_code()->source(), "B = 5");
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
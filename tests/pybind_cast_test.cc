@@ -2,6 +2,7 @@
 #include <pybind11/cast.h>
 #include <pybind11/embed.h>
 #include <pybind11/pytypes.h>
+#include <complex>
 #include <string>
 #include <vector>
 
@@ -150,6 +151,74 @@ TEST(EquationValueCast, DictRoundTrip)
     EXPECT_EQ(pybind11::cast<int>(back["a"]), 1);
 }
 
+// ---- 数值附带原生 rel::Value 视图，读取不需要 GIL -----------------------
+
+TEST(EquationValueCast, LoadScalarsHaveNativeValue)
+{
+    EquationValue i = pybind11::cast<EquationValue>(pybind11::cast(42));
+    EquationValue d = pybind11::cast<EquationValue>(pybind11::cast(2.5));
+    EquationValue b = pybind11::cast<EquationValue>(pybind11::cast(true));
+    EquationValue c = pybind11::cast<EquationValue>(pybind11::cast(std::complex<double>(1.0, -2.0)));
+
+    ASSERT_TRUE(i.HasNativeValue());
+    EXPECT_EQ(i.NativeValue().data_type(), xdataset::DataType::kInteger);
+    EXPECT_EQ(i.Cast<int>(), 42);
+    EXPECT_DOUBLE_EQ(d.Cast<double>(), 2.5);
+    EXPECT_EQ(b.NativeValue().data_type(), xdataset::DataType::kBoolean);
+    EXPECT_EQ(c.Cast<std::complex<double>>(), std::complex<double>(1.0, -2.0));
+
+    // 仍是同一个 Python 对象
+    EXPECT_TRUE(i.IsPyObject());
+    EXPECT_EQ(pybind11::cast<int>(pybind11::cast(i)), 42);
+}
+
+TEST(EquationValueCast, LoadNonNumericHasNoNativeValue)
+{
+    EXPECT_FALSE(pybind11::cast<EquationValue>(pybind11::cast("hello")).HasNativeValue());
+    EXPECT_FALSE(pybind11::cast<EquationValue>(pybind11::list()).HasNativeValue());
+    // 超出 int32 的整数保持不透明
+    pybind11::object big = pybind11::eval("2 ** 40");
+    EXPECT_FALSE(pybind11::cast<EquationValue>(big).HasNativeValue());
+}
+
+TEST(EquationValueCast, LoadWritableBufferIsCopied)
+{
+    pybind11::dict scope;
+    pybind11::exec("import array\nsamples = array.array('d', [1.0, 2.0, 3.0])", scope);
+    pybind11::object samples = scope["samples"];
+
+    EquationValue value = pybind11::cast<EquationValue>(samples);
+    ASSERT_TRUE(value.HasNativeValue());
+    const rel::Value &native = value.NativeValue();
+    ASSERT_TRUE(native.is_data_array());
+    EXPECT_EQ(native.rows(), 3);
+    EXPECT_FALSE(native.as_data_array().data().is_borrowed());
+    EXPECT_DOUBLE_EQ(native.as_data_array().data().scalar_at<double>(2), 3.0);
+
+    // 未借用导出方的内存，Python 侧仍可改变大小
+    pybind11::exec("samples.append(4.0)", scope);
+    EXPECT_EQ(pybind11::len(samples), 4u);
+    EXPECT_EQ(native.rows(), 3);
+
+    // 超过拷贝上限的可写 buffer 不附带原生视图
+    pybind11::exec("big = array.array('d', [0.0]) * 100000", scope);
+    EXPECT_FALSE(pybind11::cast<EquationValue>(scope["big"]).HasNativeValue());
+}
+
+TEST(EquationValueCast, LoadReadOnlyBufferBorrowsMemory)
+{
+    pybind11::dict scope;
+    pybind11::exec("import array\nsamples = memoryview(array.array('d', [1.0, 2.0, 3.0])).toreadonly()",
+                   scope);
+
+    EquationValue value = pybind11::cast<EquationValue>(scope["samples"]);
+    ASSERT_TRUE(value.HasNativeValue());
+    const rel::Value &native = value.NativeValue();
+    ASSERT_TRUE(native.is_data_array());
+    EXPECT_TRUE(native.as_data_array().data().is_borrowed());
+    EXPECT_DOUBLE_EQ(native.as_data_array().data().scalar_at<double>(1), 2.0);
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -90,6 +90,46 @@ d=a+b*c
     EXPECT_EQ(path, "home/user/documents/file.txt");
 }
 
+TEST(PythonEquationEngine, TestWorkerPool)
+{
+    auto& engine = PythonEquationEngine::GetInstance();
+    pybind11::gil_scoped_acquire acquire;
+    ASSERT_TRUE(engine.SetWorkerCount(2));
+    EXPECT_EQ(engine.worker_count(), 2u);
+    EXPECT_TRUE(engine.SupportsConcurrentInterpret());
+
+    auto equation_manager = engine.CreateEquationManager();
+    EXPECT_EQ(equation_manager->max_threads(), 3u);
+
+    equation_manager->AddEquationGroup("r = 10");
+    std::string total = "total = 0";
+    for (int i = 0; i < 8; i++)
+    {
+        std::string name = "x" + std::to_string(i);
+        equation_manager->AddEquationGroup(name + " = [r + " + std::to_string(i) + "] * 3");
+        total += " + sum(" + name + ")";
+    }
+    equation_manager->AddEquationGroup(total);
+    equation_manager->AddEquationGroup("pid = __import__('os').getpid()");
+    equation_manager->AddEquationGroup("z = 1 / 0");
+    // 函数无法跨进程，定义和使用它的方程都回退到本地执行
+    equation_manager->AddEquationGroup("def twice(v):\n    return 2 * v");
+    equation_manager->AddEquationGroup("w = twice(r)");
+    equation_manager->Update();
+
+    EXPECT_EQ(pybind11::cast(equation_manager->context().Get("total")).cast<int>(), 3 * (8 * 10 + 28));
+    EXPECT_EQ(equation_manager->GetEquation("x7")->status(), ResultStatus::kSuccess);
+    int main_pid = pybind11::module_::import("os").attr("getpid")().cast<int>();
+    EXPECT_NE(pybind11::cast(equation_manager->context().Get("pid")).cast<int>(), main_pid);
+    EXPECT_EQ(equation_manager->GetEquation("z")->status(), ResultStatus::kZeroDivisionError);
+    EXPECT_EQ(equation_manager->GetEquation("z")->message(), "division by zero");
+    EXPECT_EQ(pybind11::cast(equation_manager->context().Get("w")).cast<int>(), 20);
+
+    equation_manager.reset();
+    ASSERT_TRUE(engine.SetWorkerCount(0));
+    EXPECT_FALSE(engine.SupportsConcurrentInterpret());
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     // 不能用 scoped_interpreter（默认配置找不到 stdlib 会 terminate），
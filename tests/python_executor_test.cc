@@ -5,6 +5,8 @@
 #include <gtest/gtest.h>
 #include <pybind11/embed.h>
 #include <pybind11/pytypes.h>
+#include <string>
+#include <vector>
 
 using namespace xequation;
 using namespace xequation::python;
@@ -337,6 +339,57 @@ TEST_F(PythonExecutorTest, EvalReturnTypes) {
   EXPECT_EQ(pybind11::cast<std::string>(dict["key"]), "value");
 }
 
+TEST_F(PythonExecutorTest, CodeObjectCache) {
+  pybind11::dict locals;
+  locals["x"] = 1;
+
+  // 相同源码重复执行只编译一次，结果仍随 locals 变化
+  for (int i = 0; i < 3; ++i) {
+    auto result = executor_->Exec("x = x + 1", locals);
+    EXPECT_EQ(result.status, ResultStatus::kSuccess);
+  }
+  EXPECT_EQ(locals["x"].cast<int>(), 4);
+  EXPECT_EQ(executor_->GetCodeCacheSize(), 1u);
+
+  // 同一段源码的 eval 与 exec 分别缓存
+  auto eval_result = executor_->Eval("x = x + 1", locals);
+  EXPECT_EQ(eval_result.status, ResultStatus::kSyntaxError);
+  auto value = executor_->Eval("x", locals);
+  EXPECT_EQ(pybind11::cast<int>(pybind11::cast(value.value)), 4);
+  EXPECT_EQ(executor_->GetCodeCacheSize(), 2u);
+
+  auto compiled1 = executor_->Compile("x * 2", InterpretMode::kEval);
+  auto compiled2 = executor_->Compile("x * 2", InterpretMode::kEval);
+  ASSERT_TRUE(compiled1 != nullptr);
+  EXPECT_EQ(compiled1.get(), compiled2.get());
+
+  // 语法错误不进入缓存
+  EXPECT_EQ(executor_->Compile("5 +", InterpretMode::kEval), nullptr);
+  EXPECT_EQ(executor_->GetCodeCacheSize(), 3u);
+}
+
+TEST_F(PythonExecutorTest, OutputHandler) {
+  std::vector<std::string> outputs;
+  executor_->SetOutputHandler([&outputs](const std::string &msg) { outputs.push_back(msg); });
+
+  pybind11::dict locals;
+  pybind11::object old_stdout = pybind11::module_::import("sys").attr("stdout");
+  EXPECT_EQ(executor_->Exec("print('first')", locals).status, ResultStatus::kSuccess);
+  EXPECT_EQ(executor_->Exec("print('second')", locals).status, ResultStatus::kSuccess);
+  EXPECT_EQ(executor_->Exec("import sys; sys.stderr.write('third')", locals).status, ResultStatus::kSuccess);
+  ASSERT_EQ(outputs.size(), 3u);
+  EXPECT_EQ(outputs[0], "first");
+  EXPECT_EQ(outputs[1], "second");
+  EXPECT_EQ(outputs[2], "third");
+
+  // 调用结束后 stdout 已恢复
+  EXPECT_TRUE(pybind11::module_::import("sys").attr("stdout").is(old_stdout));
+
+  executor_->ClearOutputHandler();
+  EXPECT_EQ(executor_->Exec("print('ignored')", locals).status, ResultStatus::kSuccess);
+  EXPECT_EQ(outputs.size(), 3u);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
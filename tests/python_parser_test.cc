@@ -5,6 +5,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <pybind11/embed.h>
+#include <cstdio>
+#include <fstream>
 
 /**
  * Unit tests for PythonParser
@@ -27,6 +29,7 @@
  * 15. Special Python Features (f-strings, slicing, operators)
  * 16. Multi-line and Async Code
  * 17. Extended Cache Tests
+ * 18. Persistent Cache File
  */
 
 using namespace xequation;
@@ -966,6 +969,77 @@ TEST_F(PythonParserTest, CacheIndependentOfWhitespace)
     EXPECT_EQ(result1.items[0].dependencies, result2.items[0].dependencies);
 }
 
+// ============================================================================
+// Persistent Cache File Tests
+// ============================================================================
+
+TEST_F(PythonParserTest, CacheFilePersistsAcrossParsers)
+{
+    const std::string cache_file = "test_python_parse.cache";
+    std::remove(cache_file.c_str());
+
+    ASSERT_TRUE(parser_->SetCacheFile(cache_file));
+    auto result1 = parser_->ParseStatements("a = b + c\nd = a * 2");
+    auto expr1 = parser_->ParseExpression("sqrt(x) + y");
+    EXPECT_GT(parser_->GetParseResultCacheSize(), 0u);
+
+    // 新的解析器从文件命中，不经过 Python 分析
+    PythonParser reopened;
+    ASSERT_TRUE(reopened.SetCacheFile(cache_file));
+    auto result2 = reopened.ParseStatements("a = b + c\nd = a * 2");
+    auto expr2 = reopened.ParseExpression("sqrt(x) + y");
+    EXPECT_EQ(reopened.GetParseResultCacheSize(), 0u);
+
+    ASSERT_EQ(result2.items.size(), 2u);
+    EXPECT_EQ(result2.items, result1.items);
+    EXPECT_EQ(result2.items[1].status, ResultStatus::kSuccess);
+    EXPECT_EQ(expr2.items, expr1.items);
+    EXPECT_EQ(expr2.mode, ParseMode::kExpression);
+
+    // 改动过的源码照常解析
+    auto result3 = reopened.ParseSingleStatement("e = a + 1");
+    EXPECT_THAT(result3.items[0].dependencies, testing::UnorderedElementsAre("a"));
+
+    std::remove(cache_file.c_str());
+}
+
+TEST_F(PythonParserTest, CacheFileIgnoresCorruptedContent)
+{
+    const std::string cache_file = "test_python_parse_corrupted.cache";
+    {
+        std::ofstream out(cache_file.c_str(), std::ios::binary | std::ios::trunc);
+        out << "not a parse cache";
+    }
+
+    ASSERT_TRUE(parser_->SetCacheFile(cache_file));
+    auto result = parser_->ParseSingleStatement("a = b + c");
+    EXPECT_THAT(result.items[0].dependencies, testing::UnorderedElementsAre("b", "c"));
+
+    std::remove(cache_file.c_str());
+}
+
+TEST_F(PythonParserTest, CacheFileKeepsRecordsBeforeTornTail)
+{
+    const std::string cache_file = "test_python_parse_torn.cache";
+    std::remove(cache_file.c_str());
+
+    ASSERT_TRUE(parser_->SetCacheFile(cache_file));
+    auto result1 = parser_->ParseStatements("a = b + c\nd = a * 2");
+    {
+        // 模拟写入中断：文件尾只留下半条记录
+        std::ofstream out(cache_file.c_str(), std::ios::binary | std::ios::app);
+        out << "torn";
+    }
+
+    PythonParser reopened;
+    ASSERT_TRUE(reopened.SetCacheFile(cache_file));
+    auto result2 = reopened.ParseStatements("a = b + c\nd = a * 2");
+    EXPECT_EQ(reopened.GetParseResultCacheSize(), 0u);
+    EXPECT_EQ(result2.items, result1.items);
+
+    std::remove(cache_file.c_str());
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -129,6 +129,62 @@ d=a+b*c
     EXPECT_NEAR(v.Cast<double>(), 3.14159265358979, 1e-12);
 }
 
+TEST(RelEquationEngine, TestParallelUpdate)
+{
+    auto& engine = RelEquationEngine::GetInstance();
+
+    // 宽扇出：少量源头挂着大量互不依赖的方程，再汇聚到若干下游，并夹带失败方程
+    std::string statement = "src = 2\nbase = src * 10\nbad = missing_name + 1\nafter_bad = bad * 2\n";
+    for (int i = 0; i < 200; i++)
+    {
+        std::string n = std::to_string(i);
+        statement += "f" + n + " = base + " + n + "\n";
+        statement += "g" + n + " = f" + n + " * src\n";
+    }
+    statement += "sum = g0 + g50 + g100 + g199\n";
+
+    auto run = [&](size_t max_threads, std::vector<std::pair<std::string, ResultStatus>> &events) {
+        auto equation_manager = engine.CreateEquationManager();
+        equation_manager->set_max_threads(max_threads);
+        EXPECT_EQ(equation_manager->max_threads(), max_threads);
+        equation_manager->AddEquationGroup(statement);
+        auto connection = equation_manager->signals_manager().ConnectScoped<EquationEvent::kEquationUpdated>(
+            [&events](const Equation *equation, bitmask::bitmask<EquationUpdateFlag>) {
+                events.emplace_back(equation->name(), equation->status());
+            }
+        );
+        equation_manager->Update();
+        return equation_manager;
+    };
+
+    std::vector<std::pair<std::string, ResultStatus>> serial_events;
+    std::vector<std::pair<std::string, ResultStatus>> parallel_events;
+    auto serial = run(1, serial_events);
+    auto parallel = run(4, parallel_events);
+
+    // 信号都在调用线程上发出：派发前先按拓扑序把所有方程标为计算中，
+    // 结果信号再按同一拓扑序发出
+    ASSERT_EQ(parallel_events.size(), 2u * (4 + 400 + 1));
+    ASSERT_EQ(parallel_events.size(), serial_events.size());
+    const size_t equation_count = serial_events.size() / 2;
+    for (size_t i = 0; i < equation_count; i++)
+    {
+        EXPECT_EQ(serial_events[2 * i].second, ResultStatus::kCalculating);
+        EXPECT_EQ(parallel_events[i], serial_events[2 * i]);
+        EXPECT_EQ(parallel_events[equation_count + i], serial_events[2 * i + 1]);
+    }
+
+    EXPECT_EQ(parallel->context().Get("g7").Cast<int>(), (20 + 7) * 2);
+    EXPECT_EQ(parallel->context().Get("sum").Cast<int>(), serial->context().Get("sum").Cast<int>());
+    EXPECT_NE(parallel->GetEquation("bad")->status(), ResultStatus::kSuccess);
+    EXPECT_NE(parallel->GetEquation("after_bad")->status(), ResultStatus::kSuccess);
+    EXPECT_FALSE(parallel->context().Contains("bad"));
+    EXPECT_EQ(parallel->GetEquation("bad")->message(), serial->GetEquation("bad")->message());
+
+    // REL 引擎创建的管理器默认开启并行
+    EXPECT_EQ(engine.CreateEquationManager()->max_threads(), 0u);
+}
+
 TEST(RelEquationEngine, TestInterpretEval)
 {
     auto& engine = RelEquationEngine::GetInstance();
@@ -139,6 +195,28 @@ TEST(RelEquationEngine, TestInterpretEval)
     EXPECT_EQ(r.value.Cast<int>(), 14);
 }
 
+TEST(RelEquationEngine, TestCompileInterpret)
+{
+    auto& engine = RelEquationEngine::GetInstance();
+    auto ctx = engine.CreateContext();
+
+    CompiledCodePtr assign = engine.Compile("x = 2 + 3", InterpretMode::kExec);
+    ASSERT_NE(assign, nullptr);
+    auto r = engine.Interpret(*assign, ctx.get());
+    EXPECT_EQ(r.status, ResultStatus::kSuccess);
+    EXPECT_EQ(ctx->Get("x").Cast<int>(), 5);
+
+    CompiledCodePtr expr = engine.Compile("x * 4", InterpretMode::kEval);
+    ASSERT_NE(expr, nullptr);
+    r = engine.Interpret(*expr, ctx.get());
+    EXPECT_EQ(r.status, ResultStatus::kSuccess);
+    EXPECT_EQ(r.value.Cast<int>(), 20);
+
+    // 语法错误/非法绑定名不生成编译产物
+    EXPECT_EQ(engine.Compile("x = 1 +", InterpretMode::kExec), nullptr);
+    EXPECT_EQ(engine.Compile("1x = 2", InterpretMode::kExec), nullptr);
+}
+
 TEST(RelEquationEngine, TestContextSetGet)
 {
     auto& engine = RelEquationEngine::GetInstance();